@@ -5167,11 +5167,14 @@ void cpu_random_8bit( Environment * _environment, char * _entropy, char * _resul
 
     inline( cpu_random_8bit )
 
-        cpu_random( _environment, _entropy );
+        // A byte comes from its own generator: there is no need
+        // to advance the whole 32 bit state.
+        deploy_embedded( cpu_random, src_hw_6502_cpu_random_asm );
 
         if ( _result ) {
             outline1("LDA %s", _entropy );
             outline0("ADC CPURANDOM_SEED" );
+            outline0("STA CPURANDOM_SEED" );
             outline0("JSR CPURANDOM8" );
             outline0("LDA CPURANDOM_SEED" );
             outline1("STA %s", _result );
@@ -5185,7 +5188,7 @@ void cpu_random_16bit( Environment * _environment, char * _entropy, char * _resu
 
     inline( cpu_random_16bit )
 
-        cpu_random( _environment, _entropy );
+        deploy_embedded( cpu_random, src_hw_6502_cpu_random_asm );
 
         if ( _result ) {
             outline1("LDA %s", _entropy );
@@ -7405,6 +7408,95 @@ void cpu_number_to_string( Environment * _environment, char * _number, char * _s
 
 }
 
+/**
+ * @brief <i>CPU 6502</i>: emit code to add two packed BCD values
+ * 
+ * @param _environment Current calling environment
+ * @param _source First value to add
+ * @param _destination Second value to add and destination address for result (if _other is NULL)
+ * @param _other Destination address for result
+ * @param _bytes Size of the values (in bytes)
+ */
+void cpu_bcd_add( Environment * _environment, char *_source, char *_destination, char *_other, int _bytes ) {
+
+    // The NMOS 6502 does not clear the decimal flag on interrupt,
+    // so interrupts are masked while the flag is set.
+    outline0("PHP");
+    outline0("SEI");
+    outline0("SED");
+    outline0("CLC");
+    for( int i=_bytes-1; i>=0; --i ) {
+        char offset[MAX_TEMPORARY_STORAGE]; sprintf( offset, "%d", i );
+        outline1("LDA %s", address_displacement(_environment, _source, offset));
+        outline1("ADC %s", address_displacement(_environment, _destination, offset));
+        outline1("STA %s", address_displacement(_environment, _other ? _other : _destination, offset));
+    }
+    outline0("PLP");
+
+}
+
+/**
+ * @brief <i>CPU 6502</i>: emit code to subtract two packed BCD values
+ * 
+ * @param _environment Current calling environment
+ * @param _source First value
+ * @param _destination Value to subtract and destination address for result (if _other is NULL)
+ * @param _other Destination address for result
+ * @param _bytes Size of the values (in bytes)
+ */
+void cpu_bcd_sub( Environment * _environment, char *_source, char *_destination, char *_other, int _bytes ) {
+
+    outline0("PHP");
+    outline0("SEI");
+    outline0("SED");
+    outline0("SEC");
+    for( int i=_bytes-1; i>=0; --i ) {
+        char offset[MAX_TEMPORARY_STORAGE]; sprintf( offset, "%d", i );
+        outline1("LDA %s", address_displacement(_environment, _source, offset));
+        outline1("SBC %s", address_displacement(_environment, _destination, offset));
+        outline1("STA %s", address_displacement(_environment, _other ? _other : _destination, offset));
+    }
+    outline0("PLP");
+
+}
+
+/**
+ * @brief <i>CPU 6502</i>: emit code to convert a packed BCD value into digits
+ * 
+ * @param _environment Current calling environment
+ * @param _bcd Value to convert
+ * @param _string Address of the string to fill (at least 2 * _bytes chars)
+ * @param _string_size Where to store the number of digits
+ * @param _bytes Size of the value (in bytes)
+ */
+void cpu_bcd_to_string( Environment * _environment, char * _bcd, char * _string, char * _string_size, int _bytes ) {
+
+    outline1("LDA %s", _string );
+    outline0("STA TMPPTR");
+    outline1("LDA %s", address_displacement(_environment, _string, "1") );
+    outline0("STA TMPPTR+1");
+    outline0("LDY #0");
+    for( int i=0; i<_bytes; ++i ) {
+        char offset[MAX_TEMPORARY_STORAGE]; sprintf( offset, "%d", i );
+        outline1("LDA %s", address_displacement(_environment, _bcd, offset));
+        outline0("LSR");
+        outline0("LSR");
+        outline0("LSR");
+        outline0("LSR");
+        outline0("ORA #$30");
+        outline0("STA (TMPPTR),Y");
+        outline0("INY");
+        outline1("LDA %s", address_displacement(_environment, _bcd, offset));
+        outline0("AND #$0F");
+        outline0("ORA #$30");
+        outline0("STA (TMPPTR),Y");
+        outline0("INY");
+    }
+    outline0("TYA");
+    outline1("STA %s", _string_size);
+
+}
+
 void cpu_bits_to_string( Environment * _environment, char * _number, char * _string, char * _string_size, int _bits ) {
 
     MAKE_LABEL
@@ -9424,4 +9516,246 @@ void cpu_move_32bit_unsigned_16bit_unsigned( Environment * _environment, char *_
    
 }
 
+static EmbeddedCost cpuEmbeddedCost[] = {
+    { "cpu_convert_string_into_16bit", 112, 180, 25, 48 },
+    { "cpu_fill_blocks", 32, 52, 18, 36 },
+    { "cpu_lowercase", 60, 96, 35, 64 },
+    { "cpu_math_div2_const_8bit", 40, 64, 28, 52 },
+    { "cpu_math_div_16bit_to_16bit", 280, 448, 85, 144 },
+    { "cpu_math_div_32bit_to_16bit", 135, 216, 68, 116 },
+    { "cpu_math_div_8bit_to_8bit", 150, 240, 45, 80 },
+    { "cpu_math_mul2_const_8bit", 25, 40, 20, 40 },
+    { "cpu_math_mul_16bit_to_32bit", 365, 584, 85, 144 },
+    { "cpu_math_mul_8bit_to_16bit", 150, 240, 45, 80 },
+    { "cpu_mem_move", 132, 212, 32, 60 },
+    { "cpu_uppercase", 60, 96, 35, 64 },
+    { NULL, 0, 0, 0, 0 }
+};
+
+/**
+ * @brief <i>CPU 6502</i>: return the cost model of a primitive
+ * 
+ * Values are estimated from the code generated by each version: bytes and
+ * cycles of the inline expansion, and bytes and extra cycles paid by a call
+ * site (parameters passing, call and return). Only the primitives that
+ * have both versions are listed.
+ * 
+ * @param _environment Current calling environment
+ * @param _name Name of the primitive
+ * @return Cost of the primitive, or NULL if it can only be inlined (or called)
+ */
+EmbeddedCost * cpu_embedded_cost( Environment * _environment, char * _name ) {
+
+    int i = 0;
+    while( cpuEmbeddedCost[i].name ) {
+        if ( strcmp( cpuEmbeddedCost[i].name, _name ) == 0 ) {
+            return &cpuEmbeddedCost[i];
+        }
+        ++i;
+    }
+    return NULL;
+
+}
+
+/* addressing modes: implied (or accumulator), immediate, zero page, absolute,
+   indexed (,X / ,Y), (indirect),Y and (indirect,X) or (indirect); page
+   crossings are not counted, and branches are counted as not taken */
+static InstructionCycles cpuInstructionCycles[] = {
+    { "ADC", { -1, 2, 3, 4, 4, 5, 6 }, 0 },
+    { "AND", { -1, 2, 3, 4, 4, 5, 6 }, 0 },
+    { "CMP", { -1, 2, 3, 4, 4, 5, 6 }, 0 },
+    { "EOR", { -1, 2, 3, 4, 4, 5, 6 }, 0 },
+    { "LDA", { -1, 2, 3, 4, 4, 5, 6 }, 0 },
+    { "ORA", { -1, 2, 3, 4, 4, 5, 6 }, 0 },
+    { "SBC", { -1, 2, 3, 4, 4, 5, 6 }, 0 },
+    { "LDX", { -1, 2, 3, 4, 4, -1, -1 }, 0 },
+    { "LDY", { -1, 2, 3, 4, 4, -1, -1 }, 0 },
+    { "CPX", { -1, 2, 3, 4, -1, -1, -1 }, 0 },
+    { "CPY", { -1, 2, 3, 4, -1, -1, -1 }, 0 },
+    { "BIT", { -1, 2, 3, 4, 4, -1, -1 }, 0 },
+    { "STA", { -1, -1, 3, 4, 5, 6, 6 }, 0 },
+    { "STX", { -1, -1, 3, 4, 4, -1, -1 }, 0 },
+    { "STY", { -1, -1, 3, 4, 4, -1, -1 }, 0 },
+    { "STZ", { -1, -1, 3, 4, 5, -1, -1 }, 0 },
+    { "ASL", { 2, -1, 5, 6, 7, -1, -1 }, 0 },
+    { "LSR", { 2, -1, 5, 6, 7, -1, -1 }, 0 },
+    { "ROL", { 2, -1, 5, 6, 7, -1, -1 }, 0 },
+    { "ROR", { 2, -1, 5, 6, 7, -1, -1 }, 0 },
+    { "INC", { 2, -1, 5, 6, 7, -1, -1 }, 0 },
+    { "DEC", { 2, -1, 5, 6, 7, -1, -1 }, 0 },
+    { "TRB", { -1, -1, 5, 6, -1, -1, -1 }, 0 },
+    { "TSB", { -1, -1, 5, 6, -1, -1, -1 }, 0 },
+    { "JMP", { -1, -1, -1, 3, -1, -1, 5 }, 1 },
+    { "JSR", { -1, -1, -1, 6, -1, -1, -1 }, 0 },
+    { "BCC", { 2, 2, 2, 2, 2, 2, 2 }, 1 },
+    { "BCS", { 2, 2, 2, 2, 2, 2, 2 }, 1 },
+    { "BEQ", { 2, 2, 2, 2, 2, 2, 2 }, 1 },
+    { "BMI", { 2, 2, 2, 2, 2, 2, 2 }, 1 },
+    { "BNE", { 2, 2, 2, 2, 2, 2, 2 }, 1 },
+    { "BPL", { 2, 2, 2, 2, 2, 2, 2 }, 1 },
+    { "BVC", { 2, 2, 2, 2, 2, 2, 2 }, 1 },
+    { "BVS", { 2, 2, 2, 2, 2, 2, 2 }, 1 },
+    { "BRA", { 3, 3, 3, 3, 3, 3, 3 }, 1 },
+    { "CLC", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "CLD", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "CLI", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "CLV", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "SEC", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "SED", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "SEI", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "DEX", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "DEY", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "INX", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "INY", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "INA", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "DEA", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "NOP", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "TAX", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "TAY", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "TSX", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "TXA", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "TXS", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "TYA", { 2, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "PHA", { 3, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "PHP", { 3, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "PHX", { 3, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "PHY", { 3, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "PLA", { 4, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "PLP", { 4, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "PLX", { 4, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "PLY", { 4, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "RTS", { 6, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "RTI", { 6, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "BRK", { 7, -1, -1, -1, -1, -1, -1 }, 0 },
+    { NULL, { 0 }, 0 }
+};
+
+/**
+ * @brief <i>CPU 6502</i>: return the static cycles of an instruction
+ * 
+ * The table covers the NMOS 6502 and the 65C02 extensions (BRA, STZ, TRB, 
+ * TSB, PHX/PHY, PLX/PLY, INA/DEA). Operands that are not numeric are 
+ * considered absolute addresses, since the zero page is assigned by the 
+ * assembler.
+ * 
+ * @param _environment Current calling environment
+ * @param _mnemonic Mnemonic of the instruction
+ * @param _operands Operands of the instruction
+ * @param _branch Set to true if the instruction is a jump or a branch
+ * @return Cycles of the instruction (0 if it is not an instruction)
+ */
+int cpu_instruction_cycles( Environment * _environment, char * _mnemonic, char * _operands, int * _branch ) {
+
+    int mode;
+
+    if ( !*_operands || *_operands == ';' || ( toupper( _operands[0] ) == 'A' && ( !_operands[1] || _operands[1] == ' ' ) ) ) {
+        mode = 0;
+    } else if ( *_operands == '#' ) {
+        mode = 1;
+    } else if ( *_operands == '(' ) {
+        mode = strstr( _operands, "),Y" ) || strstr( _operands, "), Y" ) ? 5 : 6;
+    } else if ( strstr( _operands, ",X" ) || strstr( _operands, ",Y" ) || strstr( _operands, ", X" ) || strstr( _operands, ", Y" ) ) {
+        mode = 4;
+    } else if ( _operands[0] == '$' && isxdigit( _operands[1] ) && isxdigit( _operands[2] ) && !isxdigit( _operands[3] ) ) {
+        mode = 2;
+    } else {
+        mode = 3;
+    }
+
+    return instruction_cycles( cpuInstructionCycles, _mnemonic, mode, _branch );
+
+}
+
+/* instructions that read (and do not change) their operand */
+static char * cpuInlineReads[] = { 
+    "LDA", "LDX", "LDY", "ADC", "SBC", "AND", "ORA", "EOR", "CMP", "CPX", "CPY", "BIT", NULL 
+};
+
+/**
+ * @brief <i>6502</i>: check if an instruction only reads a variable
+ * 
+ * This function is used when a procedure is expanded inline, to decide
+ * if a parameter can be replaced by the argument (or by a constant).
+ * 
+ * @param _environment Current calling environment
+ * @param _line Line of assembly that uses the variable
+ * @param _name Name of the variable (in the assembly source)
+ * @return Offset of the byte read (if it is a plain read), -1 otherwise
+ */
+int cpu_inline_read( Environment * _environment, char * _line, char * _name ) {
+
+    char mnemonic[MAX_TEMPORARY_STORAGE];
+    char operand[MAX_TEMPORARY_STORAGE];
+    int i;
+
+    if ( sscanf( _line, " %s %s", mnemonic, operand ) != 2 ) {
+        return -1;
+    }
+
+    for( i=0; cpuInlineReads[i]; ++i ) {
+        if ( !strcasecmp( mnemonic, cpuInlineReads[i] ) ) {
+            break;
+        }
+    }
+
+    if ( !cpuInlineReads[i] ) {
+        return -1;
+    }
+
+    int length = strlen( _name );
+
+    if ( strncmp( operand, _name, length ) ) {
+        return -1;
+    }
+
+    if ( !operand[length] ) {
+        return 0;
+    }
+
+    if ( operand[length] == '+' ) {
+        char * end;
+        int offset = strtol( operand + length + 1, &end, 10 );
+        if ( !*end ) {
+            return offset;
+        }
+    }
+
+    return -1;
+
+}
+
+/**
+ * @brief <i>6502</i>: rewrite a read of a variable as an immediate value
+ * 
+ * @param _environment Current calling environment
+ * @param _line Line of assembly that reads the variable
+ * @param _name Name of the variable (in the assembly source)
+ * @param _size Size of the variable (in bytes)
+ * @param _value Value of the variable
+ * @param _result Rewritten line
+ * @return 1 if the line has been rewritten, 0 otherwise
+ */
+int cpu_inline_constant( Environment * _environment, char * _line, char * _name, int _size, int _value, char * _result ) {
+
+    char mnemonic[MAX_TEMPORARY_STORAGE];
+
+    int offset = cpu_inline_read( _environment, _line, _name );
+
+    if ( offset < 0 || offset >= _size ) {
+        return 0;
+    }
+
+    sscanf( _line, " %s", mnemonic );
+
+    // BIT has not an immediate mode (on the NMOS 6502)
+    if ( !strcasecmp( mnemonic, "BIT" ) ) {
+        return 0;
+    }
+
+    sprintf( _result, "\t%s #$%2.2x", mnemonic, ( _value >> ( 8 * offset ) ) & 0xff );
+
+    return 1;
+
+}
+
 #endif
\ No newline at end of file
@@ -35,6 +35,25 @@
 
 ; this code is migrated inside VIC-II
 
+@IF C64REU
+
+CPUMEMMOVE16:
+    LDA TMPPTR
+    STA REUMEMSRC
+    LDA TMPPTR+1
+    STA REUMEMSRC+1
+    LDA TMPPTR2
+    STA REUMEMDST
+    LDA TMPPTR2+1
+    STA REUMEMDST+1
+    LDA MATHPTR0
+    STA REUMEMLEN
+    LDA MATHPTR1
+    STA REUMEMLEN+1
+    JMP REUMEMMOVE
+
+@ELSE
+
 CPUMEMMOVE16:
     LDY #$0
 CPUMEMMOVE16Y:
@@ -56,3 +75,5 @@ CPUMEMMOVE16YL3:
     ORA MATHPTR1
     BNE CPUMEMMOVE16Y
     RTS
+
+@ENDIF
@@ -103,8 +103,10 @@ CPURANDOM16NOEOR:
 
 CPURANDOM8:
 	LDA	CPURANDOM_SEED
+	BEQ	CPURANDOM8BITEOR
 	ASL
 	BCC	CPURANDOM8BITNOEOR
+CPURANDOM8BITEOR:
 	EOR	#$CF
 CPURANDOM8BITNOEOR:
 	STA	CPURANDOM_SEED
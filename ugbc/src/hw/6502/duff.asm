@@ -37,55 +37,22 @@
 
 @IF C64REU
 
+; On REU, the move is delegated to the DMA controller (see
+; REUMEMMOVE), that falls back to the CPU for short moves.
 DUFFDEVICE:
-    LDA MATHPTR0
-    ORA MATHPTR1
-    BNE DUFFDEVICE1
-    RTS
-
-DUFFDEVICE1:
-    SEI
-
-    LDA #$3F
-    STA REUCONTROL
-    
     LDA TMPPTR
-    STA REUC64BASE
+    STA REUMEMSRC
     LDA TMPPTR+1
-    STA REUC64BASE+1
-    LDA #0
-    STA REUREUBASE
-    STA REUREUBASE+1
-    LDA MAXFREEBANK
-    STA REUREUBASE+2
-
-    LDA MATHPTR0
-    STA REUTRANSLEN
-    LDA MATHPTR1
-    STA REUTRANSLEN+1
-
-    LDA #%10010000
-    STA REUCOMMAND
-
+    STA REUMEMSRC+1
     LDA TMPPTR2
-    STA REUC64BASE
+    STA REUMEMDST
     LDA TMPPTR2+1
-    STA REUC64BASE+1
-    LDA #0
-    STA REUREUBASE
-    STA REUREUBASE+1
-    LDA MAXFREEBANK
-    STA REUREUBASE+2
-
+    STA REUMEMDST+1
     LDA MATHPTR0
-    STA REUTRANSLEN
+    STA REUMEMLEN
     LDA MATHPTR1
-    STA REUTRANSLEN+1
-
-    LDA #%10010001
-    STA REUCOMMAND
-    CLI
-    RTS
+    STA REUMEMLEN+1
+    JMP REUMEMMOVE
 
 @ELSE
 
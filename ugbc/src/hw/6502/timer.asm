@@ -52,22 +52,32 @@ TIMERMANAGERGO:
 
     ; Save the pointer registers -- some routines inside the called
     ; timers could change them and invalidate main program execution.
+    ; Each group is marked, so that the optimizer can drop the ones
+    ; that no timer handler is able to write.
+    ; TIMERSAVE TMPPTR
     LDA TMPPTR
     PHA
     LDA TMPPTR+1
     PHA
+    ; TIMERSAVEEND
+    ; TIMERSAVE TMPPTR2
     LDA TMPPTR2
     PHA
     LDA TMPPTR2+1
     PHA
+    ; TIMERSAVEEND
+    ; TIMERSAVE PLOTDEST
     LDA PLOTDEST
     PHA
     LDA PLOTDEST+1
     PHA
+    ; TIMERSAVEEND
+    ; TIMERSAVE PLOTCDEST
     LDA PLOTCDEST
     PHA
     LDA PLOTCDEST+1
     PHA
+    ; TIMERSAVEEND
 
     ; Save actual registers (X,Y)
     TXA
@@ -228,22 +238,30 @@ TIMERMANAGERL2:
     TAX
 
     ; Restore the pointer registers.
+    ; TIMERSAVE PLOTCDEST
     PLA 
     STA PLOTCDEST+1
     PLA 
     STA PLOTCDEST
+    ; TIMERSAVEEND
+    ; TIMERSAVE PLOTDEST
     PLA 
     STA PLOTDEST+1
     PLA 
     STA PLOTDEST
+    ; TIMERSAVEEND
+    ; TIMERSAVE TMPPTR2
     PLA 
     STA TMPPTR2+1
     PLA 
     STA TMPPTR2
+    ; TIMERSAVEEND
+    ; TIMERSAVE TMPPTR
     PLA 
     STA TMPPTR+1
     PLA 
     STA TMPPTR
+    ; TIMERSAVEEND
 
     ; Restore register (A)
     PLA
@@ -35,6 +35,7 @@
 #include "cpu.h"
 #include <time.h>
 #include <math.h>
+#include <ctype.h>
 
 /****************************************************************************
  * CODE SECTION
@@ -6065,6 +6066,87 @@ void cpu_number_to_string( Environment * _environment, char * _number, char * _s
 
 }
 
+/**
+ * @brief <i>CPU 6809</i>: emit code to add two packed BCD values
+ * 
+ * @param _environment Current calling environment
+ * @param _source First value to add
+ * @param _destination Second value to add and destination address for result (if _other is NULL)
+ * @param _other Destination address for result
+ * @param _bytes Size of the values (in bytes)
+ */
+void cpu_bcd_add( Environment * _environment, char *_source, char *_destination, char *_other, int _bytes ) {
+
+    outline0("ANDCC #$FE");
+    for( int i=_bytes-1; i>=0; --i ) {
+        char offset[MAX_TEMPORARY_STORAGE]; sprintf( offset, "%d", i );
+        outline1("LDA %s", address_displacement(_environment, _source, offset));
+        outline1("ADCA %s", address_displacement(_environment, _destination, offset));
+        outline0("DAA");
+        outline1("STA %s", address_displacement(_environment, _other ? _other : _destination, offset));
+    }
+
+}
+
+/**
+ * @brief <i>CPU 6809</i>: emit code to subtract two packed BCD values
+ * 
+ * DAA works only after an addition, so the value to subtract is
+ * complemented to 99 and added with an initial carry.
+ * 
+ * @param _environment Current calling environment
+ * @param _source First value
+ * @param _destination Value to subtract and destination address for result (if _other is NULL)
+ * @param _other Destination address for result
+ * @param _bytes Size of the values (in bytes)
+ */
+void cpu_bcd_sub( Environment * _environment, char *_source, char *_destination, char *_other, int _bytes ) {
+
+    outline0("ORCC #$01");
+    for( int i=_bytes-1; i>=0; --i ) {
+        char offset[MAX_TEMPORARY_STORAGE]; sprintf( offset, "%d", i );
+        outline0("PSHS CC");
+        outline0("LDA #$99");
+        outline1("SUBA %s", address_displacement(_environment, _destination, offset));
+        outline0("PULS CC");
+        outline1("ADCA %s", address_displacement(_environment, _source, offset));
+        outline0("DAA");
+        outline1("STA %s", address_displacement(_environment, _other ? _other : _destination, offset));
+    }
+
+}
+
+/**
+ * @brief <i>CPU 6809</i>: emit code to convert a packed BCD value into digits
+ * 
+ * @param _environment Current calling environment
+ * @param _bcd Value to convert
+ * @param _string Address of the string to fill (at least 2 * _bytes chars)
+ * @param _string_size Where to store the number of digits
+ * @param _bytes Size of the value (in bytes)
+ */
+void cpu_bcd_to_string( Environment * _environment, char * _bcd, char * _string, char * _string_size, int _bytes ) {
+
+    outline1("LDX %s", _string );
+    for( int i=0; i<_bytes; ++i ) {
+        char offset[MAX_TEMPORARY_STORAGE]; sprintf( offset, "%d", i );
+        outline1("LDA %s", address_displacement(_environment, _bcd, offset));
+        outline0("LSRA");
+        outline0("LSRA");
+        outline0("LSRA");
+        outline0("LSRA");
+        outline0("ORA #$30");
+        outline0("STA ,X+");
+        outline1("LDA %s", address_displacement(_environment, _bcd, offset));
+        outline0("ANDA #$0F");
+        outline0("ORA #$30");
+        outline0("STA ,X+");
+    }
+    outline1("LDA #$%2.2x", _bytes * 2 );
+    outline1("STA %s", _string_size );
+
+}
+
 void cpu_bits_to_string( Environment * _environment, char * _number, char * _string, char * _string_size, int _bits ) {
 
     deploy( bitsToString, src_hw_6809_bits_to_string_asm );
@@ -7779,4 +7861,382 @@ void cpu_move_32bit_unsigned_16bit_unsigned( Environment * _environment, char *_
 
 }
 
+static EmbeddedCost cpuEmbeddedCost[] = {
+    { "cpu_fill_blocks", 45, 75, 18, 37 },
+    { "cpu_math_div2_const_16bit", 132, 220, 24, 47 },
+    { "cpu_math_div2_const_8bit", 75, 125, 24, 47 },
+    { "cpu_math_div_16bit_to_16bit", 291, 485, 18, 37 },
+    { "cpu_math_div_8bit_to_8bit", 132, 220, 18, 37 },
+    { "cpu_math_mul_16bit_to_32bit", 267, 445, 18, 37 },
+    { "cpu_math_mul_8bit_to_16bit", 105, 175, 15, 32 },
+    { "cpu_mem_move", 78, 130, 18, 37 },
+    { "cpu_random", 48, 80, 9, 22 },
+    { NULL, 0, 0, 0, 0 }
+};
+
+/**
+ * @brief <i>CPU 6809</i>: return the cost model of a primitive
+ * 
+ * Values are estimated from the code generated by each version: bytes and
+ * cycles of the inline expansion, and bytes and extra cycles paid by a call
+ * site (parameters passing, call and return). Only the primitives that
+ * have both versions are listed.
+ * 
+ * @param _environment Current calling environment
+ * @param _name Name of the primitive
+ * @return Cost of the primitive, or NULL if it can only be inlined (or called)
+ */
+EmbeddedCost * cpu_embedded_cost( Environment * _environment, char * _name ) {
+
+    int i = 0;
+    while( cpuEmbeddedCost[i].name ) {
+        if ( strcmp( cpuEmbeddedCost[i].name, _name ) == 0 ) {
+            return &cpuEmbeddedCost[i];
+        }
+        ++i;
+    }
+    return NULL;
+
+}
+
+/* addressing modes: inherent, immediate, direct, extended, indexed
+   (the cost of the indexed post-byte is added separately).
+   Branches are counted as not taken. */
+static InstructionCycles cpuInstructionCycles[] = {
+    { "LDA", { -1, 2, 4, 5, 4 }, 0 },
+    { "LDB", { -1, 2, 4, 5, 4 }, 0 },
+    { "STA", { -1, -1, 4, 5, 4 }, 0 },
+    { "STB", { -1, -1, 4, 5, 4 }, 0 },
+    { "LDD", { -1, 3, 5, 6, 5 }, 0 },
+    { "LDX", { -1, 3, 5, 6, 5 }, 0 },
+    { "LDU", { -1, 3, 5, 6, 5 }, 0 },
+    { "LDY", { -1, 4, 6, 7, 6 }, 0 },
+    { "LDS", { -1, 4, 6, 7, 6 }, 0 },
+    { "STD", { -1, -1, 5, 6, 5 }, 0 },
+    { "STX", { -1, -1, 5, 6, 5 }, 0 },
+    { "STU", { -1, -1, 5, 6, 5 }, 0 },
+    { "STY", { -1, -1, 6, 7, 6 }, 0 },
+    { "STS", { -1, -1, 6, 7, 6 }, 0 },
+    { "ADDA", { -1, 2, 4, 5, 4 }, 0 },
+    { "ADDB", { -1, 2, 4, 5, 4 }, 0 },
+    { "SUBA", { -1, 2, 4, 5, 4 }, 0 },
+    { "SUBB", { -1, 2, 4, 5, 4 }, 0 },
+    { "ADCA", { -1, 2, 4, 5, 4 }, 0 },
+    { "ADCB", { -1, 2, 4, 5, 4 }, 0 },
+    { "SBCA", { -1, 2, 4, 5, 4 }, 0 },
+    { "SBCB", { -1, 2, 4, 5, 4 }, 0 },
+    { "ANDA", { -1, 2, 4, 5, 4 }, 0 },
+    { "ANDB", { -1, 2, 4, 5, 4 }, 0 },
+    { "ORA", { -1, 2, 4, 5, 4 }, 0 },
+    { "ORB", { -1, 2, 4, 5, 4 }, 0 },
+    { "EORA", { -1, 2, 4, 5, 4 }, 0 },
+    { "EORB", { -1, 2, 4, 5, 4 }, 0 },
+    { "CMPA", { -1, 2, 4, 5, 4 }, 0 },
+    { "CMPB", { -1, 2, 4, 5, 4 }, 0 },
+    { "BITA", { -1, 2, 4, 5, 4 }, 0 },
+    { "BITB", { -1, 2, 4, 5, 4 }, 0 },
+    { "ADDD", { -1, 4, 6, 7, 6 }, 0 },
+    { "SUBD", { -1, 4, 6, 7, 6 }, 0 },
+    { "CMPX", { -1, 4, 6, 7, 6 }, 0 },
+    { "CMPD", { -1, 5, 7, 8, 7 }, 0 },
+    { "CMPY", { -1, 5, 7, 8, 7 }, 0 },
+    { "CMPU", { -1, 5, 7, 8, 7 }, 0 },
+    { "CMPS", { -1, 5, 7, 8, 7 }, 0 },
+    { "NEG", { -1, -1, 6, 7, 6 }, 0 },
+    { "COM", { -1, -1, 6, 7, 6 }, 0 },
+    { "LSR", { -1, -1, 6, 7, 6 }, 0 },
+    { "ROR", { -1, -1, 6, 7, 6 }, 0 },
+    { "ASR", { -1, -1, 6, 7, 6 }, 0 },
+    { "ASL", { -1, -1, 6, 7, 6 }, 0 },
+    { "LSL", { -1, -1, 6, 7, 6 }, 0 },
+    { "ROL", { -1, -1, 6, 7, 6 }, 0 },
+    { "DEC", { -1, -1, 6, 7, 6 }, 0 },
+    { "INC", { -1, -1, 6, 7, 6 }, 0 },
+    { "TST", { -1, -1, 6, 7, 6 }, 0 },
+    { "CLR", { -1, -1, 6, 7, 6 }, 0 },
+    { "NEGA", { 2, 2, 2, 2, 2 }, 0 },
+    { "NEGB", { 2, 2, 2, 2, 2 }, 0 },
+    { "COMA", { 2, 2, 2, 2, 2 }, 0 },
+    { "COMB", { 2, 2, 2, 2, 2 }, 0 },
+    { "LSRA", { 2, 2, 2, 2, 2 }, 0 },
+    { "LSRB", { 2, 2, 2, 2, 2 }, 0 },
+    { "RORA", { 2, 2, 2, 2, 2 }, 0 },
+    { "RORB", { 2, 2, 2, 2, 2 }, 0 },
+    { "ASRA", { 2, 2, 2, 2, 2 }, 0 },
+    { "ASRB", { 2, 2, 2, 2, 2 }, 0 },
+    { "ASLA", { 2, 2, 2, 2, 2 }, 0 },
+    { "ASLB", { 2, 2, 2, 2, 2 }, 0 },
+    { "LSLA", { 2, 2, 2, 2, 2 }, 0 },
+    { "LSLB", { 2, 2, 2, 2, 2 }, 0 },
+    { "ROLA", { 2, 2, 2, 2, 2 }, 0 },
+    { "ROLB", { 2, 2, 2, 2, 2 }, 0 },
+    { "DECA", { 2, 2, 2, 2, 2 }, 0 },
+    { "DECB", { 2, 2, 2, 2, 2 }, 0 },
+    { "INCA", { 2, 2, 2, 2, 2 }, 0 },
+    { "INCB", { 2, 2, 2, 2, 2 }, 0 },
+    { "TSTA", { 2, 2, 2, 2, 2 }, 0 },
+    { "TSTB", { 2, 2, 2, 2, 2 }, 0 },
+    { "CLRA", { 2, 2, 2, 2, 2 }, 0 },
+    { "CLRB", { 2, 2, 2, 2, 2 }, 0 },
+    { "JMP", { -1, -1, 3, 4, 3 }, 1 },
+    { "JSR", { -1, -1, 7, 8, 7 }, 0 },
+    { "LEAX", { -1, -1, -1, -1, 4 }, 0 },
+    { "LEAY", { -1, -1, -1, -1, 4 }, 0 },
+    { "LEAS", { -1, -1, -1, -1, 4 }, 0 },
+    { "LEAU", { -1, -1, -1, -1, 4 }, 0 },
+    { "ANDCC", { 3, 3, 3, 3, 3 }, 0 },
+    { "ORCC", { 3, 3, 3, 3, 3 }, 0 },
+    { "ABX", { 3, 3, 3, 3, 3 }, 0 },
+    { "MUL", { 11, 11, 11, 11, 11 }, 0 },
+    { "SEX", { 2, 2, 2, 2, 2 }, 0 },
+    { "DAA", { 2, 2, 2, 2, 2 }, 0 },
+    { "NOP", { 2, 2, 2, 2, 2 }, 0 },
+    { "RTS", { 5, 5, 5, 5, 5 }, 0 },
+    { "RTI", { 6, 6, 6, 6, 6 }, 0 },
+    { "SWI", { 19, 19, 19, 19, 19 }, 0 },
+    { "SYNC", { 4, 4, 4, 4, 4 }, 0 },
+    { "CWAI", { 20, 20, 20, 20, 20 }, 0 },
+    { "EXG", { 8, 8, 8, 8, 8 }, 0 },
+    { "TFR", { 6, 6, 6, 6, 6 }, 0 },
+    { "BRA", { 3, 3, 3, 3, 3 }, 1 },
+    { "BRN", { 3, 3, 3, 3, 3 }, 1 },
+    { "BHI", { 3, 3, 3, 3, 3 }, 1 },
+    { "BLS", { 3, 3, 3, 3, 3 }, 1 },
+    { "BCC", { 3, 3, 3, 3, 3 }, 1 },
+    { "BHS", { 3, 3, 3, 3, 3 }, 1 },
+    { "BCS", { 3, 3, 3, 3, 3 }, 1 },
+    { "BLO", { 3, 3, 3, 3, 3 }, 1 },
+    { "BNE", { 3, 3, 3, 3, 3 }, 1 },
+    { "BEQ", { 3, 3, 3, 3, 3 }, 1 },
+    { "BVC", { 3, 3, 3, 3, 3 }, 1 },
+    { "BVS", { 3, 3, 3, 3, 3 }, 1 },
+    { "BPL", { 3, 3, 3, 3, 3 }, 1 },
+    { "BMI", { 3, 3, 3, 3, 3 }, 1 },
+    { "BGE", { 3, 3, 3, 3, 3 }, 1 },
+    { "BLT", { 3, 3, 3, 3, 3 }, 1 },
+    { "BGT", { 3, 3, 3, 3, 3 }, 1 },
+    { "BLE", { 3, 3, 3, 3, 3 }, 1 },
+    { "LBRA", { 5, 5, 5, 5, 5 }, 1 },
+    { "LBRN", { 5, 5, 5, 5, 5 }, 1 },
+    { "LBHI", { 5, 5, 5, 5, 5 }, 1 },
+    { "LBLS", { 5, 5, 5, 5, 5 }, 1 },
+    { "LBCC", { 5, 5, 5, 5, 5 }, 1 },
+    { "LBHS", { 5, 5, 5, 5, 5 }, 1 },
+    { "LBCS", { 5, 5, 5, 5, 5 }, 1 },
+    { "LBLO", { 5, 5, 5, 5, 5 }, 1 },
+    { "LBNE", { 5, 5, 5, 5, 5 }, 1 },
+    { "LBEQ", { 5, 5, 5, 5, 5 }, 1 },
+    { "LBVC", { 5, 5, 5, 5, 5 }, 1 },
+    { "LBVS", { 5, 5, 5, 5, 5 }, 1 },
+    { "LBPL", { 5, 5, 5, 5, 5 }, 1 },
+    { "LBMI", { 5, 5, 5, 5, 5 }, 1 },
+    { "LBGE", { 5, 5, 5, 5, 5 }, 1 },
+    { "LBLT", { 5, 5, 5, 5, 5 }, 1 },
+    { "LBGT", { 5, 5, 5, 5, 5 }, 1 },
+    { "LBLE", { 5, 5, 5, 5, 5 }, 1 },
+    { "BSR", { 7, 7, 7, 7, 7 }, 0 },
+    { "LBSR", { 9, 9, 9, 9, 9 }, 0 },
+    { NULL, { 0 }, 0 }
+};
+
+/**
+ * @brief <i>6809</i>: return the static cycles of an instruction
+ * 
+ * @param _environment Current calling environment
+ * @param _mnemonic Mnemonic of the instruction
+ * @param _operands Operands of the instruction
+ * @param _branch Set to true if the instruction is a jump or a branch
+ * @return Cycles of the instruction (0 if it is not an instruction)
+ */
+int cpu_instruction_cycles( Environment * _environment, char * _mnemonic, char * _operands, int * _branch ) {
+
+    char operands[MAX_TEMPORARY_STORAGE];
+    int i = 0;
+
+    while( *_operands == ' ' || *_operands == '\t' ) {
+        ++_operands;
+    }
+    for( char * p = _operands; *p && *p != ';' && i < MAX_TEMPORARY_STORAGE - 1; ++p ) {
+        if ( *p != ' ' && *p != '\t' ) {
+            operands[i++] = *p;
+        }
+    }
+    operands[i] = 0;
+
+    if ( !strcasecmp( _mnemonic, "PSHS" ) || !strcasecmp( _mnemonic, "PULS" ) || 
+         !strcasecmp( _mnemonic, "PSHU" ) || !strcasecmp( _mnemonic, "PULU" ) ) {
+        // one cycle for each byte pushed or pulled
+        int cycles = 5;
+        char * reg = strtok( operands, "," );
+        while( reg ) {
+            if ( !strcasecmp( reg, "A" ) || !strcasecmp( reg, "B" ) || !strcasecmp( reg, "CC" ) || !strcasecmp( reg, "DP" ) ) {
+                cycles += 1;
+            } else {
+                cycles += 2;
+            }
+            reg = strtok( NULL, "," );
+        }
+        *_branch = 0;
+        return cycles;
+    }
+
+    int mode = 3;
+    if ( !operands[0] ) {
+        mode = 0;
+    } else if ( operands[0] == '#' ) {
+        mode = 1;
+    } else if ( operands[0] == '[' || strchr( operands, ',' ) ) {
+        mode = 4;
+    } else if ( operands[0] == '<' ) {
+        mode = 2;
+    }
+
+    int cycles = instruction_cycles( cpuInstructionCycles, _mnemonic, mode, _branch );
+
+    if ( cycles && mode == 4 && !*_branch ) {
+        char * comma = strchr( operands, ',' );
+        char * index = comma ? comma + 1 : operands;
+        if ( operands[0] == '[' ) {
+            cycles += 3;
+            ++index;
+        }
+        if ( !strncmp( index, "--", 2 ) || strstr( index, "++" ) ) {
+            cycles += 3;
+        } else if ( *index == '-' || strchr( index, '+' ) ) {
+            cycles += 2;
+        } else if ( comma == operands || ( comma == operands + 1 && operands[0] == '[' ) ) {
+            // no offset
+        } else if ( toupper( operands[0] ) == 'D' && comma == operands + 1 ) {
+            cycles += 4;
+        } else if ( ( toupper( operands[0] ) == 'A' || toupper( operands[0] ) == 'B' ) && comma == operands + 1 ) {
+            cycles += 1;
+        } else if ( ( isdigit( operands[0] ) || operands[0] == '-' || operands[0] == '$' ) && comma && comma - operands <= 3 ) {
+            cycles += 1;
+        } else {
+            // 16 bit offset
+            cycles += 4;
+        }
+    }
+
+    return cycles;
+
+}
+
+/* instructions that read (and do not change) their operand: the size of
+   the operand is given by the register (the last letter) */
+static char * cpuInlineReads[] = { 
+    "LDA", "LDB", "LDD", "LDX", "LDY", "LDU", "LDS", 
+    "ADDA", "ADDB", "ADDD", "SUBA", "SUBB", "SUBD", "ADCA", "ADCB", "SBCA", "SBCB", 
+    "ANDA", "ANDB", "ORA", "ORB", "EORA", "EORB", "BITA", "BITB",
+    "CMPA", "CMPB", "CMPD", "CMPX", "CMPY", "CMPU", "CMPS", 
+    NULL 
+};
+
+static int cpu_inline_width( char * _mnemonic ) {
+
+    switch( toupper( _mnemonic[strlen(_mnemonic)-1] ) ) {
+        case 'A': case 'B': case 'E': case 'F':
+            return 1;
+        case 'Q':
+            return 4;
+        default:
+            return 2;
+    }
+
+}
+
+/**
+ * @brief <i>6809</i>: check if an instruction only reads a variable
+ * 
+ * This function is used when a procedure is expanded inline, to decide
+ * if a parameter can be replaced by the argument (or by a constant).
+ * 
+ * @param _environment Current calling environment
+ * @param _line Line of assembly that uses the variable
+ * @param _name Name of the variable (in the assembly source)
+ * @return Offset of the byte read (if it is a plain read), -1 otherwise
+ */
+int cpu_inline_read( Environment * _environment, char * _line, char * _name ) {
+
+    char mnemonic[MAX_TEMPORARY_STORAGE];
+    char operand[MAX_TEMPORARY_STORAGE];
+    int i;
+
+    if ( sscanf( _line, " %s %s", mnemonic, operand ) != 2 ) {
+        return -1;
+    }
+
+    for( i=0; cpuInlineReads[i]; ++i ) {
+        if ( !strcasecmp( mnemonic, cpuInlineReads[i] ) ) {
+            break;
+        }
+    }
+
+    if ( !cpuInlineReads[i] ) {
+        return -1;
+    }
+
+    int length = strlen( _name );
+
+    if ( strncmp( operand, _name, length ) ) {
+        return -1;
+    }
+
+    if ( !operand[length] ) {
+        return 0;
+    }
+
+    if ( operand[length] == '+' ) {
+        char * end;
+        int offset = strtol( operand + length + 1, &end, 10 );
+        if ( !*end ) {
+            return offset;
+        }
+    }
+
+    return -1;
+
+}
+
+/**
+ * @brief <i>6809</i>: rewrite a read of a variable as an immediate value
+ * 
+ * @param _environment Current calling environment
+ * @param _line Line of assembly that reads the variable
+ * @param _name Name of the variable (in the assembly source)
+ * @param _size Size of the variable (in bytes)
+ * @param _value Value of the variable
+ * @param _result Rewritten line
+ * @return 1 if the line has been rewritten, 0 otherwise
+ */
+int cpu_inline_constant( Environment * _environment, char * _line, char * _name, int _size, int _value, char * _result ) {
+
+    char mnemonic[MAX_TEMPORARY_STORAGE];
+
+    int offset = cpu_inline_read( _environment, _line, _name );
+
+    if ( offset < 0 ) {
+        return 0;
+    }
+
+    sscanf( _line, " %s", mnemonic );
+
+    int width = cpu_inline_width( mnemonic );
+
+    if ( offset + width > _size ) {
+        return 0;
+    }
+
+    // big endian: the first byte in memory is the most significant one
+    unsigned int value = 0;
+    for( int i=0; i<width; ++i ) {
+        value = ( value << 8 ) | ( ( _value >> ( 8 * ( _size - 1 - offset - i ) ) ) & 0xff );
+    }
+
+    sprintf( _result, "\t%s #$%0*x", mnemonic, width * 2, value );
+
+    return 1;
+
+}
+
 #endif
\ No newline at end of file
@@ -130,19 +130,25 @@ TIMERMANAGERJMP2A
     LDD , U
     STD TIMERMANAGERADD
 
-    PSHS D
+    ; Only X (the counter) and DP are still needed after the call,
+    ; since D, Y and U are reloaded or restored by the loop. Each
+    ; group is marked, so that the optimizer can drop the ones
+    ; that no timer handler is able to write.
+    ; TIMERSAVE X
     PSHS X
-    PSHS Y
-    PSHS U
+    ; TIMERSAVEEND
+    ; TIMERSAVE DP
     PSHS DP
+    ; TIMERSAVEEND
 
     JSR TIMERMANAGERJMP
 
+    ; TIMERSAVE DP
     PULS DP
-    PULS U
-    PULS Y
+    ; TIMERSAVEEND
+    ; TIMERSAVE X
     PULS X
-    PULS D
+    ; TIMERSAVEEND
 
     ; If we reach this line, we are going to decrement the
     ; counter since it is not zero.
@@ -4550,6 +4550,82 @@ void cpu_number_to_string( Environment * _environment, char * _number, char * _s
 
 }
 
+/**
+ * @brief <i>8086</i>: emit code to add two packed BCD values
+ * 
+ * @param _environment Current calling environment
+ * @param _source First value to add
+ * @param _destination Second value to add and destination address for result (if _other is NULL)
+ * @param _other Destination address for result
+ * @param _bytes Size of the values (in bytes)
+ */
+void cpu_bcd_add( Environment * _environment, char *_source, char *_destination, char *_other, int _bytes ) {
+
+    outline0("CLC");
+    for( int i=_bytes-1; i>=0; --i ) {
+        char offset[MAX_TEMPORARY_STORAGE]; sprintf( offset, "%d", i );
+        outline1("MOV AL, [%s]", address_displacement(_environment, _source, offset));
+        outline1("ADC AL, [%s]", address_displacement(_environment, _destination, offset));
+        outline0("DAA");
+        outline1("MOV [%s], AL", address_displacement(_environment, _other ? _other : _destination, offset));
+    }
+
+}
+
+/**
+ * @brief <i>8086</i>: emit code to subtract two packed BCD values
+ * 
+ * @param _environment Current calling environment
+ * @param _source First value
+ * @param _destination Value to subtract and destination address for result (if _other is NULL)
+ * @param _other Destination address for result
+ * @param _bytes Size of the values (in bytes)
+ */
+void cpu_bcd_sub( Environment * _environment, char *_source, char *_destination, char *_other, int _bytes ) {
+
+    outline0("CLC");
+    for( int i=_bytes-1; i>=0; --i ) {
+        char offset[MAX_TEMPORARY_STORAGE]; sprintf( offset, "%d", i );
+        outline1("MOV AL, [%s]", address_displacement(_environment, _source, offset));
+        outline1("SBB AL, [%s]", address_displacement(_environment, _destination, offset));
+        outline0("DAS");
+        outline1("MOV [%s], AL", address_displacement(_environment, _other ? _other : _destination, offset));
+    }
+
+}
+
+/**
+ * @brief <i>8086</i>: emit code to convert a packed BCD value into digits
+ * 
+ * @param _environment Current calling environment
+ * @param _bcd Value to convert
+ * @param _string Address of the string to fill (at least 2 * _bytes chars)
+ * @param _string_size Where to store the number of digits
+ * @param _bytes Size of the value (in bytes)
+ */
+void cpu_bcd_to_string( Environment * _environment, char * _bcd, char * _string, char * _string_size, int _bytes ) {
+
+    outline1("MOV DI, [%s]", _string );
+    outline0("MOV CL, 4");
+    for( int i=0; i<_bytes; ++i ) {
+        char offset[MAX_TEMPORARY_STORAGE]; sprintf( offset, "%d", i );
+        outline1("MOV AL, [%s]", address_displacement(_environment, _bcd, offset));
+        outline0("MOV AH, AL");
+        outline0("SHR AL, CL");
+        outline0("OR AL, 0x30");
+        outline0("MOV [DI], AL");
+        outline0("INC DI");
+        outline0("MOV AL, AH");
+        outline0("AND AL, 0x0f");
+        outline0("OR AL, 0x30");
+        outline0("MOV [DI], AL");
+        outline0("INC DI");
+    }
+    outline1("MOV AL, 0x%2.2x", _bytes * 2 );
+    outline1("MOV [%s], AL", _string_size );
+
+}
+
 void cpu_bits_to_string_vars( Environment * _environment ) {
 
     // variable_import( _environment, "BINSTRBUF", VT_BUFFER, 32 );
@@ -6196,4 +6272,265 @@ void cpu_float_single_exp( Environment * _environment, char * _value, char * _re
 }
 
 
+static EmbeddedCost cpuEmbeddedCost[] = {
+    { NULL, 0, 0, 0, 0 }
+};
+
+/**
+ * @brief <i>CPU 8086</i>: return the cost model of a primitive
+ * 
+ * No primitive has both an inline and an embedded version on this CPU,
+ * so the choice is always the one given by the -e option.
+ * 
+ * @param _environment Current calling environment
+ * @param _name Name of the primitive
+ * @return Cost of the primitive, or NULL if it can only be inlined (or called)
+ */
+EmbeddedCost * cpu_embedded_cost( Environment * _environment, char * _name ) {
+
+    int i = 0;
+    while( cpuEmbeddedCost[i].name ) {
+        if ( strcmp( cpuEmbeddedCost[i].name, _name ) == 0 ) {
+            return &cpuEmbeddedCost[i];
+        }
+        ++i;
+    }
+    return NULL;
+
+}
+
+/* addressing modes: register(s), register and immediate, register and memory,
+   memory and register, memory and immediate, memory (the cost of the
+   effective address is added separately). Branches are counted as not taken. */
+static InstructionCycles cpuInstructionCycles[] = {
+    { "MOV", { 2, 4, 8, 9, 10, -1, -1, -1 }, 0 },
+    { "ADD", { 3, 4, 9, 16, 17, -1, -1, -1 }, 0 },
+    { "ADC", { 3, 4, 9, 16, 17, -1, -1, -1 }, 0 },
+    { "SUB", { 3, 4, 9, 16, 17, -1, -1, -1 }, 0 },
+    { "SBB", { 3, 4, 9, 16, 17, -1, -1, -1 }, 0 },
+    { "AND", { 3, 4, 9, 16, 17, -1, -1, -1 }, 0 },
+    { "OR", { 3, 4, 9, 16, 17, -1, -1, -1 }, 0 },
+    { "XOR", { 3, 4, 9, 16, 17, -1, -1, -1 }, 0 },
+    { "CMP", { 3, 4, 9, 9, 10, -1, -1, -1 }, 0 },
+    { "TEST", { 3, 5, 9, 9, 11, -1, -1, -1 }, 0 },
+    { "INC", { 2, -1, -1, -1, -1, 15, -1, -1 }, 0 },
+    { "DEC", { 2, -1, -1, -1, -1, 15, -1, -1 }, 0 },
+    { "NEG", { 3, -1, -1, -1, -1, 16, -1, -1 }, 0 },
+    { "NOT", { 3, -1, -1, -1, -1, 16, -1, -1 }, 0 },
+    { "SHL", { 8, 2, -1, 20, 15, -1, -1, -1 }, 0 },
+    { "SAL", { 8, 2, -1, 20, 15, -1, -1, -1 }, 0 },
+    { "SHR", { 8, 2, -1, 20, 15, -1, -1, -1 }, 0 },
+    { "SAR", { 8, 2, -1, 20, 15, -1, -1, -1 }, 0 },
+    { "ROL", { 8, 2, -1, 20, 15, -1, -1, -1 }, 0 },
+    { "ROR", { 8, 2, -1, 20, 15, -1, -1, -1 }, 0 },
+    { "RCL", { 8, 2, -1, 20, 15, -1, -1, -1 }, 0 },
+    { "RCR", { 8, 2, -1, 20, 15, -1, -1, -1 }, 0 },
+    { "PUSH", { 11, 10, -1, -1, -1, 16, -1, -1 }, 0 },
+    { "POP", { 8, -1, -1, -1, -1, 17, -1, -1 }, 0 },
+    { "MUL", { 70, -1, -1, -1, -1, 76, -1, -1 }, 0 },
+    { "IMUL", { 80, -1, -1, -1, -1, 86, -1, -1 }, 0 },
+    { "DIV", { 80, -1, -1, -1, -1, 86, -1, -1 }, 0 },
+    { "IDIV", { 101, -1, -1, -1, -1, 107, -1, -1 }, 0 },
+    { "XCHG", { 4, -1, 17, 17, -1, -1, -1, -1 }, 0 },
+    { "LEA", { -1, -1, 2, -1, -1, -1, -1, -1 }, 0 },
+    { "LDS", { -1, -1, 16, -1, -1, -1, -1, -1 }, 0 },
+    { "LES", { -1, -1, 16, -1, -1, -1, -1, -1 }, 0 },
+    { "CALL", { 19, 19, 19, 19, 19, 19, -1, -1 }, 0 },
+    { "RET", { 16, 16, 16, 16, 16, 16, -1, -1 }, 0 },
+    { "INT", { 51, 51, 51, 51, 51, 51, -1, -1 }, 0 },
+    { "IRET", { 24, 24, 24, 24, 24, 24, -1, -1 }, 0 },
+    { "JMP", { 15, 15, 15, 15, 15, 15, -1, -1 }, 1 },
+    { "JO", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JNO", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JB", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JNAE", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JC", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JAE", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JNB", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JNC", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JE", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JZ", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JNE", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JNZ", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JBE", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JNA", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JA", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JNBE", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JS", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JNS", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JP", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JPE", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JNP", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JPO", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JL", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JNGE", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JGE", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JNL", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JLE", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JNG", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JG", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "JNLE", { 4, 4, 4, 4, 4, 4, -1, -1 }, 1 },
+    { "LOOP", { 5, 5, 5, 5, 5, 5, -1, -1 }, 1 },
+    { "LOOPE", { 5, 5, 5, 5, 5, 5, -1, -1 }, 1 },
+    { "LOOPZ", { 5, 5, 5, 5, 5, 5, -1, -1 }, 1 },
+    { "LOOPNE", { 5, 5, 5, 5, 5, 5, -1, -1 }, 1 },
+    { "LOOPNZ", { 5, 5, 5, 5, 5, 5, -1, -1 }, 1 },
+    { "JCXZ", { 6, 6, 6, 6, 6, 6, -1, -1 }, 1 },
+    { "CBW", { 2, 2, 2, 2, 2, 2, -1, -1 }, 0 },
+    { "CLC", { 2, 2, 2, 2, 2, 2, -1, -1 }, 0 },
+    { "STC", { 2, 2, 2, 2, 2, 2, -1, -1 }, 0 },
+    { "CMC", { 2, 2, 2, 2, 2, 2, -1, -1 }, 0 },
+    { "CLD", { 2, 2, 2, 2, 2, 2, -1, -1 }, 0 },
+    { "STD", { 2, 2, 2, 2, 2, 2, -1, -1 }, 0 },
+    { "CLI", { 2, 2, 2, 2, 2, 2, -1, -1 }, 0 },
+    { "STI", { 2, 2, 2, 2, 2, 2, -1, -1 }, 0 },
+    { "CWD", { 5, 5, 5, 5, 5, 5, -1, -1 }, 0 },
+    { "NOP", { 3, 3, 3, 3, 3, 3, -1, -1 }, 0 },
+    { "LAHF", { 4, 4, 4, 4, 4, 4, -1, -1 }, 0 },
+    { "SAHF", { 4, 4, 4, 4, 4, 4, -1, -1 }, 0 },
+    { "PUSHF", { 10, 10, 10, 10, 10, 10, -1, -1 }, 0 },
+    { "POPF", { 8, 8, 8, 8, 8, 8, -1, -1 }, 0 },
+    { "MOVSB", { 18, 18, 18, 18, 18, 18, -1, -1 }, 0 },
+    { "MOVSW", { 18, 18, 18, 18, 18, 18, -1, -1 }, 0 },
+    { "STOSB", { 11, 11, 11, 11, 11, 11, -1, -1 }, 0 },
+    { "STOSW", { 11, 11, 11, 11, 11, 11, -1, -1 }, 0 },
+    { "LODSB", { 12, 12, 12, 12, 12, 12, -1, -1 }, 0 },
+    { "LODSW", { 12, 12, 12, 12, 12, 12, -1, -1 }, 0 },
+    { "CMPSB", { 22, 22, 22, 22, 22, 22, -1, -1 }, 0 },
+    { "CMPSW", { 22, 22, 22, 22, 22, 22, -1, -1 }, 0 },
+    { "SCASB", { 15, 15, 15, 15, 15, 15, -1, -1 }, 0 },
+    { "SCASW", { 15, 15, 15, 15, 15, 15, -1, -1 }, 0 },
+    { "IN", { 10, 10, 10, 10, 10, 10, -1, -1 }, 0 },
+    { "OUT", { 8, 8, 8, 8, 8, 8, -1, -1 }, 0 },
+    { NULL, { 0 }, 0 }
+};
+
+#define CYCLES_EFFECTIVE_ADDRESS        6
+
+#define CYCLES_OPERAND_NONE             0
+#define CYCLES_OPERAND_REG              1
+#define CYCLES_OPERAND_MEM              2
+#define CYCLES_OPERAND_IMM              3
+
+static int cpu_instruction_operand( char * _operand ) {
+
+    static char * registers[] = { "AL", "AH", "BL", "BH", "CL", "CH", "DL", "DH", 
+        "AX", "BX", "CX", "DX", "SI", "DI", "SP", "BP", "CS", "DS", "ES", "SS", NULL };
+
+    if ( !*_operand ) {
+        return CYCLES_OPERAND_NONE;
+    }
+    if ( strchr( _operand, '[' ) ) {
+        return CYCLES_OPERAND_MEM;
+    }
+    for( int i=0; registers[i]; ++i ) {
+        if ( !strcasecmp( _operand, registers[i] ) ) {
+            return CYCLES_OPERAND_REG;
+        }
+    }
+    return CYCLES_OPERAND_IMM;
+
+}
+
+/**
+ * @brief <i>8086</i>: return the static cycles of an instruction
+ * 
+ * @param _environment Current calling environment
+ * @param _mnemonic Mnemonic of the instruction
+ * @param _operands Operands of the instruction
+ * @param _branch Set to true if the instruction is a jump or a branch
+ * @return Cycles of the instruction (0 if it is not an instruction)
+ */
+int cpu_instruction_cycles( Environment * _environment, char * _mnemonic, char * _operands, int * _branch ) {
+
+    char op1[MAX_TEMPORARY_STORAGE];
+    char op2[MAX_TEMPORARY_STORAGE];
+    char * target = op1;
+    int i = 0;
+
+    while( *_operands == ' ' || *_operands == '\t' ) {
+        ++_operands;
+    }
+
+    if ( !strncasecmp( _mnemonic, "REP", 3 ) ) {
+        // prefix of a string instruction: one iteration is counted
+        char mnemonic[MAX_TEMPORARY_STORAGE];
+        while( *_operands && *_operands != ' ' && *_operands != '\t' && *_operands != ';' && i < MAX_TEMPORARY_STORAGE - 1 ) {
+            mnemonic[i++] = *_operands++;
+        }
+        mnemonic[i] = 0;
+        return 9 + cpu_instruction_cycles( _environment, mnemonic, _operands, _branch );
+    }
+
+    op1[0] = op2[0] = 0;
+    for( char * p = _operands; *p && *p != ';' && i < MAX_TEMPORARY_STORAGE - 1; ++p ) {
+        if ( *p == ',' && target == op1 ) {
+            op1[i] = 0;
+            target = op2;
+            i = 0;
+            continue;
+        }
+        if ( *p != ' ' && *p != '\t' ) {
+            target[i++] = *p;
+        }
+    }
+    target[i] = 0;
+
+    int k1 = cpu_instruction_operand( op1 );
+    int k2 = cpu_instruction_operand( op2 );
+    int mode = 0;
+
+    if ( k1 == CYCLES_OPERAND_MEM ) {
+        mode = ( k2 == CYCLES_OPERAND_REG ) ? 3 : ( ( k2 == CYCLES_OPERAND_IMM ) ? 4 : 5 );
+    } else if ( k2 == CYCLES_OPERAND_MEM ) {
+        mode = 2;
+    } else if ( k2 == CYCLES_OPERAND_IMM || ( k1 == CYCLES_OPERAND_IMM && k2 == CYCLES_OPERAND_NONE ) ) {
+        mode = 1;
+    }
+
+    int cycles = instruction_cycles( cpuInstructionCycles, _mnemonic, mode, _branch );
+
+    if ( cycles && !*_branch && ( k1 == CYCLES_OPERAND_MEM || k2 == CYCLES_OPERAND_MEM ) ) {
+        cycles += CYCLES_EFFECTIVE_ADDRESS;
+    }
+
+    return cycles;
+
+}
+
+
+/**
+ * @brief <i>8086</i>: check if an instruction only reads a variable
+ * 
+ * This function is used when a procedure is expanded inline, to decide
+ * if a parameter can be replaced by the argument (or by a constant).
+ * 
+ * @param _environment Current calling environment
+ * @param _line Line of assembly that uses the variable
+ * @param _name Name of the variable (in the assembly source)
+ * @return Offset of the byte read (if it is a plain read), -1 otherwise
+ */
+int cpu_inline_read( Environment * _environment, char * _line, char * _name ) {
+
+    return -1;
+
+}
+
+/**
+ * @brief <i>8086</i>: rewrite a read of a variable as an immediate value
+ * 
+ * @param _environment Current calling environment
+ * @param _line Line of assembly that reads the variable
+ * @param _name Name of the variable (in the assembly source)
+ * @param _size Size of the variable (in bytes)
+ * @param _value Value of the variable
+ * @param _result Rewritten line
+ * @return 1 if the line has been rewritten, 0 otherwise
+ */
+int cpu_inline_constant( Environment * _environment, char * _line, char * _name, int _size, int _value, char * _result ) {
+
+    return 0;
+
+}
+
 #endif
\ No newline at end of file
@@ -130,9 +130,13 @@ TIMERMANAGERJMP2AH:
     MOV DI, TIMERADDRESS 
     ADD DI, AX
 
+    ; Only AX (the offset of the timer) is still needed after the
+    ; call, since SI and DI are reloaded or restored by the loop.
+    ; The group is marked, so that the optimizer can drop it if no
+    ; timer handler is able to write AX.
+    ; TIMERSAVE AX
     PUSH AX
-    PUSH SI
-    PUSH DI
+    ; TIMERSAVEEND
 
     MOV DX, [DI]
     MOV [TIMERVOID+1], DX
@@ -146,9 +150,9 @@ TIMERMANAGERJMP2AH:
 
     CALL TIMERVOID
 
-    POP DI
-    POP SI
+    ; TIMERSAVE AX
     POP AX
+    ; TIMERSAVEEND
 
     ; If we reach this line, we are going to decrement the
     ; counter since it is not zero.
@@ -67,8 +67,18 @@ void ay8910_initialization( Environment * _environment ) {
     variable_global( _environment, "AY8910TMPOFS" );
     variable_import( _environment, "AY8910TMPLEN", VT_BYTE, 0 );
     variable_global( _environment, "AY8910TMPLEN" );
-    variable_import( _environment, "AY8910JIFFIES", VT_BYTE, 0 );
+    variable_import( _environment, "AY8910JIFFIES", VT_WORD, 0 );
     variable_global( _environment, "AY8910JIFFIES" );
+    variable_import( _environment, "AY8910CALLCOUNT", VT_BYTE, 0 );
+    variable_global( _environment, "AY8910CALLCOUNT" );
+    variable_import( _environment, "AY8910CALLOFS", VT_WORD, 0 );
+    variable_global( _environment, "AY8910CALLOFS" );
+    variable_import( _environment, "AY8910RETPTR", VT_ADDRESS, 0 );
+    variable_global( _environment, "AY8910RETPTR" );
+    variable_import( _environment, "AY8910RETOFS", VT_BYTE, 0 );
+    variable_global( _environment, "AY8910RETOFS" );
+    variable_import( _environment, "AY8910RETBLOCKS", VT_BYTE, 0 );
+    variable_global( _environment, "AY8910RETBLOCKS" );
 
     variable_import( _environment, "AY8910BLOCKS_BACKUP", VT_BYTE, 0 );
     variable_global( _environment, "AY8910BLOCKS_BACKUP" );
@@ -77,6 +87,27 @@ void ay8910_initialization( Environment * _environment ) {
     variable_import( _environment, "AY8910TMPPTR_BACKUP", VT_ADDRESS, 0 );
     variable_global( _environment, "AY8910TMPPTR_BACKUP" );
 
+    variable_import( _environment, "AY8910SFXMASK", VT_BYTE, 0 );
+    variable_global( _environment, "AY8910SFXMASK" );
+    variable_import( _environment, "AY8910SFXPRIORITY", VT_BUFFER, 3 );
+    variable_global( _environment, "AY8910SFXPRIORITY" );
+    variable_import( _environment, "AY8910SFXCOUNT", VT_BUFFER, 3 );
+    variable_global( _environment, "AY8910SFXCOUNT" );
+    variable_import( _environment, "AY8910SFXHEAD", VT_BUFFER, 3 );
+    variable_global( _environment, "AY8910SFXHEAD" );
+    variable_import( _environment, "AY8910SFXQPITCH", VT_BUFFER, 24 );
+    variable_global( _environment, "AY8910SFXQPITCH" );
+    variable_import( _environment, "AY8910SFXQDURATION", VT_BUFFER, 24 );
+    variable_global( _environment, "AY8910SFXQDURATION" );
+    variable_import( _environment, "AY8910SFXPITCH", VT_WORD, 0 );
+    variable_global( _environment, "AY8910SFXPITCH" );
+    variable_import( _environment, "AY8910SFXDURATION", VT_WORD, 0 );
+    variable_global( _environment, "AY8910SFXDURATION" );
+    variable_import( _environment, "AY8910SFXPRI", VT_BYTE, 0 );
+    variable_global( _environment, "AY8910SFXPRI" );
+    variable_import( _environment, "AY8910SFXCHANNELS", VT_BYTE, 0 );
+    variable_global( _environment, "AY8910SFXCHANNELS" );
+
     cpu_call( _environment, "AY8910STARTUP" );
 
 }
@@ -1117,4 +1148,76 @@ void ay8910_wait_duration_vars( Environment * _environment, char *  _channel ) {
 
 }
 
+/**
+ * @brief Queue a sound effect, without waiting for its end.
+ * 
+ * The note is given to the timer manager, that plays it on the given
+ * channels as soon as they are free (or immediately, if the note has
+ * a higher priority than the one currently playing). The channels are
+ * taken from the music until the note is over. The code waits only if
+ * the queue of one of the channels is already full.
+ * 
+ * @param _environment Current calling environment
+ * @param _channels channels to play on
+ * @param _period period of the tone (chipset units)
+ * @param _duration duration (in jiffies)
+ * @param _priority priority (1...255)
+ */
+void ay8910_queue_sound( Environment * _environment, int _channels, int _period, int _duration, int _priority ) {
+
+    deploy( ay8910vars, src_hw_ay8910_vars_asm );
+    deploy( ay8910startup, src_hw_ay8910_startup_asm );
+
+    MAKE_LABEL
+
+    if ( _duration < 1 ) {
+        _duration = 1;
+    }
+
+    outline1("%s:", label );
+    outline0("DI");
+    outline1("LD HL, $%4.4x", ( _period & 0xffff ) );
+    outline0("LD (AY8910SFXPITCH), HL");
+    outline1("LD HL, $%4.4x", ( _duration & 0xffff ) );
+    outline0("LD (AY8910SFXDURATION), HL");
+    outline1("LD A, $%2.2x", ( _priority & 0xff ) );
+    outline0("LD (AY8910SFXPRI), A");
+    outline1("LD A, $%2.2x", ( _channels & 0x07 ) );
+    outline0("CALL AY8910SFXPUSH");
+    outline0("EI");
+    outline1("JR C, %s", label );
+
+}
+
+void ay8910_queue_sound_vars( Environment * _environment, char * _channels, char * _period, char * _duration, int _priority ) {
+
+    deploy( ay8910vars, src_hw_ay8910_vars_asm );
+    deploy( ay8910startup, src_hw_ay8910_startup_asm );
+
+    MAKE_LABEL
+
+    outline1("%sretry:", label );
+    outline0("DI");
+    outline1("LD HL, (%s)", _period );
+    outline0("LD (AY8910SFXPITCH), HL");
+    outline1("LD HL, (%s)", _duration );
+    outline0("LD A, L");
+    outline0("OR H");
+    outline1("JR NZ, %s", label );
+    outline0("INC HL");
+    outline1("%s:", label );
+    outline0("LD (AY8910SFXDURATION), HL");
+    outline1("LD A, $%2.2x", ( _priority & 0xff ) );
+    outline0("LD (AY8910SFXPRI), A");
+    if ( _channels ) {
+        outline1("LD A, (%s)", _channels );
+    } else {
+        outline0("LD A, $7" );
+    }
+    outline0("CALL AY8910SFXPUSH");
+    outline0("EI");
+    outline1("JR C, %sretry", label );
+
+}
+
 #endif
\ No newline at end of file
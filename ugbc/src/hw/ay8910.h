@@ -57,6 +57,8 @@ void ay8910_set_note_vars( Environment * _environment, char * _channel, char * _
 void ay8910_stop_vars( Environment * _environment, char * _channel );
 void ay8910_set_duration_vars( Environment * _environment, char * _channel, char * _duration );
 void ay8910_wait_duration_vars( Environment * _environment, char * _channel );
+void ay8910_queue_sound( Environment * _environment, int _channels, int _period, int _duration, int _priority );
+void ay8910_queue_sound_vars( Environment * _environment, char * _channels, char * _period, char * _duration, int _priority );
 
 void ay8910_music( Environment * _environment, char * _music, int _size, int _loop );
 
@@ -39,7 +39,9 @@
 MUSICPLAYERRESET:
     LD A, $0
     LD (AY8910JIFFIES), A
+    LD (AY8910JIFFIES+1), A
     LD (AY8910TMPOFS), A
+    LD (AY8910CALLCOUNT), A
     LD A, $1
     LD (AY8910MUSICREADY), A
     LD (AY8910TMPPTR), HL
@@ -50,14 +52,6 @@ MUSICPLAYERRESET:
     LD A, B
     LD (AY8910BLOCKS), A
     LD (AY8910BLOCKS_BACKUP), A
-    CP 0
-    JR Z, MUSICPLAYERRESET3
-    LD A, $FF
-    JP MUSICPLAYERRESET2
-MUSICPLAYERRESET3:
-    LD A, C
-MUSICPLAYERRESET2:
-    LD (AY8910TMPLEN), A
     RET
 
 ; This is the entry point for music play routine
@@ -106,12 +100,12 @@ MUSICPLAYERR:
 ; This is the entry point to wait until the waiting jiffies
 ; are exausted.
 MUSICPLAYERL1:
-    LD HL, AY8910JIFFIES
-    LD A, (HL)
-    CP 0
+    LD HL, (AY8910JIFFIES)
+    LD A, H
+    OR L
     JR Z, MUSICPLAYERL1B
-    DEC A
-    LD (HL), A
+    DEC HL
+    LD (AY8910JIFFIES), HL
     RET
 
 ; This is the entry point to read the next instruction.
@@ -125,11 +119,12 @@ MUSICPLAYERL1B:
     JR NZ, MUSICPLAYERL1X
 
     ; Let's stop the play!
+MUSICPLAYEREND:
     LD A, $0
     LD (AY8910MUSICREADY), A
     LD HL, 0
     LD (AY8910TMPPTR), HL
-    LD (AY8910JIFFIES), A
+    LD (AY8910JIFFIES), HL
     RET
 
 ; This is the entry point to decode the instruction
@@ -152,22 +147,111 @@ MUSICPLAYERL1X1:
     JR C, MUSICPLAYERL1X2
     JMP MUSICNOTEOFF
 MUSICPLAYERL1X2:
+    ; 1111xxxx: extended instructions (IMF version 2).
+    JP Z, MUSICLONGWAIT
+    CP $C0
+    JP Z, MUSICPATTERNCALL
+    CP $D0
+    JP Z, MUSICPATTERNRETURN
+    CP $E0
+    JP Z, MUSICPLAYEREND
     RET
 
 MUSICWAIT:
     SRL A
+    LD L, A
+    LD H, 0
+    LD (AY8910JIFFIES), HL
+    RET
+
+; LONG WAIT: the next two bytes are the delay (in jiffies).
+MUSICLONGWAIT:
+    CALL MUSICREADNEXTBYTE
+    LD A, C
     LD (AY8910JIFFIES), A
+    CALL MUSICREADNEXTBYTE
+    LD A, C
+    LD (AY8910JIFFIES+1), A
     RET
 
+; CALL: play the pattern at the given offset of the stream,
+; for the given number of times, then come back here.
+MUSICPATTERNCALL:
+    CALL MUSICREADNEXTBYTE
+    LD A, C
+    LD (AY8910CALLCOUNT), A
+    CALL MUSICREADNEXTBYTE
+    LD A, C
+    LD (AY8910CALLOFS), A
+    CALL MUSICREADNEXTBYTE
+    LD A, C
+    LD (AY8910CALLOFS+1), A
+
+    ; Save the reading position, to resume from it
+    ; when the pattern is over.
+    LD HL, (AY8910TMPPTR)
+    LD (AY8910RETPTR), HL
+    LD A, (AY8910TMPOFS)
+    LD (AY8910RETOFS), A
+    LD A, (AY8910BLOCKS)
+    LD (AY8910RETBLOCKS), A
+
+; Move the reading position to the start of the pattern.
+; Since blocks are 256 bytes long, the high byte of the
+; offset is the number of blocks to skip, and the low
+; byte is the offset inside that block.
+MUSICPATTERNSEEK:
+    LD HL, (AY8910TMPPTR_BACKUP)
+    LD A, (AY8910CALLOFS+1)
+    LD B, A
+    ADD A, H
+    LD H, A
+    LD (AY8910TMPPTR), HL
+    LD A, (AY8910BLOCKS_BACKUP)
+    SUB B
+    LD (AY8910BLOCKS), A
+    LD A, (AY8910CALLOFS)
+    LD (AY8910TMPOFS), A
+    JP MUSICPLAYERL1B
+
+; RETURN: the pattern is over. Repeat it, or resume
+; the reading from the saved position.
+MUSICPATTERNRETURN:
+    LD A, (AY8910CALLCOUNT)
+    CP 0
+    JP Z, MUSICPLAYERL1B
+    DEC A
+    LD (AY8910CALLCOUNT), A
+    JR NZ, MUSICPATTERNSEEK
+    LD HL, (AY8910RETPTR)
+    LD (AY8910TMPPTR), HL
+    LD A, (AY8910RETOFS)
+    LD (AY8910TMPOFS), A
+    LD A, (AY8910RETBLOCKS)
+    LD (AY8910BLOCKS), A
+    JP MUSICPLAYERL1B
+
 MUSICPROGRAM:
     CALL MUSICREADNEXTBYTE
     RET
 
+; The channels taken by a sound effect are not touched
+; by the music, until the effect is over.
+MUSICSFXFILTER:
+    PUSH BC
+    LD B, A
+    LD A, (AY8910SFXMASK)
+    CPL
+    AND B
+    POP BC
+    RET
+
 MUSICNOTEOFF:
     SRL A
     SRL A
     SRL A
     SRL A
+    CALL MUSICSFXFILTER
     CALL AY8910STOP
     RET    
 
@@ -175,6 +259,7 @@ MUSICNOTEON:
     SRL A
     SRL A
     SRL A
+    CALL MUSICSFXFILTER
     PUSH AF
     PUSH BC
     CALL MUSICREADNEXTBYTE
@@ -210,16 +295,19 @@ MUSICNOTEON:
     RET
 
 ; This routine has been added in order to read the
-; next byte in a "blocked" byte stream.
+; next byte in a "blocked" byte stream. Every block is
+; 256 bytes long, except the last one (AY8910LASTBLOCK bytes).
 MUSICREADNEXTBYTE:
-    ; Let's check if we arrived at the end of the block.
-    ; In that case, we must "load" the next block (or end
-    ; the reading).
+    ; Let's check if we arrived at the end of the last
+    ; block. In that case, the reading is over.
+    LD A, (AY8910BLOCKS)
+    CP 0
+    JR NZ, MUSICREADNEXTBYTE2
     LD A, (AY8910TMPOFS)
     LD B, A
-    LD A, (AY8910TMPLEN)
+    LD A, (AY8910LASTBLOCK)
     CP B
-    JR Z, MUSICREADNEXTBYTELE
+    JR Z, MUSICREADNEXTBYTEEND
 
 MUSICREADNEXTBYTE2:
     LD B, $ff
@@ -236,45 +324,19 @@ MUSICREADNEXTBYTE2:
     LD (AY8910TMPOFS), A
     LD A, (HL)
     LD C, A
-    RET
-
-; This is the entry point if a block (256 or less bytes)
-; is finished, and we must move forward to the next block.
-MUSICREADNEXTBYTELE:
-    ; Is file finished?
-    LD A, (AY8910BLOCKS)
-    JR Z, MUSICREADNEXTBYTEEND
-
-    ; Put the index to 0
-    LD A, 0
-    LD (AY8910TMPOFS), A
+    RET NZ
 
-    ; Increment the base address by 256
+    ; The block (256 bytes) is finished, so we must move 
+    ; forward to the next block.
     LD HL, AY8910TMPPTR
     INC HL
     LD A, (HL)
     INC A
-    LD (HL), A 
-
-    ; Decrement the number of remaining blocks
+    LD (HL), A
     LD A, (AY8910BLOCKS)
     DEC A
     LD (AY8910BLOCKS), A
-
-    ; If remaining blocks are 0, the last block
-    ; length is different from 256 bytes.
-    JR Z, MUSICPLAYERLE2
-
-    ; Remaining block is 256 bytes lenght.
-    LD A, $FF
-    LD (AY8910TMPLEN), A
-    JMP MUSICREADNEXTBYTE2
-
-    ; Remaining block is <256 bytes lenght.
-MUSICPLAYERLE2:
-    LD A, (AY8910LASTBLOCK)
-    LD (AY8910TMPLEN), A
-    JMP MUSICREADNEXTBYTE2
+    RET
 
 MUSICREADNEXTBYTEEND:
     LD B, $00
@@ -352,6 +352,8 @@ AY8910STARTUP:
     LD (HL), A
     LD HL, AY8910JIFFIES
     LD (HL), A
+    INC HL
+    LD (HL), A
     LD E, $8
     CALL AY8910STARTVOL0
     CALL AY8910STARTVOL1
@@ -735,63 +737,255 @@ AY8910STOPN0:
     CALL AY8910STARTSTOPGEN
     RET
 
+; Called at each vertical blank: the three tone channels are driven by the
+; sound effects queue (see AY8910SFXNEXT) while the noise channel is simply
+; stopped when its timer expires.
+
 AY8910MANAGER:
-    PUSH DE
     PUSH AF
-    LD DE, (AY8910TIMER)
-    LD A, E
-    OR D
-    JR Z, AY8910MANAGER2D1
-    LD DE, (AY8910TIMER)
-    DEC DE
-    LD (AY8910TIMER), DE    
-    LD DE, (AY8910TIMER)
-    LD A, E
-    OR D
-    JR NZ, AY8910MANAGER2D1
-    CALL AY8910STOP0
-AY8910MANAGER2D1:
-    LD DE, (AY8910TIMER+2)
-    LD A, E
-    OR D
-    JR Z, AY8910MANAGER2D2
-    LD DE, (AY8910TIMER+2)
-    DEC DE
-    LD (AY8910TIMER+2), DE    
-    LD DE, (AY8910TIMER+2)
-    LD A, E
-    OR D
-    JR NZ, AY8910MANAGER2D2
-    CALL AY8910STOP1
-AY8910MANAGER2D2:
-    LD DE, (AY8910TIMER+4)
+    PUSH BC
+    PUSH DE
+    PUSH HL
+    PUSH IX
+    LD B, 0
+AY8910MANAGERL1:
+    LD HL, AY8910TIMER
+    LD E, B
+    LD D, 0
+    ADD HL, DE
+    ADD HL, DE
+    LD E, (HL)
+    INC HL
+    LD D, (HL)
     LD A, E
     OR D
-    JR Z, AY8910MANAGER2D3
-    LD DE, (AY8910TIMER+4)
+    JR Z, AY8910MANAGERL2
     DEC DE
-    LD (AY8910TIMER+4), DE    
-    LD DE, (AY8910TIMER+4)
+    LD (HL), D
+    DEC HL
+    LD (HL), E
     LD A, E
     OR D
-    JR NZ, AY8910MANAGER2D3
-    CALL AY8910STOP2
-AY8910MANAGER2D3:
+    JR NZ, AY8910MANAGERL2
+    PUSH BC
+    CALL AY8910SFXNEXT
+    POP BC
+AY8910MANAGERL2:
+    INC B
+    LD A, B
+    CP 3
+    JR NZ, AY8910MANAGERL1
     LD DE, (AY8910TIMER+6)
     LD A, E
     OR D
     JR Z, AY8910MANAGER2DN0
-    LD DE, (AY8910TIMER+6)
     DEC DE
-    LD (AY8910TIMER+6), DE    
-    LD DE, (AY8910TIMER+6)
+    LD (AY8910TIMER+6), DE
     LD A, E
     OR D
     JR NZ, AY8910MANAGER2DN0
     CALL AY8910STOPN0
 AY8910MANAGER2DN0:
+    POP IX
+    POP HL
     POP DE
+    POP BC
     POP AF
     RET
 
+; Queue a sound effect on the channels given by the bitmask in A. Pitch,
+; duration and priority are taken from AY8910SFXPITCH, AY8910SFXDURATION
+; and AY8910SFXPRI. Must be called with interrupts disabled. If the queue
+; of one of the channels is full, nothing is queued and the carry is set:
+; the caller should enable the interrupts and try again.
+
+AY8910SFXPUSH:
+    LD (AY8910SFXCHANNELS), A
+    LD C, A
+    LD B, 0
+    LD D, 0
+AY8910SFXPUSHC1:
+    SRL C
+    JR NC, AY8910SFXPUSHC2
+    LD E, B
+    LD HL, AY8910SFXPRIORITY
+    ADD HL, DE
+    LD A, (AY8910SFXPRI)
+    CP (HL)
+    JR NZ, AY8910SFXPUSHC2
+    LD HL, AY8910SFXCOUNT
+    ADD HL, DE
+    LD A, (HL)
+    CP 4
+    JR C, AY8910SFXPUSHC2
+    SCF
+    RET
+AY8910SFXPUSHC2:
+    INC B
+    LD A, B
+    CP 3
+    JR NZ, AY8910SFXPUSHC1
+    LD A, (AY8910SFXCHANNELS)
+    LD C, A
+    LD B, 0
+AY8910SFXPUSHL1:
+    SRL C
+    JR NC, AY8910SFXPUSHL2
+    PUSH BC
+    CALL AY8910SFXPUSHCHANNEL
+    POP BC
+AY8910SFXPUSHL2:
+    INC B
+    LD A, B
+    CP 3
+    JR NZ, AY8910SFXPUSHL1
+    OR A
+    RET
+
+; B = channel. A free channel plays the effect at once; a channel busy
+; with the same priority queues it (up to 4 notes); a channel busy with a
+; lower priority is preempted and its queue is flushed; otherwise the
+; effect is dropped.
+
+AY8910SFXPUSHCHANNEL:
+    LD E, B
+    LD D, 0
+    LD HL, AY8910SFXPRIORITY
+    ADD HL, DE
+    LD A, (HL)
+    CP 0
+    JR Z, AY8910SFXPUSHCHANNELPLAY
+    LD C, A
+    LD A, (AY8910SFXPRI)
+    CP C
+    JR Z, AY8910SFXPUSHCHANNELQUEUE
+    JR NC, AY8910SFXPUSHCHANNELPLAY
+    RET
+AY8910SFXPUSHCHANNELQUEUE:
+    LD HL, AY8910SFXCOUNT
+    ADD HL, DE
+    LD A, (HL)
+    CP 4
+    RET NC
+    INC (HL)
+    LD HL, AY8910SFXHEAD
+    ADD HL, DE
+    ADD A, (HL)
+    AND $03
+    LD C, A
+    LD A, B
+    ADD A, A
+    ADD A, A
+    OR C
+    ADD A, A
+    LD E, A
+    LD HL, AY8910SFXQPITCH
+    ADD HL, DE
+    LD A, (AY8910SFXPITCH)
+    LD (HL), A
+    INC HL
+    LD A, (AY8910SFXPITCH+1)
+    LD (HL), A
+    LD HL, AY8910SFXQDURATION
+    ADD HL, DE
+    LD A, (AY8910SFXDURATION)
+    LD (HL), A
+    INC HL
+    LD A, (AY8910SFXDURATION+1)
+    LD (HL), A
+    RET
+AY8910SFXPUSHCHANNELPLAY:
+    LD HL, AY8910SFXCOUNT
+    ADD HL, DE
+    LD (HL), 0
+    LD HL, AY8910SFXPRIORITY
+    ADD HL, DE
+    LD A, (AY8910SFXPRI)
+    LD (HL), A
+    JP AY8910SFXPLAY
+
+; B = channel. Called when the timer of the channel expires: play the next
+; queued effect, if any, or release the channel to the music player.
+
+AY8910SFXNEXT:
+    LD E, B
+    LD D, 0
+    LD HL, AY8910SFXCOUNT
+    ADD HL, DE
+    LD A, (HL)
+    CP 0
+    JR Z, AY8910SFXNEXTRELEASE
+    DEC (HL)
+    LD HL, AY8910SFXHEAD
+    ADD HL, DE
+    LD A, (HL)
+    LD C, A
+    INC A
+    AND $03
+    LD (HL), A
+    LD A, B
+    ADD A, A
+    ADD A, A
+    OR C
+    ADD A, A
+    LD E, A
+    LD HL, AY8910SFXQPITCH
+    ADD HL, DE
+    LD A, (HL)
+    LD (AY8910SFXPITCH), A
+    INC HL
+    LD A, (HL)
+    LD (AY8910SFXPITCH+1), A
+    LD HL, AY8910SFXQDURATION
+    ADD HL, DE
+    LD A, (HL)
+    LD (AY8910SFXDURATION), A
+    INC HL
+    LD A, (HL)
+    LD (AY8910SFXDURATION+1), A
+    JP AY8910SFXPLAY
+AY8910SFXNEXTRELEASE:
+    LD HL, AY8910SFXPRIORITY
+    ADD HL, DE
+    LD (HL), 0
+    LD HL, AY8910SFXBITS
+    ADD HL, DE
+    LD A, (HL)
+    LD C, A
+    CPL
+    LD HL, AY8910SFXMASK
+    AND (HL)
+    LD (HL), A
+    LD A, C
+    JP AY8910STOP
+
+; B = channel. Program pitch and duration of the current effect and start
+; the channel, marking it as reserved for sound effects.
+
+AY8910SFXPLAY:
+    LD E, B
+    LD D, 0
+    LD HL, AY8910SFXBITS
+    ADD HL, DE
+    LD A, (HL)
+    LD HL, AY8910SFXMASK
+    OR (HL)
+    LD (HL), A
+    LD HL, AY8910TIMER
+    ADD HL, DE
+    ADD HL, DE
+    LD A, (AY8910SFXDURATION)
+    LD (HL), A
+    INC HL
+    LD A, (AY8910SFXDURATION+1)
+    LD (HL), A
+    LD HL, AY8910SFXBITS
+    ADD HL, DE
+    LD A, (HL)
+    PUSH AF
+    LD DE, (AY8910SFXPITCH)
+    CALL AY8910PROGFREQ
+    POP AF
+    JP AY8910START
+
 
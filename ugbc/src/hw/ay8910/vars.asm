@@ -35,6 +35,8 @@
 ;*                                                                             *
 ;* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
+AY8910SFXBITS:      DB  $01, $02, $04
+
 AY8910FREQTABLE:    
     DW  6841,		6841,		6841,		6841,		6841,		6841,		6841,		6841,		6841,		6841
     DW  6841,		6841,		6841,		6841,		6841,		6841,		6841,		6841,		6841,		6841
@@ -65,16 +65,8 @@ void c64_ypen( Environment * _environment, char * _destination ) {
    
 }
 
-void c64_dload( Environment * _environment, char * _filename, char * _offset, char * _address, char * _size ) {
-
-    _environment->sysCallUsed = 1;
-
-    deploy_preferred( syscall, src_hw_c64_syscall_asm);
-    deploy_preferred( dcommon, src_hw_c128_dcommon_asm);
-    deploy_preferred( dload, src_hw_c64_dload_asm);
+static void c64_dload_parameters( Environment * _environment, char * _filename, char * _address ) {
 
-    MAKE_LABEL
-    
     Variable * filename = variable_retrieve( _environment, _filename );
     Variable * tnaddress = variable_temporary( _environment, VT_ADDRESS, "(address of target_name)");
     Variable * tnsize = variable_temporary( _environment, VT_BYTE, "(size of target_name)");
@@ -83,10 +75,6 @@ void c64_dload( Environment * _environment, char * _filename, char * _offset, ch
     if ( _address ) {
         address = variable_retrieve( _environment, _address );
     }
-    Variable * size = NULL;
-    if ( _size ) {
-        size = variable_retrieve( _environment, _size );
-    }
 
     switch( filename->type ) {
         case VT_STRING:
@@ -100,27 +88,86 @@ void c64_dload( Environment * _environment, char * _filename, char * _offset, ch
     }
 
     outline1("LDA %s", tnaddress->realName);
-    outline0("STA TMPPTR");
+    outline0("STA DCOMMONP1");
     outline1("LDA %s", address_displacement(_environment, tnaddress->realName, "1"));
-    outline0("STA TMPPTR+1");
+    outline0("STA DCOMMONP1+1");
     outline1("LDA %s", tnsize->realName);
-    outline0("STA MATHPTR0");
+    outline0("STA DCOMMON0");
 
     if ( address ) {
 
         outline1("LDA %s", address->realName);
-        outline0("STA TMPPTR2");
+        outline0("STA DCOMMONP2");
         outline1("LDA %s", address_displacement(_environment, address->realName, "1"));
-        outline0("STA TMPPTR2+1");
+        outline0("STA DCOMMONP2+1");
         outline0("LDA #0");
-        outline0("STA MATHPTR1");
+        outline0("STA DCOMMON1");
+
+    } else {
+
+        outline0("LDA #1");
+        outline0("STA DCOMMON1");
 
     }
 
+}
+
+void c64_dload( Environment * _environment, char * _filename, char * _offset, char * _address, char * _size ) {
+
+    _environment->sysCallUsed = 1;
+
+    deploy_preferred( syscall, src_hw_c64_syscall_asm);
+    deploy_preferred( dcommon, src_hw_c128_dcommon_asm);
+    deploy_preferred( dload, src_hw_c64_dload_asm);
+    if ( _environment->dloadFast ) {
+        deploy_preferred( fastload, src_hw_c64_fastload_asm);
+    }
+
+    c64_dload_parameters( _environment, _filename, _address );
+
     outline0("JSR C64DLOAD");
 
 }
 
+static void c64_dload_async_deploy( Environment * _environment ) {
+
+    _environment->sysCallUsed = 1;
+
+    deploy_preferred( syscall, src_hw_c64_syscall_asm);
+    deploy_preferred( dcommon, src_hw_c128_dcommon_asm);
+    deploy_preferred( dload, src_hw_c64_dload_asm);
+    deploy_preferred( fastload, src_hw_c64_fastload_asm);
+    _environment->deployed.dloadasync = 1;
+
+}
+
+void c64_dload_async( Environment * _environment, char * _filename, char * _address ) {
+
+    c64_dload_async_deploy( _environment );
+
+    c64_dload_parameters( _environment, _filename, _address );
+
+    outline0("JSR FASTLOADASYNC");
+
+}
+
+void c64_dload_ready( Environment * _environment, char * _result ) {
+
+    c64_dload_async_deploy( _environment );
+
+    MAKE_LABEL
+
+    outline0("LDA FLASYNCSTATE");
+    outline1("BEQ %sready", label);
+    outline0("LDA #$0");
+    outline1("JMP %sdone", label);
+    outhead1("%sready:", label);
+    outline0("LDA #$FF");
+    outhead1("%sdone:", label);
+    outline1("STA %s", _result);
+
+}
+
 void c64_dsave( Environment * _environment, char * _filename, char * _offset, char * _address, char * _size ) {
 
     _environment->sysCallUsed = 1;
@@ -47,6 +47,8 @@ void c64_xpen( Environment * _environment, char * _destination );
 void c64_ypen( Environment * _environment, char * _destination );
 
 void c64_dload( Environment * _environment, char * _filename, char * _offset, char * _address, char * _size );
+void c64_dload_async( Environment * _environment, char * _filename, char * _address );
+void c64_dload_ready( Environment * _environment, char * _result );
 void c64_dsave( Environment * _environment, char * _filename, char * _offset, char * _address, char * _size );
 void c64_sys_call( Environment * _environment, int _destination );
 
@@ -40,6 +40,21 @@
 ; DCOMMONP2: address
 C64DLOAD:
 
+@IF deployed.dloadasync
+
+    JSR FASTLOADWAIT
+
+@ENDIF
+
+@IF deployed.fastload
+
+    JSR FASTLOAD
+    BCS C64DLOADKERNAL
+    RTS
+C64DLOADKERNAL:
+
+@ENDIF
+
     ; SETNAM. Set file name parameters.
     ; Input: A = File name length; X/Y = Pointer to file name.
     ; Output: –
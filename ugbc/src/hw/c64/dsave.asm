@@ -40,6 +40,12 @@
 ; DCOMMONP2: address
 C64DSAVE:
 
+@IF deployed.dloadasync
+
+    JSR FASTLOADWAIT
+
+@ENDIF
+
     ; SETNAM. Set file name parameters.
     ; Input: A = File name length; X/Y = Pointer to file name.
     ; Output: –
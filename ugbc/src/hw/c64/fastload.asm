@@ -0,0 +1,773 @@
+; /*****************************************************************************
+;  * ugBASIC - an isomorphic BASIC language compiler for retrocomputers        *
+;  *****************************************************************************
+;  * Copyright 2021-2025 Marco Spedaletti (asimov@mclink.it)
+;  *
+;  * Licensed under the Apache License, Version 2.0 (the "License
+;  * you may not use this file eXcept in compliance with the License.
+;  * You may obtain a copy of the License at
+;  *
+;  * http://www.apache.org/licenses/LICENSE-2.0
+;  *
+;  * Unless required by applicable law or agreed to in writing, software
+;  * distributed under the License is distributed on an "AS IS" BASIS,
+;  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either eXpress or implied.
+;  * See the License for the specific language governing permissions and
+;  * limitations under the License.
+;  *----------------------------------------------------------------------------
+;  * Concesso in licenza secondo i termini della Licenza Apache, versione 2.0
+;  * (la "Licenza è proibito usare questo file se non in conformità alla
+;  * Licenza. Una copia della Licenza è disponibile all'indirizzo:
+;  *
+;  * http://www.apache.org/licenses/LICENSE-2.0
+;  *
+;  * Se non richiesto dalla legislazione vigente o concordato per iscritto,
+;  * il software distribuito nei termini della Licenza è distribuito
+;  * "COSì COM'è", SENZA GARANZIE O CONDIZIONI DI ALCUN TIPO, esplicite o
+;  * implicite. Consultare la Licenza per il testo specifico che regola le
+;  * autorizzazioni e le limitazioni previste dalla medesima.
+;  ****************************************************************************/
+;* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+;*                                                                             *
+;*                          FAST LOADER ROUTINE ON C=64                        *
+;*                                                                             *
+;*                             by Marco Spedaletti                             *
+;*                                                                             *
+;* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+; This is a small two-bit fast loader for the 1541 (and compatibles).
+; The drive code is uploaded (with M-W) into the drive buffers at $0500,
+; and started (with M-E). The drive looks for the file on the directory,
+; and then follows the sectors chain, sending each sector as a block:
+;
+;   [LEN] [DATA x LEN]      LEN = $00 : end of file
+;                           LEN = $FF : file not found / read error
+;
+; Every byte is sent as four pairs of bits (MSB first) over the DATA
+; and CLK lines, clocked by the C=64 toggling the ATN line. After each
+; block the C=64 acknowledges by pulsing ATN, and the drive keeps CLK
+; low (busy) until the next sector has been read. Since ATN is used
+; as a clock, only one device should be connected to the serial bus.
+
+; DCOMMONP1 : filename; DCOMMON0: filename size
+; DCOMMON1: 1 if address is NULL; 0 if address is not NULL
+; DCOMMONP2: address
+; Output: carry clear if the file has been handled by the fast loader
+;         (DLOADERROR is set if the file was not found); carry set if
+;         the fast loader is not available (use the KERNAL instead).
+
+FLDEVICE:       .BYTE $08
+FLBANK:         .BYTE $00
+FLBYTE:         .BYTE $00
+FLLEN:          .BYTE $00
+FLCOUNT:        .BYTE $00
+FLHEADER:       .BYTE $00
+FLADDR:         .WORD $0000
+
+; Call the KERNAL routine at address X (low) / Y (high).
+FLSYSCALL:
+    STX SYSCALL0+1
+    STY SYSCALL0+2
+    JMP SYSCALL
+
+; LISTEN + SECOND on the command channel. Carry set if the
+; device is not present.
+FLLISTEN:
+    LDA #0
+    STA $90
+    LDA FLDEVICE
+    LDX #$B1
+    LDY #$FF
+    JSR FLSYSCALL
+    LDA #$6F
+    LDX #$93
+    LDY #$FF
+    JSR FLSYSCALL
+    LDA $90
+    ASL
+    RTS
+
+FLSEND:
+    LDX #$A8
+    LDY #$FF
+    JMP FLSYSCALL
+
+FLUNLISTEN:
+    LDX #$AE
+    LDY #$FF
+    JMP FLSYSCALL
+
+; Send the "M-x" command (x in A) with the address in FLADDR.
+; The command channel is left open, for the parameters.
+FLMEMCMD:
+    PHA
+    JSR FLLISTEN
+    BCS FLMEMCMDERROR
+    LDA #$4D
+    JSR FLSEND
+    LDA #$2D
+    JSR FLSEND
+    PLA
+    JSR FLSEND
+    LDA FLADDR
+    JSR FLSEND
+    LDA FLADDR+1
+    JSR FLSEND
+    CLC
+    RTS
+FLMEMCMDERROR:
+    PLA
+    JSR FLUNLISTEN
+    SEC
+    RTS
+
+; Check if the drive code is (still) in the drive memory,
+; by reading back the signature. Carry set if not.
+FASTLOADCHECK:
+    LDA #<FLDSIGNATURE
+    STA FLADDR
+    LDA #>FLDSIGNATURE
+    STA FLADDR+1
+    LDA #$52
+    JSR FLMEMCMD
+    BCS FASTLOADCHECKERROR
+    LDA #2
+    JSR FLSEND
+    JSR FLUNLISTEN
+    LDA FLDEVICE
+    LDX #$B4
+    LDY #$FF
+    JSR FLSYSCALL
+    LDA #$6F
+    LDX #$96
+    LDY #$FF
+    JSR FLSYSCALL
+    LDX #$A5
+    LDY #$FF
+    JSR FLSYSCALL
+    STA FLBYTE
+    LDX #$A5
+    LDY #$FF
+    JSR FLSYSCALL
+    STA FLLEN
+    LDX #$AB
+    LDY #$FF
+    JSR FLSYSCALL
+    LDA FLBYTE
+    CMP #$55
+    BNE FASTLOADCHECKERROR
+    LDA FLLEN
+    CMP #$47
+    BNE FASTLOADCHECKERROR
+    CLC
+    RTS
+FASTLOADCHECKERROR:
+    SEC
+    RTS
+
+; Upload the drive code, 32 bytes at a time.
+FASTLOADUPLOAD:
+    LDA #<FLDRIVECODE
+    STA DCOMMON4
+    LDA #>FLDRIVECODE
+    STA DCOMMON5
+    LDA #<FLDSTART
+    STA FLADDR
+    LDA #>FLDSTART
+    STA FLADDR+1
+    LDA #((FLDRIVECODEEND-FLDRIVECODE+31)/32)
+    STA FLCOUNT
+FASTLOADUPLOADL1:
+    LDA #$57
+    JSR FLMEMCMD
+    BCS FASTLOADUPLOADERROR
+    LDA #32
+    JSR FLSEND
+    LDY #0
+FASTLOADUPLOADL2:
+    LDA (DCOMMON4),Y
+    STY FLBYTE
+    JSR FLSEND
+    LDY FLBYTE
+    INY
+    CPY #32
+    BNE FASTLOADUPLOADL2
+    JSR FLUNLISTEN
+    CLC
+    LDA DCOMMON4
+    ADC #32
+    STA DCOMMON4
+    BCC FASTLOADUPLOADL3
+    INC DCOMMON5
+FASTLOADUPLOADL3:
+    CLC
+    LDA FLADDR
+    ADC #32
+    STA FLADDR
+    BCC FASTLOADUPLOADL4
+    INC FLADDR+1
+FASTLOADUPLOADL4:
+    DEC FLCOUNT
+    BNE FASTLOADUPLOADL1
+    JMP FASTLOADCHECK
+FASTLOADUPLOADERROR:
+    RTS
+
+; Upload (if needed) and start the drive code, and wait for the
+; drive to take the bus. Carry set if the fast loader is not available.
+FASTLOADSTART:
+
+    LDA $BA
+    BNE FASTLOADDEVICE
+    LDA #$08
+FASTLOADDEVICE:
+    STA FLDEVICE
+
+    ; The drive code is uploaded only once, unless the DOS
+    ; reused the buffers in the meanwhile.
+
+    JSR FASTLOADCHECK
+    BCC FASTLOADNAME
+    JSR FASTLOADUPLOAD
+    BCC FASTLOADNAME
+    RTS
+
+FASTLOADNAME:
+
+    ; Send the filename, padded with shifted spaces (like
+    ; on the directory).
+
+    LDA #<FLDNAME
+    STA FLADDR
+    LDA #>FLDNAME
+    STA FLADDR+1
+    LDA #$57
+    JSR FLMEMCMD
+    BCS FASTLOADUNAVAILABLE
+    LDA #16
+    JSR FLSEND
+    LDY #0
+FASTLOADNAMEL1:
+    LDA #$A0
+    CPY DCOMMON0
+    BCS FASTLOADNAMEPAD
+    LDA (DCOMMONP1),Y
+FASTLOADNAMEPAD:
+    STY FLBYTE
+    JSR FLSEND
+    LDY FLBYTE
+    INY
+    CPY #16
+    BNE FASTLOADNAMEL1
+    JSR FLUNLISTEN
+
+    ; Start the drive code.
+
+    LDA #<FLDSTART
+    STA FLADDR
+    LDA #>FLDSTART
+    STA FLADDR+1
+    LDA #$45
+    JSR FLMEMCMD
+    BCS FASTLOADUNAVAILABLE
+    JSR FLUNLISTEN
+
+    LDA #2
+    STA FLHEADER
+
+    LDA $DD00
+    AND #$07
+    STA FLBANK
+
+    ; Wait for the drive code to take the bus (CLK low).
+
+FASTLOADBUSY:
+    BIT $DD00
+    BVS FASTLOADBUSY
+    CLC
+    RTS
+
+FASTLOADUNAVAILABLE:
+    SEC
+    RTS
+
+FASTLOAD:
+
+    JSR FASTLOADSTART
+    BCC FASTLOADSTARTED
+    RTS
+
+FASTLOADSTARTED:
+
+    ; Where to load? If the address is NULL, the first two
+    ; bytes of the file are used, like the KERNAL does.
+
+    LDA DCOMMONP2
+    STA DCOMMON2
+    LDA DCOMMONP2+1
+    STA DCOMMON3
+
+FASTLOADBLOCK:
+
+    ; Wait for the next sector to be ready (CLK high).
+
+    BIT $DD00
+    BVC FASTLOADBLOCK
+    JSR FLDELAY
+    JSR FLDELAY
+
+    JSR FLRECV
+    STA FLLEN
+    BEQ FASTLOADEOF
+    CMP #$FF
+    BEQ FASTLOADERROR
+    LDA #0
+    STA FLCOUNT
+FASTLOADBYTE:
+    JSR FLRECV
+    JSR FLSTORE
+    INC FLCOUNT
+    LDA FLCOUNT
+    CMP FLLEN
+    BNE FASTLOADBYTE
+    JSR FLACK
+    JMP FASTLOADBLOCK
+
+FASTLOADEOF:
+    JSR FLACK
+    CLC
+    RTS
+
+FASTLOADERROR:
+    JSR FLACK
+    ; FILE NOT FOUND
+    LDA #$04
+    STA DLOADERROR
+    CLC
+    RTS
+
+; Store a received byte, skipping (or using) the load address.
+FLSTORE:
+    LDX FLHEADER
+    BEQ FLSTOREDATA
+    DEC FLHEADER
+    LDY DCOMMON1
+    BEQ FLSTORESKIP
+    CPX #2
+    BNE FLSTOREHI
+    STA DCOMMON2
+    RTS
+FLSTOREHI:
+    STA DCOMMON3
+FLSTORESKIP:
+    RTS
+FLSTOREDATA:
+    LDY #0
+    STA (DCOMMON2),Y
+    INC DCOMMON2
+    BNE FLSTOREDONE
+    INC DCOMMON3
+FLSTOREDONE:
+    RTS
+
+; Receive a byte (in A), as four pairs of bits.
+FLRECV:
+    LDA FLBANK
+    ORA #$08
+    JSR FLPAIR
+    LDA FLBANK
+    JSR FLPAIR
+    LDA FLBANK
+    ORA #$08
+    JSR FLPAIR
+    LDA FLBANK
+    JSR FLPAIR
+    LDA FLBYTE
+    RTS
+
+; Toggle ATN, give the drive the time to answer and
+; read DATA (bit 7) and CLK (bit 6).
+FLPAIR:
+    STA $DD00
+    NOP
+    NOP
+    NOP
+    NOP
+    NOP
+    NOP
+    NOP
+    NOP
+    NOP
+    NOP
+    NOP
+    NOP
+    LDA $DD00
+    ASL
+    ROL FLBYTE
+    ASL
+    ROL FLBYTE
+    RTS
+
+; Acknowledge a block, by pulsing ATN.
+FLACK:
+    LDA FLBANK
+    ORA #$08
+    STA $DD00
+    JSR FLDELAY
+    JSR FLDELAY
+    LDA FLBANK
+    STA $DD00
+    RTS
+
+FLDELAY:
+    NOP
+    NOP
+    NOP
+    NOP
+    NOP
+    NOP
+    NOP
+    NOP
+    NOP
+    NOP
+    RTS
+
+@IF deployed.dloadasync
+
+; Asynchronous loading: the file is started like FASTLOAD, and then
+; received by FASTLOADMANAGER, called by the timer interrupt, at most
+; FLASYNCCHUNK bytes for each call. Since the drive waits for every
+; ATN edge, the transfer can be suspended at any time.
+
+FLASYNCCHUNK = 16
+
+; 0 = idle; 1 = waiting for the next sector; 2 = receiving a sector
+FLASYNCSTATE:       .BYTE $00
+FLASYNCHEADER:      .BYTE $00
+FLASYNCCOUNT:       .BYTE $00
+
+; Same parameters of FASTLOAD. If the fast loader is not available,
+; the file is loaded (synchronously) with the KERNAL.
+FASTLOADASYNC:
+    JSR FASTLOADWAIT
+    JSR FASTLOADSTART
+    BCC FASTLOADASYNCSTARTED
+    JMP C64DLOADKERNAL
+
+FASTLOADASYNCSTARTED:
+    LDA DCOMMONP2
+    STA FLASYNCSTOREDATA+1
+    LDA DCOMMONP2+1
+    STA FLASYNCSTOREDATA+2
+    LDA DCOMMON1
+    STA FLASYNCHEADER
+    LDA #1
+    STA FLASYNCSTATE
+    RTS
+
+; Wait for the end of the pending asynchronous load, if any.
+FASTLOADWAIT:
+    LDA FLASYNCSTATE
+    BNE FASTLOADWAIT
+    RTS
+
+FASTLOADMANAGER:
+    LDA FLASYNCSTATE
+    BNE FASTLOADMANAGERGO
+    RTS
+
+FASTLOADMANAGERGO:
+    TXA
+    PHA
+    TYA
+    PHA
+
+    ; The VIC-II bank could have been changed in the meanwhile.
+
+    LDA $DD00
+    AND #$07
+    STA FLBANK
+
+    LDA FLASYNCSTATE
+    CMP #2
+    BEQ FASTLOADMANAGERDATA
+
+    BIT $DD00
+    BVC FASTLOADMANAGERDONE
+    JSR FLDELAY
+    JSR FLDELAY
+    JSR FLRECV
+    STA FLLEN
+    BEQ FASTLOADMANAGEREOF
+    CMP #$FF
+    BEQ FASTLOADMANAGERERROR
+    LDA #0
+    STA FLCOUNT
+    LDA #2
+    STA FLASYNCSTATE
+
+FASTLOADMANAGERDATA:
+    LDA #FLASYNCCHUNK
+    STA FLASYNCCOUNT
+FASTLOADMANAGERL1:
+    JSR FLRECV
+    JSR FLASYNCSTORE
+    INC FLCOUNT
+    LDA FLCOUNT
+    CMP FLLEN
+    BEQ FASTLOADMANAGERBLOCK
+    DEC FLASYNCCOUNT
+    BNE FASTLOADMANAGERL1
+    JMP FASTLOADMANAGERDONE
+
+FASTLOADMANAGERBLOCK:
+    JSR FLACK
+    LDA #1
+    STA FLASYNCSTATE
+    JMP FASTLOADMANAGERDONE
+
+FASTLOADMANAGERERROR:
+    ; FILE NOT FOUND
+    LDA #$04
+    STA DLOADERROR
+FASTLOADMANAGEREOF:
+    JSR FLACK
+    LDA #0
+    STA FLASYNCSTATE
+
+FASTLOADMANAGERDONE:
+    PLA
+    TAY
+    PLA
+    TAX
+    RTS
+
+; Like FLSTORE, but the destination pointer is kept inside the
+; store instruction, so that the main program can freely use DCOMMON.
+FLASYNCSTORE:
+    LDX FLHEADER
+    BEQ FLASYNCSTOREDATA
+    DEC FLHEADER
+    LDY FLASYNCHEADER
+    BEQ FLASYNCSTORESKIP
+    CPX #2
+    BNE FLASYNCSTOREHI
+    STA FLASYNCSTOREDATA+1
+    RTS
+FLASYNCSTOREHI:
+    STA FLASYNCSTOREDATA+2
+FLASYNCSTORESKIP:
+    RTS
+FLASYNCSTOREDATA:
+    STA $0000
+    INC FLASYNCSTOREDATA+1
+    BNE FLASYNCSTOREDONE
+    INC FLASYNCSTOREDATA+2
+FLASYNCSTOREDONE:
+    RTS
+
+@ENDIF
+
+;* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+;* DRIVE CODE (runs on the 1541, from $0500 to $06FF)
+;* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+FLDRIVECODE:
+
+    .ORG $0500
+
+FLDSTART:
+    SEI
+    ; Disable the ATN interrupt, since ATN is used as a clock.
+    LDA #$02
+    STA $180E
+    ; Busy.
+    LDA #$08
+    STA $1800
+
+    ; Look for the file on the directory (18/1...).
+
+    LDA #18
+    STA $06
+    LDA #1
+    STA $07
+FLDDIRNEXT:
+    JSR FLDREAD
+    BCS FLDERROR
+    LDX #0
+FLDDIRENTRY:
+    LDA $0302,X
+    AND #$07
+    BEQ FLDDIRSKIP
+    STX FLDENTRY
+    LDY #0
+FLDDIRNAME:
+    LDA FLDNAME,Y
+    ; '*' matches the rest of the name
+    CMP #$2A
+    BEQ FLDFOUND
+    ; '?' matches any character
+    CMP #$3F
+    BEQ FLDDIRCHAR
+    CMP $0305,X
+    BNE FLDDIRMISMATCH
+FLDDIRCHAR:
+    INX
+    INY
+    CPY #16
+    BNE FLDDIRNAME
+FLDFOUND:
+    LDX FLDENTRY
+    LDA $0303,X
+    STA $06
+    LDA $0304,X
+    STA $07
+    JMP FLDSEND
+FLDDIRMISMATCH:
+    LDX FLDENTRY
+FLDDIRSKIP:
+    TXA
+    CLC
+    ADC #$20
+    TAX
+    BNE FLDDIRENTRY
+    LDA $0300
+    BEQ FLDERROR
+    STA $06
+    LDA $0301
+    STA $07
+    JMP FLDDIRNEXT
+
+    ; Send the file, following the sectors chain.
+
+FLDSEND:
+    JSR FLDREAD
+    BCS FLDERROR
+    LDY #254
+    LDA $0300
+    BNE FLDSENDFULL
+    LDY $0301
+    DEY
+FLDSENDFULL:
+    STY FLDLEN
+    LDA #$00
+    STA $1800
+    TYA
+    JSR FLDSENDBYTE
+    LDX #0
+FLDSENDL1:
+    LDA $0302,X
+    JSR FLDSENDBYTE
+    INX
+    CPX FLDLEN
+    BNE FLDSENDL1
+    JSR FLDACK
+    LDA $0300
+    BEQ FLDEOF
+    STA $06
+    LDA $0301
+    STA $07
+    JMP FLDSEND
+
+FLDEOF:
+    LDA #$00
+    BEQ FLDEND
+FLDERROR:
+    LDA #$FF
+FLDEND:
+    LDX #$00
+    STX $1800
+    JSR FLDSENDBYTE
+    JSR FLDACK
+    ; Release the bus, and give back the ATN interrupt.
+    LDA #$00
+    STA $1800
+    LDA $1801
+    LDA #$82
+    STA $180E
+    CLI
+    RTS
+
+; Read the sector at $06/$07 on buffer 0 ($0300).
+; Carry set on error.
+FLDREAD:
+    LDA #$80
+    STA $00
+    CLI
+FLDREADL1:
+    LDA $00
+    BMI FLDREADL1
+    SEI
+    CMP #$02
+    RTS
+
+; Wait for the ATN pulse of the acknowledge.
+FLDACK:
+    BIT $1800
+    BPL FLDACK
+    LDA #$18
+    STA $1800
+FLDACKL1:
+    BIT $1800
+    BMI FLDACKL1
+    LDA #$08
+    STA $1800
+    RTS
+
+; Send the byte in A (X is preserved).
+FLDSENDBYTE:
+    STX FLDX
+    PHA
+    LSR
+    LSR
+    LSR
+    LSR
+    TAX
+    PLA
+    AND #$0F
+    STA FLDLO
+FLDSENDBYTEL1:
+    BIT $1800
+    BPL FLDSENDBYTEL1
+    LDA FLDENCODEA,X
+    STA $1800
+FLDSENDBYTEL2:
+    BIT $1800
+    BMI FLDSENDBYTEL2
+    LDA FLDENCODEB,X
+    STA $1800
+    LDX FLDLO
+FLDSENDBYTEL3:
+    BIT $1800
+    BPL FLDSENDBYTEL3
+    LDA FLDENCODEA,X
+    STA $1800
+FLDSENDBYTEL4:
+    BIT $1800
+    BMI FLDSENDBYTEL4
+    LDA FLDENCODEB,X
+    STA $1800
+    LDX FLDX
+    RTS
+
+; Bits 3-2 (with ATN asserted, so ATNA must be set)
+; and bits 1-0 of a nibble, as DATA OUT / CLK OUT.
+FLDENCODEA:
+    .BYTE $1A, $1A, $1A, $1A, $12, $12, $12, $12
+    .BYTE $18, $18, $18, $18, $10, $10, $10, $10
+FLDENCODEB:
+    .BYTE $0A, $02, $08, $00, $0A, $02, $08, $00
+    .BYTE $0A, $02, $08, $00, $0A, $02, $08, $00
+
+FLDENTRY:       .BYTE $00
+FLDLEN:         .BYTE $00
+FLDX:           .BYTE $00
+FLDLO:          .BYTE $00
+FLDNAME:        .RES 16, $A0
+FLDSIGNATURE:   .BYTE $55, $47
+
+    .RELOC
+
+FLDRIVECODEEND:
+
+    .ASSERT (FLDRIVECODEEND - FLDRIVECODE) <= 512, error, "fast loader drive code too big"
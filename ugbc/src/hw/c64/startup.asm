@@ -179,6 +179,9 @@ IRQSVCX:
 @ENDIF
 @IF deployed.timer
     JSR TIMERMANAGER
+@ENDIF
+@IF deployed.dloadasync
+    JSR FASTLOADMANAGER
 @ENDIF
     PLA
     JMP ($0314)    
@@ -0,0 +1,213 @@
+; /*****************************************************************************
+;  * ugBASIC - an isomorphic BASIC language compiler for retrocomputers        *
+;  *****************************************************************************
+;  * Copyright 2021-2025 Marco Spedaletti (asimov@mclink.it)
+;  *
+;  * Licensed under the Apache License, Version 2.0 (the "License");
+;  * you may not use this file eXcept in compliance with the License.
+;  * You may obtain a copy of the License at
+;  *
+;  * http://www.apache.org/licenses/LICENSE-2.0
+;  *
+;  * Unless required by applicable law or agreed to in writing, software
+;  * distributed under the License is distributed on an "AS IS" BASIS,
+;  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either eXpress or implied.
+;  * See the License for the specific language governing permissions and
+;  * limitations under the License.
+;  *----------------------------------------------------------------------------
+;  * Concesso in licenza secondo i termini della Licenza Apache, versione 2.0
+;  * (la "Licenza"); è proibito usare questo file se non in conformità alla
+;  * Licenza. Una copia della Licenza è disponibile all'indirizzo:
+;  *
+;  * http://www.apache.org/licenses/LICENSE-2.0
+;  *
+;  * Se non richiesto dalla legislazione vigente o concordato per iscritto,
+;  * il software distribuito nei termini della Licenza è distribuito
+;  * "COSì COM'è", SENZA GARANZIE O CONDIZIONI DI ALCUN TIPO, esplicite o
+;  * implicite. Consultare la Licenza per il testo specifico che regola le
+;  * autorizzazioni e le limitazioni previste dalla medesima.
+;  ****************************************************************************/
+;* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+;*                                                                             *
+;*                      DMA MEMORY ROUTINES ON C=64 + REU                      *
+;*                                                                             *
+;*                             by Marco Spedaletti                             *
+;*                                                                             *
+;* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+; Under this number of bytes, programming the REU costs more
+; than moving the data with the CPU.
+REUDMATHRESHOLD = 16
+
+; Parameters for REUMEMMOVE and REUMEMFILL. They are kept apart
+; from the zero page pointers, so that the video routines can
+; call these routines without losing their own state.
+REUMEMSRC:      .WORD   0
+REUMEMDST:      .WORD   0
+REUMEMLEN:      .WORD   0
+REUMEMVALUE:    .BYTE   0
+
+; Move REUMEMLEN bytes from REUMEMSRC to REUMEMDST. Areas can
+; overlap, since the REU copy goes through a bounce buffer
+; (the first bytes of the last REU bank) and the CPU copy
+; chooses the direction. X is preserved.
+REUMEMMOVE:
+    LDA REUMEMLEN+1
+    BNE REUMEMMOVEDMA
+    LDA REUMEMLEN
+    BNE REUMEMMOVESMALL
+    RTS
+REUMEMMOVESMALL:
+    CMP #REUDMATHRESHOLD
+    BCS REUMEMMOVEDMA
+
+    LDA REUMEMSRC
+    STA REUMEMMOVEFL0+1
+    STA REUMEMMOVEBL0+1
+    LDA REUMEMSRC+1
+    STA REUMEMMOVEFL0+2
+    STA REUMEMMOVEBL0+2
+    LDA REUMEMDST
+    STA REUMEMMOVEFL1+1
+    STA REUMEMMOVEBL1+1
+    LDA REUMEMDST+1
+    STA REUMEMMOVEFL1+2
+    STA REUMEMMOVEBL1+2
+
+    ; If destination is after the source, we must copy
+    ; from the last byte, to avoid overwriting the source.
+    CMP REUMEMSRC+1
+    BNE REUMEMMOVEDIR
+    LDA REUMEMDST
+    CMP REUMEMSRC
+REUMEMMOVEDIR:
+    BCS REUMEMMOVEB
+
+    LDY #0
+REUMEMMOVEFL0:
+    LDA $FFFF, Y
+REUMEMMOVEFL1:
+    STA $FFFF, Y
+    INY
+    CPY REUMEMLEN
+    BNE REUMEMMOVEFL0
+    RTS
+
+REUMEMMOVEB:
+    LDY REUMEMLEN
+REUMEMMOVEBL:
+    DEY
+REUMEMMOVEBL0:
+    LDA $FFFF, Y
+REUMEMMOVEBL1:
+    STA $FFFF, Y
+    CPY #0
+    BNE REUMEMMOVEBL
+    RTS
+
+REUMEMMOVEDMA:
+    PHP
+    SEI
+
+    LDA #0
+    STA REUCONTROL
+
+    ; Stash the source into the bounce buffer. The autoload
+    ; bit restores the registers at the end of the transfer,
+    ; so only the C64 address must be changed to fetch back.
+    LDA REUMEMSRC
+    STA REUC64BASE
+    LDA REUMEMSRC+1
+    STA REUC64BASE+1
+    LDA #0
+    STA REUREUBASE
+    STA REUREUBASE+1
+    LDA MAXFREEBANK
+    STA REUREUBASE+2
+    LDA REUMEMLEN
+    STA REUTRANSLEN
+    LDA REUMEMLEN+1
+    STA REUTRANSLEN+1
+    LDA #%10110000
+    STA REUCOMMAND
+
+    ; Fetch the bounce buffer into the destination.
+    LDA REUMEMDST
+    STA REUC64BASE
+    LDA REUMEMDST+1
+    STA REUC64BASE+1
+    LDA #%10110001
+    STA REUCOMMAND
+
+    PLP
+    RTS
+
+; Fill REUMEMLEN bytes starting from REUMEMDST with REUMEMVALUE.
+; The REU fetches the same byte over and over, by keeping fixed
+; the address on the expansion side. X is preserved.
+REUMEMFILL:
+    LDA REUMEMLEN+1
+    BNE REUMEMFILLDMA
+    LDA REUMEMLEN
+    BNE REUMEMFILLSMALL
+    RTS
+REUMEMFILLSMALL:
+    CMP #REUDMATHRESHOLD
+    BCS REUMEMFILLDMA
+
+    LDA REUMEMDST
+    STA REUMEMFILLL1+1
+    LDA REUMEMDST+1
+    STA REUMEMFILLL1+2
+    LDA REUMEMVALUE
+    LDY REUMEMLEN
+REUMEMFILLL:
+    DEY
+REUMEMFILLL1:
+    STA $FFFF, Y
+    CPY #0
+    BNE REUMEMFILLL
+    RTS
+
+REUMEMFILLDMA:
+    PHP
+    SEI
+
+    LDA #0
+    STA REUCONTROL
+
+    ; Stash the single byte value into the bounce buffer.
+    LDA #<REUMEMVALUE
+    STA REUC64BASE
+    LDA #>REUMEMVALUE
+    STA REUC64BASE+1
+    LDA #0
+    STA REUREUBASE
+    STA REUREUBASE+1
+    STA REUTRANSLEN+1
+    LDA MAXFREEBANK
+    STA REUREUBASE+2
+    LDA #1
+    STA REUTRANSLEN
+    LDA #%10110000
+    STA REUCOMMAND
+
+    ; Fetch it on the whole destination, with a fixed REU address.
+    LDA REUMEMDST
+    STA REUC64BASE
+    LDA REUMEMDST+1
+    STA REUC64BASE+1
+    LDA REUMEMLEN
+    STA REUTRANSLEN
+    LDA REUMEMLEN+1
+    STA REUTRANSLEN+1
+    LDA #%01000000
+    STA REUCONTROL
+    LDA #%10010001
+    STA REUCOMMAND
+
+    LDA #0
+    STA REUCONTROL
+
+    PLP
+    RTS
@@ -83,6 +83,9 @@ NMI:
     LD HL,(COLECOTIMER)
     INC HL
     LD (COLECOTIMER),HL
+@IF screenCache
+    CALL VDPSHADOWFLUSH
+@ENDIF
 	LD A, (IRQVECTORREADY)
 	CMP 0
 	JR Z, IRQVECTORSKIP
@@ -211,6 +211,11 @@ void cpu_move_32bit_signed_16bit_unsigned( Environment * _environment, char *_so
 void cpu_move_32bit_unsigned_16bit_signed( Environment * _environment, char *_source, char *_destination );
 void cpu_move_32bit_unsigned_16bit_unsigned( Environment * _environment, char *_source, char *_destination );
 
+EmbeddedCost * cpu_embedded_cost( Environment * _environment, char * _name );
+int cpu_instruction_cycles( Environment * _environment, char * _mnemonic, char * _operands, int * _branch );
+int cpu_inline_read( Environment * _environment, char * _line, char * _name );
+int cpu_inline_constant( Environment * _environment, char * _line, char * _name, int _size, int _value, char * _result );
+
 void cpu_move_nbit( Environment * _environment, int _n, char *_source, char *_destination );
 void cpu_peek( Environment * _environment, char * _address, char * _target );
 void cpu_poke( Environment * _environment, char * _address, char * _value );
@@ -269,6 +274,9 @@ void cpu_bit_inplace_8bit_extended_indirect( Environment * _environment, char *
 void cpu_number_to_string( Environment * _environment, char * _number, char * _string, char * _string_size, int _bits, int _Signed );
 void cpu_bits_to_string( Environment * _environment, char * _number, char * _string, char * _string_size, int _bits );
 void cpu_hex_to_string( Environment * _environment, char * _number, char * _string, char * _string_size, int _bits );
+void cpu_bcd_add( Environment * _environment, char *_source, char *_destination, char *_other, int _bytes );
+void cpu_bcd_sub( Environment * _environment, char *_source, char *_destination, char *_other, int _bytes );
+void cpu_bcd_to_string( Environment * _environment, char * _bcd, char * _string, char * _string_size, int _bytes );
 void cpu_move_8bit_indirect_with_offset2( Environment * _environment, char *_source, char * _value, char * _offset );
 void cpu_dsdefine( Environment * _environment, char * _string, char * _index );
 void cpu_dsalloc( Environment * _environment, char * _size, char * _index );
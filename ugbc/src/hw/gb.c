@@ -1187,8 +1187,18 @@ void gb_initialization( Environment * _environment ) {
     variable_global( _environment, "GBTMPOFS" );
     variable_import( _environment, "GBTMPLEN", VT_BYTE, 0 );
     variable_global( _environment, "GBTMPLEN" );
-    variable_import( _environment, "GBJIFFIES", VT_BYTE, 0 );
+    variable_import( _environment, "GBJIFFIES", VT_WORD, 0 );
     variable_global( _environment, "GBJIFFIES" );
+    variable_import( _environment, "GBCALLCOUNT", VT_BYTE, 0 );
+    variable_global( _environment, "GBCALLCOUNT" );
+    variable_import( _environment, "GBCALLOFS", VT_WORD, 0 );
+    variable_global( _environment, "GBCALLOFS" );
+    variable_import( _environment, "GBRETPTR", VT_ADDRESS, 0 );
+    variable_global( _environment, "GBRETPTR" );
+    variable_import( _environment, "GBRETOFS", VT_BYTE, 0 );
+    variable_global( _environment, "GBRETOFS" );
+    variable_import( _environment, "GBRETBLOCKS", VT_BYTE, 0 );
+    variable_global( _environment, "GBRETBLOCKS" );
 
     variable_import( _environment, "GBBLOCKS_BACKUP", VT_BYTE, 0 );
     variable_global( _environment, "GBBLOCKS_BACKUP" );
@@ -1202,6 +1212,13 @@ void gb_initialization( Environment * _environment ) {
     variable_import( _environment, "GBAUDIOTIMERS", VT_BUFFER, 8 );
     variable_global( _environment, "GBAUDIOTIMERS" );
 
+    variable_import( _environment, "VRAMQUEUE", VT_BUFFER, 240 );
+    variable_global( _environment, "VRAMQUEUE" );
+    variable_import( _environment, "VRAMQUEUEHEAD", VT_BYTE, 0 );
+    variable_global( _environment, "VRAMQUEUEHEAD" );
+    variable_import( _environment, "VRAMQUEUETAIL", VT_BYTE, 0 );
+    variable_global( _environment, "VRAMQUEUETAIL" );
+
     // variable_import( _environment, "XSCROLLPOS", VT_BYTE, 0 );
     // variable_global( _environment, "XSCROLLPOS" );
     // variable_import( _environment, "YSCROLLPOS", VT_BYTE, 0 );
@@ -35,13 +35,21 @@
 ;*                                                                             *
 ;* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
+; The whole TILEMAP does not fit into a VBlank, so it is cleared
+; directly, after the pending writes have been done.
+
 CLS:
+    CALL VRAMQUEUEFLUSH
     LD HL, (TEXTADDRESS)
+    LD A, (EMPTYTILE)
+    LD D, A
     LD BC, 32*32
 CLSL1:
-    CALL WAITSTATE
-    LD A, (EMPTYTILE)
-    LD (HL+), A
+    LDH A, (rSTAT)
+    AND STATF_BUSY
+    JR NZ, CLSL1
+    LD (HL), D
+    INC HL
     DEC BC
     LD A, B
     OR C
@@ -39,7 +39,9 @@
 MUSICPLAYERRESET:
     LD A, $0
     LD (GBJIFFIES), A
+    LD (GBJIFFIES+1), A
     LD (GBTMPOFS), A
+    LD (GBCALLCOUNT), A
     LD A, $1
     LD (GBMUSICREADY), A
     LD (GBTMPPTR), HL
@@ -50,14 +52,6 @@ MUSICPLAYERRESET:
     LD A, B
     LD (GBBLOCKS), A
     LD (GBBLOCKS_BACKUP), A
-    CP 0
-    JR Z, MUSICPLAYERRESET3
-    LD A, $FF
-    JP MUSICPLAYERRESET2
-MUSICPLAYERRESET3:
-    LD A, C
-MUSICPLAYERRESET2:
-    LD (GBTMPLEN), A
     RET
 
 ; This is the entry point for music play routine
@@ -106,12 +100,12 @@ MUSICPLAYERR:
 ; This is the entry point to wait until the waiting jiffies
 ; are exausted.
 MUSICPLAYERL1:
-    LD HL, GBJIFFIES
-    LD A, (HL)
-    CP 0
+    LD HL, (GBJIFFIES)
+    LD A, H
+    OR L
     JR Z, MUSICPLAYERL1B
-    DEC A
-    LD (HL), A
+    DEC HL
+    LD (GBJIFFIES), HL
     RET
 
 ; This is the entry point to read the next instruction.
@@ -125,11 +119,12 @@ MUSICPLAYERL1B:
     JR NZ, MUSICPLAYERL1X
 
     ; Let's stop the play!
+MUSICPLAYEREND:
     LD A, $0
     LD (GBMUSICREADY), A
     LD HL, 0
     LD (GBTMPPTR), HL
-    LD (GBJIFFIES), A
+    LD (GBJIFFIES), HL
     RET
 
 ; This is the entry point to decode the instruction
@@ -152,13 +147,90 @@ MUSICPLAYERL1X1:
     JR C, MUSICPLAYERL1X2
     JMP MUSICNOTEOFF
 MUSICPLAYERL1X2:
+    ; 1111xxxx: extended instructions (IMF version 2).
+    JP Z, MUSICLONGWAIT
+    CP $C0
+    JP Z, MUSICPATTERNCALL
+    CP $D0
+    JP Z, MUSICPATTERNRETURN
+    CP $E0
+    JP Z, MUSICPLAYEREND
     RET
 
 MUSICWAIT:
     SRL A
+    LD L, A
+    LD H, 0
+    LD (GBJIFFIES), HL
+    RET
+
+; LONG WAIT: the next two bytes are the delay (in jiffies).
+MUSICLONGWAIT:
+    CALL MUSICREADNEXTBYTE
+    LD A, C
     LD (GBJIFFIES), A
+    CALL MUSICREADNEXTBYTE
+    LD A, C
+    LD (GBJIFFIES+1), A
     RET
 
+; CALL: play the pattern at the given offset of the stream,
+; for the given number of times, then come back here.
+MUSICPATTERNCALL:
+    CALL MUSICREADNEXTBYTE
+    LD A, C
+    LD (GBCALLCOUNT), A
+    CALL MUSICREADNEXTBYTE
+    LD A, C
+    LD (GBCALLOFS), A
+    CALL MUSICREADNEXTBYTE
+    LD A, C
+    LD (GBCALLOFS+1), A
+
+    ; Save the reading position, to resume from it
+    ; when the pattern is over.
+    LD HL, (GBTMPPTR)
+    LD (GBRETPTR), HL
+    LD A, (GBTMPOFS)
+    LD (GBRETOFS), A
+    LD A, (GBBLOCKS)
+    LD (GBRETBLOCKS), A
+
+; Move the reading position to the start of the pattern.
+; Since blocks are 256 bytes long, the high byte of the
+; offset is the number of blocks to skip, and the low
+; byte is the offset inside that block.
+MUSICPATTERNSEEK:
+    LD HL, (GBTMPPTR_BACKUP)
+    LD A, (GBCALLOFS+1)
+    LD B, A
+    ADD A, H
+    LD H, A
+    LD (GBTMPPTR), HL
+    LD A, (GBBLOCKS_BACKUP)
+    SUB B
+    LD (GBBLOCKS), A
+    LD A, (GBCALLOFS)
+    LD (GBTMPOFS), A
+    JP MUSICPLAYERL1B
+
+; RETURN: the pattern is over. Repeat it, or resume
+; the reading from the saved position.
+MUSICPATTERNRETURN:
+    LD A, (GBCALLCOUNT)
+    CP 0
+    JP Z, MUSICPLAYERL1B
+    DEC A
+    LD (GBCALLCOUNT), A
+    JR NZ, MUSICPATTERNSEEK
+    LD HL, (GBRETPTR)
+    LD (GBTMPPTR), HL
+    LD A, (GBRETOFS)
+    LD (GBTMPOFS), A
+    LD A, (GBRETBLOCKS)
+    LD (GBBLOCKS), A
+    JP MUSICPLAYERL1B
+
 MUSICPROGRAM:
     CALL MUSICREADNEXTBYTE
     RET
@@ -215,16 +287,19 @@ MUSICNOTEON:
     RET
 
 ; This routine has been added in order to read the
-; next byte in a "blocked" byte stream.
+; next byte in a "blocked" byte stream. Every block is
+; 256 bytes long, except the last one (GBLASTBLOCK bytes).
 MUSICREADNEXTBYTE:
-    ; Let's check if we arrived at the end of the block.
-    ; In that case, we must "load" the next block (or end
-    ; the reading).
+    ; Let's check if we arrived at the end of the last
+    ; block. In that case, the reading is over.
+    LD A, (GBBLOCKS)
+    CP 0
+    JR NZ, MUSICREADNEXTBYTE2
     LD A, (GBTMPOFS)
     LD B, A
-    LD A, (GBTMPLEN)
+    LD A, (GBLASTBLOCK)
     CP B
-    JR Z, MUSICREADNEXTBYTELE
+    JR Z, MUSICREADNEXTBYTEEND
 
 MUSICREADNEXTBYTE2:
     LD B, $ff
@@ -241,45 +316,19 @@ MUSICREADNEXTBYTE2:
     LD (GBTMPOFS), A
     LD A, (HL)
     LD C, A
-    RET
-
-; This is the entry point if a block (256 or less bytes)
-; is finished, and we must move forward to the next block.
-MUSICREADNEXTBYTELE:
-    ; Is file finished?
-    LD A, (GBBLOCKS)
-    JR Z, MUSICREADNEXTBYTEEND
-
-    ; Put the index to 0
-    LD A, 0
-    LD (GBTMPOFS), A
+    RET NZ
 
-    ; Increment the base address by 256
+    ; The block (256 bytes) is finished, so we must move 
+    ; forward to the next block.
     LD HL, GBTMPPTR
     INC HL
     LD A, (HL)
     INC A
-    LD (HL), A 
-
-    ; Decrement the number of remaining blocks
+    LD (HL), A
     LD A, (GBBLOCKS)
     DEC A
     LD (GBBLOCKS), A
-
-    ; If remaining blocks are 0, the last block
-    ; length is different from 256 bytes.
-    JR Z, MUSICPLAYERLE2
-
-    ; Remaining block is 256 bytes lenght.
-    LD A, $FF
-    LD (GBTMPLEN), A
-    JMP MUSICREADNEXTBYTE2
-
-    ; Remaining block is <256 bytes lenght.
-MUSICPLAYERLE2:
-    LD A, (GBLASTBLOCK)
-    LD (GBTMPLEN), A
-    JMP MUSICREADNEXTBYTE2
+    RET
 
 MUSICREADNEXTBYTEEND:
     LD B, $00
@@ -175,15 +175,8 @@ PUTIMAGEALLOCOK:
 
     ; Let's repeat the copy for 16 bytes.
 
-    LD B, 16
-PUTIMAGEALLOCOKL1:
-    CALL WAITSTATE
-    LD A, (HL)
-    LD (DE), A
-    INC HL
-    INC DE
-    DEC B
-    JR NZ, PUTIMAGEALLOCOKL1
+    LD C, 16
+    CALL VRAMQUEUEPUT
 
     POP HL
 
@@ -278,58 +271,46 @@ PUTIMAGEDRAWL1B:
 
 PUTIMAGEDRAWL2:
 
-    CALL WAITSTATE
+    ; Take a whole row of indexes (or what is left, if less).
 
-    ; Load the index from the IMAGE.
-
-    LD A, (HL)
+    LD A, (PUTIMAGEWIDTH)
+    CP C
+    JR C, PUTIMAGEDRAWL2ROW
+    LD A, C
+PUTIMAGEDRAWL2ROW:
+    LD B, A
 
-    ; Store the index into the TILEMAP.
+    ; Store the indexes into the TILEMAP, during the next VBlank.
 
-    LD (DE), A
+    PUSH BC
+    LD C, A
+    CALL VRAMQUEUEPUT
+    POP BC
 
-    ; Decrement the tiles to copy.
+    ; Decrement the tiles to copy. If the tiles have been copied, exit!
 
-    DEC C
+    LD A, C
+    SUB B
+    JR Z, PUTIMAGEDRAWDONE
+    LD C, A
 
-    ; If the tiles have been copied, exit!
+    ; Move forward by one row on the IMAGE...
 
-    JR NZ, PUTIMAGEDRAWL2NEXT
-    JP PUTIMAGEDRAWDONE
+    LD A, L
+    ADD A, B
+    LD L, A
+    JR NC, PUTIMAGEDRAWL2NEXT
+    INC H
 
 PUTIMAGEDRAWL2NEXT:
 
-    ; Move forward by one tile.
-
-    INC HL
-    INC DE
-
-    ; We reached the width of the IMAGE?
-    ; No, so we have to repeat.
-
-    LD A, (PUTIMAGEX)
-    INC A
-    LD (PUTIMAGEX), A
-    LD B, A
-    LD A, (PUTIMAGEWIDTH)
-    CP B
-    JR NZ, PUTIMAGEDRAWL2
-
-    LD A, 0
-    LD (PUTIMAGEX), A
-
-    ; Move forward on the TILEMAP & COLORMAP memory only!
+    ; ... and on the TILEMAP & COLORMAP memory only!
 
     PUSH HL
-    LD H, D
-    LD L, E
-    LD DE, 32
+    LD HL, 32
     ADD HL, DE
-    LD D, 0
-    LD A, (PUTIMAGEWIDTH)
-    LD E, A
-    CALL SUB_HL_DE
-    LD DE, HL
+    LD D, H
+    LD E, L
     POP HL
 
     JP PUTIMAGEDRAWL2
@@ -36,6 +36,7 @@
 ;* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
 SCREEN:
+    CALL VRAMQUEUEFLUSH
     LD HL, (TEXTADDRESS)
     LD D, 0
     LD A, B
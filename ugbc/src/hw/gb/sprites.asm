@@ -42,12 +42,11 @@ SPRITEDATASET:
     SLA A
     LD E, A
     LD D, 0
-    LD HL, $FE00
+    LD HL, SHADOWOAM
     ADD HL, DE
     POP AF
     INC HL
     INC HL
-    CALL WAITSTATEM0
     LD (HL), A
     RET
 
@@ -66,7 +65,7 @@ SPRITEDATAFROM:
     SLA A
     LD E, A
     LD D, 0
-    LD HL, $FE00
+    LD HL, SHADOWOAM
     ADD HL, DE
     POP AF
 
@@ -85,7 +84,6 @@ SPRITEDATAFROM:
     CALL TILESETSLOTRESETFREESLOT
 
     LD A, B
-    CALL WAITSTATEM0
     LD (HL), A
 
     POP HL
@@ -120,15 +118,8 @@ SPRITEDATAFROM:
 
     ; Let's repeat the copy for 16 bytes.
 
-    LD B, 16
-SPRITEDATAFROML1:
-    CALL WAITSTATE
-    LD A, (HL)
-    LD (DE), A
-    INC HL
-    INC DE
-    DEC B
-    JR NZ, SPRITEDATAFROML1
+    LD C, 16
+    CALL VRAMQUEUEPUT
 
     RET
 
@@ -138,13 +129,12 @@ SPRITEENABLE:
     SLA A
     LD E, A
     LD D, 0
-    LD HL, $FE00
+    LD HL, SHADOWOAM
     ADD HL, DE
     INC HL
     INC HL
     INC HL
     LD A, 0
-    CALL WAITSTATEM0
     LD (HL), A
     RET
 
@@ -154,10 +144,9 @@ SPRITEDISABLE:
     SLA A
     LD E, A
     LD D, 0
-    LD HL, $FE00
+    LD HL, SHADOWOAM
     ADD HL, DE
     LD A, 255
-    CALL WAITSTATEM0
     LD (HL), A
     RET
 
@@ -168,11 +157,10 @@ SPRITEAT:
     SLA A
     LD E, A
     LD D, 0
-    LD HL, $FE00
+    LD HL, SHADOWOAM
     ADD HL, DE
     POP DE
     LD A, E
-    CALL WAITSTATEM0
     LD (HL), A
     INC HL
     LD A, D
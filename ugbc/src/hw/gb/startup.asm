@@ -986,7 +986,264 @@ WAITSTATEM0L2:
     POP HL
     RET
 
+; ------------------------------------------------------------------------------
+; OAM DMA
+;
+; Sprites are written into SHADOWOAM (see _var.c, it is the first thing in
+; WRAM so that it is aligned to 256 bytes) and copied to OAM once per frame
+; by the VBlank handler. During the transfer the CPU can only access HRAM,
+; so this routine is copied to _HRAM by GBSTARTUP and called from there.
+;  In : A high byte of the source address
+; ------------------------------------------------------------------------------
+
+OAMDMA:
+    LDH (rDMA), A
+    LD A, 40
+OAMDMAL1:
+    DEC A
+    JR NZ, OAMDMAL1
+    RET
+OAMDMAEND:
+
+; ------------------------------------------------------------------------------
+; VRAM TRANSFER QUEUE
+;
+; Instead of waiting on STAT for every single byte, writes to VRAM are
+; appended to VRAMQUEUE and carried out by the VBlank handler. Each entry
+; is made by the destination address (2 bytes), the length (1 byte) and
+; the data itself. At most VRAMQUEUEBUDGET "units" (one for each byte,
+; plus four for each entry) are drained for each frame, and never after
+; the 150th line, so that the VBlank period is never exceeded. If the
+; queue is full, or the screen is off, it is flushed synchronously.
+; ------------------------------------------------------------------------------
+
+VRAMQUEUESIZE       EQU 240
+VRAMQUEUEMAXLEN     EQU 32
+VRAMQUEUEBUDGET     EQU 72
+
+; Point to the entry at head (A), and load its header.
+;  In : A offset of the entry
+;  Out: DE destination, C length, HL data
+VRAMQUEUEENTRY:
+    LD HL, VRAMQUEUE
+    ADD A, L
+    LD L, A
+    JR NC, VRAMQUEUEENTRY2
+    INC H
+VRAMQUEUEENTRY2:
+    LD A, (HL+)
+    LD E, A
+    LD A, (HL+)
+    LD D, A
+    LD A, (HL+)
+    LD C, A
+    LD A, (VRAMQUEUEHEAD)
+    ADD A, 3
+    ADD A, C
+    LD (VRAMQUEUEHEAD), A
+    RET
+
+; Called by the VBlank handler.
+VRAMQUEUEDRAIN:
+    LD B, VRAMQUEUEBUDGET
+VRAMQUEUEDRAINL1:
+    LD A, (VRAMQUEUETAIL)
+    LD C, A
+    LD A, (VRAMQUEUEHEAD)
+    CP C
+    JR Z, VRAMQUEUEDRAINEMPTY
+    LD C, A
+    LDH A, (rLY)
+    CP 144
+    RET C
+    CP 150
+    RET NC
+    LD HL, VRAMQUEUE
+    LD A, C
+    ADD A, L
+    LD L, A
+    JR NC, VRAMQUEUEDRAINL2
+    INC H
+VRAMQUEUEDRAINL2:
+    INC HL
+    INC HL
+    LD A, B
+    SUB 4
+    RET C
+    SUB (HL)
+    RET C
+    LD B, A
+    LD A, C
+    CALL VRAMQUEUEENTRY
+VRAMQUEUEDRAINL3:
+    LD A, (HL+)
+    LD (DE), A
+    INC DE
+    DEC C
+    JR NZ, VRAMQUEUEDRAINL3
+    JR VRAMQUEUEDRAINL1
+VRAMQUEUEDRAINEMPTY:
+    XOR A
+    LD (VRAMQUEUEHEAD), A
+    LD (VRAMQUEUETAIL), A
+    RET
+
+; Write everything is still pending, waiting on STAT. It must be
+; called before accessing VRAM directly, to keep writes in order.
+VRAMQUEUEFLUSH:
+    PUSH BC
+    PUSH DE
+    PUSH HL
+    DI
+VRAMQUEUEFLUSHL1:
+    LD A, (VRAMQUEUETAIL)
+    LD C, A
+    LD A, (VRAMQUEUEHEAD)
+    CP C
+    JR Z, VRAMQUEUEFLUSHDONE
+    CALL VRAMQUEUEENTRY
+VRAMQUEUEFLUSHL2:
+    CALL WAITSTATE
+    LD A, (HL+)
+    LD (DE), A
+    INC DE
+    DEC C
+    JR NZ, VRAMQUEUEFLUSHL2
+    JR VRAMQUEUEFLUSHL1
+VRAMQUEUEFLUSHDONE:
+    XOR A
+    LD (VRAMQUEUEHEAD), A
+    LD (VRAMQUEUETAIL), A
+    EI
+    POP HL
+    POP DE
+    POP BC
+    RET
+
+; Reserve a new entry, with interrupts disabled.
+;  In : DE destination, C length
+;  Out: HL where to put the data
+VRAMQUEUEOPEN:
+    DI
+    LD A, (VRAMQUEUETAIL)
+    ADD A, 3
+    ADD A, C
+    JR C, VRAMQUEUEOPENFULL
+    CP VRAMQUEUESIZE+1
+    JR C, VRAMQUEUEOPENOK
+VRAMQUEUEOPENFULL:
+    CALL VRAMQUEUEFLUSH
+    JR VRAMQUEUEOPEN
+VRAMQUEUEOPENOK:
+    LD A, (VRAMQUEUETAIL)
+    LD HL, VRAMQUEUE
+    ADD A, L
+    LD L, A
+    JR NC, VRAMQUEUEOPENOK2
+    INC H
+VRAMQUEUEOPENOK2:
+    LD A, (VRAMQUEUETAIL)
+    ADD A, 3
+    ADD A, C
+    LD (VRAMQUEUETAIL), A
+    LD A, E
+    LD (HL+), A
+    LD A, D
+    LD (HL+), A
+    LD A, C
+    LD (HL+), A
+    RET
+
+; Commit the entry. If the screen is off there will be no VBlank
+; to drain the queue, so we do it immediately.
+VRAMQUEUECLOSE:
+    LD A, (rLCDC)
+    BIT 7, A
+    JR Z, VRAMQUEUEFLUSH
+    EI
+    RET
+
+; ------------------------------------------------------------------------------
+; VRAMQUEUEPUT
+;  In : DE destination (VRAM), HL source, C length
+;  Out: -
+; ------------------------------------------------------------------------------
+VRAMQUEUEPUT:
+    LD A, C
+    CP 0
+    RET Z
+    CP VRAMQUEUEMAXLEN+1
+    JR NC, VRAMQUEUEPUTDIRECT
+    PUSH BC
+    PUSH DE
+    PUSH HL
+    CALL VRAMQUEUEOPEN
+    POP DE
+    PUSH DE
+VRAMQUEUEPUTL1:
+    LD A, (DE)
+    INC DE
+    LD (HL+), A
+    DEC C
+    JR NZ, VRAMQUEUEPUTL1
+    CALL VRAMQUEUECLOSE
+    POP HL
+    POP DE
+    POP BC
+    RET
+
+    ; Too long to be done in a single VBlank: write it directly.
+VRAMQUEUEPUTDIRECT:
+    CALL VRAMQUEUEFLUSH
+    PUSH BC
+    PUSH DE
+    PUSH HL
+VRAMQUEUEPUTDIRECTL1:
+    CALL WAITSTATE
+    LD A, (HL+)
+    LD (DE), A
+    INC DE
+    DEC C
+    JR NZ, VRAMQUEUEPUTDIRECTL1
+    POP HL
+    POP DE
+    POP BC
+    RET
+
+; ------------------------------------------------------------------------------
+; VRAMQUEUEPUTBYTE
+;  In : HL destination (VRAM), C value
+;  Out: -
+; ------------------------------------------------------------------------------
+VRAMQUEUEPUTBYTE:
+    PUSH BC
+    PUSH DE
+    PUSH HL
+    LD D, H
+    LD E, L
+    LD B, C
+    LD C, 1
+    CALL VRAMQUEUEOPEN
+    LD A, B
+    LD (HL), A
+    CALL VRAMQUEUECLOSE
+    POP HL
+    POP DE
+    POP BC
+    RET
+
 IRQSVC:
+    PUSH AF
+    LD A, SHADOWOAM/256
+    CALL _HRAM
+    PUSH BC
+    PUSH DE
+    PUSH HL
+    CALL VRAMQUEUEDRAIN
+    POP HL
+    POP DE
+    POP BC
+    POP AF
     PUSH HL
     LD HL,(GBTIMER)
     INC HL
@@ -1051,10 +1308,11 @@ GBSTARTUP:
     LD ($FF48), A
     LD ($FF49), A
 
-    LD HL, $FE00
+    ; Hide all the sprites, and put the routine for OAM DMA into HRAM.
+
+    LD HL, SHADOWOAM
     LD C, 40
 GBSTARTUPL1:
-    CALL WAITSTATEM0
     LD A, 255
     LD (HL), A
     INC HL
@@ -1069,6 +1327,16 @@ GBSTARTUPL1:
     DEC C
     JR NZ, GBSTARTUPL1
 
+    LD HL, OAMDMA
+    LD DE, _HRAM
+    LD C, OAMDMAEND - OAMDMA
+GBSTARTUPL2:
+    LD A, (HL+)
+    LD (DE), A
+    INC DE
+    DEC C
+    JR NZ, GBSTARTUPL2
+
     LD A, (rLCDC)
     OR $02
     LD (rLCDC), A
@@ -1092,6 +1360,8 @@ GBSTARTUPL1:
     LD (HL), A
     LD HL, GBJIFFIES
     LD (HL), A
+    INC HL
+    LD (HL), A
     LD A, $77
     LD (rAUDVOL), A
     LD A, $FF
@@ -57,11 +57,7 @@ WRITECHAR:
     LD E,A
     ADD HL,DE
 
-    CALL WAITSTATE
-
-    LD A, C
-    LD (HL), A
-    RET
+    JP VRAMQUEUEPUTBYTE
 
 ; Read a char from the text buffer to print.
 ; Input: DE - pointer to the string to print
@@ -36,6 +36,8 @@
 ;* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
 
 VSCROLLTDOWN:
+
+    CALL VRAMQUEUEFLUSH
     
     LD A, (CONSOLEW)
     LD B, A
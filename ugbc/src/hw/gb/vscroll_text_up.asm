@@ -37,6 +37,8 @@
 
 VSCROLLTUP:
 
+    CALL VRAMQUEUEFLUSH
+
     LD A, (CONSOLEW)
     LD B, A
     LD A, 32
@@ -43,6 +43,10 @@ CLSG
 CLSGX
     PSHS A,B,X,Y,U
 
+@IF printCache && deployed.textAtGraphic
+    JSR TEXTATBMSHADOWRESET
+@ENDIF
+
     LDB _PAPER
     JSR GIMESELECTPALETTE
     STA <PLOTC
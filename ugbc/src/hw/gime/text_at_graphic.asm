@@ -38,6 +38,34 @@
 TEXTATBMDRAWCHAR
     PSHS D, X, Y, U, CC
 
+@IF printCache
+
+    ; If the same character has already been drawn on this cell, with
+    ; the same pen, there is nothing to draw. This makes fields that 
+    ; are printed again and again (like scores) cost only for the 
+    ; characters that changed.
+
+    PSHS A
+    LDA <YCURSYS
+    LDB CURRENTTILESWIDTH
+    MUL
+    ADDB <XCURSYS
+    ADCA #0
+    LSLB
+    ROLA
+    ADDD #TEXTATBMSHADOW
+    TFR D, U
+    PULS A
+    LDB <PLOTC
+    CMPD , U
+    BNE TEXTATBMDRAWCHARMISS
+    PULS D, X, Y, U, CC
+    RTS
+TEXTATBMDRAWCHARMISS
+    STD , U
+
+@ENDIF
+
     ; The PRINT primitive should have control if it is necessary to bank 
     ; in the RAM and, if necessary, to differentiate the drawing logic.
     ; However, since the font is probably in the screen segment,
@@ -72,170 +100,105 @@ TEXTATBMDRAWCHAR
     PULS D, X, Y, U, CC
     RTS
 
+    ; In 16 colors mode every pixel of the font takes a nibble, so each
+    ; row of the glyph fills four bytes. Every nibble of the row is 
+    ; expanded to a mask of two bytes by a table, and the mask selects 
+    ; the pen color, already repeated on both the nibbles of the byte.
+
 TEXTATBMDRAWCHARB16
+    LDA <PLOTC
+    LSLA
+    LSLA
+    LSLA
+    LSLA
+    ORA <PLOTC
+    STA TEXTATBMPATTERN
+
     LDA CURRENTTILESWIDTH
-    LDB #2
+    LDB #4
     MUL
+    STB TEXTATBMSTRIDE
 
-    LDU #8
+    LDU #TEXTATBMREMAP16
+    LDA #8
+    STA TEXTATBMCOUNT
 TEXTATBMDRAWCHARB16L1
     JSR GIMEBANKROM
     LDA , Y+
     JSR GIMEBANKVIDEO
 
-    LEAX 3, X
-
-    PSHS U, D
-    LDU #2
-    LDB #0
-    STB , X
-    LDB <PLOTC
-TEXTATBMDRAWCHARB16L1A
+    PSHS A
     LSRA
-    BCC TEXTATBMDRAWCHARB16L1A0
-    ORB , X
-    STB , X
-TEXTATBMDRAWCHARB16L1A0
-    LSLB
-    LSLB
-    LSLB
-    LSLB
-    LEAU -1, U
-    CMPU #0
-    BNE TEXTATBMDRAWCHARB16L1A
-    PULS U
-
-    LEAX -1, X
-
-    PSHS U
-    LDB #0
-    STB , X
-    LDB <PLOTC
-    LDU #2
-TEXTATBMDRAWCHARB16L1B
     LSRA
-    BCC TEXTATBMDRAWCHARB16L1B0
-    ORB , X
-    STB , X
-TEXTATBMDRAWCHARB16L1B0
-    LSLB
-    LSLB
-    LSLB
-    LSLB
-    LEAU -1, U
-    CMPU #0
-    BNE TEXTATBMDRAWCHARB16L1B
-    PULS U
-
-    LEAX -1, X
-
-    PSHS U
-    LDB #0
-    STB , X
-    LDB <PLOTC
-    LDU #2
-TEXTATBMDRAWCHARB16L1C
-    LSRA
-    BCC TEXTATBMDRAWCHARB16L1C0
-    ORB , X
-    STB , X
-TEXTATBMDRAWCHARB16L1C0
-    LSLB
-    LSLB
-    LSLB
-    LSLB
-    LEAU -1, U
-    CMPU #0
-    BNE TEXTATBMDRAWCHARB16L1C
-    PULS U
-
-    LEAX -1, X
-
-    PSHS U
-    LDB #0
-    STB , X
-    LDB <PLOTC
-    LDU #2
-TEXTATBMDRAWCHARB16L1D
     LSRA
-    BCC TEXTATBMDRAWCHARB16L1D0
-    ORB , X
-    STB , X
-TEXTATBMDRAWCHARB16L1D0
-    LSLB
-    LSLB
-    LSLB
-    LSLB
-    LEAU -1, U
-    CMPU #0
-    BNE TEXTATBMDRAWCHARB16L1D
-    PULS D, U
-
-    LEAX B, X
-    LEAX B, X
-    LEAU -1, U
-    CMPU #0
-    LBNE TEXTATBMDRAWCHARB16L1
+    ANDA #$1E
+    LDD A, U
+    ANDA TEXTATBMPATTERN
+    ANDB TEXTATBMPATTERN
+    STD , X
+    PULS A
+    ANDA #$0F
+    LSLA
+    LDD A, U
+    ANDA TEXTATBMPATTERN
+    ANDB TEXTATBMPATTERN
+    STD 2, X
+
+    LDB TEXTATBMSTRIDE
+    ABX
+    DEC TEXTATBMCOUNT
+    BNE TEXTATBMDRAWCHARB16L1
 
     JSR GIMEBANKROM
 
     PULS D, X, Y, U, CC
     RTS
 
+    ; In 4 colors mode every pixel of the font takes two bits, so each
+    ; row of the glyph fills two bytes. Every nibble of the row is 
+    ; expanded to a mask of one byte by a table.
+
 TEXTATBMDRAWCHARB4
+    LDA <PLOTC
+    LSLA
+    LSLA
+    ORA <PLOTC
+    LSLA
+    LSLA
+    ORA <PLOTC
+    LSLA
+    LSLA
+    ORA <PLOTC
+    STA TEXTATBMPATTERN
+
     LDA CURRENTTILESWIDTH
     LDB #2
     MUL
+    STB TEXTATBMSTRIDE
 
-    LDU #8
+    LDU #TEXTATBMREMAP4
+    LDA #8
+    STA TEXTATBMCOUNT
 TEXTATBMDRAWCHARB4L1
     JSR GIMEBANKROM
     LDA , Y+
     JSR GIMEBANKVIDEO
 
-    LEAX 1, X
-
-    PSHS U, D
-    LDU #4
-    LDB #0
-    STB , X
-    LDB <PLOTC
-TEXTATBMDRAWCHARB4L2
+    TFR A, B
     LSRA
-    BCC TEXTATBMDRAWCHARB4L10
-    ORB , X
-    STB , X
-TEXTATBMDRAWCHARB4L10    
-    LSLB
-    LSLB
-    LEAU -1, U
-    CMPU #0
-    BNE TEXTATBMDRAWCHARB4L2
-    PULS U
-
-    LEAX -1, X
-
-    PSHS U
-    LDB #0
-    STB , X
-    LDB <PLOTC
-    LDU #4
-TEXTATBMDRAWCHARB4L2B
     LSRA
-    BCC TEXTATBMDRAWCHARB4L10C
-    ORB , X
-    STB , X
-TEXTATBMDRAWCHARB4L10C
-    LSLB
-    LSLB
-    LEAU -1, U
-    CMPU #0
-    BNE TEXTATBMDRAWCHARB4L2B
-    PULS D, U
-
-    LEAX B, X
-    LEAU -1, U
-    CMPU #0
+    LSRA
+    LSRA
+    ANDB #$0F
+    LDA A, U
+    LDB B, U
+    ANDA TEXTATBMPATTERN
+    ANDB TEXTATBMPATTERN
+    STD , X
+
+    LDB TEXTATBMSTRIDE
+    ABX
+    DEC TEXTATBMCOUNT
     BNE TEXTATBMDRAWCHARB4L1
 
     JSR GIMEBANKROM
@@ -701,3 +664,35 @@ TEXTATBMEND2
 TEXTATFLIP
     fcb $0, $8, $4, $c, $2, $a, $6, $e
     fcb $1, $9, $5, $d, $3, $b, $7, $f
+
+TEXTATBMPATTERN fcb $0
+TEXTATBMSTRIDE fcb $0
+TEXTATBMCOUNT fcb $0
+
+TEXTATBMREMAP4
+    fcb $00, $03, $0c, $0f, $30, $33, $3c, $3f
+    fcb $c0, $c3, $cc, $cf, $f0, $f3, $fc, $ff
+
+TEXTATBMREMAP16
+    fdb $0000, $000f, $00f0, $00ff, $0f00, $0f0f, $0ff0, $0fff
+    fdb $f000, $f00f, $f0f0, $f0ff, $ff00, $ff0f, $fff0, $ffff
+
+@IF printCache
+
+; Characters (and pens) drawn on each cell of the screen (PRINT CACHE).
+; A cell is empty when it is zero, since control codes are never drawn.
+
+TEXTATBMSHADOW rzb 80*28*2
+
+TEXTATBMSHADOWRESET
+    PSHS D, X
+    LDX #TEXTATBMSHADOW
+    LDD #0
+TEXTATBMSHADOWRESETL1
+    STD , X++
+    CMPX #(TEXTATBMSHADOW+80*28*2)
+    BNE TEXTATBMSHADOWRESETL1
+    PULS D, X
+    RTS
+
+@ENDIF
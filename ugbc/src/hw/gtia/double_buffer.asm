@@ -0,0 +1,100 @@
+; /*****************************************************************************
+;  * ugBASIC - an isomorphic BASIC language compiler for retrocomputers        *
+;  *****************************************************************************
+;  * Copyright 2021-2025 Marco Spedaletti (asimov@mclink.it)
+;  *
+;  * Licensed under the Apache License, Version 2.0 (the "License");
+;  * you may not use this file except in compliance with the License.
+;  * You may obtain a copy of the License at
+;  *
+;  * http://www.apache.org/licenses/LICENSE-2.0
+;  *
+;  * Unless required by applicable law or agreed to in writing, software
+;  * distributed under the License is distributed on an "AS IS" BASIS,
+;  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+;  * See the License for the specific language governing permissions and
+;  * limitations under the License.
+;  *----------------------------------------------------------------------------
+;  * Concesso in licenza secondo i termini della Licenza Apache, versione 2.0
+;  * (la "Licenza"); è proibito usare questo file se non in conformità alla
+;  * Licenza. Una copia della Licenza è disponibile all'indirizzo:
+;  *
+;  * http://www.apache.org/licenses/LICENSE-2.0
+;  *
+;  * Se non richiesto dalla legislazione vigente o concordato per iscritto,
+;  * il software distribuito nei termini della Licenza è distribuito
+;  * "COSì COM'è", SENZA GARANZIE O CONDIZIONI DI ALCUN TIPO, esplicite o
+;  * implicite. Consultare la Licenza per il testo specifico che regola le
+;  * autorizzazioni e le limitazioni previste dalla medesima.
+;  ****************************************************************************/
+;* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+;*                                                                             *
+;*                       DOUBLE BUFFER ROUTINE ON GTIA                         *
+;*                                                                             *
+;*                             by Marco Spedaletti                             *
+;*                                                                             *
+;* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+; The double buffer is done on text modes only, by changing the address of
+; the LMS instruction of the display list. The two screens are 1 KB each,
+; and they are reserved by the compiler at DOUBLEBUFFERBASE (2 KB aligned), 
+; below the frame buffer. The visible screen is the one pointed by the LMS,
+; while TEXTADDRESS points to the hidden one, where all the drawing goes.
+
+DOUBLEBUFFERBASE:   .BYTE 0
+
+DOUBLEBUFFERINIT:
+    STA DOUBLEBUFFERBASE
+    LDA CURRENTMODE
+    CMP #8
+    BCS DOUBLEBUFFERX
+    JMP DOUBLEBUFFERHIDDEN
+
+DOUBLEBUFFERCLEANUP:
+    LDA CURRENTMODE
+    CMP #8
+    BCS DOUBLEBUFFERX
+    LDA DLI+4
+    STA TEXTADDRESS
+    LDA DLI+5
+    STA TEXTADDRESS+1
+DOUBLEBUFFERX:
+    RTS
+
+; Show the hidden screen (at the next vertical blank) and make the other
+; screen of the pair the hidden one.
+
+SWITCHSCREEN:
+    LDA CURRENTMODE
+    CMP #8
+    BCS DOUBLEBUFFERX
+    JSR VBL
+    LDA TEXTADDRESS
+    STA DLI+4
+    LDA TEXTADDRESS+1
+    STA DLI+5
+
+; The hidden screen is the one of the pair that is not visible (the visible
+; one could also be outside of the pair, after a SCREEN MODE), and it starts
+; with the same content of the visible one.
+
+DOUBLEBUFFERHIDDEN:
+    LDA DLI+4
+    STA TMPPTR
+    LDA DLI+5
+    STA TMPPTR+1
+    LDA #0
+    STA TEXTADDRESS
+    STA TMPPTR2
+    LDA DOUBLEBUFFERBASE
+    CMP TMPPTR+1
+    BNE DOUBLEBUFFERHIDDEN2
+    ORA #$04
+DOUBLEBUFFERHIDDEN2:
+    STA TEXTADDRESS+1
+    STA TMPPTR2+1
+    LDA #<960
+    STA MATHPTR0
+    LDA #>960
+    STA MATHPTR0+1
+    JMP CPUMEMMOVE
@@ -65,6 +65,9 @@ VDPLOOPDQ0:
     RET
 
 ISRSVC:
+@IF screenCache
+    CALL VDPSHADOWFLUSH
+@ENDIF
 @IF deployed.ay8910startup
 	CALL AY8910MANAGER
 @ENDIF
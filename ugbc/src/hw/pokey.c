@@ -698,6 +698,90 @@ void pokey_wait_duration_vars( Environment * _environment, char * _channels ) {
 
 }
 
+/**
+ * @brief Queue a sound effect, without waiting for its end.
+ * 
+ * The note is given to the timer manager, that plays it on the given
+ * channels as soon as they are free (or immediately, if the note has
+ * a higher priority than the one currently playing). The channels are
+ * taken from the music until the note is over. The code waits only if
+ * the queue of one of the channels is already full.
+ * 
+ * @param _environment Current calling environment
+ * @param _channels channels to play on
+ * @param _frequency frequency to play
+ * @param _duration duration (in jiffies)
+ * @param _priority priority (1...255)
+ */
+void pokey_queue_sound( Environment * _environment, int _channels, int _frequency, int _duration, int _priority ) {
+
+    deploy( pokeyvars, src_hw_pokey_vars_asm );
+    deploy( pokeystartup, src_hw_pokey_startup_asm );
+
+    MAKE_LABEL
+
+    int pitch = _frequency;
+
+    if ( _duration < 1 ) {
+        _duration = 1;
+    } else if ( _duration > 255 ) {
+        _duration = 255;
+    }
+
+    outline1("%s:", label );
+    outline0("SEI");
+    outline1("LDA #$%2.2x", ( pitch & 0xff ) );
+    outline0("STA POKEYSFXPITCH");
+    outline1("LDA #$%2.2x", ( ( pitch >> 8 ) & 0xff ) );
+    outline0("STA POKEYSFXPITCH+1");
+    outline1("LDA #$%2.2x", _duration );
+    outline0("STA POKEYSFXDURATION");
+    outline1("LDA #$%2.2x", ( _priority & 0xff ) );
+    outline0("STA POKEYSFXPRI");
+    outline1("LDA #$%2.2x", ( _channels & 0x0f ) );
+    outline0("JSR POKEYSFXPUSH");
+    outline0("CLI");
+    outline1("BCS %s", label );
+
+}
+
+void pokey_queue_sound_vars( Environment * _environment, char * _channels, char * _frequency, char * _duration, int _priority ) {
+
+    deploy( pokeyvars, src_hw_pokey_vars_asm );
+    deploy( pokeystartup, src_hw_pokey_startup_asm );
+
+    MAKE_LABEL
+
+    outline1("%sretry:", label );
+    outline0("SEI");
+    outline1("LDX %s", _frequency );
+    outline1("LDY %s", address_displacement(_environment, _frequency, "1") );
+    outline0("JSR POKEYCALCFREQ");
+    outline0("STX POKEYSFXPITCH");
+    outline0("STY POKEYSFXPITCH+1");
+    outline1("LDA %s", address_displacement(_environment, _duration, "1") );
+    outline1("BEQ %slo", label );
+    outline0("LDA #$ff");
+    outline1("BNE %sdone", label );
+    outline1("%slo:", label );
+    outline1("LDA %s", _duration );
+    outline1("BNE %sdone", label );
+    outline0("LDA #$1");
+    outline1("%sdone:", label );
+    outline0("STA POKEYSFXDURATION");
+    outline1("LDA #$%2.2x", ( _priority & 0xff ) );
+    outline0("STA POKEYSFXPRI");
+    if ( _channels ) {
+        outline1("LDA %s", _channels );
+    } else {
+        outline1("LDA #$%1.1x", 0x0f );
+    }
+    outline0("JSR POKEYSFXPUSH");
+    outline0("CLI");
+    outline1("BCS %sretry", label );
+
+}
+
 void pokey_set_note_vars( Environment * _environment, char * _channels, char * _note ) {
 
     deploy( pokeyvars, src_hw_pokey_vars_asm );
@@ -57,6 +57,8 @@ void pokey_set_note_vars( Environment * _environment, char * _channel, char * _n
 void pokey_stop_vars( Environment * _environment, char * _channel );
 void pokey_set_duration_vars( Environment * _environment, char * _channel, char * _duration );
 void pokey_wait_duration_vars( Environment * _environment, char * _channel );
+void pokey_queue_sound( Environment * _environment, int _channels, int _frequency, int _duration, int _priority );
+void pokey_queue_sound_vars( Environment * _environment, char * _channels, char * _frequency, char * _duration, int _priority );
 
 void pokey_music( Environment * _environment, char * _music, int _size, int _loop );
 
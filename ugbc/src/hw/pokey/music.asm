@@ -46,6 +46,12 @@ POKEYBLOCKS_BACKUP: .word $0
 POKEYLASTBLOCK_BACKUP: .byte $0
 POKEYTMPPTR_BACKUP: .word $0
 
+POKEYCALLCOUNT: .byte $0
+POKEYCALLOFS: .word $0
+POKEYRETPTR: .word $0
+POKEYRETOFS: .byte $0
+POKEYRETBLOCKS: .byte $0
+
 POKEYTMPOFS: .byte $00
 POKEYTMPLEN: .byte $00
 
@@ -53,7 +59,9 @@ MUSICPLAYERRESET:
     SEI
     LDA #$0
     STA POKEYJIFFIES
+    STA POKEYJIFFIES+1
     STA POKEYTMPOFS
+    STA POKEYCALLCOUNT
     LDA #$1
     STA POKEYMUSICREADY
     LDA POKEYTMPPTR_BACKUP
@@ -64,13 +72,6 @@ MUSICPLAYERRESET:
     STA POKEYLASTBLOCK
     LDA POKEYBLOCKS_BACKUP
     STA POKEYBLOCKS
-    BEQ MUSICPLAYERRESET3
-    LDA #$FF
-    JMP MUSICPLAYERRESET2
-MUSICPLAYERRESET3:
-    LDA POKEYLASTBLOCK_BACKUP
-MUSICPLAYERRESET2:
-    STA POKEYTMPLEN
     CLI
     RTS
 
@@ -106,7 +107,11 @@ MUSICPLAYERR:
 ; are exausted.
 MUSICPLAYERL1:
     LDA POKEYJIFFIES
+    BNE MUSICPLAYERL1A
+    LDA POKEYJIFFIES+1
     BEQ MUSICPLAYERL1B
+    DEC POKEYJIFFIES+1
+MUSICPLAYERL1A:
     DEC POKEYJIFFIES
     RTS
 
@@ -120,11 +125,13 @@ MUSICPLAYERL1B:
     BNE MUSICPLAYERL1X
 
     ; Let's stop the play!
+MUSICPLAYEREND:
     LDA #$0
     STA POKEYMUSICREADY
     STA POKEYTMPPTR
     STA POKEYTMPPTR+1
     STA POKEYJIFFIES
+    STA POKEYJIFFIES+1
     RTS
 
 ; This is the entry point to decode the instruction
@@ -146,13 +153,97 @@ MUSICPLAYERL1X3:
     BCS MUSICPLAYERL1X2
     JMP MUSICNOTEOFF
 MUSICPLAYERL1X2:
+    ; 1111xxxx: extended instructions (IMF version 2).
+    BNE MUSICPLAYERL1X4
+    JMP MUSICLONGWAIT
+MUSICPLAYERL1X4:
+    CMP #$C0
+    BNE MUSICPLAYERL1X5
+    JMP MUSICPATTERNCALL
+MUSICPLAYERL1X5:
+    CMP #$D0
+    BNE MUSICPLAYERL1X6
+    JMP MUSICPATTERNRETURN
+MUSICPLAYERL1X6:
+    CMP #$E0
+    BNE MUSICPLAYERL1X7
+    JMP MUSICPLAYEREND
+MUSICPLAYERL1X7:
     RTS
 
 MUSICWAIT:
     LSR
     STA POKEYJIFFIES
+    LDA #$0
+    STA POKEYJIFFIES+1
+    RTS
+
+; LONG WAIT: the next two bytes are the delay (in jiffies).
+MUSICLONGWAIT:
+    JSR MUSICREADNEXTBYTE
+    STA POKEYJIFFIES
+    JSR MUSICREADNEXTBYTE
+    STA POKEYJIFFIES+1
     RTS
 
+; CALL: play the pattern at the given offset of the stream,
+; for the given number of times, then come back here.
+MUSICPATTERNCALL:
+    JSR MUSICREADNEXTBYTE
+    STA POKEYCALLCOUNT
+    JSR MUSICREADNEXTBYTE
+    STA POKEYCALLOFS
+    JSR MUSICREADNEXTBYTE
+    STA POKEYCALLOFS+1
+
+    ; Save the reading position, to resume from it
+    ; when the pattern is over.
+    LDA POKEYTMPPTR
+    STA POKEYRETPTR
+    LDA POKEYTMPPTR+1
+    STA POKEYRETPTR+1
+    LDA POKEYTMPOFS
+    STA POKEYRETOFS
+    LDA POKEYBLOCKS
+    STA POKEYRETBLOCKS
+
+; Move the reading position to the start of the pattern.
+; Since blocks are 256 bytes long, the high byte of the
+; offset is the number of blocks to skip, and the low
+; byte is the offset inside that block.
+MUSICPATTERNSEEK:
+    LDA POKEYTMPPTR_BACKUP
+    STA POKEYTMPPTR
+    LDA POKEYTMPPTR_BACKUP+1
+    CLC
+    ADC POKEYCALLOFS+1
+    STA POKEYTMPPTR+1
+    LDA POKEYBLOCKS_BACKUP
+    SEC
+    SBC POKEYCALLOFS+1
+    STA POKEYBLOCKS
+    LDA POKEYCALLOFS
+    STA POKEYTMPOFS
+    JMP MUSICPLAYERL1B
+
+; RETURN: the pattern is over. Repeat it, or resume
+; the reading from the saved position.
+MUSICPATTERNRETURN:
+    LDA POKEYCALLCOUNT
+    BEQ MUSICPATTERNRETURN2
+    DEC POKEYCALLCOUNT
+    BNE MUSICPATTERNSEEK
+    LDA POKEYRETPTR
+    STA POKEYTMPPTR
+    LDA POKEYRETPTR+1
+    STA POKEYTMPPTR+1
+    LDA POKEYRETOFS
+    STA POKEYTMPOFS
+    LDA POKEYRETBLOCKS
+    STA POKEYBLOCKS
+MUSICPATTERNRETURN2:
+    JMP MUSICPLAYERL1B
+
 MUSICSETPROGRAM:
     PHA
     JSR MUSICREADNEXTBYTE
@@ -164,6 +255,7 @@ MUSICNOTEOFF:
     LSR
     LSR
     LSR
+    JSR MUSICSFXFILTER
     JSR POKEYSTOP
     RTS    
 
@@ -171,6 +263,7 @@ MUSICNOTEON:
     LSR
     LSR
     LSR
+    JSR MUSICSFXFILTER
     PHA
     JSR MUSICREADNEXTBYTE
     ASL
@@ -197,60 +290,41 @@ MUSICNOTEON:
     JSR POKEYPROGDIST
     RTS
 
+; The channels taken by a sound effect are not touched
+; by the music, until the effect is over.
+MUSICSFXFILTER:
+    STA POKEYSFXTMP
+    LDA POKEYSFXMASK
+    EOR #$FF
+    AND POKEYSFXTMP
+    RTS
+
 ; This routine has been added in order to read the
-; next byte in a "blocked" byte stream.
+; next byte in a "blocked" byte stream. Every block is
+; 256 bytes long, except the last one (POKEYLASTBLOCK bytes).
 MUSICREADNEXTBYTE:
-    ; Let's check if we arrived at the end of the block.
-    ; In that case, we must "load" the next block (or end
-    ; the reading).
+    ; Let's check if we arrived at the end of the last
+    ; block. In that case, the reading is over.
     LDY POKEYTMPOFS
-    CPY POKEYTMPLEN
-    BEQ MUSICREADNEXTBYTELE
+    LDA POKEYBLOCKS
+    BNE MUSICREADNEXTBYTE2
+    CPY POKEYLASTBLOCK
+    BEQ MUSICREADNEXTBYTEEND
 
 MUSICREADNEXTBYTE2:
     LDX #$ff
     LDA (POKEYTMPPTR), Y
     INY
     STY POKEYTMPOFS
-    RTS
-
-; This is the entry point if a block (256 or less bytes)
-; is finished, and we must move forward to the next block.
-MUSICREADNEXTBYTELE:
-    ; Is file finished?
-    LDA POKEYBLOCKS
-    BEQ MUSICREADNEXTBYTEEND
+    BNE MUSICREADNEXTBYTE3
 
-    ; Increment the base address by 256
+    ; The block (256 bytes) is finished, so we must move 
+    ; forward to the next block.
     INC POKEYTMPPTR+1
-
-    ; Decrement the number of remaining blocks
     DEC POKEYBLOCKS
 
-    ; If remaining blocks are 0, the last block
-    ; length is different from 256 bytes.
-    BEQ MUSICPLAYERLE2
-
-    ; Remaining block is 256 bytes lenght.
-    LDY #$FF
-    STY POKEYTMPLEN
-
-    ; Put the index to 0
-    LDY #$0
-    STY POKEYTMPOFS
-
-    JMP MUSICREADNEXTBYTE2
-
-    ; Remaining block is <256 bytes lenght.
-MUSICPLAYERLE2:
-    LDY POKEYLASTBLOCK
-    STY POKEYTMPLEN
-
-    ; Put the index to 0
-    LDY #$0
-    STY POKEYTMPOFS
-
-    JMP MUSICREADNEXTBYTE2
+MUSICREADNEXTBYTE3:
+    RTS
 
 MUSICREADNEXTBYTEEND:
     LDX #$0
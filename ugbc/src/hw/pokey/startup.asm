@@ -590,19 +590,27 @@ POKEYSTART3:
 POKEYSTOP:
     LSR
     BCC POKEYSTOP0X
+    PHA
     JSR POKEYSTOP0
+    PLA
 POKEYSTOP0X:
     LSR
     BCC POKEYSTOP1X
+    PHA
     JSR POKEYSTOP1
+    PLA
 POKEYSTOP1X:
     LSR
     BCC POKEYSTOP2X
+    PHA
     JSR POKEYSTOP2
+    PLA
 POKEYSTOP2X:
     LSR
     BCC POKEYSTOP3X
+    PHA
     JSR POKEYSTOP3
+    PLA
 POKEYSTOP3X:
     RTS
 
@@ -634,31 +642,162 @@ POKEYSTOP3:
     STA POKEYAUDC3
     RTS
 
+; Timer manager: when the duration of a channel expires, the next
+; queued note is played (if any). Otherwise the note is stopped, and
+; the channel is given back to the music.
 POKEYTIMERMANAGER:
     PHA
-    LDA POKEYTIMER
-    BEQ POKEYTIMERMANAGER0
-    DEC POKEYTIMER
-    BNE POKEYTIMERMANAGER0
-    JSR POKEYSTOP0
-POKEYTIMERMANAGER0:
-    LDA POKEYTIMER+1
-    BEQ POKEYTIMERMANAGER1
-    DEC POKEYTIMER+1
-    BNE POKEYTIMERMANAGER1
-    JSR POKEYSTOP1
-POKEYTIMERMANAGER1:
-    LDA POKEYTIMER+2
-    BEQ POKEYTIMERMANAGER2
-    DEC POKEYTIMER+2
-    BNE POKEYTIMERMANAGER2
-    JSR POKEYSTOP2
-POKEYTIMERMANAGER2:
-    LDA POKEYTIMER+3
-    BEQ POKEYTIMERMANAGER3
-    DEC POKEYTIMER+3
-    BNE POKEYTIMERMANAGER3
-    JSR POKEYSTOP3
-POKEYTIMERMANAGER3:
+    TXA
+    PHA
+    TYA
+    PHA
+    LDX #$0
+POKEYTIMERMANAGERL1:
+    LDA POKEYTIMER, X
+    BEQ POKEYTIMERMANAGERL2
+    DEC POKEYTIMER, X
+    BNE POKEYTIMERMANAGERL2
+    JSR POKEYSFXNEXT
+POKEYTIMERMANAGERL2:
+    INX
+    CPX #$4
+    BNE POKEYTIMERMANAGERL1
     PLA
+    TAY
+    PLA
+    TAX
+    PLA
+    RTS
+
+; Queue a note on the channels in A. The note is described by
+; POKEYSFXPITCH, POKEYSFXDURATION and POKEYSFXPRI. It must be called
+; with interrupts disabled. If the queue of one of the channels is
+; full, nothing is queued and the carry is set: the caller should
+; enable the interrupts and try again.
+POKEYSFXPUSH:
+    STA POKEYSFXCHANNELS
+    LDX #$0
+POKEYSFXPUSHC1:
+    LSR
+    BCC POKEYSFXPUSHC3
+    PHA
+    LDA POKEYSFXPRIORITY, X
+    CMP POKEYSFXPRI
+    BNE POKEYSFXPUSHC2
+    LDA POKEYSFXCOUNT, X
+    CMP #$4
+    BCC POKEYSFXPUSHC2
+    PLA
+    SEC
+    RTS
+POKEYSFXPUSHC2:
+    PLA
+POKEYSFXPUSHC3:
+    INX
+    CPX #$4
+    BNE POKEYSFXPUSHC1
+    LDA POKEYSFXCHANNELS
+    LDX #$0
+POKEYSFXPUSHL1:
+    LSR
+    BCC POKEYSFXPUSHL2
+    PHA
+    JSR POKEYSFXPUSHCHANNEL
+    PLA
+POKEYSFXPUSHL2:
+    INX
+    CPX #$4
+    BNE POKEYSFXPUSHL1
+    CLC
+    RTS
+
+; Queue a note on the channel X. A note with a lower priority than
+; the effect playing on the channel is dropped, while a note with a 
+; higher priority replaces it (and its queue).
+POKEYSFXPUSHCHANNEL:
+    LDA POKEYSFXPRIORITY, X
+    BEQ POKEYSFXPUSHCHANNELPLAY
+    CMP POKEYSFXPRI
+    BEQ POKEYSFXPUSHCHANNELQUEUE
+    BCC POKEYSFXPUSHCHANNELPLAY
+    RTS
+POKEYSFXPUSHCHANNELQUEUE:
+    LDA POKEYSFXCOUNT, X
+    CMP #$4
+    BCS POKEYSFXPUSHCHANNELDONE
+    CLC
+    ADC POKEYSFXHEAD, X
+    AND #$3
+    STA POKEYSFXTMP
+    TXA
+    ASL
+    ASL
+    ORA POKEYSFXTMP
+    TAY
+    LDA POKEYSFXPITCH
+    STA POKEYSFXQPITCHLO, Y
+    LDA POKEYSFXPITCH+1
+    STA POKEYSFXQPITCHHI, Y
+    LDA POKEYSFXDURATION
+    STA POKEYSFXQDURATION, Y
+    INC POKEYSFXCOUNT, X
+POKEYSFXPUSHCHANNELDONE:
+    RTS
+POKEYSFXPUSHCHANNELPLAY:
+    LDA #$0
+    STA POKEYSFXCOUNT, X
+    LDA POKEYSFXPRI
+    STA POKEYSFXPRIORITY, X
+    JMP POKEYSFXPLAY
+
+; Play the next queued note on the channel X or, if there are no
+; more notes, stop it and give it back to the music.
+POKEYSFXNEXT:
+    LDA POKEYSFXCOUNT, X
+    BEQ POKEYSFXNEXTRELEASE
+    DEC POKEYSFXCOUNT, X
+    TXA
+    ASL
+    ASL
+    ORA POKEYSFXHEAD, X
+    TAY
+    LDA POKEYSFXHEAD, X
+    CLC
+    ADC #$1
+    AND #$3
+    STA POKEYSFXHEAD, X
+    LDA POKEYSFXQPITCHLO, Y
+    STA POKEYSFXPITCH
+    LDA POKEYSFXQPITCHHI, Y
+    STA POKEYSFXPITCH+1
+    LDA POKEYSFXQDURATION, Y
+    STA POKEYSFXDURATION
+    JMP POKEYSFXPLAY
+POKEYSFXNEXTRELEASE:
+    LDA #$0
+    STA POKEYSFXPRIORITY, X
+    LDA POKEYSFXBIT, X
+    EOR #$FF
+    AND POKEYSFXMASK
+    STA POKEYSFXMASK
+    LDA POKEYSFXBIT, X
+    JMP POKEYSTOP
+
+; Play the note in POKEYSFXPITCH for POKEYSFXDURATION jiffies on
+; the channel X, taking the channel from the music.
+POKEYSFXPLAY:
+    LDA POKEYSFXDURATION
+    STA POKEYTIMER, X
+    LDA POKEYSFXBIT, X
+    ORA POKEYSFXMASK
+    STA POKEYSFXMASK
+    STX POKEYSFXTMP
+    LDA POKEYSFXBIT, X
+    LDX POKEYSFXPITCH
+    LDY POKEYSFXPITCH+1
+    JSR POKEYPROGFREQ
+    LDX POKEYSFXTMP
+    LDA POKEYSFXBIT, X
+    JSR POKEYSTART
+    LDX POKEYSFXTMP
     RTS
\ No newline at end of file
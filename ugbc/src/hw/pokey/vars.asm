@@ -52,6 +52,23 @@ POKEYFREQTABLE:
     
 POKEYTIMER: .byte $0, $0, $0, $0
 
+; Sound effects queue. For each channel, the priority of the effect
+; playing on it (0 = the channel belongs to the music) and up to 4 
+; further notes (pitch and duration) waiting to be played.
+POKEYSFXMASK: .byte $0
+POKEYSFXBIT: .byte $1, $2, $4, $8
+POKEYSFXPRIORITY: .byte $0, $0, $0, $0
+POKEYSFXCOUNT: .byte $0, $0, $0, $0
+POKEYSFXHEAD: .byte $0, $0, $0, $0
+POKEYSFXQPITCHLO: .res 16
+POKEYSFXQPITCHHI: .res 16
+POKEYSFXQDURATION: .res 16
+POKEYSFXPITCH: .word $0
+POKEYSFXDURATION: .byte $0
+POKEYSFXPRI: .byte $0
+POKEYSFXTMP: .byte $0
+POKEYSFXCHANNELS: .byte $0
+
 POKEYAUDC0:     .BYTE   $A0
 POKEYAUDC1:     .BYTE   $A0
 POKEYAUDC2:     .BYTE   $A0
@@ -58,6 +58,9 @@ INT_HANDLER2:
     LD HL,(SC3000TIMER)
     INC HL
     LD (SC3000TIMER),HL
+@IF screenCache
+    CALL VDPSHADOWFLUSH
+@ENDIF
 	LD A, (IRQVECTORREADY)
 	CMP 0
 	JR Z, IRQVECTORSKIP
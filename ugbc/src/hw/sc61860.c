@@ -6231,6 +6231,131 @@ void cpu_number_to_string( Environment * _environment, char * _number, char * _s
 
 }
 
+/**
+ * @brief <i>SC616860</i>: emit code to add or subtract two packed BCD values
+ * 
+ * The SC61860 has no decimal adjust for the accumulator, so each digit
+ * is computed apart and brought back in the 0...9 range, propagating
+ * the carry (or the borrow) to the next one.
+ * 
+ * @param _environment Current calling environment
+ * @param _source First value
+ * @param _destination Second value and destination address for result (if _other is NULL)
+ * @param _other Destination address for result
+ * @param _bytes Size of the values (in bytes)
+ * @param _subtract Subtract instead of add
+ */
+static void cpu_bcd_add_sub( Environment * _environment, char *_source, char *_destination, char *_other, int _bytes, int _subtract ) {
+
+    MAKE_LABEL
+
+    Variable * carry = variable_temporary( _environment, VT_BYTE, "(bcd carry)" );
+    Variable * low = variable_temporary( _environment, VT_BYTE, "(bcd low digit)" );
+    Variable * digit = variable_temporary( _environment, VT_BYTE, "(bcd digit)" );
+    Variable * other = variable_temporary( _environment, VT_BYTE, "(bcd other digit)" );
+
+    cpu_store_8bit( _environment, carry->realName, 0 );
+
+    for( int i=_bytes-1; i>=0; --i ) {
+        char offset[MAX_TEMPORARY_STORAGE]; sprintf( offset, "%d", i );
+        for( int high=0; high<2; ++high ) {
+            char skipLabel[MAX_TEMPORARY_STORAGE]; sprintf( skipLabel, "%s%d%c", label, i, high ? 'h' : 'l' );
+            cpu_move_8bit( _environment, address_displacement(_environment, _source, offset), digit->realName );
+            cpu_move_8bit( _environment, address_displacement(_environment, _destination, offset), other->realName );
+            if ( high ) {
+                cpu_math_div2_const_8bit( _environment, digit->realName, 4, 0, NULL );
+                cpu_math_div2_const_8bit( _environment, other->realName, 4, 0, NULL );
+            } else {
+                cpu_math_and_const_8bit( _environment, digit->realName, 0x0f );
+                cpu_math_and_const_8bit( _environment, other->realName, 0x0f );
+            }
+            if ( _subtract ) {
+                cpu_math_sub_8bit( _environment, digit->realName, other->realName, digit->realName );
+                cpu_math_sub_8bit( _environment, digit->realName, carry->realName, digit->realName );
+            } else {
+                cpu_math_add_8bit( _environment, digit->realName, other->realName, digit->realName );
+                cpu_math_add_8bit( _environment, digit->realName, carry->realName, digit->realName );
+            }
+            cpu_store_8bit( _environment, carry->realName, 0 );
+            cpu_less_than_8bit_const( _environment, digit->realName, 10, other->realName, 0, 0 );
+            cpu_compare_and_branch_8bit_const( _environment, other->realName, 0, skipLabel, 0 );
+            cpu_math_add_8bit_const( _environment, digit->realName, _subtract ? 10 : 0xf6, digit->realName );
+            cpu_store_8bit( _environment, carry->realName, 1 );
+            cpu_label( _environment, skipLabel );
+            if ( high ) {
+                cpu_math_mul2_const_8bit( _environment, digit->realName, 4, 0 );
+                cpu_or_8bit( _environment, digit->realName, low->realName, address_displacement(_environment, _other ? _other : _destination, offset) );
+            } else {
+                cpu_move_8bit( _environment, digit->realName, low->realName );
+            }
+        }
+    }
+
+}
+
+/**
+ * @brief <i>SC616860</i>: emit code to add two packed BCD values
+ * 
+ * @param _environment Current calling environment
+ * @param _source First value to add
+ * @param _destination Second value to add and destination address for result (if _other is NULL)
+ * @param _other Destination address for result
+ * @param _bytes Size of the values (in bytes)
+ */
+void cpu_bcd_add( Environment * _environment, char *_source, char *_destination, char *_other, int _bytes ) {
+
+    cpu_bcd_add_sub( _environment, _source, _destination, _other, _bytes, 0 );
+
+}
+
+/**
+ * @brief <i>SC616860</i>: emit code to subtract two packed BCD values
+ * 
+ * @param _environment Current calling environment
+ * @param _source First value
+ * @param _destination Value to subtract and destination address for result (if _other is NULL)
+ * @param _other Destination address for result
+ * @param _bytes Size of the values (in bytes)
+ */
+void cpu_bcd_sub( Environment * _environment, char *_source, char *_destination, char *_other, int _bytes ) {
+
+    cpu_bcd_add_sub( _environment, _source, _destination, _other, _bytes, 1 );
+
+}
+
+/**
+ * @brief <i>SC616860</i>: emit code to convert a packed BCD value into digits
+ * 
+ * @param _environment Current calling environment
+ * @param _bcd Value to convert
+ * @param _string Address of the string to fill (at least 2 * _bytes chars)
+ * @param _string_size Where to store the number of digits
+ * @param _bytes Size of the value (in bytes)
+ */
+void cpu_bcd_to_string( Environment * _environment, char * _bcd, char * _string, char * _string_size, int _bytes ) {
+
+    op_ldy( _environment, _string );
+    for( int i=0; i<_bytes; ++i ) {
+        char offset[MAX_TEMPORARY_STORAGE]; sprintf( offset, "%d", i );
+        op_lda( _environment, address_displacement(_environment, _bcd, offset) );
+        outline0("SWP");
+        op_anda_direct( _environment, 0x0f );
+        outline0("ORIA 0x30");
+        if ( i == 0 ) {
+            op_sta_y( _environment );
+        } else {
+            op_sta_yn( _environment );
+        }
+        op_lda( _environment, address_displacement(_environment, _bcd, offset) );
+        op_anda_direct( _environment, 0x0f );
+        outline0("ORIA 0x30");
+        op_sta_yn( _environment );
+    }
+    op_lda_direct( _environment, _bytes * 2 );
+    op_sta( _environment, _string_size );
+
+}
+
 void cpu_bits_to_string_vars( Environment * _environment ) {
 
     variable_import( _environment, "BINSTRBUF", VT_BUFFER, 32 );
@@ -8860,4 +8985,205 @@ void cpu_float_single_exp( Environment * _environment, char * _value, char * _re
 }
 
 
+static EmbeddedCost cpuEmbeddedCost[] = {
+    { NULL, 0, 0, 0, 0 }
+};
+
+/**
+ * @brief <i>SC61860</i>: return the cost model of a primitive
+ * 
+ * No primitive has both an inline and an embedded version on this CPU,
+ * so the choice is always the one given by the -e option.
+ * 
+ * @param _environment Current calling environment
+ * @param _name Name of the primitive
+ * @return Cost of the primitive, or NULL if it can only be inlined (or called)
+ */
+EmbeddedCost * cpu_embedded_cost( Environment * _environment, char * _name ) {
+
+    int i = 0;
+    while( cpuEmbeddedCost[i].name ) {
+        if ( strcmp( cpuEmbeddedCost[i].name, _name ) == 0 ) {
+            return &cpuEmbeddedCost[i];
+        }
+        ++i;
+    }
+    return NULL;
+
+}
+
+/* The SC61860 has one form for each instruction: timings are approximate
+   and branches are counted as not taken. */
+static InstructionCycles cpuInstructionCycles[] = {
+    { "LII", { 4 }, 0 },
+    { "LIJ", { 4 }, 0 },
+    { "LIA", { 4 }, 0 },
+    { "LIB", { 4 }, 0 },
+    { "LIP", { 4 }, 0 },
+    { "LIQ", { 4 }, 0 },
+    { "LP", { 2 }, 0 },
+    { "LIDP", { 8 }, 0 },
+    { "LIDL", { 5 }, 0 },
+    { "LDP", { 2 }, 0 },
+    { "LDQ", { 2 }, 0 },
+    { "LDR", { 2 }, 0 },
+    { "LDM", { 2 }, 0 },
+    { "LDD", { 3 }, 0 },
+    { "STP", { 2 }, 0 },
+    { "STQ", { 2 }, 0 },
+    { "STR", { 2 }, 0 },
+    { "STD", { 2 }, 0 },
+    { "MVDM", { 3 }, 0 },
+    { "MVMD", { 3 }, 0 },
+    { "EXAM", { 3 }, 0 },
+    { "EXAB", { 3 }, 0 },
+    { "IX", { 6 }, 0 },
+    { "DX", { 6 }, 0 },
+    { "IY", { 6 }, 0 },
+    { "DY", { 6 }, 0 },
+    { "IXL", { 7 }, 0 },
+    { "DXL", { 7 }, 0 },
+    { "IYS", { 7 }, 0 },
+    { "DYS", { 7 }, 0 },
+    { "INCI", { 4 }, 0 },
+    { "DECI", { 4 }, 0 },
+    { "INCJ", { 4 }, 0 },
+    { "DECJ", { 4 }, 0 },
+    { "INCA", { 4 }, 0 },
+    { "DECA", { 4 }, 0 },
+    { "INCB", { 4 }, 0 },
+    { "DECB", { 4 }, 0 },
+    { "INCK", { 4 }, 0 },
+    { "DECK", { 4 }, 0 },
+    { "INCL", { 4 }, 0 },
+    { "DECL", { 4 }, 0 },
+    { "INCM", { 4 }, 0 },
+    { "DECM", { 4 }, 0 },
+    { "INCN", { 4 }, 0 },
+    { "DECN", { 4 }, 0 },
+    { "INCP", { 4 }, 0 },
+    { "DECP", { 4 }, 0 },
+    { "ADIA", { 4 }, 0 },
+    { "SBIA", { 4 }, 0 },
+    { "ADIM", { 4 }, 0 },
+    { "SBIM", { 4 }, 0 },
+    { "ANIA", { 4 }, 0 },
+    { "ORIA", { 4 }, 0 },
+    { "ANIM", { 4 }, 0 },
+    { "ORIM", { 4 }, 0 },
+    { "CPIA", { 4 }, 0 },
+    { "CPIM", { 4 }, 0 },
+    { "TSIA", { 4 }, 0 },
+    { "TSIM", { 4 }, 0 },
+    { "ADM", { 3 }, 0 },
+    { "SBM", { 3 }, 0 },
+    { "ADCM", { 3 }, 0 },
+    { "SBCM", { 3 }, 0 },
+    { "ANMA", { 3 }, 0 },
+    { "ORMA", { 3 }, 0 },
+    { "CPMA", { 3 }, 0 },
+    { "ADN", { 7 }, 0 },
+    { "SBN", { 7 }, 0 },
+    { "ADW", { 7 }, 0 },
+    { "SBW", { 7 }, 0 },
+    { "MVW", { 5 }, 0 },
+    { "MVB", { 5 }, 0 },
+    { "EXW", { 6 }, 0 },
+    { "EXB", { 6 }, 0 },
+    { "FILM", { 5 }, 0 },
+    { "FILD", { 5 }, 0 },
+    { "SL", { 2 }, 0 },
+    { "SR", { 2 }, 0 },
+    { "SWP", { 2 }, 0 },
+    { "CLRA", { 2 }, 0 },
+    { "RC", { 2 }, 0 },
+    { "SC", { 2 }, 0 },
+    { "CDN", { 2 }, 0 },
+    { "NOPW", { 2 }, 0 },
+    { "SLW", { 5 }, 0 },
+    { "SRW", { 5 }, 0 },
+    { "NOPT", { 3 }, 0 },
+    { "OUTA", { 3 }, 0 },
+    { "OUTB", { 3 }, 0 },
+    { "OUTF", { 3 }, 0 },
+    { "OUTC", { 3 }, 0 },
+    { "INA", { 2 }, 0 },
+    { "INB", { 2 }, 0 },
+    { "TEST", { 4 }, 0 },
+    { "WAIT", { 6 }, 0 },
+    { "PUSH", { 3 }, 0 },
+    { "POP", { 2 }, 0 },
+    { "LDPC", { 3 }, 0 },
+    { "CALL", { 8 }, 0 },
+    { "CAL", { 7 }, 0 },
+    { "RTN", { 4 }, 0 },
+    { "JRNZP", { 4 }, 1 },
+    { "JRNZM", { 4 }, 1 },
+    { "JRNCP", { 4 }, 1 },
+    { "JRNCM", { 4 }, 1 },
+    { "JRZP", { 4 }, 1 },
+    { "JRZM", { 4 }, 1 },
+    { "JRCP", { 4 }, 1 },
+    { "JRCM", { 4 }, 1 },
+    { "JRP", { 7 }, 1 },
+    { "JRM", { 7 }, 1 },
+    { "JPNZ", { 4 }, 1 },
+    { "JPNC", { 4 }, 1 },
+    { "JPZ", { 4 }, 1 },
+    { "JPC", { 4 }, 1 },
+    { "JP", { 6 }, 1 },
+    { "LOOP", { 7 }, 1 },
+    { NULL, { 0 }, 0 }
+};
+
+/**
+ * @brief <i>SC61860</i>: return the static cycles of an instruction
+ * 
+ * @param _environment Current calling environment
+ * @param _mnemonic Mnemonic of the instruction
+ * @param _operands Operands of the instruction
+ * @param _branch Set to true if the instruction is a jump or a branch
+ * @return Cycles of the instruction (0 if it is not an instruction)
+ */
+int cpu_instruction_cycles( Environment * _environment, char * _mnemonic, char * _operands, int * _branch ) {
+
+    return instruction_cycles( cpuInstructionCycles, _mnemonic, 0, _branch );
+
+}
+
+
+/**
+ * @brief <i>SC61860</i>: check if an instruction only reads a variable
+ * 
+ * This function is used when a procedure is expanded inline, to decide
+ * if a parameter can be replaced by the argument (or by a constant).
+ * 
+ * @param _environment Current calling environment
+ * @param _line Line of assembly that uses the variable
+ * @param _name Name of the variable (in the assembly source)
+ * @return Offset of the byte read (if it is a plain read), -1 otherwise
+ */
+int cpu_inline_read( Environment * _environment, char * _line, char * _name ) {
+
+    return -1;
+
+}
+
+/**
+ * @brief <i>SC61860</i>: rewrite a read of a variable as an immediate value
+ * 
+ * @param _environment Current calling environment
+ * @param _line Line of assembly that reads the variable
+ * @param _name Name of the variable (in the assembly source)
+ * @param _size Size of the variable (in bytes)
+ * @param _value Value of the variable
+ * @param _result Rewritten line
+ * @return 1 if the line has been rewritten, 0 otherwise
+ */
+int cpu_inline_constant( Environment * _environment, char * _line, char * _name, int _size, int _value, char * _result ) {
+
+    return 0;
+
+}
+
 #endif
\ No newline at end of file
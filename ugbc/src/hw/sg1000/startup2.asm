@@ -60,6 +60,9 @@ INT_HANDLER2:
     LD HL,(SG1000TIMER)
     INC HL
     LD (SG1000TIMER),HL
+@IF screenCache
+    CALL VDPSHADOWFLUSH
+@ENDIF
 	LD A, (IRQVECTORREADY)
 	CMP 0
 	JR Z, IRQVECTORSKIP
@@ -896,6 +896,150 @@ void sid_wait_duration_vars( Environment * _environment, char * _channels ) {
 
 }
 
+/**
+ * @brief Emit (once) the routine that sets an instrument for the queue.
+ * 
+ * The sound effects queue sets the instrument only when the note is
+ * actually played, by calling this routine with the bit of the channel
+ * in A. The name of the routine is returned into _label.
+ * 
+ * @param _environment Current calling environment
+ * @param _program instrument to set
+ * @param _semi_var 1 to use the same program of sid_set_program_semi_var()
+ * @param _label buffer for the name of the routine
+ */
+static void sid_queue_program( Environment * _environment, int _program, int _semi_var, char * _label ) {
+
+    sprintf( _label, "SIDSFXPROGRAM%s%2.2x", _semi_var ? "V" : "C", ( _program & 0xff ) );
+
+    if ( label_stored_exists_named( _environment, _label ) ) {
+        return;
+    }
+
+    MAKE_LABEL
+
+    outline1("JMP %sskip", label );
+    outline1("%s:", _label );
+    if ( _semi_var ) {
+        outline0("STA SIDSFXPROGRAMMASK");
+        sid_set_program_semi_var( _environment, "SIDSFXPROGRAMMASK", _program );
+    } else {
+        int i;
+        for( i=0; i<3; ++i ) {
+            outline0("LSR");
+            outline2("BCC %sc%d", label, i );
+            outline0("PHA");
+            sid_set_program( _environment, ( 1 << i ), _program );
+            outline0("PLA");
+            outline2("%sc%d:", label, i );
+        }
+    }
+    outline0("RTS");
+    outline1("%sskip:", label );
+
+    label_stored_define_named( _environment, _label );
+
+}
+
+/**
+ * @brief Queue a sound effect, without waiting for its end.
+ * 
+ * The note is given to the timer manager, that plays it on the given
+ * channels as soon as they are free (or immediately, if the note has
+ * a higher priority than the one currently playing). The channels are
+ * taken from the music until the note is over. The code waits only if
+ * the queue of one of the channels is already full.
+ * 
+ * @param _environment Current calling environment
+ * @param _channels channels to play on
+ * @param _frequency frequency to play
+ * @param _duration duration (in jiffies)
+ * @param _priority priority (1...255)
+ * @param _program instrument to play with
+ */
+void sid_queue_sound( Environment * _environment, int _channels, int _frequency, int _duration, int _priority, int _program ) {
+
+    deploy( sidvars, src_hw_sid_vars_asm );
+    deploy( sidstartup, src_hw_sid_startup_asm );
+
+    char programLabel[MAX_TEMPORARY_STORAGE];
+    sid_queue_program( _environment, _program, 0, programLabel );
+
+    MAKE_LABEL
+
+    int pitch = ( ( _frequency * 0xffff ) / 4000 );
+
+    if ( _duration < 1 ) {
+        _duration = 1;
+    } else if ( _duration > 255 ) {
+        _duration = 255;
+    }
+
+    outline1("%s:", label );
+    outline0("SEI");
+    outline1("LDA #$%2.2x", ( pitch & 0xff ) );
+    outline0("STA SIDSFXPITCH");
+    outline1("LDA #$%2.2x", ( ( pitch >> 8 ) & 0xff ) );
+    outline0("STA SIDSFXPITCH+1");
+    outline1("LDA #$%2.2x", _duration );
+    outline0("STA SIDSFXDURATION");
+    outline1("LDA #$%2.2x", ( _priority & 0xff ) );
+    outline0("STA SIDSFXPRI");
+    outline1("LDA #<(%s-1)", programLabel );
+    outline0("STA SIDSFXPROGRAM");
+    outline1("LDA #>(%s-1)", programLabel );
+    outline0("STA SIDSFXPROGRAM+1");
+    outline1("LDA #$%2.2x", ( _channels & 0x07 ) );
+    outline0("JSR SIDSFXPUSH");
+    outline0("CLI");
+    outline1("BCS %s", label );
+
+}
+
+void sid_queue_sound_vars( Environment * _environment, char * _channels, char * _frequency, char * _duration, int _priority, int _program ) {
+
+    deploy( sidvars, src_hw_sid_vars_asm );
+    deploy( sidstartup, src_hw_sid_startup_asm );
+
+    char programLabel[MAX_TEMPORARY_STORAGE];
+    sid_queue_program( _environment, _program, 1, programLabel );
+
+    MAKE_LABEL
+
+    outline1("%sretry:", label );
+    outline0("SEI");
+    outline1("LDX %s", _frequency );
+    outline1("LDY %s", address_displacement(_environment, _frequency, "1") );
+    outline0("JSR SIDCALCFREQ");
+    outline0("STX SIDSFXPITCH");
+    outline0("STY SIDSFXPITCH+1");
+    outline1("LDA %s", address_displacement(_environment, _duration, "1") );
+    outline1("BEQ %slo", label );
+    outline0("LDA #$ff");
+    outline1("BNE %sdone", label );
+    outline1("%slo:", label );
+    outline1("LDA %s", _duration );
+    outline1("BNE %sdone", label );
+    outline0("LDA #$1");
+    outline1("%sdone:", label );
+    outline0("STA SIDSFXDURATION");
+    outline1("LDA #$%2.2x", ( _priority & 0xff ) );
+    outline0("STA SIDSFXPRI");
+    outline1("LDA #<(%s-1)", programLabel );
+    outline0("STA SIDSFXPROGRAM");
+    outline1("LDA #>(%s-1)", programLabel );
+    outline0("STA SIDSFXPROGRAM+1");
+    if ( _channels ) {
+        outline1("LDA %s", _channels );
+    } else {
+        outline1("LDA #$%1.1x", 0x07 );
+    }
+    outline0("JSR SIDSFXPUSH");
+    outline0("CLI");
+    outline1("BCS %sretry", label );
+
+}
+
 void sid_player_init( Environment * _environment, int _init_address ) {
 
     deploy( sidplayer, src_hw_sid_player_asm );
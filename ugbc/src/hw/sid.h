@@ -57,6 +57,8 @@ void sid_set_note_vars( Environment * _environment, char * _channel, char * _not
 void sid_stop_vars( Environment * _environment, char * _channel );
 void sid_set_duration_vars( Environment * _environment, char * _channel, char * _duration );
 void sid_wait_duration_vars( Environment * _environment, char * _channel );
+void sid_queue_sound( Environment * _environment, int _channels, int _frequency, int _duration, int _priority, int _program );
+void sid_queue_sound_vars( Environment * _environment, char * _channels, char * _frequency, char * _duration, int _priority, int _program );
 
 void sid_music( Environment * _environment, char * _music, int _size, int _loop );
 void sid_player_init( Environment * _environment, int _init_address );
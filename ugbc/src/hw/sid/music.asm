@@ -1159,6 +1159,12 @@ SIDBLOCKS_BACKUP: .word $0
 SIDLASTBLOCK_BACKUP: .byte $0
 SIDTMPPTR_BACKUP: .word $0
 
+SIDCALLCOUNT: .byte $0
+SIDCALLOFS: .word $0
+SIDRETPTR: .word $0
+SIDRETOFS: .byte $0
+SIDRETBLOCKS: .byte $0
+
 SIDTMPPTR = $05 ; $06
 SIDTMPOFS = $07
 SIDTMPLEN = $08
@@ -1167,7 +1173,9 @@ SIDJIFFIES = $09 ; $0A
 MUSICPLAYERRESET:
     LDA #$0
     STA SIDJIFFIES
+    STA SIDJIFFIES+1
     STA SIDTMPOFS
+    STA SIDCALLCOUNT
     LDA #$1
     STA SIDMUSICREADY
     LDA SIDTMPPTR_BACKUP
@@ -1178,13 +1186,6 @@ MUSICPLAYERRESET:
     STA SIDLASTBLOCK
     LDA SIDBLOCKS_BACKUP
     STA SIDBLOCKS
-    BEQ MUSICPLAYERRESET3
-    LDA #$FF
-    JMP MUSICPLAYERRESET2
-MUSICPLAYERRESET3:
-    LDA SIDLASTBLOCK_BACKUP
-MUSICPLAYERRESET2:
-    STA SIDTMPLEN
     RTS
 
 ; This is the entry point for music play routine
@@ -1216,7 +1217,11 @@ MUSICPLAYERR:
 ; are exausted.
 MUSICPLAYERL1:
     LDA SIDJIFFIES
+    BNE MUSICPLAYERL1A
+    LDA SIDJIFFIES+1
     BEQ MUSICPLAYERL1B
+    DEC SIDJIFFIES+1
+MUSICPLAYERL1A:
     DEC SIDJIFFIES
     RTS
 
@@ -1229,6 +1234,7 @@ MUSICPLAYERL1B:
     CPX #$0
     BNE MUSICPLAYERL1X
 
+MUSICPLAYEREND:
     ; Is a LOOP requested?
     LDA SIDMUSICLOOP
     BEQ MUSICPLAYERL1BDONE
@@ -1243,6 +1249,7 @@ MUSICPLAYERL1BDONE:
     STA SIDTMPPTR
     STA SIDTMPPTR+1
     STA SIDJIFFIES
+    STA SIDJIFFIES+1
     RTS
 
 ; This is the entry point to decode the instruction
@@ -1264,16 +1271,101 @@ MUSICPLAYERL1X1:
     BCS MUSICPLAYERL1X2
     JMP MUSICNOTEOFF
 MUSICPLAYERL1X2:
+    ; 1111xxxx: extended instructions (IMF version 2).
+    BNE MUSICPLAYERL1X4
+    JMP MUSICLONGWAIT
+MUSICPLAYERL1X4:
+    CMP #$C0
+    BNE MUSICPLAYERL1X5
+    JMP MUSICPATTERNCALL
+MUSICPLAYERL1X5:
+    CMP #$D0
+    BNE MUSICPLAYERL1X6
+    JMP MUSICPATTERNRETURN
+MUSICPLAYERL1X6:
+    CMP #$E0
+    BNE MUSICPLAYERL1X7
+    JMP MUSICPLAYEREND
+MUSICPLAYERL1X7:
     RTS
 
 MUSICWAIT:
     LSR
     STA SIDJIFFIES
+    LDA #$0
+    STA SIDJIFFIES+1
+    RTS
+
+; LONG WAIT: the next two bytes are the delay (in jiffies).
+MUSICLONGWAIT:
+    JSR MUSICREADNEXTBYTE
+    STA SIDJIFFIES
+    JSR MUSICREADNEXTBYTE
+    STA SIDJIFFIES+1
     RTS
 
+; CALL: play the pattern at the given offset of the stream,
+; for the given number of times, then come back here.
+MUSICPATTERNCALL:
+    JSR MUSICREADNEXTBYTE
+    STA SIDCALLCOUNT
+    JSR MUSICREADNEXTBYTE
+    STA SIDCALLOFS
+    JSR MUSICREADNEXTBYTE
+    STA SIDCALLOFS+1
+
+    ; Save the reading position, to resume from it
+    ; when the pattern is over.
+    LDA SIDTMPPTR
+    STA SIDRETPTR
+    LDA SIDTMPPTR+1
+    STA SIDRETPTR+1
+    LDA SIDTMPOFS
+    STA SIDRETOFS
+    LDA SIDBLOCKS
+    STA SIDRETBLOCKS
+
+; Move the reading position to the start of the pattern.
+; Since blocks are 256 bytes long, the high byte of the
+; offset is the number of blocks to skip, and the low
+; byte is the offset inside that block.
+MUSICPATTERNSEEK:
+    LDA SIDTMPPTR_BACKUP
+    STA SIDTMPPTR
+    LDA SIDTMPPTR_BACKUP+1
+    CLC
+    ADC SIDCALLOFS+1
+    STA SIDTMPPTR+1
+    LDA SIDBLOCKS_BACKUP
+    SEC
+    SBC SIDCALLOFS+1
+    STA SIDBLOCKS
+    LDA SIDCALLOFS
+    STA SIDTMPOFS
+    JMP MUSICPLAYERL1B
+
+; RETURN: the pattern is over. Repeat it, or resume
+; the reading from the saved position.
+MUSICPATTERNRETURN:
+    LDA SIDCALLCOUNT
+    BEQ MUSICPATTERNRETURN2
+    DEC SIDCALLCOUNT
+    BNE MUSICPATTERNSEEK
+    LDA SIDRETPTR
+    STA SIDTMPPTR
+    LDA SIDRETPTR+1
+    STA SIDTMPPTR+1
+    LDA SIDRETOFS
+    STA SIDTMPOFS
+    LDA SIDRETBLOCKS
+    STA SIDBLOCKS
+MUSICPATTERNRETURN2:
+    JMP MUSICPLAYERL1B
+
 MUSICSETPROGRAM:
     LSR
     LSR
+    JSR MUSICSFXFILTER
     STA MUSICTMP
     JSR MUSICREADNEXTBYTE
     PHA
@@ -1288,6 +1380,7 @@ MUSICNOTEOFF:
     LSR
     LSR
     LSR
+    JSR MUSICSFXFILTER
     JSR SIDSTOP
     JMP MUSICPLAYERL1B
 
@@ -1295,6 +1388,7 @@ MUSICNOTEON:
     LSR
     LSR
     LSR
+    JSR MUSICSFXFILTER
     PHA
     JSR MUSICREADNEXTBYTE
     ASL
@@ -1313,61 +1407,41 @@ MUSICNOTEON:
     PLA
     JMP MUSICPLAYERL1B
 
+; The channels taken by a sound effect are not touched
+; by the music, until the effect is over.
+MUSICSFXFILTER:
+    STA SIDSFXTMP
+    LDA SIDSFXMASK
+    EOR #$FF
+    AND SIDSFXTMP
+    RTS
+
 ; This routine has been added in order to read the
-; next byte in a "blocked" byte stream.
+; next byte in a "blocked" byte stream. Every block is
+; 256 bytes long, except the last one (SIDLASTBLOCK bytes).
 MUSICREADNEXTBYTE:
-    ; Let's check if we arrived at the end of the block.
-    ; In that case, we must "load" the next block (or end
-    ; the reading).
+    ; Let's check if we arrived at the end of the last
+    ; block. In that case, the reading is over.
     LDY SIDTMPOFS
-    CPY SIDTMPLEN
-    BEQ MUSICREADNEXTBYTELE
+    LDA SIDBLOCKS
+    BNE MUSICREADNEXTBYTE2
+    CPY SIDLASTBLOCK
+    BEQ MUSICREADNEXTBYTEEND
 
 MUSICREADNEXTBYTE2:
     LDX #$ff
     LDA (SIDTMPPTR), Y
     INY
     STY SIDTMPOFS
-    RTS
+    BNE MUSICREADNEXTBYTE3
 
-; This is the entry point if a block (256 or less bytes)
-; is finished, and we must move forward to the next block.
-MUSICREADNEXTBYTELE:
-    ; Is file finished?
-    LDA SIDBLOCKS
-    BEQ MUSICREADNEXTBYTEEND
-
-    ; Increment the base address by 255
+    ; The block (256 bytes) is finished, so we must move 
+    ; forward to the next block.
     INC SIDTMPPTR+1
-    DEC SIDTMPPTR
-
-    ; Decrement the number of remaining blocks
     DEC SIDBLOCKS
 
-    ; If remaining blocks are 0, the last block
-    ; length is different from 256 bytes.
-    BEQ MUSICPLAYERLE2
-
-    ; Remaining block is 256 bytes lenght.
-    LDY #$ff
-    STY SIDTMPLEN
-
-    ; Put the index to 0
-    LDY #$0
-    STY SIDTMPOFS
-
-    JMP MUSICREADNEXTBYTE2
-
-    ; Remaining block is <256 bytes lenght.
-MUSICPLAYERLE2:
-    LDY SIDLASTBLOCK
-    STY SIDTMPLEN
-
-    ; Put the index to 0
-    LDY #$0
-    STY SIDTMPOFS
-
-    JMP MUSICREADNEXTBYTE2
+MUSICREADNEXTBYTE3:
+    RTS
 
 MUSICREADNEXTBYTEEND:
     LDX #$0
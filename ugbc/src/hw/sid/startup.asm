@@ -37,27 +37,188 @@
 
 SIDTMPPTR2 = $03 ; $04
 
+; Timer manager: when the duration of a channel expires, the next
+; queued note is played (if any). Otherwise the note is stopped, and
+; the channel is given back to the music.
 SIDMANAGER:
     PHA
-    LDA SIDTIMER
-    BEQ SIDMANAGER0
-    DEC SIDTIMER
-    BNE SIDMANAGER0
-    JSR SIDSTOP0
-SIDMANAGER0:
-    LDA SIDTIMER+1
-    BEQ SIDMANAGER1
-    DEC SIDTIMER+1
-    BNE SIDMANAGER1
-    JSR SIDSTOP1
-SIDMANAGER1:
-    LDA SIDTIMER+2
-    BEQ SIDMANAGER2
-    DEC SIDTIMER+2
-    BNE SIDMANAGER2
-    JSR SIDSTOP2
-SIDMANAGER2:
+    TXA
+    PHA
+    TYA
+    PHA
+    LDX #$0
+SIDMANAGERL1:
+    LDA SIDTIMER, X
+    BEQ SIDMANAGERL2
+    DEC SIDTIMER, X
+    BNE SIDMANAGERL2
+    JSR SIDSFXNEXT
+SIDMANAGERL2:
+    INX
+    CPX #$3
+    BNE SIDMANAGERL1
+    PLA
+    TAY
     PLA
+    TAX
+    PLA
+    RTS
+
+; Queue a note on the channels in A. The note is described by
+; SIDSFXPITCH, SIDSFXDURATION, SIDSFXPROGRAM and SIDSFXPRI, where
+; SIDSFXPROGRAM is the address (minus one) of the routine that sets
+; the instrument on the channels in A. It must be called
+; with interrupts disabled. If the queue of one of the channels is
+; full, nothing is queued and the carry is set: the caller should
+; enable the interrupts and try again.
+SIDSFXPUSH:
+    STA SIDSFXCHANNELS
+    LDX #$0
+SIDSFXPUSHC1:
+    LSR
+    BCC SIDSFXPUSHC3
+    PHA
+    LDA SIDSFXPRIORITY, X
+    CMP SIDSFXPRI
+    BNE SIDSFXPUSHC2
+    LDA SIDSFXCOUNT, X
+    CMP #$4
+    BCC SIDSFXPUSHC2
+    PLA
+    SEC
+    RTS
+SIDSFXPUSHC2:
+    PLA
+SIDSFXPUSHC3:
+    INX
+    CPX #$3
+    BNE SIDSFXPUSHC1
+    LDA SIDSFXCHANNELS
+    LDX #$0
+SIDSFXPUSHL1:
+    LSR
+    BCC SIDSFXPUSHL2
+    PHA
+    JSR SIDSFXPUSHCHANNEL
+    PLA
+SIDSFXPUSHL2:
+    INX
+    CPX #$3
+    BNE SIDSFXPUSHL1
+    CLC
+    RTS
+
+; Queue a note on the channel X. A note with a lower priority than
+; the effect playing on the channel is dropped, while a note with a 
+; higher priority replaces it (and its queue).
+SIDSFXPUSHCHANNEL:
+    LDA SIDSFXPRIORITY, X
+    BEQ SIDSFXPUSHCHANNELPLAY
+    CMP SIDSFXPRI
+    BEQ SIDSFXPUSHCHANNELQUEUE
+    BCC SIDSFXPUSHCHANNELPLAY
+    RTS
+SIDSFXPUSHCHANNELQUEUE:
+    LDA SIDSFXCOUNT, X
+    CMP #$4
+    BCS SIDSFXPUSHCHANNELDONE
+    CLC
+    ADC SIDSFXHEAD, X
+    AND #$3
+    STA SIDSFXTMP
+    TXA
+    ASL
+    ASL
+    ORA SIDSFXTMP
+    TAY
+    LDA SIDSFXPITCH
+    STA SIDSFXQPITCHLO, Y
+    LDA SIDSFXPITCH+1
+    STA SIDSFXQPITCHHI, Y
+    LDA SIDSFXDURATION
+    STA SIDSFXQDURATION, Y
+    LDA SIDSFXPROGRAM
+    STA SIDSFXQPROGRAMLO, Y
+    LDA SIDSFXPROGRAM+1
+    STA SIDSFXQPROGRAMHI, Y
+    INC SIDSFXCOUNT, X
+SIDSFXPUSHCHANNELDONE:
+    RTS
+SIDSFXPUSHCHANNELPLAY:
+    LDA #$0
+    STA SIDSFXCOUNT, X
+    LDA SIDSFXPRI
+    STA SIDSFXPRIORITY, X
+    JMP SIDSFXPLAY
+
+; Play the next queued note on the channel X or, if there are no
+; more notes, stop it and give it back to the music.
+SIDSFXNEXT:
+    LDA SIDSFXCOUNT, X
+    BEQ SIDSFXNEXTRELEASE
+    DEC SIDSFXCOUNT, X
+    TXA
+    ASL
+    ASL
+    ORA SIDSFXHEAD, X
+    TAY
+    LDA SIDSFXHEAD, X
+    CLC
+    ADC #$1
+    AND #$3
+    STA SIDSFXHEAD, X
+    LDA SIDSFXQPITCHLO, Y
+    STA SIDSFXPITCH
+    LDA SIDSFXQPITCHHI, Y
+    STA SIDSFXPITCH+1
+    LDA SIDSFXQDURATION, Y
+    STA SIDSFXDURATION
+    LDA SIDSFXQPROGRAMLO, Y
+    STA SIDSFXPROGRAM
+    LDA SIDSFXQPROGRAMHI, Y
+    STA SIDSFXPROGRAM+1
+    JMP SIDSFXPLAY
+SIDSFXNEXTRELEASE:
+    LDA #$0
+    STA SIDSFXPRIORITY, X
+    LDA SIDSFXBIT, X
+    EOR #$FF
+    AND SIDSFXMASK
+    STA SIDSFXMASK
+    LDA SIDSFXBIT, X
+    JMP SIDSTOP
+
+; Play the note in SIDSFXPITCH for SIDSFXDURATION jiffies on
+; the channel X, taking the channel from the music. The instrument
+; is set here, so that the notes waiting in the queue do not touch
+; the channel before their turn.
+SIDSFXPLAY:
+    LDA SIDSFXDURATION
+    STA SIDTIMER, X
+    LDA SIDSFXBIT, X
+    ORA SIDSFXMASK
+    STA SIDSFXMASK
+    STX SIDSFXTMP
+    JSR SIDSFXPROGRAMCALL
+    LDX SIDSFXTMP
+    LDA SIDSFXBIT, X
+    LDX SIDSFXPITCH
+    LDY SIDSFXPITCH+1
+    JSR SIDPROGFREQ
+    LDX SIDSFXTMP
+    LDA SIDSFXBIT, X
+    JSR SIDSTART
+    LDX SIDSFXTMP
+    RTS
+
+; Call the routine in SIDSFXPROGRAM with the bit of the channel X
+; in A (the address is pushed on the stack and reached by RTS).
+SIDSFXPROGRAMCALL:
+    LDA SIDSFXPROGRAM+1
+    PHA
+    LDA SIDSFXPROGRAM
+    PHA
+    LDA SIDSFXBIT, X
     RTS
 
 SIDSTARTUP:
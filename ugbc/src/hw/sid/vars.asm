@@ -53,3 +53,24 @@ SIDFREQTABLE:
 
 SIDTIMER: .byte $0, $0, $0
 
+; Sound effects queue. For each channel, the priority of the effect
+; playing on it (0 = the channel belongs to the music) and up to 4 
+; further notes (pitch, duration and program) waiting to be played.
+SIDSFXMASK: .byte $0
+SIDSFXBIT: .byte $1, $2, $4
+SIDSFXPRIORITY: .byte $0, $0, $0
+SIDSFXCOUNT: .byte $0, $0, $0
+SIDSFXHEAD: .byte $0, $0, $0
+SIDSFXQPITCHLO: .res 12
+SIDSFXQPITCHHI: .res 12
+SIDSFXQDURATION: .res 12
+SIDSFXQPROGRAMLO: .res 12
+SIDSFXQPROGRAMHI: .res 12
+SIDSFXPITCH: .word $0
+SIDSFXPROGRAM: .word $0
+SIDSFXPROGRAMMASK: .byte $0
+SIDSFXDURATION: .byte $0
+SIDSFXPRI: .byte $0
+SIDSFXTMP: .byte $0
+SIDSFXCHANNELS: .byte $0
+
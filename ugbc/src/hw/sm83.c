@@ -6787,6 +6787,89 @@ void cpu_number_to_string( Environment * _environment, char * _number, char * _s
 
 }
 
+/**
+ * @brief <i>SM83</i>: emit code to add two packed BCD values
+ * 
+ * @param _environment Current calling environment
+ * @param _source First value to add
+ * @param _destination Second value to add and destination address for result (if _other is NULL)
+ * @param _other Destination address for result
+ * @param _bytes Size of the values (in bytes)
+ */
+void cpu_bcd_add( Environment * _environment, char *_source, char *_destination, char *_other, int _bytes ) {
+
+    // DAA on SM83 uses the N and H flags, so it adjusts correctly
+    // after both additions and subtractions.
+
+    outline0("AND A");
+    for( int i=_bytes-1; i>=0; --i ) {
+        char offset[MAX_TEMPORARY_STORAGE]; sprintf( offset, "%d", i );
+        outline1("LD A, (%s)", address_displacement(_environment, _destination, offset));
+        outline0("LD B, A");
+        outline1("LD A, (%s)", address_displacement(_environment, _source, offset));
+        outline0("ADC A, B");
+        outline0("DAA");
+        outline1("LD (%s), A", address_displacement(_environment, _other ? _other : _destination, offset));
+    }
+
+}
+
+/**
+ * @brief <i>SM83</i>: emit code to subtract two packed BCD values
+ * 
+ * @param _environment Current calling environment
+ * @param _source First value
+ * @param _destination Value to subtract and destination address for result (if _other is NULL)
+ * @param _other Destination address for result
+ * @param _bytes Size of the values (in bytes)
+ */
+void cpu_bcd_sub( Environment * _environment, char *_source, char *_destination, char *_other, int _bytes ) {
+
+    outline0("AND A");
+    for( int i=_bytes-1; i>=0; --i ) {
+        char offset[MAX_TEMPORARY_STORAGE]; sprintf( offset, "%d", i );
+        outline1("LD A, (%s)", address_displacement(_environment, _destination, offset));
+        outline0("LD B, A");
+        outline1("LD A, (%s)", address_displacement(_environment, _source, offset));
+        outline0("SBC A, B");
+        outline0("DAA");
+        outline1("LD (%s), A", address_displacement(_environment, _other ? _other : _destination, offset));
+    }
+
+}
+
+/**
+ * @brief <i>SM83</i>: emit code to convert a packed BCD value into digits
+ * 
+ * @param _environment Current calling environment
+ * @param _bcd Value to convert
+ * @param _string Address of the string to fill (at least 2 * _bytes chars)
+ * @param _string_size Where to store the number of digits
+ * @param _bytes Size of the value (in bytes)
+ */
+void cpu_bcd_to_string( Environment * _environment, char * _bcd, char * _string, char * _string_size, int _bytes ) {
+
+    outline1("LD HL, (%s)", _string );
+    for( int i=0; i<_bytes; ++i ) {
+        char offset[MAX_TEMPORARY_STORAGE]; sprintf( offset, "%d", i );
+        outline1("LD A, (%s)", address_displacement(_environment, _bcd, offset));
+        outline0("LD B, A");
+        outline0("SWAP A");
+        outline0("AND $0F");
+        outline0("OR $30");
+        outline0("LD (HL), A");
+        outline0("INC HL");
+        outline0("LD A, B");
+        outline0("AND $0F");
+        outline0("OR $30");
+        outline0("LD (HL), A");
+        outline0("INC HL");
+    }
+    outline1("LD A, $%2.2x", _bytes * 2 );
+    outline1("LD (%s), A", _string_size );
+
+}
+
 void cpu_bits_to_string_vars( Environment * _environment ) {
 
     variable_import( _environment, "BINSTRBUF", VT_BUFFER, 32 );
@@ -8353,4 +8436,342 @@ void cpu_float_single_exp( Environment * _environment, char * _value, char * _re
 }
 
 
+static EmbeddedCost cpuEmbeddedCost[] = {
+    { "cpu_compare_16bit", 34, 136, 18, 104 },
+    { "cpu_compare_32bit", 54, 216, 18, 104 },
+    { "cpu_fill_blocks", 48, 192, 10, 72 },
+    { "cpu_less_than_16bit", 80, 320, 32, 160 },
+    { "cpu_less_than_8bit", 58, 232, 32, 160 },
+    { "cpu_math_div2_const_16bit", 42, 168, 26, 136 },
+    { "cpu_math_div2_const_8bit", 38, 152, 22, 120 },
+    { "cpu_math_mul2_const_8bit", 26, 104, 16, 96 },
+    { "cpu_math_mul_8bit_to_16bit", 106, 424, 24, 128 },
+    { NULL, 0, 0, 0, 0 }
+};
+
+/**
+ * @brief <i>SM83</i>: return the cost model of a primitive
+ * 
+ * Values are estimated from the code generated by each version: bytes and
+ * T-states of the inline expansion, and bytes and extra T-states paid by a call
+ * site (parameters passing, call and return). Only the primitives that
+ * have both versions are listed.
+ * 
+ * @param _environment Current calling environment
+ * @param _name Name of the primitive
+ * @return Cost of the primitive, or NULL if it can only be inlined (or called)
+ */
+EmbeddedCost * cpu_embedded_cost( Environment * _environment, char * _name ) {
+
+    int i = 0;
+    while( cpuEmbeddedCost[i].name ) {
+        if ( strcmp( cpuEmbeddedCost[i].name, _name ) == 0 ) {
+            return &cpuEmbeddedCost[i];
+        }
+        ++i;
+    }
+    return NULL;
+
+}
+
+/* kinds of operand */
+#define CYCLES_OPERAND_NONE         0
+#define CYCLES_OPERAND_REG          1
+#define CYCLES_OPERAND_REG16        2
+#define CYCLES_OPERAND_IND          3
+#define CYCLES_OPERAND_IDX          4
+#define CYCLES_OPERAND_MEM          5
+#define CYCLES_OPERAND_IMM          6
+
+static int cpu_instruction_operand( char * _operand ) {
+
+    static char * registers[] = { "A", "B", "C", "D", "E", "H", "L", "I", "R", "IXH", "IXL", "IYH", "IYL", NULL };
+    static char * registers16[] = { "AF", "AF'", "BC", "DE", "HL", "SP", "IX", "IY", NULL };
+
+    if ( !*_operand ) {
+        return CYCLES_OPERAND_NONE;
+    }
+    for( int i=0; registers[i]; ++i ) {
+        if ( !strcasecmp( _operand, registers[i] ) ) {
+            return CYCLES_OPERAND_REG;
+        }
+    }
+    for( int i=0; registers16[i]; ++i ) {
+        if ( !strcasecmp( _operand, registers16[i] ) ) {
+            return CYCLES_OPERAND_REG16;
+        }
+    }
+    if ( *_operand == '(' ) {
+        if ( !strncasecmp( _operand, "(IX", 3 ) || !strncasecmp( _operand, "(IY", 3 ) ) {
+            return CYCLES_OPERAND_IDX;
+        }
+        if ( !strncasecmp( _operand, "(HL", 3 ) || !strcasecmp( _operand, "(BC)" ) || !strcasecmp( _operand, "(DE)" ) || 
+             !strcasecmp( _operand, "(SP)" ) || !strcasecmp( _operand, "(C)" ) ) {
+            return CYCLES_OPERAND_IND;
+        }
+        return CYCLES_OPERAND_MEM;
+    }
+    return CYCLES_OPERAND_IMM;
+
+}
+
+/* addressing modes: registers, immediate, (HL)/(BC)/(DE)/(C), unused,
+   (nn), register pairs, register pair and immediate, register pair and (nn).
+   For JP, JR, CALL and RET: unconditional, conditional (not taken), (HL).
+   Cycles are in T-states (4 for each machine cycle). Branches are counted
+   as not taken. */
+static InstructionCycles cpuInstructionCycles[] = {
+    { "LD", { 4, 8, 8, -1, 16, 8, 12, 20 }, 0 },
+    { "LDH", { -1, -1, 8, -1, 12, -1, -1, -1 }, 0 },
+    { "LDI", { 8, -1, 8, -1, -1, -1, -1, -1 }, 0 },
+    { "LDD", { 8, -1, 8, -1, -1, -1, -1, -1 }, 0 },
+    { "LDHL", { -1, -1, -1, -1, -1, 12, 12, -1 }, 0 },
+    { "ADD", { 4, 8, 8, -1, -1, 8, 16, -1 }, 0 },
+    { "ADC", { 4, 8, 8, -1, -1, -1, -1, -1 }, 0 },
+    { "SBC", { 4, 8, 8, -1, -1, -1, -1, -1 }, 0 },
+    { "SUB", { 4, 8, 8, -1, -1, -1, -1, -1 }, 0 },
+    { "AND", { 4, 8, 8, -1, -1, -1, -1, -1 }, 0 },
+    { "OR", { 4, 8, 8, -1, -1, -1, -1, -1 }, 0 },
+    { "XOR", { 4, 8, 8, -1, -1, -1, -1, -1 }, 0 },
+    { "CP", { 4, 8, 8, -1, -1, -1, -1, -1 }, 0 },
+    { "INC", { 4, -1, 12, -1, -1, 8, -1, -1 }, 0 },
+    { "DEC", { 4, -1, 12, -1, -1, 8, -1, -1 }, 0 },
+    { "RLC", { 8, -1, 16, -1, -1, -1, -1, -1 }, 0 },
+    { "RL", { 8, -1, 16, -1, -1, -1, -1, -1 }, 0 },
+    { "RRC", { 8, -1, 16, -1, -1, -1, -1, -1 }, 0 },
+    { "RR", { 8, -1, 16, -1, -1, -1, -1, -1 }, 0 },
+    { "SLA", { 8, -1, 16, -1, -1, -1, -1, -1 }, 0 },
+    { "SRA", { 8, -1, 16, -1, -1, -1, -1, -1 }, 0 },
+    { "SRL", { 8, -1, 16, -1, -1, -1, -1, -1 }, 0 },
+    { "SWAP", { 8, -1, 16, -1, -1, -1, -1, -1 }, 0 },
+    { "BIT", { 8, -1, 12, -1, -1, -1, -1, -1 }, 0 },
+    { "SET", { 8, -1, 16, -1, -1, -1, -1, -1 }, 0 },
+    { "RES", { 8, -1, 16, -1, -1, -1, -1, -1 }, 0 },
+    { "PUSH", { -1, -1, -1, -1, -1, 16, -1, -1 }, 0 },
+    { "POP", { -1, -1, -1, -1, -1, 12, -1, -1 }, 0 },
+    { "JP", { 16, 12, 4, -1, -1, -1, -1, -1 }, 1 },
+    { "JR", { 12, 8, -1, -1, -1, -1, -1, -1 }, 1 },
+    { "CALL", { 24, 12, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "RET", { 16, 8, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "RETI", { 16, -1, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "RST", { 16, 16, 16, 16, 16, 16, 16, 16 }, 0 },
+    { "NOP", { 4, -1, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "HALT", { 4, -1, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "STOP", { 4, -1, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "DI", { 4, -1, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "EI", { 4, -1, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "SCF", { 4, -1, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "CCF", { 4, -1, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "CPL", { 4, -1, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "DAA", { 4, -1, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "RLCA", { 4, -1, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "RRCA", { 4, -1, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "RLA", { 4, -1, -1, -1, -1, -1, -1, -1 }, 0 },
+    { "RRA", { 4, -1, -1, -1, -1, -1, -1, -1 }, 0 },
+    { NULL, { 0 }, 0 }
+};
+
+/**
+ * @brief <i>SM83</i>: return the static cycles of an instruction
+ * 
+ * @param _environment Current calling environment
+ * @param _mnemonic Mnemonic of the instruction
+ * @param _operands Operands of the instruction
+ * @param _branch Set to true if the instruction is a jump or a branch
+ * @return Cycles of the instruction (0 if it is not an instruction)
+ */
+int cpu_instruction_cycles( Environment * _environment, char * _mnemonic, char * _operands, int * _branch ) {
+
+    char op1[MAX_TEMPORARY_STORAGE];
+    char op2[MAX_TEMPORARY_STORAGE];
+    char * target = op1;
+    int i = 0, parenthesis = 0;
+
+    op1[0] = op2[0] = 0;
+    for( char * p = _operands; *p && *p != ';' && i < MAX_TEMPORARY_STORAGE - 1; ++p ) {
+        if ( *p == '(' ) ++parenthesis;
+        if ( *p == ')' ) --parenthesis;
+        if ( *p == ',' && !parenthesis && target == op1 ) {
+            op1[i] = 0;
+            target = op2;
+            i = 0;
+            continue;
+        }
+        if ( *p != ' ' && *p != '\t' ) {
+            target[i++] = *p;
+        }
+    }
+    target[i] = 0;
+
+    int k1 = cpu_instruction_operand( op1 );
+    int k2 = cpu_instruction_operand( op2 );
+    int mode = 0;
+
+    if ( !strcasecmp( _mnemonic, "JP" ) || !strcasecmp( _mnemonic, "JR" ) || !strcasecmp( _mnemonic, "CALL" ) || !strcasecmp( _mnemonic, "RET" ) ) {
+        // conditional (or indirect, for JP)
+        if ( k1 == CYCLES_OPERAND_IND || k1 == CYCLES_OPERAND_IDX ) {
+            mode = k1 == CYCLES_OPERAND_IND ? 2 : 3;
+        } else {
+            mode = ( k2 != CYCLES_OPERAND_NONE || ( !strcasecmp( _mnemonic, "RET" ) && k1 != CYCLES_OPERAND_NONE ) ) ? 1 : 0;
+        }
+        return instruction_cycles( cpuInstructionCycles, _mnemonic, mode, _branch );
+    }
+
+    if ( !strcasecmp( _mnemonic, "BIT" ) || !strcasecmp( _mnemonic, "SET" ) || !strcasecmp( _mnemonic, "RES" ) ) {
+        // the first operand is the number of the bit
+        k1 = k2;
+        k2 = CYCLES_OPERAND_NONE;
+    }
+
+    if ( k1 == CYCLES_OPERAND_IDX || k2 == CYCLES_OPERAND_IDX ) {
+        mode = 3;
+    } else if ( k1 == CYCLES_OPERAND_MEM || k2 == CYCLES_OPERAND_MEM ) {
+        mode = ( k1 == CYCLES_OPERAND_REG16 || k2 == CYCLES_OPERAND_REG16 ) ? 7 : 4;
+    } else if ( k1 == CYCLES_OPERAND_IND || k2 == CYCLES_OPERAND_IND ) {
+        mode = 2;
+    } else if ( k1 == CYCLES_OPERAND_REG16 || k2 == CYCLES_OPERAND_REG16 ) {
+        mode = ( k2 == CYCLES_OPERAND_IMM ) ? 6 : 5;
+    } else if ( k1 == CYCLES_OPERAND_IMM || k2 == CYCLES_OPERAND_IMM ) {
+        mode = 1;
+    }
+
+    int cycles = instruction_cycles( cpuInstructionCycles, _mnemonic, mode, _branch );
+
+    if ( !strcasecmp( _mnemonic, "LD" ) && k1 == CYCLES_OPERAND_IND && k2 == CYCLES_OPERAND_IMM ) {
+        // LD (HL), n
+        cycles = 12;
+    }
+
+    return cycles;
+
+}
+
+/* split an instruction into mnemonic, destination and source (without spaces) */
+static int cpu_inline_split( char * _line, char * _mnemonic, char * _destination, char * _source ) {
+
+    char operands[MAX_TEMPORARY_STORAGE];
+    int i = 0;
+
+    if ( sscanf( _line, " %s", _mnemonic ) != 1 ) {
+        return 0;
+    }
+
+    char * p = strstr( _line, _mnemonic ) + strlen( _mnemonic );
+    for( ; *p && *p != ';' && i < MAX_TEMPORARY_STORAGE - 1; ++p ) {
+        if ( *p != ' ' && *p != '\t' && *p != '\r' ) {
+            operands[i++] = *p;
+        }
+    }
+    operands[i] = 0;
+
+    char * comma = strchr( operands, ',' );
+    if ( !comma ) {
+        return 0;
+    }
+    *comma = 0;
+    strcpy( _destination, operands );
+    strcpy( _source, comma + 1 );
+
+    return 1;
+
+}
+
+/* size of the register loaded from memory with LD, 0 if not supported */
+static int cpu_inline_register( char * _register ) {
+
+    if ( !strcasecmp( _register, "A" ) ) {
+        return 1;
+    }
+    return 0;
+
+}
+
+/**
+ * @brief <i>SM83</i>: check if an instruction only reads a variable
+ * 
+ * This function is used when a procedure is expanded inline, to decide
+ * if a parameter can be replaced by the argument (or by a constant).
+ * 
+ * @param _environment Current calling environment
+ * @param _line Line of assembly that uses the variable
+ * @param _name Name of the variable (in the assembly source)
+ * @return Offset of the byte read (if it is a plain read), -1 otherwise
+ */
+int cpu_inline_read( Environment * _environment, char * _line, char * _name ) {
+
+    char mnemonic[MAX_TEMPORARY_STORAGE];
+    char destination[MAX_TEMPORARY_STORAGE];
+    char source[MAX_TEMPORARY_STORAGE];
+
+    if ( !cpu_inline_split( _line, mnemonic, destination, source ) ) {
+        return -1;
+    }
+
+    if ( strcasecmp( mnemonic, "LD" ) || !cpu_inline_register( destination ) ) {
+        return -1;
+    }
+
+    int length = strlen( _name );
+
+    if ( source[0] != '(' || strncmp( source + 1, _name, length ) ) {
+        return -1;
+    }
+
+    if ( !strcmp( source + 1 + length, ")" ) ) {
+        return 0;
+    }
+
+    if ( source[1 + length] == '+' ) {
+        char * end;
+        int offset = strtol( source + 2 + length, &end, 10 );
+        if ( !strcmp( end, ")" ) ) {
+            return offset;
+        }
+    }
+
+    return -1;
+
+}
+
+/**
+ * @brief <i>SM83</i>: rewrite a read of a variable as an immediate value
+ * 
+ * @param _environment Current calling environment
+ * @param _line Line of assembly that reads the variable
+ * @param _name Name of the variable (in the assembly source)
+ * @param _size Size of the variable (in bytes)
+ * @param _value Value of the variable
+ * @param _result Rewritten line
+ * @return 1 if the line has been rewritten, 0 otherwise
+ */
+int cpu_inline_constant( Environment * _environment, char * _line, char * _name, int _size, int _value, char * _result ) {
+
+    char mnemonic[MAX_TEMPORARY_STORAGE];
+    char destination[MAX_TEMPORARY_STORAGE];
+    char source[MAX_TEMPORARY_STORAGE];
+
+    int offset = cpu_inline_read( _environment, _line, _name );
+
+    if ( offset < 0 ) {
+        return 0;
+    }
+
+    cpu_inline_split( _line, mnemonic, destination, source );
+
+    int width = cpu_inline_register( destination );
+
+    if ( offset + width > _size ) {
+        return 0;
+    }
+
+    if ( width == 1 ) {
+        sprintf( _result, "\tLD %s, $%2.2x", destination, ( _value >> ( 8 * offset ) ) & 0xff );
+    } else {
+        sprintf( _result, "\tLD %s, $%4.4x", destination, ( _value >> ( 8 * offset ) ) & 0xffff );
+    }
+
+    return 1;
+
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,115 @@
+; /*****************************************************************************
+;  * ugBASIC - an isomorphic BASIC language compiler for retrocomputers        *
+;  *****************************************************************************
+;  * Copyright 2021-2025 Marco Spedaletti (asimov@mclink.it)
+;  *
+;  * Licensed under the Apache License, Version 2.0 (the "License");
+;  * you may not use this file except in compliance with the License.
+;  * You may obtain a copy of the License at
+;  *
+;  * http://www.apache.org/licenses/LICENSE-2.0
+;  *
+;  * Unless required by applicable law or agreed to in writing, software
+;  * distributed under the License is distributed on an "AS IS" BASIS,
+;  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+;  * See the License for the specific language governing permissions and
+;  * limitations under the License.
+;  *----------------------------------------------------------------------------
+;  * Concesso in licenza secondo i termini della Licenza Apache, versione 2.0
+;  * (la "Licenza"); è proibito usare questo file se non in conformità alla
+;  * Licenza. Una copia della Licenza è disponibile all'indirizzo:
+;  *
+;  * http://www.apache.org/licenses/LICENSE-2.0
+;  *
+;  * Se non richiesto dalla legislazione vigente o concordato per iscritto,
+;  * il software distribuito nei termini della Licenza è distribuito
+;  * "COSì COM'è", SENZA GARANZIE O CONDIZIONI DI ALCUN TIPO, esplicite o
+;  * implicite. Consultare la Licenza per il testo specifico che regola le
+;  * autorizzazioni e le limitazioni previste dalla medesima.
+;  ****************************************************************************/
+;* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+;*                                                                             *
+;*                        DOUBLE BUFFER ROUTINE ON TED                         *
+;*                                                                             *
+;*                             by Marco Spedaletti                             *
+;*                                                                             *
+;* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+; The double buffer is done on the video matrix (attributes + characters),
+; so it is available only on tilemap modes. The visible matrix is the one
+; selected by $FF14 ($0800 or $5800), while COLORMAPADDRESS and TEXTADDRESS
+; point to the hidden one, where all the drawing goes. The second matrix 
+; lives just after the program area ($57FF) and before the bitmap ($6000).
+
+DOUBLEBUFFERINIT:
+    LDA $FF06
+    AND #$20
+    BNE DOUBLEBUFFERINITX
+    LDA #$08
+    STA TMPPTR+1
+    LDA #$58
+    STA TMPPTR2+1
+    STA COLORMAPADDRESS+1
+    LDA #$5C
+    STA TEXTADDRESS+1
+    JMP DOUBLEBUFFERCOPY
+DOUBLEBUFFERINITX:
+    RTS
+
+DOUBLEBUFFERCLEANUP:
+    LDA $FF06
+    AND #$20
+    BNE DOUBLEBUFFERCLEANUPX
+    LDA #$08
+    STA COLORMAPADDRESS+1
+    LDA #$0C
+    STA TEXTADDRESS+1
+    LDA $FF14
+    AND #$F8
+    CMP #$58
+    BNE DOUBLEBUFFERCLEANUPX
+    JSR VBL
+    LDA $FF14
+    AND #$07
+    ORA #$08
+    STA $FF14
+    LDA #$58
+    STA TMPPTR+1
+    LDA #$08
+    STA TMPPTR2+1
+    JMP DOUBLEBUFFERCOPY
+DOUBLEBUFFERCLEANUPX:
+    RTS
+
+; Show the hidden video matrix (at the next vertical blank) and make the 
+; other one the hidden matrix, with the same content of the visible one.
+
+SWITCHSCREEN:
+    LDA $FF06
+    AND #$20
+    BNE DOUBLEBUFFERCLEANUPX
+    JSR VBL
+    LDA $FF14
+    AND #$07
+    ORA COLORMAPADDRESS+1
+    STA $FF14
+    LDA COLORMAPADDRESS+1
+    STA TMPPTR+1
+    EOR #$50
+    STA TMPPTR2+1
+    STA COLORMAPADDRESS+1
+    ORA #$04
+    STA TEXTADDRESS+1
+
+; Copy a video matrix from (TMPPTR) to (TMPPTR2): 1000 attributes, the
+; 24 unused bytes and 1000 characters.
+
+DOUBLEBUFFERCOPY:
+    LDA #0
+    STA TMPPTR
+    STA TMPPTR2
+    LDA #<($0400+1000)
+    STA MATHPTR0
+    LDA #>($0400+1000)
+    STA MATHPTR0+1
+    JMP CPUMEMMOVE
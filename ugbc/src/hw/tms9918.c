@@ -600,6 +600,10 @@ int tms9918_screen_mode_enable( Environment * _environment, ScreenMode * _screen
     cpu_store_8bit( _environment, "_PEN", _environment->defaultPenColor );
     cpu_store_8bit( _environment, "_PAPER", _environment->defaultPaperColor );
 
+    if ( _environment->screenCache ) {
+        outline0("CALL VDPSHADOWINVALIDATE");
+    }
+
 // #ifdef __coleco__
 
 //     MAKE_LABEL
@@ -1651,6 +1655,8 @@ void tms9918_initialization( Environment * _environment ) {
     variable_global( _environment, "VBLFLAG" ); 
     variable_import( _environment, "VDPINUSE", VT_BYTE, 0 );
     variable_global( _environment, "VDPINUSE" );
+    variable_import( _environment, "DOUBLEBUFFERTMP", VT_BUFFER, 32 );
+    variable_global( _environment, "DOUBLEBUFFERTMP" );
 
     variable_import( _environment, "SLICEX", VT_POSITION, 0 );
     variable_global( _environment, "SLICEX" );
@@ -132,8 +132,12 @@ CLINE0CL1:
     PUSH DE
     PUSH BC
     LD DE, HL
+@IF screenCache
+    CALL VDPSHADOWOUTCHAR
+@ELSE
     LD BC, 1
     CALL VDPOUTCHAR
+@ENDIF
     POP BC
     POP DE
 
@@ -37,6 +37,10 @@
 
 CLSBOX:
 
+@IF screenCache
+    CALL VDPSHADOWSYNC
+@ENDIF
+
     LD A, (CURRENTTILEMODE)
     CP 1
     RET Z
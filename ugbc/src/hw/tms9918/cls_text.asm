@@ -110,4 +110,7 @@ CLST3:
     JP CLSTDONE
 
 CLSTDONE:
+@IF screenCache
+    CALL VDPSHADOWCLEAR
+@ENDIF
     RET
\ No newline at end of file
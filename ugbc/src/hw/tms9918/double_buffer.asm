@@ -0,0 +1,152 @@
+; /*****************************************************************************
+;  * ugBASIC - an isomorphic BASIC language compiler for retrocomputers        *
+;  *****************************************************************************
+;  * Copyright 2021-2025 Marco Spedaletti (asimov@mclink.it)
+;  *
+;  * Licensed under the Apache License, Version 2.0 (the "License");
+;  * you may not use this file except in compliance with the License.
+;  * You may obtain a copy of the License at
+;  *
+;  * http://www.apache.org/licenses/LICENSE-2.0
+;  *
+;  * Unless required by applicable law or agreed to in writing, software
+;  * distributed under the License is distributed on an "AS IS" BASIS,
+;  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+;  * See the License for the specific language governing permissions and
+;  * limitations under the License.
+;  *----------------------------------------------------------------------------
+;  * Concesso in licenza secondo i termini della Licenza Apache, versione 2.0
+;  * (la "Licenza"); è proibito usare questo file se non in conformità alla
+;  * Licenza. Una copia della Licenza è disponibile all'indirizzo:
+;  *
+;  * http://www.apache.org/licenses/LICENSE-2.0
+;  *
+;  * Se non richiesto dalla legislazione vigente o concordato per iscritto,
+;  * il software distribuito nei termini della Licenza è distribuito
+;  * "COSì COM'è", SENZA GARANZIE O CONDIZIONI DI ALCUN TIPO, esplicite o
+;  * implicite. Consultare la Licenza per il testo specifico che regola le
+;  * autorizzazioni e le limitazioni previste dalla medesima.
+;  ****************************************************************************/
+;* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+;*                                                                             *
+;*                      DOUBLE BUFFER ROUTINE ON TMS9918                       *
+;*                                                                             *
+;*                             by Marco Spedaletti                             *
+;*                                                                             *
+;* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+; The double buffer is done on the name table. The visible table is the one 
+; selected by register 2, while TEXTADDRESS points to the hidden one, where
+; all the drawing goes. The two tables are 1 KB apart (register 2 and 
+; register 2 + 1): every screen mode places the name table on an even 
+; page, and leaves the next one free.
+
+DOUBLEBUFFERINIT:
+@IF screenCache
+    CALL VDPSHADOWSYNC
+@ENDIF
+    LD HL, (TEXTADDRESS)
+    LD A, H
+    OR $04
+    LD D, A
+    LD E, L
+    LD (TEXTADDRESS), DE
+    JP DOUBLEBUFFERCOPY
+
+DOUBLEBUFFERCLEANUP:
+@IF screenCache
+    CALL VDPSHADOWSYNC
+@ENDIF
+    LD HL, (TEXTADDRESS)
+    LD A, H
+    XOR $04
+    LD H, A
+    LD (TEXTADDRESS), HL
+    RET
+
+; Show the hidden name table (at the next vertical blank) and make the 
+; other one the hidden table, with the same content of the visible one.
+
+SWITCHSCREEN:
+@IF screenCache
+    CALL VDPSHADOWSEND
+@ENDIF
+    LD HL, (TEXTADDRESS)
+    LD A, H
+    SRL A
+    SRL A
+    LD E, VDP_RNAME
+    PUSH AF
+    CALL VDPLOCK
+    CALL VDPREGIN
+SWITCHSCREENL1:
+    CALL VDPREGIN
+    AND $80
+    JR Z, SWITCHSCREENL1
+    POP AF
+    CALL VDPSETREGI
+    CALL VDPUNLOCK
+    LD A, H
+    XOR $04
+    LD D, A
+    LD E, L
+    LD (TEXTADDRESS), DE
+
+; Copy a name table from HL to DE, in chunks of 32 bytes. Only the used part
+; of the table (CURRENTTILESWIDTH x CURRENTTILESHEIGHT) is copied: in bitmap
+; modes the sprite attribute table follows the name table at $3B00.
+
+DOUBLEBUFFERCOPY:
+    PUSH HL
+    PUSH DE
+    LD A, (CURRENTTILESWIDTH)
+    LD E, A
+    LD D, 0
+    LD HL, 0
+    LD A, (CURRENTTILESHEIGHT)
+    LD B, A
+DOUBLEBUFFERCOPYL0:
+    ADD HL, DE
+    DJNZ DOUBLEBUFFERCOPYL0
+    LD DE, 31
+    ADD HL, DE
+    ADD HL, HL
+    ADD HL, HL
+    ADD HL, HL
+    LD B, H
+    POP DE
+    POP HL
+DOUBLEBUFFERCOPYL1:
+    PUSH BC
+    CALL VDPLOCK
+    PUSH DE
+    LD D, H
+    LD E, L
+    CALL VDPREADADDR
+    LD DE, DOUBLEBUFFERTMP
+    LD B, 32
+DOUBLEBUFFERCOPYL2:
+    CALL VDPRAMIN
+    LD (DE), A
+    INC DE
+    DJNZ DOUBLEBUFFERCOPYL2
+    POP DE
+    CALL VDPWRITEADDR
+    PUSH HL
+    LD HL, DOUBLEBUFFERTMP
+    LD B, 32
+DOUBLEBUFFERCOPYL3:
+    LD A, (HL)
+    CALL VDPRAMOUT
+    INC HL
+    DJNZ DOUBLEBUFFERCOPYL3
+    POP HL
+    CALL VDPUNLOCK
+    LD BC, 32
+    ADD HL, BC
+    EX DE, HL
+    ADD HL, BC
+    EX DE, HL
+    POP BC
+    DJNZ DOUBLEBUFFERCOPYL1
+    RET
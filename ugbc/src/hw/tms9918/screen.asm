@@ -77,8 +77,12 @@ SCREENSP0:
     PUSH DE
     PUSH BC
     LD DE, HL
+@IF screenCache
+    CALL VDPSHADOWINCHAR
+@ELSE
     LD BC, 1
     CALL VDPINCHAR
+@ENDIF
     POP BC
     POP DE
 
@@ -442,6 +442,335 @@ VDP_RSPRITEA        EQU 85H
 VDP_RSPRITEP        EQU 86H
 VDP_RCOLOR          EQU 87H
 
+@IF screenCache
+
+; ------------------------------------------------------------------------------
+; SCREEN CACHE (DEFINE SCREEN CACHE)
+;
+; A copy of the name table (32 x 24 modes only) is kept in VDPSHADOW.
+; Text output and text scrolling work on it, and remember for each row
+; the first and the last column changed (VDPSHADOWDIRTY, 24 + 24 bytes,
+; $FF / $00 for a clean row). The rows are then sent to VRAM during the
+; vertical blank by VDPSHADOWFLUSH, VDPSHADOWBUDGET rows at a time.
+; Routines that still write directly into the name table must call
+; VDPSHADOWSYNC before doing it: the shadow will be read back from VRAM
+; the next time it is needed.
+; ------------------------------------------------------------------------------
+
+VDPSHADOWBUDGET     EQU 8
+
+; Make the shadow usable, reloading it from VRAM if needed.
+;  Out: Z if the shadow can be used.
+VDPSHADOWREADY:
+    LD A, (VDPSHADOWVALID)
+    CP 1
+    RET Z
+    LD A, (CURRENTTILESWIDTH)
+    CP 32
+    RET NZ
+    PUSH BC
+    PUSH DE
+    PUSH HL
+    CALL VDPLOCK
+    LD DE, (TEXTADDRESS)
+    CALL VDPREADADDR
+    LD HL, VDPSHADOW
+    LD BC, 768
+VDPSHADOWREADYL1:
+    CALL VDPRAMIN
+    LD (HL), A
+    INC HL
+    DEC BC
+    LD A, B
+    OR C
+    JR NZ, VDPSHADOWREADYL1
+    CALL VDPSHADOWCLEAN
+    CALL VDPUNLOCK
+    POP HL
+    POP DE
+    POP BC
+    CP A
+    RET
+
+; Mark all rows as clean, and the shadow as valid.
+VDPSHADOWCLEAN:
+    LD HL, VDPSHADOWDIRTY
+    LD B, 24
+VDPSHADOWCLEANL1:
+    LD (HL), $FF
+    INC HL
+    DJNZ VDPSHADOWCLEANL1
+    LD B, 24
+VDPSHADOWCLEANL2:
+    LD (HL), 0
+    INC HL
+    DJNZ VDPSHADOWCLEANL2
+    XOR A
+    LD (VDPSHADOWPENDING), A
+    INC A
+    LD (VDPSHADOWVALID), A
+    RET
+
+; The name table has been filled with EMPTYTILE (CLS).
+VDPSHADOWCLEAR:
+    XOR A
+    LD (VDPSHADOWPENDING), A
+    LD (VDPSHADOWVALID), A
+    LD A, (CURRENTTILESWIDTH)
+    CP 32
+    RET NZ
+    LD HL, VDPSHADOW
+    LD DE, VDPSHADOW+1
+    LD BC, 767
+    LD A, (EMPTYTILE)
+    LD (HL), A
+    LDIR
+    JP VDPSHADOWCLEAN
+
+; The name table has been moved or changed under our feet.
+VDPSHADOWINVALIDATE:
+    XOR A
+    LD (VDPSHADOWPENDING), A
+    LD (VDPSHADOWVALID), A
+    RET
+
+; Translate a name table address into a position on the shadow.
+;  In : DE address into VRAM
+;  Out: HL address into VDPSHADOW, B row, C column
+VDPSHADOWADDR:
+    PUSH DE
+    LD HL, (TEXTADDRESS)
+    EX DE, HL
+    AND A
+    SBC HL, DE
+    LD A, L
+    AND $1F
+    LD C, A
+    LD A, L
+    RLCA
+    RLCA
+    RLCA
+    AND $07
+    LD B, A
+    LD A, H
+    ADD A, A
+    ADD A, A
+    ADD A, A
+    OR B
+    LD B, A
+    LD DE, VDPSHADOW
+    ADD HL, DE
+    POP DE
+    RET
+
+; Mark a rectangle of the shadow as changed.
+;  In : B first row, D number of rows, C first column, E last column
+VDPSHADOWMARK:
+    PUSH HL
+    PUSH BC
+    PUSH DE
+    CALL VDPLOCK
+    LD HL, VDPSHADOWDIRTY
+    LD A, L
+    ADD A, B
+    LD L, A
+    JR NC, VDPSHADOWMARKL1
+    INC H
+VDPSHADOWMARKL1:
+    LD A, (HL)
+    CP C
+    JR C, VDPSHADOWMARKL2
+    LD (HL), C
+VDPSHADOWMARKL2:
+    PUSH DE
+    LD DE, 24
+    ADD HL, DE
+    POP DE
+    LD A, (HL)
+    CP E
+    JR NC, VDPSHADOWMARKL3
+    LD (HL), E
+VDPSHADOWMARKL3:
+    PUSH DE
+    LD DE, -23
+    ADD HL, DE
+    POP DE
+    DEC D
+    JR NZ, VDPSHADOWMARKL1
+    LD A, 1
+    LD (VDPSHADOWPENDING), A
+    CALL VDPUNLOCK
+    POP DE
+    POP BC
+    POP HL
+    RET
+
+; Write a character into the name table, through the shadow.
+;  In : DE address into VRAM, A character
+VDPSHADOWOUTCHAR:
+    PUSH AF
+    CALL VDPSHADOWREADY
+    JR NZ, VDPSHADOWOUTCHARDIRECT
+    POP AF
+    PUSH BC
+    PUSH DE
+    PUSH HL
+    PUSH AF
+    CALL VDPSHADOWADDR
+    POP AF
+    LD (HL), A
+    LD E, C
+    LD D, 1
+    CALL VDPSHADOWMARK
+    POP HL
+    POP DE
+    POP BC
+    RET
+VDPSHADOWOUTCHARDIRECT:
+    POP AF
+    PUSH BC
+    LD BC, 1
+    CALL VDPOUTCHAR
+    POP BC
+    RET
+
+; Read a character from the name table, through the shadow.
+;  In : DE address into VRAM
+;  Out: A character
+VDPSHADOWINCHAR:
+    CALL VDPSHADOWREADY
+    JR NZ, VDPSHADOWINCHARDIRECT
+    PUSH BC
+    PUSH HL
+    CALL VDPSHADOWADDR
+    LD A, (HL)
+    POP HL
+    POP BC
+    RET
+VDPSHADOWINCHARDIRECT:
+    PUSH BC
+    LD BC, 1
+    CALL VDPINCHAR
+    POP BC
+    RET
+
+; Take the dirty run of a row, and prepare to send it to VRAM.
+;  In : E row
+;  Out: Z if the row is clean, otherwise HL source, B count and the
+;       VDP ready to receive the data.
+VDPSHADOWROW:
+    PUSH DE
+    LD HL, VDPSHADOWDIRTY
+    LD D, 0
+    ADD HL, DE
+    LD C, (HL)
+    LD (HL), $FF
+    LD DE, 24
+    ADD HL, DE
+    LD A, (HL)
+    LD (HL), 0
+    POP DE
+    SUB C
+    JR C, VDPSHADOWROWCLEAN
+    INC A
+    LD B, A
+    LD H, 0
+    LD L, E
+    ADD HL, HL
+    ADD HL, HL
+    ADD HL, HL
+    ADD HL, HL
+    ADD HL, HL
+    LD A, L
+    OR C
+    LD L, A
+    PUSH DE
+    PUSH HL
+    LD DE, (TEXTADDRESS)
+    ADD HL, DE
+    EX DE, HL
+    CALL VDPWRITEADDR
+    POP HL
+    LD DE, VDPSHADOW
+    ADD HL, DE
+    POP DE
+    XOR A
+    INC A
+    RET
+VDPSHADOWROWCLEAN:
+    XOR A
+    RET
+
+; Called by the vertical blank handler: the VDP is free, and it can
+; receive data at full speed.
+VDPSHADOWFLUSH:
+    LD A, (VDPSHADOWPENDING)
+    CP 0
+    RET Z
+    PUSH BC
+    PUSH DE
+    PUSH HL
+    LD D, VDPSHADOWBUDGET
+    LD E, 0
+VDPSHADOWFLUSHL1:
+    CALL VDPSHADOWROW
+    JR Z, VDPSHADOWFLUSHNEXT
+    LD A, (VDPDATAPORTWRITE)
+    LD C, A
+    OTIR
+    DEC D
+    JR Z, VDPSHADOWFLUSHDONE
+VDPSHADOWFLUSHNEXT:
+    INC E
+    LD A, E
+    CP 24
+    JR NZ, VDPSHADOWFLUSHL1
+    XOR A
+    LD (VDPSHADOWPENDING), A
+VDPSHADOWFLUSHDONE:
+    POP HL
+    POP DE
+    POP BC
+    RET
+
+; Send everything to VRAM now, and forget the shadow.
+VDPSHADOWSYNC:
+    CALL VDPSHADOWSEND
+    JP VDPSHADOWINVALIDATE
+
+; Send everything to VRAM now.
+VDPSHADOWSEND:
+    LD A, (VDPSHADOWVALID)
+    CP 0
+    RET Z
+    PUSH BC
+    PUSH DE
+    PUSH HL
+    CALL VDPLOCK
+    LD E, 0
+VDPSHADOWSENDL1:
+    CALL VDPSHADOWROW
+    JR Z, VDPSHADOWSENDNEXT
+VDPSHADOWSENDL2:
+    LD A, (HL)
+    CALL VDPRAMOUT
+    INC HL
+    DJNZ VDPSHADOWSENDL2
+VDPSHADOWSENDNEXT:
+    INC E
+    LD A, E
+    CP 24
+    JR NZ, VDPSHADOWSENDL1
+    XOR A
+    LD (VDPSHADOWPENDING), A
+    CALL VDPUNLOCK
+    POP HL
+    POP DE
+    POP BC
+    RET
+
+@ENDIF
+
 ONSCROLLVOID:
     RET
 
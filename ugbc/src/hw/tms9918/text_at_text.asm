@@ -372,8 +372,12 @@ TEXTATSP0:
     PUSH DE
     PUSH BC
     LD DE, HL
+@IF screenCache
+    CALL VDPSHADOWOUTCHAR
+@ELSE
     LD BC, 1
     CALL VDPOUTCHAR
+@ENDIF
     POP BC
     POP DE
     POP AF
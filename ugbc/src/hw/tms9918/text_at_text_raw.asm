@@ -140,8 +140,12 @@ TEXTATRAWSP0:
     PUSH DE
     PUSH BC
     LD DE, HL
+@IF screenCache
+    CALL VDPSHADOWOUTCHAR
+@ELSE
     LD BC, 1
     CALL VDPOUTCHAR
+@ENDIF
     POP BC
     POP DE
     POP AF
@@ -148,8 +148,12 @@ PUTTILEL2:
     PUSH BC
     LD A, (TILET)
     LD DE, HL
+@IF screenCache
+    CALL VDPSHADOWOUTCHAR
+@ELSE
     LD BC, 1
     CALL VDPOUTCHAR
+@ENDIF
     POP BC
 
     PUSH HL
@@ -460,7 +464,12 @@ TILEATL1:
     LD D, 0
     ADD HL, DE
 
+@IF screenCache
+    LD DE, HL
+    CALL VDPSHADOWINCHAR
+@ELSE
     CALL VDPINCHAR
+@ENDIF
 
     LD (TILET), A
 TILEATEE:
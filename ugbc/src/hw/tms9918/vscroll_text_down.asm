@@ -58,6 +58,11 @@ VSCROLLTDOWNNMI2:
     CP 0
     RET Z
 
+@IF screenCache
+    CALL VDPSHADOWREADY
+    JP Z, VSCROLLTDOWNSHADOW
+@ENDIF
+
     LD A, (CURRENTMODE)
     CP 0
     JR Z,VSCROLLTDOWN0
@@ -164,4 +169,23 @@ VSCROLLTDOWNX3:
     JP VSCROLLTDOWNDONE
 
 VSCROLLTDOWNDONE:
-    RET
\ No newline at end of file
+    RET
+
+@IF screenCache
+
+    ; Move the whole name table on the shadow, and let it
+    ; be sent to VRAM during the vertical blank.
+
+VSCROLLTDOWNSHADOW:
+    LD HL, VDPSHADOW + 32 * 23 - 1
+    LD DE, VDPSHADOW + 32 * 24 - 1
+    LD BC, 32 * 23
+    LDDR
+
+    LD B, 0
+    LD D, 24
+    LD C, 0
+    LD E, 31
+    JP VDPSHADOWMARK
+
+@ENDIF
\ No newline at end of file
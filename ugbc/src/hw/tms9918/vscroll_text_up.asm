@@ -68,6 +68,11 @@ VSCROLLTUPNMI2:
     CP 0
     RET Z
 
+@IF screenCache
+    CALL VDPSHADOWREADY
+    JP Z, VSCROLLTUPSHADOW
+@ENDIF
+
     LD A, (CURRENTMODE)
     CP 0
     JR Z,VSCROLLTUP0
@@ -202,4 +207,67 @@ VSCROLLTUPX2:
     JP VSCROLLTUPDONE
 
 VSCROLLTUPDONE:
-    RET
\ No newline at end of file
+    RET
+
+@IF screenCache
+
+    ; Move the rows of the console on the shadow, and let them
+    ; be sent to VRAM during the vertical blank.
+
+VSCROLLTUPSHADOW:
+    LD A, (CONSOLEY1)
+    LD L, A
+    LD H, 0
+    ADD HL, HL
+    ADD HL, HL
+    ADD HL, HL
+    ADD HL, HL
+    ADD HL, HL
+    LD A, (CONSOLEX1)
+    LD E, A
+    LD D, 0
+    ADD HL, DE
+    LD DE, VDPSHADOW
+    ADD HL, DE
+
+    LD A, (CONSOLEH)
+    DEC A
+    JR Z, VSCROLLTUPSHADOWCLEAR
+    LD B, A
+VSCROLLTUPSHADOWL1:
+    PUSH BC
+    LD D, H
+    LD E, L
+    LD BC, 32
+    ADD HL, BC
+    PUSH HL
+    LD A, (CONSOLEW)
+    LD C, A
+    LD B, 0
+    LDIR
+    POP HL
+    POP BC
+    DJNZ VSCROLLTUPSHADOWL1
+
+VSCROLLTUPSHADOWCLEAR:
+    LD A, (CONSOLEW)
+    LD B, A
+    LD A, (EMPTYTILE)
+VSCROLLTUPSHADOWL2:
+    LD (HL), A
+    INC HL
+    DJNZ VSCROLLTUPSHADOWL2
+
+    LD A, (CONSOLEY1)
+    LD B, A
+    LD A, (CONSOLEH)
+    LD D, A
+    LD A, (CONSOLEX1)
+    LD C, A
+    LD A, (CONSOLEW)
+    DEC A
+    ADD A, C
+    LD E, A
+    JP VDPSHADOWMARK
+
+@ENDIF
\ No newline at end of file
@@ -0,0 +1,130 @@
+; /*****************************************************************************
+;  * ugBASIC - an isomorphic BASIC language compiler for retrocomputers        *
+;  *****************************************************************************
+;  * Copyright 2021-2025 Marco Spedaletti (asimov@mclink.it)
+;  *
+;  * Licensed under the Apache License, Version 2.0 (the "License");
+;  * you may not use this file except in compliance with the License.
+;  * You may obtain a copy of the License at
+;  *
+;  * http://www.apache.org/licenses/LICENSE-2.0
+;  *
+;  * Unless required by applicable law or agreed to in writing, software
+;  * distributed under the License is distributed on an "AS IS" BASIS,
+;  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+;  * See the License for the specific language governing permissions and
+;  * limitations under the License.
+;  *----------------------------------------------------------------------------
+;  * Concesso in licenza secondo i termini della Licenza Apache, versione 2.0
+;  * (la "Licenza"); è proibito usare questo file se non in conformità alla
+;  * Licenza. Una copia della Licenza è disponibile all'indirizzo:
+;  *
+;  * http://www.apache.org/licenses/LICENSE-2.0
+;  *
+;  * Se non richiesto dalla legislazione vigente o concordato per iscritto,
+;  * il software distribuito nei termini della Licenza è distribuito
+;  * "COSì COM'è", SENZA GARANZIE O CONDIZIONI DI ALCUN TIPO, esplicite o
+;  * implicite. Consultare la Licenza per il testo specifico che regola le
+;  * autorizzazioni e le limitazioni previste dalla medesima.
+;  ****************************************************************************/
+;* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+;*                                                                             *
+;*                      DOUBLE BUFFER ROUTINE ON VIC-I                         *
+;*                                                                             *
+;*                             by Marco Spedaletti                             *
+;*                                                                             *
+;* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+
+; The double buffer is done on the video matrix (characters + colors), so
+; it is available only on tilemap mode. The visible matrix is selected by
+; bit 7 of $9002 (bit 9 of the address of the screen): $1000, with colors
+; at $9400, or $1200, with colors at $9600. COLORMAPADDRESS and TEXTADDRESS
+; point to the hidden one, where all the drawing goes. The second matrix 
+; takes the place of the BASIC stub, that is not needed anymore once the
+; program is running, and ends before the user defined characters ($1800).
+
+DOUBLEBUFFERINIT:
+    LDA CURRENTMODE
+    BNE DOUBLEBUFFERINITX
+    LDA #$12
+    STA TEXTADDRESS+1
+    LDA #$96
+    STA COLORMAPADDRESS+1
+    LDA $9002
+    AND #$7F
+    STA $9002
+    LDA #$10
+    JMP DOUBLEBUFFERCOPY
+DOUBLEBUFFERINITX:
+    RTS
+
+DOUBLEBUFFERCLEANUP:
+    LDA CURRENTMODE
+    BNE DOUBLEBUFFERCLEANUPX
+    LDA #$10
+    STA TEXTADDRESS+1
+    LDA #$94
+    STA COLORMAPADDRESS+1
+    LDA $9002
+    BPL DOUBLEBUFFERCLEANUPX
+    JSR VBL
+    LDA $9002
+    AND #$7F
+    STA $9002
+    LDA #$12
+    JMP DOUBLEBUFFERCOPY
+DOUBLEBUFFERCLEANUPX:
+    RTS
+
+; Show the hidden video matrix (at the next vertical blank) and make the 
+; other one the hidden matrix, with the same content of the visible one.
+
+SWITCHSCREEN:
+    LDA CURRENTMODE
+    BNE DOUBLEBUFFERCLEANUPX
+    JSR VBL
+    LDA $9002
+    EOR #$80
+    STA $9002
+    LDA TEXTADDRESS+1
+    PHA
+    EOR #$02
+    STA TEXTADDRESS+1
+    CLC
+    ADC #$84
+    STA COLORMAPADDRESS+1
+    PLA
+
+; Copy the video matrix at the page in A ($10 or $12) to the other one,
+; and then the related colors (at $94 or $96): two pages for each.
+
+DOUBLEBUFFERCOPY:
+    STA TMPPTR+1
+    EOR #$02
+    STA TMPPTR2+1
+    JSR DOUBLEBUFFERCOPYPAGES
+    LDA TMPPTR+1
+    CLC
+    ADC #$82
+    STA TMPPTR+1
+    LDA TMPPTR2+1
+    CLC
+    ADC #$82
+    STA TMPPTR2+1
+DOUBLEBUFFERCOPYPAGES:
+    LDA #0
+    STA TMPPTR
+    STA TMPPTR2
+    LDX #2
+DOUBLEBUFFERCOPYL1:
+    LDY #0
+DOUBLEBUFFERCOPYL2:
+    LDA (TMPPTR),Y
+    STA (TMPPTR2),Y
+    INY
+    BNE DOUBLEBUFFERCOPYL2
+    INC TMPPTR+1
+    INC TMPPTR2+1
+    DEX
+    BNE DOUBLEBUFFERCOPYL1
+    RTS
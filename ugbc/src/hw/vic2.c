@@ -2247,6 +2247,8 @@ void vic2_initialization( Environment * _environment ) {
 
     variable_import( _environment, "SPRITECOUNT", VT_SPRITE, 0 );
     variable_global( _environment, "SPRITECOUNT" );
+    variable_import( _environment, "MSPRITESDROPPED", VT_BYTE, 0 );
+    variable_global( _environment, "MSPRITESDROPPED" );
 
     _environment->fontWidth = 8;
     _environment->fontHeight = 8;
@@ -204,6 +204,26 @@ CLSBOX2:
         ; Note that IMAGEW could be > 256: this
         ; case will be threated after this one.
 
+@IF C64REU
+
+        ; On REU, the whole row is cleared by the DMA controller.
+
+    CLSBOX2REU:
+        LDA PLOTDEST
+        STA REUMEMDST
+        LDA PLOTDEST+1
+        STA REUMEMDST+1
+        LDA IMAGEW
+        STA REUMEMLEN
+        LDA IMAGEW+1
+        STA REUMEMLEN+1
+        LDA #0
+        STA REUMEMVALUE
+        JSR REUMEMFILL
+        JMP CLSBOX2L1XX
+
+@ENDIF
+
         LDY #0
         LDA #0
     CLSBOX2L1:
@@ -291,7 +311,11 @@ CLSBOX2:
 
         LDY #0
         LDA #0
+@IF C64REU
+        JMP CLSBOX2REU
+@ELSE
         JMP CLSBOX2L1
+@ENDIF
 
     ; Starting from this line, we are drawing the second
     ; color map, the map for 11 bitmap.
@@ -41,6 +41,43 @@ CLSG:
 
 @IF !vestigialConfig.screenModeUnique || ( ( currentMode == 2 ) || ( currentMode == 3 ) )
 
+@IF printCache && deployed.textAtGraphic
+    JSR TEXTATBMSHADOWRESET
+@ENDIF
+
+@IF C64REU
+
+    LDA BITMAPADDRESS
+    STA REUMEMDST
+    LDA BITMAPADDRESS+1
+    STA REUMEMDST+1
+    LDA #<8000
+    STA REUMEMLEN
+    LDA #>8000
+    STA REUMEMLEN+1
+    LDA #0
+    STA REUMEMVALUE
+    JSR REUMEMFILL
+
+    LDA COLORMAPADDRESS
+    STA REUMEMDST
+    LDA COLORMAPADDRESS+1
+    STA REUMEMDST+1
+    LDA #<1000
+    STA REUMEMLEN
+    LDA #>1000
+    STA REUMEMLEN+1
+    LDA _PEN
+    ASL A
+    ASL A
+    ASL A
+    ASL A
+    ORA _PAPER
+    STA REUMEMVALUE
+    JSR REUMEMFILL
+
+@ELSE
+
     LDA BITMAPADDRESS
     STA COPYOFBITMAPADDRESS
     LDA BITMAPADDRESS+1
@@ -90,6 +127,8 @@ CLGCNB:
     DEX
     BNE CLGC
 
+@ENDIF
+
 @IF !vestigialConfig.screenModeUnique
     LDA CURRENTMODE
     CMP #3
@@ -98,6 +137,18 @@ CLGCNB:
 
 @IF !vestigialConfig.screenModeUnique || ( currentMode == 3 ) 
 
+@IF C64REU
+
+    ; REUMEMLEN and REUMEMVALUE are still valid from the
+    ; color map clearing.
+    LDA #$00
+    STA REUMEMDST
+    LDA #$D8
+    STA REUMEMDST+1
+    JSR REUMEMFILL
+
+@ELSE
+
     LDA #$00
     STA COPYOFCOLORMAPADDRESS
     LDA #$D8
@@ -130,6 +181,8 @@ CLGCNB3:
 
 @ENDIF
 
+@ENDIF
+
 CLSGDONE:
 
     RTS
\ No newline at end of file
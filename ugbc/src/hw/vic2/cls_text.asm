@@ -39,6 +39,30 @@ CLST:
 
 @IF !vestigialConfig.screenModeUnique || ( ( currentMode == 0 ) || ( currentMode == 1 ) )
 
+@IF C64REU
+
+    LDA TEXTADDRESS
+    STA REUMEMDST
+    LDA TEXTADDRESS+1
+    STA REUMEMDST+1
+    LDA #<1000
+    STA REUMEMLEN
+    LDA #>1000
+    STA REUMEMLEN+1
+    LDA EMPTYTILE
+    STA REUMEMVALUE
+    JSR REUMEMFILL
+
+    LDA COLORMAPADDRESS
+    STA REUMEMDST
+    LDA COLORMAPADDRESS+1
+    STA REUMEMDST+1
+    LDA _PEN
+    STA REUMEMVALUE
+    JSR REUMEMFILL
+
+@ELSE
+
     LDA TEXTADDRESS
     STA COPYOFTEXTADDRESS
     LDA TEXTADDRESS+1
@@ -85,6 +109,8 @@ CLSTCNB:
     DEX
     BNE CLSTC
 
+@ENDIF
+
 @ENDIF
 
     RTS
@@ -125,6 +125,147 @@ HSCROLLSTL1C:
 
     LDX CONSOLEH
 
+@IF C64REU
+
+    ; Each row is moved by the REU, a column at a time,
+    ; and then the column left empty is filled.
+    LDY CONSOLEW
+    DEY
+    STY REUMEMLEN
+    LDA #0
+    STA REUMEMLEN+1
+
+HSCROLLSTREU:
+    LDA DIRECTION
+    CMP #$80
+    BCC HSCROLLSTREURIGHT
+
+HSCROLLSTREULEFT:
+
+@IF horizontalOverlapRequired
+    LDY #0
+    LDA (COPYOFTEXTADDRESS),Y
+    STA HSCROLLBUFFERCHARACTER
+    LDA (COPYOFCOLORMAPADDRESS),Y
+    STA HSCROLLBUFFERCOLOR
+@ENDIF
+
+    LDA COPYOFTEXTADDRESS2
+    STA REUMEMSRC
+    LDA COPYOFTEXTADDRESS2+1
+    STA REUMEMSRC+1
+    LDA COPYOFTEXTADDRESS
+    STA REUMEMDST
+    LDA COPYOFTEXTADDRESS+1
+    STA REUMEMDST+1
+    JSR REUMEMMOVE
+
+    LDA COPYOFCOLORMAPADDRESS2
+    STA REUMEMSRC
+    LDA COPYOFCOLORMAPADDRESS2+1
+    STA REUMEMSRC+1
+    LDA COPYOFCOLORMAPADDRESS
+    STA REUMEMDST
+    LDA COPYOFCOLORMAPADDRESS+1
+    STA REUMEMDST+1
+    JSR REUMEMMOVE
+
+    LDY REUMEMLEN
+    JSR HSCROLLSTREUFILL
+    JMP HSCROLLSTREUNEXT
+
+HSCROLLSTREURIGHT:
+
+@IF horizontalOverlapRequired
+    LDY REUMEMLEN
+    LDA (COPYOFTEXTADDRESS),Y
+    STA HSCROLLBUFFERCHARACTER
+    LDA (COPYOFCOLORMAPADDRESS),Y
+    STA HSCROLLBUFFERCOLOR
+@ENDIF
+
+    LDA COPYOFTEXTADDRESS
+    STA REUMEMSRC
+    LDA COPYOFTEXTADDRESS+1
+    STA REUMEMSRC+1
+    LDA COPYOFTEXTADDRESS2
+    STA REUMEMDST
+    LDA COPYOFTEXTADDRESS2+1
+    STA REUMEMDST+1
+    JSR REUMEMMOVE
+
+    LDA COPYOFCOLORMAPADDRESS
+    STA REUMEMSRC
+    LDA COPYOFCOLORMAPADDRESS+1
+    STA REUMEMSRC+1
+    LDA COPYOFCOLORMAPADDRESS2
+    STA REUMEMDST
+    LDA COPYOFCOLORMAPADDRESS2+1
+    STA REUMEMDST+1
+    JSR REUMEMMOVE
+
+    LDY #0
+    JSR HSCROLLSTREUFILL
+
+HSCROLLSTREUNEXT:
+
+    CLC
+    LDA CURRENTTILESWIDTH
+    ADC COPYOFTEXTADDRESS
+    STA COPYOFTEXTADDRESS
+    LDA #0
+    ADC COPYOFTEXTADDRESS+1
+    STA COPYOFTEXTADDRESS+1
+
+    CLC
+    LDA CURRENTTILESWIDTH
+    ADC COPYOFTEXTADDRESS2
+    STA COPYOFTEXTADDRESS2
+    LDA #0
+    ADC COPYOFTEXTADDRESS2+1
+    STA COPYOFTEXTADDRESS2+1
+
+    CLC
+    LDA CURRENTTILESWIDTH
+    ADC COPYOFCOLORMAPADDRESS
+    STA COPYOFCOLORMAPADDRESS
+    LDA #0
+    ADC COPYOFCOLORMAPADDRESS+1
+    STA COPYOFCOLORMAPADDRESS+1
+
+    CLC
+    LDA CURRENTTILESWIDTH
+    ADC COPYOFCOLORMAPADDRESS2
+    STA COPYOFCOLORMAPADDRESS2
+    LDA #0
+    ADC COPYOFCOLORMAPADDRESS2+1
+    STA COPYOFCOLORMAPADDRESS2+1
+
+    DEX
+    BNE HSCROLLSTREU
+    RTS
+
+HSCROLLSTREUFILL:
+
+@IF horizontalOverlapRequired
+    LDA PORT
+    BEQ HSCROLLSTREUFILLEMPTY
+    LDA HSCROLLBUFFERCHARACTER
+    STA (COPYOFTEXTADDRESS),Y
+    LDA HSCROLLBUFFERCOLOR
+    STA (COPYOFCOLORMAPADDRESS),Y
+    RTS
+HSCROLLSTREUFILLEMPTY:
+@ENDIF
+
+    LDA EMPTYTILE
+    STA (COPYOFTEXTADDRESS),Y
+    LDA #0
+    STA (COPYOFCOLORMAPADDRESS),Y
+    RTS
+
+@ENDIF
+
 HSCROLLSTL1:
     LDA DIRECTION
     CMP #$80
@@ -49,6 +49,9 @@ SPRUPDATEFLAG2:   .BYTE $00
 SORTEDSPRITES:   .BYTE $00
 TEMPVARIABLE:   .BYTE $00
 SPRIRQCOUNTER:  .BYTE 0
+SPRSORTLAST:    .BYTE 0
+SPRSORTSRC:     .BYTE 0
+SPRBUCKETS      = 32
 SORTORDER       = $26
 SORTORDERLAST   = $46
 
@@ -117,19 +120,65 @@ MSPRITESMANAGERNOSPRITESATALL:
     PLA
     RTS
 
+    ; Sprites are sorted by Y with a bucket sort, where every bucket
+    ; holds 8 raster lines: this puts each sprite in the right bucket
+    ; with a fixed cost. The order inside a bucket is then fixed by 
+    ; an insertion sort, that moves only the sprites out of place.
+
 MSPRITESMANAGERBEGINSORT:
-    LDX #MAXSPR
+    LDX #SPRBUCKETS-1
+    LDA #$00
+MSPRITESMANAGERBUCKETCLEAR:
+    STA SPRBUCKET, X
     DEX
-    CPX SORTEDSPRITES
-    BCC MSPRITESMANAGERCLEARDONE
-    LDA #$ff
-MSPRITESMANAGERCLEARLOOP: 
-    STA SPRY, X
-    ; STA SPROY, X
+    BPL MSPRITESMANAGERBUCKETCLEAR
+
+    LDY #$00
+MSPRITESMANAGERBUCKETCOUNT:
+    LDA SPRY, Y
+    LSR
+    LSR
+    LSR
+    TAX
+    INC SPRBUCKET, X
+    INY
+    CPY SORTEDSPRITES
+    BCC MSPRITESMANAGERBUCKETCOUNT
+
+    ; Counters become the starting position of each bucket.
+
+    LDX #$00
+    TXA
+MSPRITESMANAGERBUCKETSTART:
+    LDY SPRBUCKET, X
+    STA SPRBUCKET, X
+    STY TEMPVARIABLE
+    CLC
+    ADC TEMPVARIABLE
+    INX
+    CPX #SPRBUCKETS
+    BCC MSPRITESMANAGERBUCKETSTART
+
+    LDY #$00
+MSPRITESMANAGERBUCKETPLACE:
+    LDA SPRY, Y
+    LSR
+    LSR
+    LSR
+    TAX
+    LDA SPRBUCKET, X
+    INC SPRBUCKET, X
+    TAX
+    STY SORTORDER, X
+    INY
+    CPY SORTEDSPRITES
+    BCC MSPRITESMANAGERBUCKETPLACE
+
+    LDX SORTEDSPRITES
     DEX
-    CPX SORTEDSPRITES
-    BCS MSPRITESMANAGERCLEARLOOP
-MSPRITESMANAGERCLEARDONE: 
+    STX SPRSORTLAST
+    BEQ MSPRITESMANAGERSORTDONE
+
     LDX #$00
 MSPRITESMANAGERSORTLOOP:  
     LDY SORTORDER+1, X
@@ -154,18 +203,50 @@ MSPRITESMANAGERSORTRELOAD:
     LDX #$00
 MSPRITESMANAGERSORTSKIP:  
     INX
-    CPX #MAXSPR-1
+    CPX SPRSORTLAST
     BCC MSPRITESMANAGERSORTLOOP
-    LDX SORTEDSPRITES
-    LDA #$ff
-    STA SORTSPRY, X
-    LDX #$00
+MSPRITESMANAGERSORTDONE:
+
+    ; Copy the sprites in sorted order, leaving out the disabled ones.
+    ; A sprite is dropped if the physical sprite that it reuses (the one
+    ; eight places before) is still drawn on the same raster lines: it 
+    ; would be cut anyway, and it would waste a raster interrupt.
+
+    LDA #$00
+    STA MSPRITESDROPPED
+    STA SPRSORTSRC
+    TAX
 MSPRITESMANAGERSORTLOOP3:
-    LDY SORTORDER, X
+    LDY SPRSORTSRC
+    LDA SORTORDER, Y
+    TAY
+    LDA SPRY, Y
+    CMP #$ff
+    BEQ MSPRITESMANAGERSORTNEXT
+    CPX #$08
+    BCC MSPRITESMANAGERSORTACCEPT
+    SEC
+    SBC SORTSPRY-8, X
+    STA TEMPVARIABLE
+    LDA SORTSPRE-8, X
+    AND #$02
+    BEQ MSPRITESMANAGERSORTHEIGHT21
+    LDA TEMPVARIABLE
+    CMP #42
+    BCS MSPRITESMANAGERSORTACCEPT
+    BCC MSPRITESMANAGERSORTDROP
+MSPRITESMANAGERSORTHEIGHT21:
+    LDA TEMPVARIABLE
+    CMP #21
+    BCS MSPRITESMANAGERSORTACCEPT
+MSPRITESMANAGERSORTDROP:
+    INC MSPRITESDROPPED
+    JMP MSPRITESMANAGERSORTNEXT
+MSPRITESMANAGERSORTACCEPT:
     LDA SPRY, Y
     STA SORTSPRY, X
     LDA SPRX, Y
-    STA SORTSPRX, x
+    STA SORTSPRX, X
     LDA SPRF, Y
     STA SORTSPRF, X
     LDA SPRC, Y
@@ -173,8 +254,14 @@ MSPRITESMANAGERSORTLOOP3:
     LDA SPRE, Y
     STA SORTSPRE, X
     INX
-    CPX SORTEDSPRITES
+MSPRITESMANAGERSORTNEXT:
+    INC SPRSORTSRC
+    LDA SPRSORTSRC
+    CMP SORTEDSPRITES
     BCC MSPRITESMANAGERSORTLOOP3
+    LDA #$ff
+    STA SORTSPRY, X
+    STX SORTEDSPRITES
     JMP MSPRITESMANAGERNONEWSPRITES
 
 MSPRITESMANAGER2:
@@ -298,6 +385,8 @@ SORTSPRC:       .RES MAXSPR,0
 SORTSPRF:       .RES MAXSPR,0
 SORTSPRE:       .RES MAXSPR,0
 
+SPRBUCKET:      .RES SPRBUCKETS,0
+
 D015TBL:        .BYTE %00000000                  
                 .BYTE %00000001                  
                 .BYTE %00000011
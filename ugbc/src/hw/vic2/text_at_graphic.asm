@@ -407,6 +407,18 @@ TEXTATBMSP0LOLOB:
     ADC #0
     STA PLOTCDEST+1
 
+@IF printCache
+
+    CLC
+    LDA PLOTCDEST
+    ADC #<(TEXTATBMSHADOW-$8C00)
+    STA BLITTMPPTR2
+    LDA PLOTCDEST+1
+    ADC #>(TEXTATBMSHADOW-$8C00)
+    STA BLITTMPPTR2+1
+
+@ENDIF
+
     LDA #0
 
 TEXTATBMSP0MIMI0:
@@ -483,6 +495,47 @@ TEXTATBMSP0MIMI21:
     PHA
     LDY #0
 
+@IF printCache
+
+    ; If the same character has already been drawn on this cell, with
+    ; the same colors, there is nothing to draw. This makes fields that 
+    ; are printed again and again (like scores) cost only for the 
+    ; characters that changed.
+
+    LDA (BLITTMPPTR2),Y
+    CMP SCREENCODE
+    BNE TEXTATBMCACHEMISS
+
+@IF !vestigialConfig.screenModeUnique
+
+    LDA CURRENTMODE
+    CMP #3
+    BEQ TEXTATBMCACHE3
+
+@ENDIF
+
+@IF !vestigialConfig.screenModeUnique || ( currentMode == 2 )
+
+    LDA MATHPTR6
+    ORA _PAPER
+    CMP (PLOTCDEST),Y
+    BNE TEXTATBMCACHEMISS
+    JMP TEXTATBMF
+
+@ENDIF
+
+TEXTATBMCACHE3:
+    LDA MATHPTR6
+    CMP (PLOTCDEST),Y
+    BNE TEXTATBMCACHEMISS
+    JMP TEXTATBMF
+
+TEXTATBMCACHEMISS:
+    LDA SCREENCODE
+    STA (BLITTMPPTR2),Y
+
+@ENDIF
+
     LDA SCREENCODE
     STA TMPPTR
     LDA #0
@@ -529,85 +582,81 @@ TEXTATBMSP0L1:
 TEXTATBMSP0L1B2:
     LDA (TMPPTR),Y
     STA (PLOTDEST),Y
+    INY
+    CPY #8
+    BNE TEXTATBMSP0L1B2
     JMP TEXTATBMSP0L1X
 
-TEXTATBMREMAP:
-    .BYTE %00000000	
-    .BYTE %00000001	
-    .BYTE %00000100
-    .BYTE %00000101
-    .BYTE %00010000
-    .BYTE %00010001
-    .BYTE %00010100
-    .BYTE %00010101
-    .BYTE %01000000
-    .BYTE %01000001
-    .BYTE %01000100
-    .BYTE %01000101
-    .BYTE %01010000
-    .BYTE %01010001
-    .BYTE %01010100
-    .BYTE %01010101
+@IF !vestigialConfig.screenModeUnique || (currentMode==3)
 
-TEXTATBMSP0L1B3:
+    ; In multicolor mode every pixel of the font becomes a pair of 
+    ; pixels, so each row of the glyph fills two cells. The rows are 
+    ; already converted by two tables, one for the left cell (high 
+    ; nibble) and one for the right cell (low nibble).
 
+TEXTATBMSP0L1B3:
     TXA
     PHA
-    LDA (TMPPTR),Y
-    AND #$F0
-    LSR
-    LSR
-    LSR
-    LSR
-    TAX
-    LDA TEXTATBMREMAP, X
-
-    TAX
-    TYA
-    PHA
-    LDY #0
-    TXA
-    STA (PLOTDEST), Y
-    PLA
-    TAY
-
     CLC
     LDA PLOTDEST
     ADC #8
-    STA PLOTDEST
+    STA BLITTMPPTR
     LDA PLOTDEST+1
     ADC #0
-    STA PLOTDEST+1
-
+    STA BLITTMPPTR+1
+TEXTATBMSP0L1B3L:
     LDA (TMPPTR),Y
-    AND #$0F
-    TAX
-    LDA TEXTATBMREMAP, X
-
     TAX
-    TYA
-    PHA
-    LDY #0
-    TXA
-    STA (PLOTDEST), Y
+    LDA TEXTATBMREMAPHI, X
+    STA (PLOTDEST),Y
+    LDA TEXTATBMREMAPLO, X
+    STA (BLITTMPPTR),Y
+    INY
+    CPY #8
+    BNE TEXTATBMSP0L1B3L
     PLA
-    TAY
+    TAX
+    JMP TEXTATBMSP0L1X
 
-    SEC
-    LDA PLOTDEST
-    SBC #7
-    STA PLOTDEST
-    LDA PLOTDEST+1
-    SBC #0
-    STA PLOTDEST+1
+TEXTATBMREMAPHI:
+    .BYTE $00, $00, $00, $00, $00, $00, $00, $00, $00, $00, $00, $00, $00, $00, $00, $00
+    .BYTE $01, $01, $01, $01, $01, $01, $01, $01, $01, $01, $01, $01, $01, $01, $01, $01
+    .BYTE $04, $04, $04, $04, $04, $04, $04, $04, $04, $04, $04, $04, $04, $04, $04, $04
+    .BYTE $05, $05, $05, $05, $05, $05, $05, $05, $05, $05, $05, $05, $05, $05, $05, $05
+    .BYTE $10, $10, $10, $10, $10, $10, $10, $10, $10, $10, $10, $10, $10, $10, $10, $10
+    .BYTE $11, $11, $11, $11, $11, $11, $11, $11, $11, $11, $11, $11, $11, $11, $11, $11
+    .BYTE $14, $14, $14, $14, $14, $14, $14, $14, $14, $14, $14, $14, $14, $14, $14, $14
+    .BYTE $15, $15, $15, $15, $15, $15, $15, $15, $15, $15, $15, $15, $15, $15, $15, $15
+    .BYTE $40, $40, $40, $40, $40, $40, $40, $40, $40, $40, $40, $40, $40, $40, $40, $40
+    .BYTE $41, $41, $41, $41, $41, $41, $41, $41, $41, $41, $41, $41, $41, $41, $41, $41
+    .BYTE $44, $44, $44, $44, $44, $44, $44, $44, $44, $44, $44, $44, $44, $44, $44, $44
+    .BYTE $45, $45, $45, $45, $45, $45, $45, $45, $45, $45, $45, $45, $45, $45, $45, $45
+    .BYTE $50, $50, $50, $50, $50, $50, $50, $50, $50, $50, $50, $50, $50, $50, $50, $50
+    .BYTE $51, $51, $51, $51, $51, $51, $51, $51, $51, $51, $51, $51, $51, $51, $51, $51
+    .BYTE $54, $54, $54, $54, $54, $54, $54, $54, $54, $54, $54, $54, $54, $54, $54, $54
+    .BYTE $55, $55, $55, $55, $55, $55, $55, $55, $55, $55, $55, $55, $55, $55, $55, $55
+
+TEXTATBMREMAPLO:
+    .BYTE $00, $01, $04, $05, $10, $11, $14, $15, $40, $41, $44, $45, $50, $51, $54, $55
+    .BYTE $00, $01, $04, $05, $10, $11, $14, $15, $40, $41, $44, $45, $50, $51, $54, $55
+    .BYTE $00, $01, $04, $05, $10, $11, $14, $15, $40, $41, $44, $45, $50, $51, $54, $55
+    .BYTE $00, $01, $04, $05, $10, $11, $14, $15, $40, $41, $44, $45, $50, $51, $54, $55
+    .BYTE $00, $01, $04, $05, $10, $11, $14, $15, $40, $41, $44, $45, $50, $51, $54, $55
+    .BYTE $00, $01, $04, $05, $10, $11, $14, $15, $40, $41, $44, $45, $50, $51, $54, $55
+    .BYTE $00, $01, $04, $05, $10, $11, $14, $15, $40, $41, $44, $45, $50, $51, $54, $55
+    .BYTE $00, $01, $04, $05, $10, $11, $14, $15, $40, $41, $44, $45, $50, $51, $54, $55
+    .BYTE $00, $01, $04, $05, $10, $11, $14, $15, $40, $41, $44, $45, $50, $51, $54, $55
+    .BYTE $00, $01, $04, $05, $10, $11, $14, $15, $40, $41, $44, $45, $50, $51, $54, $55
+    .BYTE $00, $01, $04, $05, $10, $11, $14, $15, $40, $41, $44, $45, $50, $51, $54, $55
+    .BYTE $00, $01, $04, $05, $10, $11, $14, $15, $40, $41, $44, $45, $50, $51, $54, $55
+    .BYTE $00, $01, $04, $05, $10, $11, $14, $15, $40, $41, $44, $45, $50, $51, $54, $55
+    .BYTE $00, $01, $04, $05, $10, $11, $14, $15, $40, $41, $44, $45, $50, $51, $54, $55
+    .BYTE $00, $01, $04, $05, $10, $11, $14, $15, $40, $41, $44, $45, $50, $51, $54, $55
+    .BYTE $00, $01, $04, $05, $10, $11, $14, $15, $40, $41, $44, $45, $50, $51, $54, $55
+
+@ENDIF
 
-    PLA
-    TAX
-    
 TEXTATBMSP0L1X:
-    INY
-    CPY #8
-    BNE TEXTATBMSP0L1
 
 @IF !vestigialConfig.screenModeUnique
 
@@ -768,3 +817,28 @@ TEXTATBMDONE:
 
 @ENDIF
     RTS
+
+@IF printCache
+
+; Characters drawn on each cell of the screen (PRINT CACHE).
+
+TEXTATBMSHADOW:     .RES 1024, $FF
+
+TEXTATBMSHADOWRESET:
+    LDA #<TEXTATBMSHADOW
+    STA COPYOFTEXTADDRESS
+    LDA #>TEXTATBMSHADOW
+    STA COPYOFTEXTADDRESS+1
+    LDX #4
+    LDY #0
+    LDA #$FF
+TEXTATBMSHADOWRESETL1:
+    STA (COPYOFTEXTADDRESS),Y
+    INY
+    BNE TEXTATBMSHADOWRESETL1
+    INC COPYOFTEXTADDRESS+1
+    DEX
+    BNE TEXTATBMSHADOWRESETL1
+    RTS
+
+@ENDIF
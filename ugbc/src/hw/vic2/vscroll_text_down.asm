@@ -126,6 +126,75 @@ VSCROLLTDOWNNOW:
 
     LDX CONSOLEH
     DEX
+
+@IF C64REU
+
+    ; When the console is as wide as the screen, the rows to move
+    ; are contiguous, so they can be moved with a single transfer.
+    LDA CONSOLEW
+    CMP CURRENTTILESWIDTH
+    BNE VSCROLLTDOWNREUX
+    CPX #0
+    BEQ VSCROLLTDOWNREUX
+
+    LDA #0
+    STA REUMEMLEN
+    STA REUMEMLEN+1
+VSCROLLTDOWNREULEN:
+    CLC
+    LDA REUMEMLEN
+    ADC CURRENTTILESWIDTH
+    STA REUMEMLEN
+    LDA REUMEMLEN+1
+    ADC #0
+    STA REUMEMLEN+1
+    DEX
+    BNE VSCROLLTDOWNREULEN
+
+    ; The pointers go back to the first row, as the loop below does,
+    ; and the rows from there are moved one row ahead.
+    SEC
+    LDA COPYOFTEXTADDRESS
+    SBC REUMEMLEN
+    STA COPYOFTEXTADDRESS
+    STA REUMEMSRC
+    LDA COPYOFTEXTADDRESS+1
+    SBC REUMEMLEN+1
+    STA COPYOFTEXTADDRESS+1
+    STA REUMEMSRC+1
+    CLC
+    LDA REUMEMSRC
+    ADC CURRENTTILESWIDTH
+    STA REUMEMDST
+    LDA REUMEMSRC+1
+    ADC #0
+    STA REUMEMDST+1
+    JSR REUMEMMOVE
+
+    SEC
+    LDA COPYOFCOLORMAPADDRESS
+    SBC REUMEMLEN
+    STA COPYOFCOLORMAPADDRESS
+    STA REUMEMSRC
+    LDA COPYOFCOLORMAPADDRESS+1
+    SBC REUMEMLEN+1
+    STA COPYOFCOLORMAPADDRESS+1
+    STA REUMEMSRC+1
+    CLC
+    LDA REUMEMSRC
+    ADC CURRENTTILESWIDTH
+    STA REUMEMDST
+    LDA REUMEMSRC+1
+    ADC #0
+    STA REUMEMDST+1
+    JSR REUMEMMOVE
+
+    JMP VSCROLLTDOWNYS3DONE
+
+VSCROLLTDOWNREUX:
+
+@ENDIF
+
 VSCROLLTDOWNYS30:
     LDY #0
 VSCROLLTDOWNYS3:
@@ -172,6 +241,8 @@ VSCROLLTDOWNYS3:
     DEX
     BNE VSCROLLTDOWNYS30
 
+VSCROLLTDOWNYS3DONE:
+
 @IF verticalOverlapRequired
 
     LDA PORT
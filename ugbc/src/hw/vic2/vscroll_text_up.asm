@@ -126,6 +126,74 @@ VSCROLLTUPNOW:
 
     LDX CONSOLEH
     DEX
+
+@IF C64REU
+
+    ; When the console is as wide as the screen, the rows to move
+    ; are contiguous, so they can be moved with a single transfer.
+    LDA CONSOLEW
+    CMP CURRENTTILESWIDTH
+    BNE VSCROLLTUPREUX
+    CPX #0
+    BEQ VSCROLLTUPREUX
+
+    LDA #0
+    STA REUMEMLEN
+    STA REUMEMLEN+1
+VSCROLLTUPREULEN:
+    CLC
+    LDA REUMEMLEN
+    ADC CURRENTTILESWIDTH
+    STA REUMEMLEN
+    LDA REUMEMLEN+1
+    ADC #0
+    STA REUMEMLEN+1
+    DEX
+    BNE VSCROLLTUPREULEN
+
+    LDA COPYOFTEXTADDRESS2
+    STA REUMEMSRC
+    LDA COPYOFTEXTADDRESS2+1
+    STA REUMEMSRC+1
+    LDA COPYOFTEXTADDRESS
+    STA REUMEMDST
+    LDA COPYOFTEXTADDRESS+1
+    STA REUMEMDST+1
+    JSR REUMEMMOVE
+
+    LDA COPYOFCOLORMAPADDRESS2
+    STA REUMEMSRC
+    LDA COPYOFCOLORMAPADDRESS2+1
+    STA REUMEMSRC+1
+    LDA COPYOFCOLORMAPADDRESS
+    STA REUMEMDST
+    LDA COPYOFCOLORMAPADDRESS+1
+    STA REUMEMDST+1
+    JSR REUMEMMOVE
+
+    ; Move the pointers to the last row, as the loop below does.
+    CLC
+    LDA COPYOFTEXTADDRESS
+    ADC REUMEMLEN
+    STA COPYOFTEXTADDRESS
+    LDA COPYOFTEXTADDRESS+1
+    ADC REUMEMLEN+1
+    STA COPYOFTEXTADDRESS+1
+
+    CLC
+    LDA COPYOFCOLORMAPADDRESS
+    ADC REUMEMLEN
+    STA COPYOFCOLORMAPADDRESS
+    LDA COPYOFCOLORMAPADDRESS+1
+    ADC REUMEMLEN+1
+    STA COPYOFCOLORMAPADDRESS+1
+
+    JMP VSCROLLTUPYSCRDONE
+
+VSCROLLTUPREUX:
+
+@ENDIF
+
 VSCROLLTUPYSCR0:
     LDY #0
 VSCROLLTUPYSCR:
@@ -172,6 +240,8 @@ VSCROLLTUPYSCR:
     DEX
     BNE VSCROLLTUPYSCR0
 
+VSCROLLTUPYSCRDONE:
+
 @IF verticalOverlapRequired
 
     LDA PORT
@@ -162,10 +162,14 @@ TIMERMANAGERJMP2AL:
     LD A, (HL)
     LD IXH, A
 
-    PUSH AF
-    PUSH HL
+    ; Only DE (the offset of the timer) is still needed after the
+    ; call, since AF and HL are reloaded or restored by the loop.
+    ; The group is marked, so that the optimizer can drop it if no
+    ; timer handler is able to write DE.
+    ; TIMERSAVE DE
     PUSH DE
-    
+    ; TIMERSAVEEND
+
     LD A, IXL
     LD L, A
     LD A, IXH
@@ -178,9 +182,9 @@ TIMERMANAGERJMP2AL:
 
     CALL TIMERMANAGERJMP
 
+    ; TIMERSAVE DE
     POP DE
-    POP HL
-    POP AF
+    ; TIMERSAVEEND
 
     ; If we reach this line, we are going to decrement the
     ; counter since it is not zero.
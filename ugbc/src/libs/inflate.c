@@ -0,0 +1,420 @@
+/*****************************************************************************
+ * ugBASIC - an isomorphic BASIC language compiler for retrocomputers        *
+ *****************************************************************************
+ * Copyright 2021-2025 Marco Spedaletti (asimov@mclink.it)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *----------------------------------------------------------------------------
+ * Concesso in licenza secondo i termini della Licenza Apache, versione 2.0
+ * (la "Licenza"); è proibito usare questo file se non in conformità alla
+ * Licenza. Una copia della Licenza è disponibile all'indirizzo:
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Se non richiesto dalla legislazione vigente o concordato per iscritto,
+ * il software distribuito nei termini della Licenza è distribuito
+ * "COSÌ COM'È", SENZA GARANZIE O CONDIZIONI DI ALCUN TIPO, esplicite o
+ * implicite. Consultare la Licenza per il testo specifico che regola le
+ * autorizzazioni e le limitazioni previste dalla medesima.
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * INCLUDE SECTION 
+ ****************************************************************************/
+
+#include "inflate.h"
+
+/****************************************************************************
+ * DECLARATIONS AND DEFINITIONS SECTION 
+ ****************************************************************************/
+
+// A minimal DEFLATE decoder, used to read the compressed layers of Tiled 
+// maps without depending on zlib (the same approach of "puff", by Mark 
+// Adler). Speed is not an issue, since data is small and decoded once.
+
+typedef struct _InflateState {
+
+    unsigned char *     input;
+    int                 inputSize;
+    int                 inputPosition;
+
+    unsigned int        bitBuffer;
+    int                 bitCount;
+
+    unsigned char *     output;
+    int                 outputSize;
+    int                 outputCapacity;
+
+    int                 error;
+
+} InflateState;
+
+typedef struct _InflateTree {
+
+    short               counts[16];
+    short               symbols[288];
+
+} InflateTree;
+
+static const short lengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+
+static const short lengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+static const short distanceBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+    8193, 12289, 16385, 24577 };
+
+static const short distanceExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+static const unsigned char codeLengthOrder[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+/****************************************************************************
+ * CODE SECTION 
+ ****************************************************************************/
+
+static int inflate_bits( InflateState * _state, int _count ) {
+
+    while( _state->bitCount < _count ) {
+        if ( _state->inputPosition >= _state->inputSize ) {
+            _state->error = 1;
+            return 0;
+        }
+        _state->bitBuffer |= ( (unsigned int) _state->input[_state->inputPosition++] ) << _state->bitCount;
+        _state->bitCount += 8;
+    }
+
+    int value = _state->bitBuffer & ( ( 1 << _count ) - 1 );
+    _state->bitBuffer >>= _count;
+    _state->bitCount -= _count;
+
+    return value;
+
+}
+
+static void inflate_emit( InflateState * _state, unsigned char _value ) {
+
+    if ( _state->outputSize == _state->outputCapacity ) {
+        _state->outputCapacity = _state->outputCapacity ? _state->outputCapacity * 2 : 4096;
+        _state->output = realloc( _state->output, _state->outputCapacity );
+    }
+
+    _state->output[_state->outputSize++] = _value;
+
+}
+
+static int inflate_build( InflateTree * _tree, unsigned char * _lengths, int _count ) {
+
+    short offsets[16];
+    int i;
+
+    memset( _tree->counts, 0, sizeof( _tree->counts ) );
+    for( i=0; i<_count; ++i ) {
+        ++_tree->counts[_lengths[i]];
+    }
+    _tree->counts[0] = 0;
+
+    offsets[1] = 0;
+    for( i=1; i<15; ++i ) {
+        offsets[i+1] = offsets[i] + _tree->counts[i];
+    }
+
+    for( i=0; i<_count; ++i ) {
+        if ( _lengths[i] ) {
+            _tree->symbols[offsets[_lengths[i]]++] = i;
+        }
+    }
+
+    return 0;
+
+}
+
+static int inflate_decode( InflateState * _state, InflateTree * _tree ) {
+
+    int code = 0, first = 0, index = 0;
+    int length;
+
+    for( length=1; length<16; ++length ) {
+        code |= inflate_bits( _state, 1 );
+        if ( _state->error ) {
+            return -1;
+        }
+        int count = _tree->counts[length];
+        if ( code - count < first ) {
+            return _tree->symbols[index + ( code - first )];
+        }
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+
+    _state->error = 1;
+    return -1;
+
+}
+
+static void inflate_stored( InflateState * _state ) {
+
+    _state->bitBuffer = 0;
+    _state->bitCount = 0;
+
+    if ( _state->inputPosition + 4 > _state->inputSize ) {
+        _state->error = 1;
+        return;
+    }
+
+    int length = _state->input[_state->inputPosition] | ( _state->input[_state->inputPosition+1] << 8 );
+    int complement = _state->input[_state->inputPosition+2] | ( _state->input[_state->inputPosition+3] << 8 );
+    _state->inputPosition += 4;
+
+    if ( length != ( ~complement & 0xffff ) || _state->inputPosition + length > _state->inputSize ) {
+        _state->error = 1;
+        return;
+    }
+
+    while( length-- ) {
+        inflate_emit( _state, _state->input[_state->inputPosition++] );
+    }
+
+}
+
+static void inflate_codes( InflateState * _state, InflateTree * _lengths, InflateTree * _distances ) {
+
+    while( !_state->error ) {
+
+        int symbol = inflate_decode( _state, _lengths );
+
+        if ( symbol < 0 ) {
+            return;
+        } else if ( symbol < 256 ) {
+            inflate_emit( _state, symbol );
+        } else if ( symbol == 256 ) {
+            return;
+        } else {
+            symbol -= 257;
+            if ( symbol >= 29 ) {
+                _state->error = 1;
+                return;
+            }
+            int length = lengthBase[symbol] + inflate_bits( _state, lengthExtra[symbol] );
+            symbol = inflate_decode( _state, _distances );
+            if ( symbol < 0 || symbol >= 30 ) {
+                _state->error = 1;
+                return;
+            }
+            int distance = distanceBase[symbol] + inflate_bits( _state, distanceExtra[symbol] );
+            if ( _state->error || distance > _state->outputSize ) {
+                _state->error = 1;
+                return;
+            }
+            while( length-- ) {
+                inflate_emit( _state, _state->output[_state->outputSize - distance] );
+            }
+        }
+
+    }
+
+}
+
+static void inflate_fixed( InflateState * _state ) {
+
+    InflateTree lengths, distances;
+    unsigned char lengthsSize[288];
+    int i;
+
+    for( i=0; i<144; ++i ) lengthsSize[i] = 8;
+    for( ; i<256; ++i ) lengthsSize[i] = 9;
+    for( ; i<280; ++i ) lengthsSize[i] = 7;
+    for( ; i<288; ++i ) lengthsSize[i] = 8;
+    inflate_build( &lengths, lengthsSize, 288 );
+
+    for( i=0; i<30; ++i ) lengthsSize[i] = 5;
+    inflate_build( &distances, lengthsSize, 30 );
+
+    inflate_codes( _state, &lengths, &distances );
+
+}
+
+static void inflate_dynamic( InflateState * _state ) {
+
+    InflateTree lengths, distances;
+    unsigned char lengthsSize[320];
+    int i;
+
+    int literalCount = inflate_bits( _state, 5 ) + 257;
+    int distanceCount = inflate_bits( _state, 5 ) + 1;
+    int codeCount = inflate_bits( _state, 4 ) + 4;
+
+    if ( _state->error || literalCount > 286 || distanceCount > 30 ) {
+        _state->error = 1;
+        return;
+    }
+
+    memset( lengthsSize, 0, sizeof( lengthsSize ) );
+    for( i=0; i<codeCount; ++i ) {
+        lengthsSize[codeLengthOrder[i]] = inflate_bits( _state, 3 );
+    }
+    inflate_build( &lengths, lengthsSize, 19 );
+
+    i = 0;
+    while( i < literalCount + distanceCount && !_state->error ) {
+        int symbol = inflate_decode( _state, &lengths );
+        int repeat = 0, value = 0;
+        if ( symbol < 0 ) {
+            return;
+        } else if ( symbol < 16 ) {
+            lengthsSize[i++] = symbol;
+            continue;
+        } else if ( symbol == 16 ) {
+            if ( i == 0 ) {
+                _state->error = 1;
+                return;
+            }
+            value = lengthsSize[i-1];
+            repeat = 3 + inflate_bits( _state, 2 );
+        } else if ( symbol == 17 ) {
+            repeat = 3 + inflate_bits( _state, 3 );
+        } else {
+            repeat = 11 + inflate_bits( _state, 7 );
+        }
+        if ( i + repeat > literalCount + distanceCount ) {
+            _state->error = 1;
+            return;
+        }
+        while( repeat-- ) {
+            lengthsSize[i++] = value;
+        }
+    }
+
+    if ( _state->error ) {
+        return;
+    }
+
+    inflate_build( &lengths, lengthsSize, literalCount );
+    inflate_build( &distances, lengthsSize + literalCount, distanceCount );
+
+    inflate_codes( _state, &lengths, &distances );
+
+}
+
+static int inflate_header( unsigned char * _input, int _size, InflateFormat _format ) {
+
+    int position = 0;
+
+    switch( _format ) {
+        case INFLATE_RAW:
+            break;
+        case INFLATE_ZLIB:
+            if ( _size < 2 || ( _input[0] & 0x0f ) != 8 || ( ( _input[0] << 8 ) | _input[1] ) % 31 || ( _input[1] & 0x20 ) ) {
+                return -1;
+            }
+            position = 2;
+            break;
+        case INFLATE_GZIP: {
+            if ( _size < 10 || _input[0] != 0x1f || _input[1] != 0x8b || _input[2] != 8 ) {
+                return -1;
+            }
+            int flags = _input[3];
+            position = 10;
+            if ( flags & 0x04 ) {
+                if ( position + 2 > _size ) {
+                    return -1;
+                }
+                position += 2 + ( _input[position] | ( _input[position+1] << 8 ) );
+            }
+            if ( flags & 0x08 ) {
+                while( position < _size && _input[position] ) ++position;
+                ++position;
+            }
+            if ( flags & 0x10 ) {
+                while( position < _size && _input[position] ) ++position;
+                ++position;
+            }
+            if ( flags & 0x02 ) {
+                position += 2;
+            }
+            if ( position > _size ) {
+                return -1;
+            }
+            break;
+        }
+    }
+
+    return position;
+
+}
+
+/**
+ * @brief Uncompress a DEFLATE stream
+ * 
+ * @param _input Compressed data
+ * @param _size Size of compressed data
+ * @param _format Kind of header that precedes the compressed data
+ * @param _output_size Size of uncompressed data
+ * @return unsigned char* Uncompressed data (to be freed) or NULL if invalid
+ */
+unsigned char * inflate_uncompress( unsigned char * _input, int _size, InflateFormat _format, int * _output_size ) {
+
+    InflateState state;
+    int last = 0;
+
+    memset( &state, 0, sizeof( InflateState ) );
+
+    state.inputPosition = inflate_header( _input, _size, _format );
+    if ( state.inputPosition < 0 ) {
+        return NULL;
+    }
+    state.input = _input;
+    state.inputSize = _size;
+
+    while( !last && !state.error ) {
+        last = inflate_bits( &state, 1 );
+        switch( inflate_bits( &state, 2 ) ) {
+            case 0:
+                inflate_stored( &state );
+                break;
+            case 1:
+                inflate_fixed( &state );
+                break;
+            case 2:
+                inflate_dynamic( &state );
+                break;
+            default:
+                state.error = 1;
+                break;
+        }
+    }
+
+    if ( state.error ) {
+        free( state.output );
+        return NULL;
+    }
+
+    if ( ! state.output ) {
+        state.output = malloc( 1 );
+    }
+
+    *_output_size = state.outputSize;
+
+    return state.output;
+
+}
@@ -0,0 +1,62 @@
+#ifndef __INFLATE__
+#define __INFLATE__
+
+
+/*****************************************************************************
+ * ugBASIC - an isomorphic BASIC language compiler for retrocomputers        *
+ *****************************************************************************
+ * Copyright 2021-2025 Marco Spedaletti (asimov@mclink.it)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *----------------------------------------------------------------------------
+ * Concesso in licenza secondo i termini della Licenza Apache, versione 2.0
+ * (la "Licenza"); è proibito usare questo file se non in conformità alla
+ * Licenza. Una copia della Licenza è disponibile all'indirizzo:
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Se non richiesto dalla legislazione vigente o concordato per iscritto,
+ * il software distribuito nei termini della Licenza è distribuito
+ * "COSÌ COM'È", SENZA GARANZIE O CONDIZIONI DI ALCUN TIPO, esplicite o
+ * implicite. Consultare la Licenza per il testo specifico che regola le
+ * autorizzazioni e le limitazioni previste dalla medesima.
+ ****************************************************************************/
+
+/****************************************************************************
+ * INCLUDE SECTION 
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+/****************************************************************************
+ * DECLARATIONS AND DEFINITIONS SECTION 
+ ****************************************************************************/
+
+typedef enum _InflateFormat {
+
+    /** Raw DEFLATE stream (RFC 1951) */
+    INFLATE_RAW = 0,
+
+    /** DEFLATE stream with zlib header (RFC 1950) */
+    INFLATE_ZLIB = 1,
+
+    /** DEFLATE stream with gzip header (RFC 1952) */
+    INFLATE_GZIP = 2
+
+} InflateFormat;
+
+unsigned char *     inflate_uncompress( unsigned char * _input, int _size, InflateFormat _format, int * _output_size );
+
+#endif
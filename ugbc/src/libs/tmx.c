@@ -34,229 +34,568 @@
 
 #include "tsx.h"
 #include "tmx.h"
+#include "inflate.h"
 
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <limits.h>
 #include <unistd.h>
-#include <libxml/parser.h>
-#include <libxml/tree.h>
+#include <libxml/xmlreader.h>
 
 char * strcopy( char * _dest, const char * _source );
 
-TmxMap * tmx_load( char * _filename ) {
+/****************************************************************************
+ * DECLARATIONS AND DEFINITIONS SECTION 
+ ****************************************************************************/
 
-    TmxMap * result = NULL;
+typedef enum _TmxEncoding {
 
-    xmlDocPtr doc;
+    TMX_ENCODING_XML = 0,
+    TMX_ENCODING_CSV = 1,
+    TMX_ENCODING_BASE64 = 2
 
-    doc = xmlReadFile( _filename, NULL, 0 );
+} TmxEncoding;
 
-    if ( ! doc )
-        return result;
+typedef enum _TmxCompression {
 
-    result = malloc( sizeof( TmxMap ) );
-    memset( result, 0, sizeof ( TmxMap ) );
+    TMX_COMPRESSION_NONE = 0,
+    TMX_COMPRESSION_ZLIB = 1,
+    TMX_COMPRESSION_GZIP = 2
 
-    xmlNode *root_element = NULL;
-    xmlNode *cur_node = NULL;
-
-    root_element = xmlDocGetRootElement(doc);
- 
-    for (cur_node = root_element; cur_node; cur_node = cur_node->next) {
-        if (cur_node->type == XML_ELEMENT_NODE) {
-            if ( strcmp( cur_node->name, "map" ) == 0 ) {
-                struct _xmlAttr * properties = cur_node->properties;
-                while( properties ) {
-                    if ( properties->type == XML_ATTRIBUTE_NODE ) {
-                        xmlChar* value = xmlNodeListGetString(cur_node->doc, properties->children, 1);
-                        if ( strcmp( properties->name, "version") == 0 ) {
-                            result->version = strdup( value );
-                        } else if ( strcmp( properties->name, "tiledVersion") == 0 ) {
-                            result->tiledversion = strdup( value );
-                        } else if ( strcmp( properties->name, "orientation") == 0 ) {
-                            if ( strcmp( value, "orthogonal" ) == 0 ) {
-                                result->orientation = TMX_ORTHOGONAL;
-                            } else if ( strcmp( value, "isometric" ) == 0 ) {
-                                result->orientation = TMX_ISOMETRIC;
-                            } else if ( strcmp( value, "staggered" ) == 0 ) {
-                                result->orientation = TMX_STAGGERED;
-                            } else if ( strcmp( value, "hexagonal" ) == 0 ) {
-                                result->orientation = TMX_HEXAGONAL;
-                            }
-                        } else if ( strcmp( properties->name, "renderorder") == 0 ) {
-                            if ( strcmp( value, "right-down" ) == 0 ) {
-                                result->orientation = TMX_RIGHT_DOWN;
-                            } else if ( strcmp( value, "right-up" ) == 0 ) {
-                                result->orientation = TMX_RIGHT_UP;
-                            } else if ( strcmp( value, "left-down" ) == 0 ) {
-                                result->orientation = TMX_LEFT_DOWN;
-                            } else if ( strcmp( value, "left-up" ) == 0 ) {
-                                result->orientation = TMX_LEFT_UP;
-                            }
-                        } else if ( strcmp( properties->name, "width") == 0 ) {
-                            result->width = atoi( value );
-                        } else if ( strcmp( properties->name, "height") == 0 ) {
-                            result->height = atoi( value );
-                        } else if ( strcmp( properties->name, "tilewidth") == 0 ) {
-                            result->tilewidth = atoi( value );
-                        } else if ( strcmp( properties->name, "tileheight") == 0 ) {
-                            result->tileheight = atoi( value );
-                        } else if ( strcmp( properties->name, "infinite") == 0 ) {
-                            result->infinite = atoi( value );
-                        } else if ( strcmp( properties->name, "nextlayerid") == 0 ) {
-                            result->nextlayerid = atoi( value );
-                        } else if ( strcmp( properties->name, "nextobjectid") == 0 ) {
-                            result->nextobjectid = atoi( value );
-                        }
-                        xmlFree(value); 
-                    }
-                    properties = properties->next;
+} TmxCompression;
+
+// Layer data is decoded while the document is read: CSV values go straight
+// into the grid, while base64 text is collected until the end of the block 
+// (since it could be compressed as a whole).
+
+typedef struct _TmxDataReader {
+
+    TmxEncoding             encoding;
+    TmxCompression          compression;
+
+    int                 *   data;
+    int                     size;
+    int                     position;
+
+    unsigned int            value;
+    int                     digits;
+
+    char                *   text;
+    int                     textSize;
+    int                     textCapacity;
+
+} TmxDataReader;
+
+/****************************************************************************
+ * CODE SECTION 
+ ****************************************************************************/
+
+static void tmx_data_store( TmxDataReader * _reader, unsigned int _value ) {
+
+    if ( _reader->position < _reader->size ) {
+        _reader->data[_reader->position++] = _value & TMX_GID_MASK;
+    }
+
+}
+
+static void tmx_data_begin( TmxDataReader * _reader, int * _data, int _size ) {
+
+    _reader->data = _data;
+    _reader->size = _size;
+    _reader->position = 0;
+    _reader->value = 0;
+    _reader->digits = 0;
+    _reader->textSize = 0;
+
+}
+
+static void tmx_data_feed( TmxDataReader * _reader, const char * _text ) {
+
+    switch( _reader->encoding ) {
+        case TMX_ENCODING_CSV:
+            while( *_text ) {
+                char c = *_text++;
+                if ( c >= '0' && c <= '9' ) {
+                    _reader->value = _reader->value * 10 + ( c - '0' );
+                    _reader->digits = 1;
+                } else if ( _reader->digits ) {
+                    tmx_data_store( _reader, _reader->value );
+                    _reader->value = 0;
+                    _reader->digits = 0;
                 }
+            }
+            break;
+        case TMX_ENCODING_BASE64: {
+            int size = strlen( _text );
+            if ( _reader->textSize + size + 1 > _reader->textCapacity ) {
+                _reader->textCapacity = ( _reader->textSize + size + 1 ) * 2;
+                _reader->text = realloc( _reader->text, _reader->textCapacity );
+            }
+            memcpy( _reader->text + _reader->textSize, _text, size + 1 );
+            _reader->textSize += size;
+            break;
+        }
+        case TMX_ENCODING_XML:
+            break;
+    }
 
-                xmlNode * child = cur_node->children;
-                while( child ) {
+}
 
-                    if ( strcmp( child->name, "tileset" ) == 0 ) {
+static int tmx_base64_value( char _c ) {
 
-                        char * source;
-                        int firstgid;
+    if ( _c >= 'A' && _c <= 'Z' ) return _c - 'A';
+    if ( _c >= 'a' && _c <= 'z' ) return _c - 'a' + 26;
+    if ( _c >= '0' && _c <= '9' ) return _c - '0' + 52;
+    if ( _c == '+' ) return 62;
+    if ( _c == '/' ) return 63;
+    return -1;
 
-                        struct _xmlAttr * properties = child->properties;
-                        while( properties ) {
-                            if ( properties->type == XML_ATTRIBUTE_NODE ) {
-                                xmlChar* value = xmlNodeListGetString(child->doc, properties->children, 1);
-                                if ( strcmp( properties->name, "source") == 0 ) {
-                                    source = strdup( value );
-                                } if ( strcmp( properties->name, "firstgid") == 0 ) {
-                                    firstgid = atoi( value );
-                                }
-                                xmlFree(value); 
-                            }
-                            properties = properties->next;
-                        }
+}
 
-                        if ( source ) {
+static unsigned char * tmx_base64_decode( char * _text, int _size, int * _output_size ) {
 
-                            char * filename = strdup( _filename );
-                            char * filenameWithPath = malloc( 1024 );
-                            memset( filenameWithPath, 0, 1024 );
-                            char * separator = strrchr( filename, '/' );
-                            if ( separator ) {
-                                *(separator+1) = 0;
-                                strcopy( filenameWithPath, filename );
-                            }
-                            strcat( filenameWithPath, source );
+    unsigned char * output = malloc( ( _size / 4 ) * 3 + 3 );
+    unsigned int bits = 0;
+    int count = 0, size = 0, i;
 
-                            TsxTileset * tileset = tsx_load( filenameWithPath );
+    for( i=0; i<_size; ++i ) {
+        int value = tmx_base64_value( _text[i] );
+        if ( value < 0 ) {
+            continue;
+        }
+        bits = ( bits << 6 ) | value;
+        count += 6;
+        if ( count >= 8 ) {
+            count -= 8;
+            output[size++] = ( bits >> count ) & 0xff;
+        }
+    }
 
-                            tileset->source = source;
-                            tileset->firstgid = firstgid;
+    *_output_size = size;
 
-                            if ( ! result->tilesets ) {
-                                result->tilesets = tileset;
-                            } else {
-                                TsxTileset * actual = result->tilesets;
-                                while( actual->next )  {
-                                    actual = actual->next;
-                                }
-                                actual->next = tileset;
-                            }
+    return output;
 
-                        }
+}
 
-                    } else if ( strcmp( child->name, "layer" ) == 0 ) {
-
-                        TmxLayer * layer = malloc( sizeof( TmxLayer ) );
-                        memset( layer, 0, sizeof( TmxLayer ) );
-
-                        struct _xmlAttr * properties = child->properties;
-                        while( properties ) {
-                            if ( properties->type == XML_ATTRIBUTE_NODE ) {
-                                xmlChar* value = xmlNodeListGetString(child->doc, properties->children, 1);
-                                if ( strcmp( properties->name, "name") == 0 ) {
-                                    layer->name = strdup( value );
-                                } if ( strcmp( properties->name, "width") == 0 ) {
-                                    layer->width = atoi( value );
-                                } if ( strcmp( properties->name, "height") == 0 ) {
-                                    layer->height = atoi( value );
-                                } if ( strcmp( properties->name, "id") == 0 ) {
-                                    layer->id = atoi( value );
-                                }
-                                xmlFree(value); 
-                            }
-                            properties = properties->next;
-                        }
+// Returns zero if the data cannot be decoded.
 
-                        xmlNode * rechild = child->children;
-                        while( rechild ) {
-
-                            if ( strcmp( rechild->name, "data" ) == 0 ) {
-
-                                layer->data = malloc( layer->width * layer->height * sizeof( int ) );
-                                memset( layer->data, 0, layer->width * layer->height * sizeof( int ) );
-
-                                char * content = (char*)xmlNodeGetContent( rechild->children );
-
-                                int step = 0;
-                                
-                                while( *content ) {
-                                    
-                                    char valueString[32];
-                                    memset( valueString, 0, 32 );
-                                    int p=0, j=0;
-
-                                    while( *content ) {
-                                        char c = *content;
-                                        ++content;
-                                        if ( j == 0 ) {
-                                            if ( (c < '0') || (c > '9') ) {
-                                                continue;
-                                            }
-                                            j = 1;
-                                        } else {
-                                            if ( (c < '0') || (c > '9') ) {
-                                                break;
-                                            }
-                                        }
-                                        valueString[p] = c;
-                                        ++p;
-                                    }
-
-                                    int value = atoi( valueString );
-                                    layer->data[step] = value;
-                                    ++step;
-
-                                }
+static int tmx_data_end( TmxDataReader * _reader ) {
 
-                            }
+    if ( _reader->encoding == TMX_ENCODING_CSV ) {
 
-                            rechild = rechild->next;
+        if ( _reader->digits ) {
+            tmx_data_store( _reader, _reader->value );
+        }
 
-                        }
+    } else if ( _reader->encoding == TMX_ENCODING_BASE64 ) {
+
+        int size = 0;
+        unsigned char * bytes = tmx_base64_decode( _reader->text ? _reader->text : "", _reader->textSize, &size );
+
+        if ( _reader->compression != TMX_COMPRESSION_NONE ) {
+            int uncompressedSize = 0;
+            unsigned char * uncompressed = inflate_uncompress( bytes, size, 
+                ( _reader->compression == TMX_COMPRESSION_ZLIB ) ? INFLATE_ZLIB : INFLATE_GZIP, &uncompressedSize );
+            free( bytes );
+            if ( ! uncompressed ) {
+                return 0;
+            }
+            bytes = uncompressed;
+            size = uncompressedSize;
+        }
+
+        int i;
+        for( i=0; i+3<size; i+=4 ) {
+            tmx_data_store( _reader, bytes[i] | ( bytes[i+1] << 8 ) | ( bytes[i+2] << 16 ) | ( (unsigned int) bytes[i+3] << 24 ) );
+        }
+
+        free( bytes );
+
+    }
+
+    return 1;
+
+}
+
+// Infinite maps store each layer as a set of chunks: they are merged into 
+// a single grid, covering the area used by all the layers.
+
+static void tmx_merge_chunks( TmxMap * _map ) {
+
+    int minX = INT_MAX, minY = INT_MAX, maxX = INT_MIN, maxY = INT_MIN;
+
+    TmxLayer * layer = _map->layers;
+    while( layer ) {
+        TmxChunk * chunk = layer->chunks;
+        while( chunk ) {
+            if ( chunk->x < minX ) minX = chunk->x;
+            if ( chunk->y < minY ) minY = chunk->y;
+            if ( chunk->x + chunk->width > maxX ) maxX = chunk->x + chunk->width;
+            if ( chunk->y + chunk->height > maxY ) maxY = chunk->y + chunk->height;
+            chunk = chunk->next;
+        }
+        layer = layer->next;
+    }
+
+    if ( minX > maxX ) {
+        return;
+    }
+
+    _map->width = maxX - minX;
+    _map->height = maxY - minY;
+
+    layer = _map->layers;
+    while( layer ) {
+        free( layer->data );
+        layer->width = _map->width;
+        layer->height = _map->height;
+        layer->data = malloc( layer->width * layer->height * sizeof( int ) );
+        memset( layer->data, 0, layer->width * layer->height * sizeof( int ) );
+        TmxChunk * chunk = layer->chunks;
+        while( chunk ) {
+            int y;
+            for( y=0; y<chunk->height; ++y ) {
+                memcpy( &layer->data[ ( chunk->y - minY + y ) * layer->width + ( chunk->x - minX ) ],
+                    &chunk->data[ y * chunk->width ], chunk->width * sizeof( int ) );
+            }
+            TmxChunk * next = chunk->next;
+            free( chunk->data );
+            free( chunk );
+            chunk = next;
+        }
+        layer->chunks = NULL;
+        layer = layer->next;
+    }
+
+}
+
+static void tmx_load_map( xmlTextReaderPtr _reader, TmxMap * _result ) {
+
+    while( xmlTextReaderMoveToNextAttribute( _reader ) == 1 ) {
+        const char * name = (const char *) xmlTextReaderConstName( _reader );
+        const char * value = (const char *) xmlTextReaderConstValue( _reader );
+        if ( strcmp( name, "version") == 0 ) {
+            _result->version = strdup( value );
+        } else if ( strcmp( name, "tiledversion") == 0 ) {
+            _result->tiledversion = strdup( value );
+        } else if ( strcmp( name, "orientation") == 0 ) {
+            if ( strcmp( value, "orthogonal" ) == 0 ) {
+                _result->orientation = TMX_ORTHOGONAL;
+            } else if ( strcmp( value, "isometric" ) == 0 ) {
+                _result->orientation = TMX_ISOMETRIC;
+            } else if ( strcmp( value, "staggered" ) == 0 ) {
+                _result->orientation = TMX_STAGGERED;
+            } else if ( strcmp( value, "hexagonal" ) == 0 ) {
+                _result->orientation = TMX_HEXAGONAL;
+            }
+        } else if ( strcmp( name, "renderorder") == 0 ) {
+            if ( strcmp( value, "right-down" ) == 0 ) {
+                _result->renderorder = TMX_RIGHT_DOWN;
+            } else if ( strcmp( value, "right-up" ) == 0 ) {
+                _result->renderorder = TMX_RIGHT_UP;
+            } else if ( strcmp( value, "left-down" ) == 0 ) {
+                _result->renderorder = TMX_LEFT_DOWN;
+            } else if ( strcmp( value, "left-up" ) == 0 ) {
+                _result->renderorder = TMX_LEFT_UP;
+            }
+        } else if ( strcmp( name, "width") == 0 ) {
+            _result->width = atoi( value );
+        } else if ( strcmp( name, "height") == 0 ) {
+            _result->height = atoi( value );
+        } else if ( strcmp( name, "tilewidth") == 0 ) {
+            _result->tilewidth = atoi( value );
+        } else if ( strcmp( name, "tileheight") == 0 ) {
+            _result->tileheight = atoi( value );
+        } else if ( strcmp( name, "infinite") == 0 ) {
+            _result->infinite = atoi( value );
+        } else if ( strcmp( name, "nextlayerid") == 0 ) {
+            _result->nextlayerid = atoi( value );
+        } else if ( strcmp( name, "nextobjectid") == 0 ) {
+            _result->nextobjectid = atoi( value );
+        }
+    }
+
+    xmlTextReaderMoveToElement( _reader );
+
+}
+
+static TsxTileset * tmx_load_tileset( xmlTextReaderPtr _reader, char * _filename ) {
+
+    char * source = NULL;
+    int firstgid = 0;
+
+    while( xmlTextReaderMoveToNextAttribute( _reader ) == 1 ) {
+        const char * name = (const char *) xmlTextReaderConstName( _reader );
+        const char * value = (const char *) xmlTextReaderConstValue( _reader );
+        if ( strcmp( name, "source") == 0 ) {
+            source = strdup( value );
+        } else if ( strcmp( name, "firstgid") == 0 ) {
+            firstgid = atoi( value );
+        }
+    }
+
+    xmlTextReaderMoveToElement( _reader );
+
+    if ( ! source ) {
+        return NULL;
+    }
+
+    char * filename = strdup( _filename );
+    char * filenameWithPath = malloc( 1024 );
+    memset( filenameWithPath, 0, 1024 );
+    char * separator = strrchr( filename, '/' );
+    if ( separator ) {
+        *(separator+1) = 0;
+        strcopy( filenameWithPath, filename );
+    }
+    strcat( filenameWithPath, source );
 
-                        if ( ! result->layers ) {
-                            result->layers = layer;
+    TsxTileset * tileset = tsx_load( filenameWithPath );
+
+    if ( tileset ) {
+        tileset->source = source;
+        tileset->firstgid = firstgid;
+    }
+
+    return tileset;
+
+}
+
+static TmxLayer * tmx_load_layer( xmlTextReaderPtr _reader ) {
+
+    TmxLayer * layer = malloc( sizeof( TmxLayer ) );
+    memset( layer, 0, sizeof( TmxLayer ) );
+
+    while( xmlTextReaderMoveToNextAttribute( _reader ) == 1 ) {
+        const char * name = (const char *) xmlTextReaderConstName( _reader );
+        const char * value = (const char *) xmlTextReaderConstValue( _reader );
+        if ( strcmp( name, "name") == 0 ) {
+            layer->name = strdup( value );
+        } else if ( strcmp( name, "width") == 0 ) {
+            layer->width = atoi( value );
+        } else if ( strcmp( name, "height") == 0 ) {
+            layer->height = atoi( value );
+        } else if ( strcmp( name, "id") == 0 ) {
+            layer->id = atoi( value );
+        }
+    }
+
+    xmlTextReaderMoveToElement( _reader );
+
+    return layer;
+
+}
+
+// Returns zero if the encoding or the compression are not supported.
+
+static int tmx_load_data( xmlTextReaderPtr _reader, TmxDataReader * _data ) {
+
+    int supported = 1;
+
+    _data->encoding = TMX_ENCODING_XML;
+    _data->compression = TMX_COMPRESSION_NONE;
+
+    while( xmlTextReaderMoveToNextAttribute( _reader ) == 1 ) {
+        const char * name = (const char *) xmlTextReaderConstName( _reader );
+        const char * value = (const char *) xmlTextReaderConstValue( _reader );
+        if ( strcmp( name, "encoding") == 0 ) {
+            if ( strcmp( value, "csv" ) == 0 ) {
+                _data->encoding = TMX_ENCODING_CSV;
+            } else if ( strcmp( value, "base64" ) == 0 ) {
+                _data->encoding = TMX_ENCODING_BASE64;
+            } else {
+                supported = 0;
+            }
+        } else if ( strcmp( name, "compression") == 0 ) {
+            if ( strcmp( value, "zlib" ) == 0 ) {
+                _data->compression = TMX_COMPRESSION_ZLIB;
+            } else if ( strcmp( value, "gzip" ) == 0 ) {
+                _data->compression = TMX_COMPRESSION_GZIP;
+            } else {
+                supported = 0;
+            }
+        }
+    }
+
+    xmlTextReaderMoveToElement( _reader );
+
+    return supported;
+
+}
+
+static TmxChunk * tmx_load_chunk( xmlTextReaderPtr _reader ) {
+
+    TmxChunk * chunk = malloc( sizeof( TmxChunk ) );
+    memset( chunk, 0, sizeof( TmxChunk ) );
+
+    while( xmlTextReaderMoveToNextAttribute( _reader ) == 1 ) {
+        const char * name = (const char *) xmlTextReaderConstName( _reader );
+        const char * value = (const char *) xmlTextReaderConstValue( _reader );
+        if ( strcmp( name, "x") == 0 ) {
+            chunk->x = atoi( value );
+        } else if ( strcmp( name, "y") == 0 ) {
+            chunk->y = atoi( value );
+        } else if ( strcmp( name, "width") == 0 ) {
+            chunk->width = atoi( value );
+        } else if ( strcmp( name, "height") == 0 ) {
+            chunk->height = atoi( value );
+        }
+    }
+
+    xmlTextReaderMoveToElement( _reader );
+
+    chunk->data = malloc( chunk->width * chunk->height * sizeof( int ) );
+    memset( chunk->data, 0, chunk->width * chunk->height * sizeof( int ) );
+
+    return chunk;
+
+}
+
+// The map is read as a stream of nodes, and layers are decoded as soon
+// as their data arrive: the document is never kept in memory as a whole.
+
+TmxMap * tmx_load( char * _filename ) {
+
+    TmxMap * result = NULL;
+
+    xmlTextReaderPtr reader = xmlReaderForFile( _filename, NULL, 0 );
+
+    if ( ! reader )
+        return result;
+
+    result = malloc( sizeof( TmxMap ) );
+    memset( result, 0, sizeof ( TmxMap ) );
+
+    TmxDataReader data;
+    memset( &data, 0, sizeof( TmxDataReader ) );
+
+    TmxLayer * layer = NULL;
+    TmxLayer * lastLayer = NULL;
+    TmxChunk * chunk = NULL;
+    int inData = 0;
+    int valid = 1;
+    int status;
+
+    while( valid && ( status = xmlTextReaderRead( reader ) ) == 1 ) {
+
+        const char * name = (const char *) xmlTextReaderConstName( reader );
+        int depth = xmlTextReaderDepth( reader );
+
+        switch( xmlTextReaderNodeType( reader ) ) {
+
+            case XML_READER_TYPE_ELEMENT: {
+
+                int empty = xmlTextReaderIsEmptyElement( reader );
+
+                if ( depth == 0 && strcmp( name, "map" ) == 0 ) {
+
+                    tmx_load_map( reader, result );
+
+                } else if ( depth == 1 && strcmp( name, "tileset" ) == 0 ) {
+
+                    TsxTileset * tileset = tmx_load_tileset( reader, _filename );
+
+                    if ( tileset ) {
+                        if ( ! result->tilesets ) {
+                            result->tilesets = tileset;
                         } else {
-                            TmxLayer * actual = result->layers;
+                            TsxTileset * actual = result->tilesets;
                             while( actual->next )  {
                                 actual = actual->next;
                             }
-                            actual->next = layer;
+                            actual->next = tileset;
                         }
+                    }
 
+                } else if ( depth == 1 && strcmp( name, "layer" ) == 0 ) {
+
+                    layer = tmx_load_layer( reader );
+
+                    if ( ! result->layers ) {
+                        result->layers = layer;
+                    } else {
+                        lastLayer->next = layer;
                     }
+                    lastLayer = layer;
+
+                } else if ( depth == 2 && layer && strcmp( name, "data" ) == 0 ) {
 
-                    child = child->next;
+                    valid = tmx_load_data( reader, &data );
+
+                    layer->data = malloc( layer->width * layer->height * sizeof( int ) );
+                    memset( layer->data, 0, layer->width * layer->height * sizeof( int ) );
+
+                    tmx_data_begin( &data, layer->data, layer->width * layer->height );
+                    inData = !empty;
+
+                } else if ( depth == 3 && inData && strcmp( name, "chunk" ) == 0 ) {
+
+                    chunk = tmx_load_chunk( reader );
+                    chunk->next = layer->chunks;
+                    layer->chunks = chunk;
+
+                    tmx_data_begin( &data, chunk->data, chunk->width * chunk->height );
+                    if ( empty ) {
+                        chunk = NULL;
+                    }
+
+                } else if ( inData && strcmp( name, "tile" ) == 0 && data.encoding == TMX_ENCODING_XML ) {
+
+                    unsigned int gid = 0;
+                    while( xmlTextReaderMoveToNextAttribute( reader ) == 1 ) {
+                        if ( strcmp( (const char *) xmlTextReaderConstName( reader ), "gid" ) == 0 ) {
+                            gid = strtoul( (const char *) xmlTextReaderConstValue( reader ), NULL, 10 );
+                        }
+                    }
+                    xmlTextReaderMoveToElement( reader );
+                    tmx_data_store( &data, gid );
 
                 }
 
+                break;
+
             }
+
+            case XML_READER_TYPE_TEXT:
+            case XML_READER_TYPE_CDATA:
+            case XML_READER_TYPE_SIGNIFICANT_WHITESPACE:
+
+                if ( inData ) {
+                    tmx_data_feed( &data, (const char *) xmlTextReaderConstValue( reader ) );
+                }
+
+                break;
+
+            case XML_READER_TYPE_END_ELEMENT:
+
+                if ( chunk && strcmp( name, "chunk" ) == 0 ) {
+                    valid = tmx_data_end( &data );
+                    chunk = NULL;
+                } else if ( inData && strcmp( name, "data" ) == 0 ) {
+                    if ( ! layer->chunks ) {
+                        valid = tmx_data_end( &data );
+                    }
+                    inData = 0;
+                } else if ( depth == 1 && strcmp( name, "layer" ) == 0 ) {
+                    layer = NULL;
+                }
+
+                break;
+
         }
+
+    }
+
+    xmlFreeTextReader( reader );
+
+    free( data.text );
+
+    if ( status < 0 || ! valid ) {
+        return NULL;
     }
 
-    xmlFreeDoc(doc);
+    tmx_merge_chunks( result );
 
     return result;
 
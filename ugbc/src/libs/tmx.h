@@ -55,6 +55,22 @@ typedef enum _TmxRenderOrder {
  
 } TmxRenderOrder;
 
+// Global tile IDs carry the flipping / rotation flags in the upper bits.
+#define TMX_GID_MASK        0x0fffffff
+
+typedef struct _TmxChunk {
+
+    int                     x;
+    int                     y;
+    int                     width;
+    int                     height;
+
+    int                 *   data;
+
+    struct _TmxChunk    *   next;
+
+} TmxChunk;
+
 typedef struct _TmxLayer {
 
     int                     id;
@@ -64,6 +80,9 @@ typedef struct _TmxLayer {
 
     int                 *   data;
 
+    // Chunks of an infinite map, merged into data once loaded.
+    struct _TmxChunk    *   chunks;
+
     struct _TmxLayer    *   next;
 
 } TmxLayer;
@@ -73,7 +92,7 @@ typedef struct _TmxMap {
     char                *   version;
     char                *   tiledversion;
     TmxOrientation          orientation;
-    TmxOrientation          renderorder;
+    TmxRenderOrder          renderorder;
     int                     width;
     int                     height;
     int                     tilewidth;
@@ -39,202 +39,224 @@
 #include <stdlib.h>
 #include <limits.h>
 #include <unistd.h>
-#include <libxml/parser.h>
-#include <libxml/tree.h>
+#include <libxml/xmlreader.h>
 
 char * strcopy( char * _dest, const char * _source );
 
+static void tsx_load_tileset( xmlTextReaderPtr _reader, TsxTileset * _result ) {
+
+    while( xmlTextReaderMoveToNextAttribute( _reader ) == 1 ) {
+        const char * name = (const char *) xmlTextReaderConstName( _reader );
+        const char * value = (const char *) xmlTextReaderConstValue( _reader );
+        if ( strcmp( name, "version") == 0 ) {
+            _result->version = strdup( value );
+        } else if ( strcmp( name, "tiledversion") == 0 ) {
+            _result->tiledversion = strdup( value );
+        } else if ( strcmp( name, "name") == 0 ) {
+            _result->name = strdup( value );
+        } else if ( strcmp( name, "tilewidth") == 0 ) {
+            _result->tilewidth = atoi( value );
+        } else if ( strcmp( name, "tileheight") == 0 ) {
+            _result->tileheight = atoi( value );
+        } else if ( strcmp( name, "tilecount") == 0 ) {
+            _result->tilecount = atoi( value );
+        } else if ( strcmp( name, "columns") == 0 ) {
+            _result->columns = atoi( value );
+        } else if ( strcmp( name, "spacing") == 0 ) {
+            _result->spacing = atoi( value );
+        } else if ( strcmp( name, "margin") == 0 ) {
+            _result->margin = atoi( value );
+        } else if ( strcmp( name, "objectalignment") == 0 ) {
+            
+            // Object Alignment
+            // The alignment to use for tile objects referring to tiles from this tileset. 
+            // This affects the placement of the tile relative to the position of the object 
+            // (the origin) and is also the location around which the rotation is applied.
+            // Possible values are: Unspecified (the default), Top Left, Top, Top Right, 
+            // Left, Center, Right, Bottom Left, Bottom and Bottom Right. When unspecified, 
+            // tile object alignment is generally Bottom Left, except for Isometric maps 
+            // where it is Bottom.
+            
+            // currently unsupported
+
+        } else if ( strcmp( name, "tilerendersize") == 0 ) {
+            
+            // currently unsupported
+
+        } else if ( strcmp( name, "backgroundcolor") == 0 ) {
+            
+            // currently unsupported
+
+        } else if ( strcmp( name, "fillmode") == 0 ) {
+            
+            // currently unsupported
+
+        }
+    }
+
+    xmlTextReaderMoveToElement( _reader );
+
+}
+
+static TsxImage * tsx_load_image( xmlTextReaderPtr _reader ) {
+
+    TsxImage * image = malloc( sizeof( TsxImage ) );
+    memset( image, 0, sizeof ( TsxImage ) );
+
+    while( xmlTextReaderMoveToNextAttribute( _reader ) == 1 ) {
+        const char * name = (const char *) xmlTextReaderConstName( _reader );
+        const char * value = (const char *) xmlTextReaderConstValue( _reader );
+        if ( strcmp( name, "source") == 0 ) {
+            image->source = strdup( value );
+        } else if ( strcmp( name, "width") == 0 ) {
+            image->width = atoi( value );
+        } else if ( strcmp( name, "height") == 0 ) {
+            image->height = atoi( value );
+        }
+    }
+
+    xmlTextReaderMoveToElement( _reader );
+
+    return image;
+
+}
+
+static TsxTile * tsx_load_tile( xmlTextReaderPtr _reader ) {
+
+    TsxTile * tile = malloc( sizeof( TsxTile ) );
+    memset( tile, 0, sizeof ( TsxTile ) );
+
+    tile->probability = 1.0f;
+
+    while( xmlTextReaderMoveToNextAttribute( _reader ) == 1 ) {
+        const char * name = (const char *) xmlTextReaderConstName( _reader );
+        const char * value = (const char *) xmlTextReaderConstValue( _reader );
+        if ( strcmp( name, "id") == 0 ) {
+            tile->id = atoi( value );
+        } else if ( strcmp( name, "type") == 0 ) {
+            tile->type = strdup( value );
+        } else if ( strcmp( name, "probability") == 0 ) {
+            tile->probability = atof( value );
+        }
+    }
+
+    xmlTextReaderMoveToElement( _reader );
+
+    return tile;
+
+}
+
+// The tileset is read as a stream of nodes: only the root element and 
+// its direct children are used, so the document is never kept in memory.
+
 TsxTileset * tsx_load( char * _filename ) {
 
     TsxTileset * result = NULL;
 
-    xmlDocPtr doc;
-
-    doc = xmlReadFile( _filename, NULL, 0 );
+    xmlTextReaderPtr reader = xmlReaderForFile( _filename, NULL, 0 );
 
-    if ( ! doc )
+    if ( ! reader )
         return result;
 
     result = malloc( sizeof( TsxTileset ) );
     memset( result, 0, sizeof ( TsxTileset ) );
 
-    xmlNode *root_element = NULL;
-    xmlNode *cur_node = NULL;
+    int status;
+    int found = 0;
+
+    while( ( status = xmlTextReaderRead( reader ) ) == 1 ) {
+
+        if ( xmlTextReaderNodeType( reader ) != XML_READER_TYPE_ELEMENT ) {
+            continue;
+        }
 
-    root_element = xmlDocGetRootElement(doc);
- 
-    for (cur_node = root_element; cur_node; cur_node = cur_node->next) {
-        if (cur_node->type == XML_ELEMENT_NODE) {
-            if ( strcmp( cur_node->name, "tileset" ) == 0 ) {
+        const char * name = (const char *) xmlTextReaderConstName( reader );
+        int depth = xmlTextReaderDepth( reader );
+
+        if ( depth == 0 ) {
+
+            if ( strcmp( name, "tileset" ) == 0 ) {
+                tsx_load_tileset( reader, result );
+                found = 1;
+            }
+
+        } else if ( depth == 1 && found ) {
+
+            if ( strcmp( name, "image" ) == 0 ) {
+
+                result->image = tsx_load_image( reader );
+
+            } else if ( strcmp( name, "tileoffset" ) == 0 ) {
                 
-                struct _xmlAttr * properties = cur_node->properties;
-                while( properties ) {
-                    if ( properties->type == XML_ATTRIBUTE_NODE ) {
-                        xmlChar* value = xmlNodeListGetString(cur_node->doc, properties->children, 1);
-                        if ( strcmp( properties->name, "version") == 0 ) {
-                            result->version = strdup( value );
-                        } else if ( strcmp( properties->name, "tiledVersion") == 0 ) {
-                            result->tiledversion = strdup( value );
-                        } else if ( strcmp( properties->name, "name") == 0 ) {
-                            result->name = strdup( value );
-                        } else if ( strcmp( properties->name, "tilewidth") == 0 ) {
-                            result->tilewidth = atoi( value );
-                        } else if ( strcmp( properties->name, "tileheight") == 0 ) {
-                            result->tileheight = atoi( value );
-                        } else if ( strcmp( properties->name, "tilecount") == 0 ) {
-                            result->tilecount = atoi( value );
-                        } else if ( strcmp( properties->name, "columns") == 0 ) {
-                            result->columns = atoi( value );
-                        } else if ( strcmp( properties->name, "spacing") == 0 ) {
-                            result->spacing = atoi( value );
-                        } else if ( strcmp( properties->name, "margin") == 0 ) {
-                            result->margin = atoi( value );
-                        } else if ( strcmp( properties->name, "objectalignment") == 0 ) {
-                            
-                            // Object Alignment
-                            // The alignment to use for tile objects referring to tiles from this tileset. 
-                            // This affects the placement of the tile relative to the position of the object 
-                            // (the origin) and is also the location around which the rotation is applied.
-                            // Possible values are: Unspecified (the default), Top Left, Top, Top Right, 
-                            // Left, Center, Right, Bottom Left, Bottom and Bottom Right. When unspecified, 
-                            // tile object alignment is generally Bottom Left, except for Isometric maps 
-                            // where it is Bottom.
-                            
-                            // currently unsupported
-
-                        } else if ( strcmp( properties->name, "tilerendersize") == 0 ) {
-                            
-                            // currently unsupported
-
-                        } else if ( strcmp( properties->name, "backgroundcolor") == 0 ) {
-                            
-                            // currently unsupported
-
-                        } else if ( strcmp( properties->name, "fillmode") == 0 ) {
-                            
-                            // currently unsupported
-
-                        }
-                        xmlFree(value); 
-                    }
-                    properties = properties->next;
-                }
+                // Drawing Offset
+                // A drawing offset in pixels, applied when rendering any tile from the 
+                // tileset (as part of tile layers or as tile objects). This is can be 
+                // useful to make your tiles align to the grid.
 
-                xmlNode * child = cur_node->children;
-                while( child ) {
-                    if ( strcmp( child->name, "image" ) == 0 ) {
-
-                        TsxImage * image = malloc( sizeof( TsxImage ) );
-                        memset( image, 0, sizeof ( TsxImage ) );
-
-                        struct _xmlAttr * properties = child->properties;
-                        while( properties ) {
-                            if ( properties->type == XML_ATTRIBUTE_NODE ) {
-                                xmlChar* value = xmlNodeListGetString(child->doc, properties->children, 1);
-                                if ( strcmp( properties->name, "source") == 0 ) {
-                                    image->source = strdup( value );
-                                } if ( strcmp( properties->name, "width") == 0 ) {
-                                    image->width = atoi( value );
-                                } if ( strcmp( properties->name, "height") == 0 ) {
-                                    image->height = atoi( value );
-                                }
-                                xmlFree(value); 
-                            }
-                            properties = properties->next;
-                        }
-
-                        result->image = image;
-
-                    } else if ( strcmp( child->name, "tileoffset" ) == 0 ) {
-                        
-                        // Drawing Offset
-                        // A drawing offset in pixels, applied when rendering any tile from the 
-                        // tileset (as part of tile layers or as tile objects). This is can be 
-                        // useful to make your tiles align to the grid.
-
-                        // currently unsupported
-
-                    } else if ( strcmp( child->name, "grid" ) == 0 ) {
-                        
-                        // Orientation
-                        // When the tileset contains isometric tiles, you can set this to Isometric. 
-                        // This value, along with the Grid Width and Grid Height properties, is 
-                        // taken into account by overlays rendered on top of the tiles. This helps 
-                        // for example when specifying Terrain Information. It also affects the 
-                        // orientation used by the Tile Collision Editor.
-
-                        // currently unsupported
-
-                    } else if ( strcmp( child->name, "transformations" ) == 0 ) {
-                        
-                        // Tiled supports flipping and rotating tiles. When using terrains, tiles 
-                        // can be automatically flipped and/or rotated to create variations that 
-                        // would otherwise not be available in a tileset. This can be enabled in 
-                        // the Tileset Properties.
-
-                        // The following transformation-related options are available:
-
-                        // Flip Horizontally
-                        // Allow tiles to be flipped horizontally.
-
-                        // Flip Vertically
-                        // Allow tiles to be flipped vertically. This would be left disabled 
-                        // when the graphics contain shadows in vertical direction, for example.
-
-                        // Rotate
-                        // Allow tiles to be rotated (by 90, 180 or 270-degrees).
-
-                        // Prefer Untransformed Tiles
-                        // When transformations are enabled, it could happen that a certain pattern 
-                        // can be filled by either a regular tile or a transformed tile. With this 
-                        // option enabled, the untransformed tiles will always take precedence. 
-                        // Leaving this option disabled allows transformations to be used to create 
-                        // more variation.
-
-                        // currently unsupported
-
-                    } else if ( strcmp( child->name, "tile" ) == 0 ) {
-
-                        TsxTile * tile = malloc( sizeof( TsxTile ) );
-                        memset( tile, 0, sizeof ( TsxTile ) );
-
-                        tile->probability = 1.0f;
-
-                        struct _xmlAttr * properties = child->properties;
-                        while( properties ) {
-                            if ( properties->type == XML_ATTRIBUTE_NODE ) {
-                                xmlChar* value = xmlNodeListGetString(child->doc, properties->children, 1);
-                                if ( strcmp( properties->name, "id") == 0 ) {
-                                    tile->id = atoi( value );
-                                } if ( strcmp( properties->name, "type") == 0 ) {
-                                    tile->type = strdup( value );
-                                } if ( strcmp( properties->name, "probability") == 0 ) {
-                                    tile->probability = atof( value );
-                                }
-                                xmlFree(value); 
-                            }
-                            properties = properties->next;
-                        }
-
-                        if ( result->tiles ) {
-                            tile->next = result->tiles;
-                            result->tiles = tile;
-                        } else {
-                            result->tiles = tile;
-                        }
-
-                    }
-
-                    child = child->next;
-                }
+                // currently unsupported
+
+            } else if ( strcmp( name, "grid" ) == 0 ) {
+                
+                // Orientation
+                // When the tileset contains isometric tiles, you can set this to Isometric. 
+                // This value, along with the Grid Width and Grid Height properties, is 
+                // taken into account by overlays rendered on top of the tiles. This helps 
+                // for example when specifying Terrain Information. It also affects the 
+                // orientation used by the Tile Collision Editor.
+
+                // currently unsupported
+
+            } else if ( strcmp( name, "transformations" ) == 0 ) {
+                
+                // Tiled supports flipping and rotating tiles. When using terrains, tiles 
+                // can be automatically flipped and/or rotated to create variations that 
+                // would otherwise not be available in a tileset. This can be enabled in 
+                // the Tileset Properties.
 
-                break;
+                // The following transformation-related options are available:
+
+                // Flip Horizontally
+                // Allow tiles to be flipped horizontally.
+
+                // Flip Vertically
+                // Allow tiles to be flipped vertically. This would be left disabled 
+                // when the graphics contain shadows in vertical direction, for example.
+
+                // Rotate
+                // Allow tiles to be rotated (by 90, 180 or 270-degrees).
+
+                // Prefer Untransformed Tiles
+                // When transformations are enabled, it could happen that a certain pattern 
+                // can be filled by either a regular tile or a transformed tile. With this 
+                // option enabled, the untransformed tiles will always take precedence. 
+                // Leaving this option disabled allows transformations to be used to create 
+                // more variation.
+
+                // currently unsupported
+
+            } else if ( strcmp( name, "tile" ) == 0 ) {
+
+                TsxTile * tile = tsx_load_tile( reader );
+
+                if ( result->tiles ) {
+                    tile->next = result->tiles;
+                    result->tiles = tile;
+                } else {
+                    result->tiles = tile;
+                }
 
             }
+
         }
+
     }
 
-    xmlFreeDoc(doc);
+    xmlFreeTextReader( reader );
+
+    if ( status < 0 ) {
+        free( result );
+        result = NULL;
+    }
 
     return result;
 
@@ -356,73 +356,98 @@ static void d64_allocate_sector( D64Handle * _handle, D64Track _track, D64Sector
 }
 
 /**
- * @brief Find a free sector on the disk image.
+ * @brief Retrieve the BAM entry for a given track.
  * 
  * @param _handle Handle to the disk image
- * @param _track Track with the free sector (1...42)
- * @param _sector Free sector (0...21)
+ * @param _bam BAM sector of the disk image
+ * @param _track Track to look for (1...42)
+ * @return D64BAMEntry* BAM entry (NULL if the track is not available)
  */
-static void d64_find_free_sector( D64Handle * _handle, D64Track * _track, D64Sector * _sector ) {
+static D64BAMEntry * d64_get_bam_entry( D64Handle * _handle, D64SectorBAM * _bam, D64Track _track ) {
 
-    // printf( "d64_find_free_sector\n" );
+    // With tracks greater of 35 we have to use the extension
+    // of the BAM based on disk's format.
+    if ( _track > 35 ) {
 
-    // A 0/0 result means "no free sector available".
-    *_track = 0;
-    *_sector = 0;
+        switch( _handle->format ) {
+            case SPEEDDOS40:
+            case PROFESSIONALDOS40:
+            case PROFESSIONALDOS40B:
+            case PROSPEED40:
+                return &_bam->entriesSpeedDOS[_track-36];
 
-    // Retrieve the sector with the BAM.
-    D64SectorBAM * bam = (D64SectorBAM *) d64_get_sector( _handle, D64_BAM_TRACK, D64_BAM_SECTOR );
+            case DOLPHINDOS40:
+                return &_bam->entriesDolphinDOS[_track-36];
 
-    // This will contain the BAM entry with the free sector.
-    D64BAMEntry * entry;
+            case PROLOGICDOS40:
+                return &_bam->prologic.entriesPrologicDOS[_track-36];
 
-    _handle->lastUsedTrack = 17;
+            default:
+                return NULL;
+        }
 
-    // We are going to examinate tracks from 1 to the maximum number.
-    while( _handle->lastUsedTrack != 0 ) {
+    }
 
-        // With tracks greater of 35 we have to use the extension
-        // of the BAM based on disk's format.
-        if ( _handle->lastUsedTrack > 35 ) {
+    return &_bam->entries[_track-1];
 
-            switch( _handle->format ) {
-                case SPEEDDOS40:
-                case PROFESSIONALDOS40:
-                case PROFESSIONALDOS40B:
-                case PROSPEED40:
-                    entry = &bam->entriesSpeedDOS[_handle->lastUsedTrack-36];
-                    break;
+}
 
-                case DOLPHINDOS40:
-                    entry = &bam->entriesDolphinDOS[_handle->lastUsedTrack-36];
-                    break;
+/**
+ * @brief Find a free sector on the disk image.
+ * 
+ * The search mimics the CBM DOS: tracks are examinated from the
+ * directory track outwards (17...1, then the upper tracks down to
+ * 19), and the first sector of a file is the first free sector on
+ * the first free track. Every other sector is searched starting 
+ * _handle->interleave sectors after the previous one, so that the 
+ * drive has the time to deliver a sector before the next one passes
+ * under the head. The same skew is kept when moving to the next track.
+ * 
+ * @param _handle Handle to the disk image
+ * @param _track Track of the previous sector (0 if none) and, on
+ *               exit, track with the free sector (1...42)
+ * @param _sector Previous sector and, on exit, free sector (0...21)
+ */
+static void d64_find_free_sector( D64Handle * _handle, D64Track * _track, D64Sector * _sector ) {
 
-                case PROLOGICDOS40:
-                    entry = &bam->prologic.entriesPrologicDOS[_handle->lastUsedTrack-36];
-                    break;
+    // printf( "d64_find_free_sector\n" );
 
-                default:
-                    // No free sectors available!
-                    return;
-            }
+    // Retrieve the sector with the BAM.
+    D64SectorBAM * bam = (D64SectorBAM *) d64_get_sector( _handle, D64_BAM_TRACK, D64_BAM_SECTOR );
 
-        } else {
-            entry = &bam->entries[_handle->lastUsedTrack-1];
-        }
+    // First candidate sector: the sector after the given interleave
+    // or the very first one, for the first sector of a file.
+    int start = 0;
+
+    if ( *_track ) {
+        _handle->lastUsedTrack = *_track;
+        start = *_sector + _handle->interleave;
+    } else {
+        _handle->lastUsedTrack = 17;
+    }
+
+    // A 0/0 result means "no free sector available".
+    *_track = 0;
+    *_sector = 0;
+
+    // We are going to examinate all the tracks, at most once.
+    for( int i=0; i<_handle->tracks; ++i ) {
+
+        // This will contain the BAM entry with the free sector.
+        D64BAMEntry * entry = d64_get_bam_entry( _handle, bam, _handle->lastUsedTrack );
 
         // printf( "  >> track %d, free sectors = %d\n", _handle->lastUsedTrack, entry->freeSectors );
 
         // A fast check if free sectors are available.
-        if ( entry->freeSectors > 0 ) {
+        if ( entry && entry->freeSectors > 0 ) {
             // A detailed check to find out the correct sector
-            // must be executed.
-            int sector = 0;
-            for( int j=0; j<D64SectorsPerTrack[_handle->lastUsedTrack-1]; ++j ) {
-                // printf( " > sector = %d\n", j );
+            // must be executed, starting from the candidate.
+            int sectors = D64SectorsPerTrack[_handle->lastUsedTrack-1];
+            for( int j=0; j<sectors; ++j ) {
+                int sector = ( start + j ) % sectors;
                 // Let's calculate the offset and the bitmap for the given sector.
                 int offset = sector >> 3;
                 int bitmap = 1 << ( sector & 0x07 ); 
-                // printf( " > offset, bitmap = %2.2x %2.2x\n", offset, bitmap );
                 // If the bit is set, the sector is free.
                 if ( ( entry->bitmappedFree[offset] & bitmap ) == bitmap ) {
                     *_track = _handle->lastUsedTrack;
@@ -430,8 +455,6 @@ static void d64_find_free_sector( D64Handle * _handle, D64Track * _track, D64Sec
                     // printf( "found %2.2x %2.2x -> track = %d sector = %d\n", offset, bitmap, *_track, *_sector );
                     return;
                 }
-                sector += 10;
-                sector = sector % D64SectorsPerTrack[_handle->lastUsedTrack-1];
             }
         }
         
@@ -442,12 +465,53 @@ static void d64_find_free_sector( D64Handle * _handle, D64Track * _track, D64Sec
         }
 
         if ( _handle->lastUsedTrack == 18 ) {
-            _handle->lastUsedTrack = 0;
+            return;
         }
 
     }
 }
 
+/**
+ * @brief Find a free sector for the directory.
+ * 
+ * Like the CBM DOS, the directory is kept on the directory track,
+ * with an interleave of 3 sectors. Only if that track is full, the 
+ * sector is searched as for any other file.
+ * 
+ * @param _handle Handle to current disk image
+ * @param _previous Previous sector of the directory
+ * @param _track On exit, track with the free sector (0 if none)
+ * @param _sector On exit, free sector
+ */
+static void d64_find_free_directory_sector( D64Handle * _handle, D64Sector _previous, D64Track * _track, D64Sector * _sector ) {
+
+    // Retrieve the sector with the BAM.
+    D64SectorBAM * bam = (D64SectorBAM *) d64_get_sector( _handle, D64_BAM_TRACK, D64_BAM_SECTOR );
+
+    D64BAMEntry * entry = d64_get_bam_entry( _handle, bam, D64_BAM_TRACK );
+
+    if ( entry && entry->freeSectors > 0 ) {
+        int sectors = D64SectorsPerTrack[D64_BAM_TRACK-1];
+        for( int j=0; j<sectors; ++j ) {
+            int sector = ( _previous + 3 + j ) % sectors;
+            int offset = sector >> 3;
+            int bitmap = 1 << ( sector & 0x07 );
+            if ( ( entry->bitmappedFree[offset] & bitmap ) == bitmap ) {
+                *_track = D64_BAM_TRACK;
+                *_sector = sector;
+                return;
+            }
+        }
+    }
+
+    // The directory track is full: search like for the first
+    // sector of a file.
+    *_track = 0;
+    *_sector = 0;
+    d64_find_free_sector( _handle, _track, _sector );
+
+}
+
 /**
  * @brief Allocate an retrieve the address of a directory's entry
  * 
@@ -468,6 +532,9 @@ static D64DirectoryEntry * d64_allocate_directory_entry( D64Handle * _handle ) {
     // Take note of the index into the directory's entries.
     int directoryIndex = 0;
 
+    // Take note of the current sector with directory.
+    D64Sector directorySector = bam->firstDirectorySector;
+
     do {
 
         // Retrieve the address of the directory's entry.
@@ -497,7 +564,7 @@ static D64DirectoryEntry * d64_allocate_directory_entry( D64Handle * _handle ) {
                     // Find out the next free sector to use.
                     D64Track track;
                     D64Sector sector;
-                    d64_find_free_sector( _handle, &track, &sector );
+                    d64_find_free_directory_sector( _handle, directorySector, &track, &sector );
 
                     if ( track == 0 && sector == 0 ) {
                         return NULL;
@@ -512,6 +579,7 @@ static D64DirectoryEntry * d64_allocate_directory_entry( D64Handle * _handle ) {
                 }
 
                 // Move to the next directory sector.
+                directorySector = directory->entries[0].sector;
                 directory = (D64SectorDirectory *) d64_get_sector( _handle, directory->entries[0].track, directory->entries[0].sector );
             }
         }
@@ -670,6 +738,11 @@ static void d64_format( D64Handle * _handle ) {
         d64_free_sectors_on_bam( &bam->entries[i], D64SectorsPerTrack[i] );
     }
 
+    // The BAM and the first directory sector are in use, so they
+    // cannot be given to the directory when it grows.
+    d64_allocate_sector( _handle, D64_BAM_TRACK, D64_BAM_SECTOR );
+    d64_allocate_sector( _handle, D64_DIRECTORY_TRACK, D64_DIRECTORY_SECTOR );
+
     // Set the default disk name
     d64_set_disk_name( _handle, "UGBASIC" );
 
@@ -770,6 +843,26 @@ void d64_set_dos_type( D64Handle * _handle, unsigned char * _dos_type ) {
 
 }
 
+/**
+ * @brief Set the sector interleave used to write the next files
+ * 
+ * @param _handle Handle to the disk image
+ * @param _interleave Distance between consecutive sectors (1...20)
+ */
+void d64_set_interleave( D64Handle * _handle, int _interleave ) {
+
+    if ( _interleave < 1 ) {
+        _interleave = 1;
+    }
+
+    if ( _interleave > 20 ) {
+        _interleave = 20;
+    }
+
+    _handle->interleave = _interleave;
+
+}
+
 /**
  * @brief Create a new D64 disk image 
  * 
@@ -784,6 +877,7 @@ D64Handle * d64_create( D64Format _format ) {
 
     // Update and format the disk image
     handle->format = _format;
+    handle->interleave = D64_DEFAULT_INTERLEAVE;
     d64_format( handle );
 
     return handle;
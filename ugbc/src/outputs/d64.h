@@ -618,6 +618,10 @@ typedef struct _D64Handle {
     // 
     D64Track            lastUsedTrack;
 
+    // Distance (in sectors) between two consecutive sectors
+    // of the same file, on the same track.
+    D64Sector           interleave;
+
 } D64Handle;
 
 #define         D64_BAM_TRACK               18
@@ -625,6 +629,14 @@ typedef struct _D64Handle {
 #define         D64_DIRECTORY_TRACK         18
 #define         D64_DIRECTORY_SECTOR         1
 
+// This is the interleave used by the CBM DOS when writing
+// files: it fits the standard KERNAL loader.
+#define         D64_DEFAULT_INTERLEAVE      10
+
+// This is the interleave that fits the built-in fast loader:
+// a sector is received in about 6-7 sector times.
+#define         D64_FASTLOAD_INTERLEAVE      8
+
 /****************************************************************************
  * FUNCTION DECLARATION
  ****************************************************************************/
@@ -635,6 +647,7 @@ void                d64_set_dos_version( D64Handle * _handle, D64DosVersion _ver
 void                d64_set_disk_name( D64Handle * _handle, unsigned char * _disk_name );
 void                d64_set_disk_id( D64Handle * _handle, D64DiskId _disk_id );
 void                d64_set_dos_type( D64Handle * _handle, unsigned char * _dos_type );
+void                d64_set_interleave( D64Handle * _handle, int _interleave );
 int                 d64_write_file( D64Handle * _handle, unsigned char * _filename, D64FileType _type, unsigned char * _buffer, int _size );
 void                d64_output( D64Handle * _handle, unsigned char * _filename );
 void                d64_free( D64Handle * _handle );
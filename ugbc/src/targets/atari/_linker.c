@@ -102,6 +102,7 @@ void linker_setup( Environment * _environment ) {
     cfgline0("LOWCODE:  load = MAIN,     type = ro, define = yes, optional = yes;");
     cfgline0("INIT:     load = MAIN,     type = ro,               optional = yes;");
     cfgline0("CODE:     load = MAIN,     type = ro, define = yes;");
+    cfgline0("LIB:      load = MAIN,     type = ro,               optional = yes;");
     cfgline0("RODATA:   load = MAIN,     type = ro;");
     cfgline0("DATA:     load = MAIN,     type = rw;");
     cfgline0("ZPSAVE:   load = MAIN,     type = bss, define = yes, optional = yes;");
@@ -150,6 +150,15 @@ static void variable_cleanup_entry( Environment * _environment, Variable * _firs
                         outhead1("%s: .res 16,0", variable->realName);
                     }
                     break;
+                case VT_BCD4:
+                case VT_BCD6:
+                case VT_BCD8:
+                    if ( variable->memoryArea ) {
+                        // outhead2("%s = $%4.4x", variable->realName, variable->absoluteAddress);
+                    } else {
+                        outhead2("%s: .res %d,0", variable->realName, VT_BCD_BYTES( variable->type ) );
+                    }
+                    break;
                 case VT_VECTOR2:
                     if ( variable->memoryArea ) {
                         // outhead2("%s = $%4.4x", variable->realName, variable->absoluteAddress);
@@ -46,7 +46,32 @@
  */
 /* <usermanual>
 @keyword DOUBLE BUFFER
+
+@target atari
+@target atarixl
 </usermanual> */
 void double_buffer( Environment * _environment, int _enabled ) {
 
+    deploy( vbl, src_hw_gtia_vbl_asm );
+    deploy( doubleBuffer, src_hw_gtia_double_buffer_asm );
+
+    // The two screens are reserved once, below the frame buffer.
+    if ( ! _environment->doubleBufferStart ) {
+        _environment->frameBufferStart = ( ( _environment->frameBufferStart - 0x800 ) >> 11 ) << 11;
+        _environment->doubleBufferStart = _environment->frameBufferStart;
+    }
+
+    if ( _environment->doubleBufferEnabled != _enabled ) {
+
+        _environment->doubleBufferEnabled = _enabled;
+
+        if ( _enabled ) {
+            outline1("LDA #$%2.2x", ( _environment->doubleBufferStart >> 8 ) & 0xff );
+            outline0("JSR DOUBLEBUFFERINIT");
+        } else {
+            outline0("JSR DOUBLEBUFFERCLEANUP");
+        }
+
+    };
+
 }
@@ -108,6 +108,9 @@ void generate_d64( Environment * _environment ) {
 
     if ( !storage ) {
         D64Handle * handle = d64_create( CBMDOS );
+        if ( _environment->diskInterleave ) {
+            d64_set_interleave( handle, _environment->diskInterleave );
+        }
         d64_write_file( handle, "MAIN", FT_PRG, prgContent, prgSize );
         d64_output( handle, _environment->exeFileName );
         d64_free( handle );
@@ -115,6 +118,9 @@ void generate_d64( Environment * _environment ) {
         int i=0;
         while( storage ) {
             D64Handle * handle = d64_create( CBMDOS );
+            if ( _environment->diskInterleave ) {
+                d64_set_interleave( handle, _environment->diskInterleave );
+            }
             if ( i == 0 ) {
                 d64_write_file( handle, "MAIN", FT_PRG, prgContent, prgSize );
             }
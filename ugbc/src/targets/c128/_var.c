@@ -87,6 +87,15 @@ static void variable_cleanup_entry( Environment * _environment, Variable * _firs
                         outhead1("%s: .res 16,0", variable->realName);
                     }        
                     break;
+                case VT_BCD4:
+                case VT_BCD6:
+                case VT_BCD8:
+                    if ( variable->memoryArea && variable->bankAssigned != -1 ) {
+                        // outline2("%s = $%4.4x", variable->realName, variable->absoluteAddress);
+                    } else {
+                        outhead2("%s: .res %d,0", variable->realName, VT_BCD_BYTES( variable->type ) );
+                    }        
+                    break;
                 case VT_VECTOR2:
                     if ( variable->memoryArea && variable->bankAssigned != -1 ) {
                         // outline2("%s = $%4.4x", variable->realName, variable->absoluteAddress);
@@ -392,6 +401,11 @@ static void variable_cleanup_memory_mapped( Environment * _environment, Variable
         case VT_PATH:
             outhead1("%s: .res 16,0", _variable->realName);
             break;
+        case VT_BCD4:
+        case VT_BCD6:
+        case VT_BCD8:
+            outhead2("%s: .res %d,0", _variable->realName, VT_BCD_BYTES( _variable->type ) );
+            break;
         case VT_VECTOR2:
             outhead1("%s: .res 4,0", _variable->realName);
             break;
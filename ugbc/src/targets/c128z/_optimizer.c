@@ -75,6 +75,8 @@
 
 #include "../../ugbc.h"
 #include <stdarg.h>
+#include <stdlib.h>
+#include <ctype.h>
 
 /****************************************************************************
  * CODE SECTION 
@@ -191,6 +193,334 @@ static int _isZero(POBuffer buf) {
     return buf!=NULL && isZero(buf->str);
 }
 
+/* value tracking */
+
+/* The optimizer keeps track of what is known about the contents of A, HL,
+   DE and BC, along straight-line code: the immediate value loaded into the
+   register, and/or the (symbolic) memory location it holds a copy of. Any
+   label, call or instruction we do not know about forgets everything. */
+
+#define KNOWN_A         0
+#define KNOWN_HL        1
+#define KNOWN_DE        2
+#define KNOWN_BC        3
+#define KNOWN_COUNT     4
+#define KNOWN_NONE      -1
+
+#define KNOWN_MAX_TOKEN 128
+
+static struct {
+    char value[KNOWN_MAX_TOKEN];
+    char memory[KNOWN_MAX_TOKEN];
+} known[KNOWN_COUNT];
+
+static void known_forget(int _reg) {
+    if ( _reg != KNOWN_NONE ) {
+        known[_reg].value[0] = '\0';
+        known[_reg].memory[0] = '\0';
+    }
+}
+
+static void known_forget_all(void) {
+    for( int i=0; i<KNOWN_COUNT; ++i ) {
+        known_forget(i);
+    }
+}
+
+/* compares two identifiers, ignoring case */
+static int known_same(const char *_a, const char *_b) {
+    while( *_a && *_b && _toUpper(*_a) == _toUpper(*_b) ) {
+        ++_a; ++_b;
+    }
+    return *_a == *_b;
+}
+
+/* length of the base symbol (i.e. "_var" for "_var+1") */
+static int known_base_length(const char *_s) {
+    int n = 0;
+    while( _s[n] && _s[n] != '+' && _s[n] != '-' && _s[n] != ' ' ) ++n;
+    return n;
+}
+
+/* forget every register that holds a copy of the given symbol
+   (NULL means: any memory location) */
+static void known_forget_memory(const char *_symbol) {
+    for( int i=0; i<KNOWN_COUNT; ++i ) {
+        if ( !known[i].memory[0] ) continue;
+        if ( _symbol ) {
+            int n = known_base_length(_symbol);
+            if ( known_base_length(known[i].memory) != n || strncmp(known[i].memory, _symbol, n) != 0 ) {
+                continue;
+            }
+        }
+        known[i].memory[0] = '\0';
+    }
+}
+
+/* which tracked register (or register pair) is written by this operand */
+static int known_register(const char *_op) {
+    if ( known_same(_op, "A") ) return KNOWN_A;
+    if ( known_same(_op, "HL") || known_same(_op, "H") || known_same(_op, "L") ) return KNOWN_HL;
+    if ( known_same(_op, "DE") || known_same(_op, "D") || known_same(_op, "E") ) return KNOWN_DE;
+    if ( known_same(_op, "BC") || known_same(_op, "B") || known_same(_op, "C") ) return KNOWN_BC;
+    return KNOWN_NONE;
+}
+
+static int known_is_register(const char *_op) {
+    static char * registers[] = {
+        "A", "B", "C", "D", "E", "H", "L", "F", "I", "R",
+        "AF", "BC", "DE", "HL", "SP", "IX", "IY", "IXH", "IXL", "IYH", "IYL", NULL
+    };
+    for( int i=0; registers[i]; ++i ) {
+        if ( known_same(_op, registers[i]) ) return 1;
+    }
+    return 0;
+}
+
+/* only the ugBASIC variables are tracked in memory: hardware registers
+   (and anything else that could change by itself) are never cached */
+static int known_is_trackable(const char *_symbol) {
+    if ( _symbol[0] != '_' ) return 0;
+    if ( strncmp(_symbol, "_label", 6) == 0 ) return 0;
+    for( const char *s = _symbol; *s; ++s ) {
+        if ( *s == '(' || *s == ')' || *s == ',' ) return 0;
+    }
+    return 1;
+}
+
+/* an immediate value that means the same everywhere (no "$+n") */
+static int known_is_constant(const char *_op) {
+    if ( !_op[0] || _op[0] == '(' || known_is_register(_op) ) return 0;
+    for( const char *s = _op; *s; ++s ) {
+        if ( *s == '$' && !isxdigit( (unsigned char) s[1] ) ) return 0;
+    }
+    return 1;
+}
+
+/* numeric value of an operand, if it is a plain number */
+static int known_number(const char *_op, int *_value) {
+    char *end;
+    long v;
+    if ( _op[0] == '$' ) {
+        v = strtol(_op+1, &end, 16);
+    } else if ( _op[0] == '0' && _toUpper(_op[1]) == 'X' ) {
+        v = strtol(_op+2, &end, 16);
+    } else if ( isdigit( (unsigned char) _op[0] ) ) {
+        v = strtol(_op, &end, 10);
+    } else {
+        return 0;
+    }
+    if ( *end ) return 0;
+    *_value = (int) v;
+    return 1;
+}
+
+static int known_same_value(const char *_a, const char *_b) {
+    int va, vb;
+    if ( !_a[0] || !_b[0] ) return 0;
+    if ( known_number(_a, &va) && known_number(_b, &vb) ) return va == vb;
+    return known_same(_a, _b);
+}
+
+/* copy the symbol inside a "(symbol)" operand, if any */
+static int known_indirect(const char *_op, char *_symbol) {
+    int n = strlen(_op);
+    if ( n < 3 || _op[0] != '(' || _op[n-1] != ')' ) return 0;
+    strncpy(_symbol, _op+1, n-2);
+    _symbol[n-2] = '\0';
+    return 1;
+}
+
+/* split the first line of the buffer into mnemonic and operands:
+   returns 1 for an instruction, 0 for comments and empty lines,
+   -1 for labels and lines already changed in this pass */
+static int known_parse(POBuffer _buf, char *_mnemonic, char *_op1, char *_op2) {
+    char *s = _buf->str;
+    char *d;
+    int n;
+
+    _mnemonic[0] = _op1[0] = _op2[0] = '\0';
+
+    if ( _eol(*s) || *s == '\r' ) return 0;
+    if ( *s == ';' ) return -1;
+    if ( *s != ' ' && *s != '\t' ) return -1;
+
+    while( *s == ' ' || *s == '\t' ) ++s;
+    if ( _eol(*s) || *s == '\r' || *s == ';' ) return 0;
+
+    for( d = _mnemonic, n = 0; !_eol(*s) && *s != ' ' && *s != '\t' && *s != ';' && *s != '\r' && n < KNOWN_MAX_TOKEN-1; ++n ) *d++ = _toUpper(*s++);
+    *d = '\0';
+
+    for( int k=0; k<2; ++k ) {
+        char *op = k ? _op2 : _op1;
+        while( *s == ' ' || *s == '\t' ) ++s;
+        for( d = op, n = 0; !_eol(*s) && *s != ',' && *s != ';' && *s != '\r' && n < KNOWN_MAX_TOKEN-1; ++n ) *d++ = *s++;
+        while( d > op && ( d[-1] == ' ' || d[-1] == '\t' ) ) --d;
+        *d = '\0';
+        if ( *s != ',' ) break;
+        ++s;
+    }
+
+    return 1;
+}
+
+static int known_is_condition(const char *_op) {
+    static char * conditions[] = { "Z", "NZ", "C", "NC", "PO", "PE", "P", "M", NULL };
+    for( int i=0; conditions[i]; ++i ) {
+        if ( known_same(_op, conditions[i]) ) return 1;
+    }
+    return 0;
+}
+
+/* the destination of a write: a register or a memory location */
+static void known_write(const char *_op) {
+    char symbol[KNOWN_MAX_TOKEN];
+    if ( known_indirect(_op, symbol) ) {
+        if ( known_is_trackable(symbol) ) {
+            known_forget_memory(symbol);
+        } else {
+            known_forget_memory(NULL);
+        }
+    } else {
+        known_forget(known_register(_op));
+    }
+}
+
+static void optim_known(Environment * _environment, POBuffer buf[LOOK_AHEAD]) {
+    char mnemonic[KNOWN_MAX_TOKEN];
+    char op1[KNOWN_MAX_TOKEN];
+    char op2[KNOWN_MAX_TOKEN];
+    char symbol[KNOWN_MAX_TOKEN];
+
+    int kind = known_parse(buf[0], mnemonic, op1, op2);
+
+    if ( kind == 0 ) return;
+    if ( kind < 0 ) {
+        known_forget_all();
+        return;
+    }
+
+    if ( known_same(mnemonic, "LD") && op2[0] ) {
+        int reg = known_register(op1);
+        if ( known_is_register(op1) ) {
+            int pair = known_same(op1, "A") || known_same(op1, "HL") || known_same(op1, "DE") || known_same(op1, "BC");
+            if ( pair && known_indirect(op2, symbol) && known_is_trackable(symbol) ) {
+                // LD A, (x) / LD HL, (x) : x is already there
+                if ( known_same(known[reg].memory, symbol) ) {
+                    optim(buf[0], RULE "[known](LD r, (x))->()", NULL);
+                    ++_environment->removedAssemblyLines;
+                    return;
+                }
+                known_forget(reg);
+                strcpy(known[reg].memory, symbol);
+            } else if ( pair && known_is_constant(op2) ) {
+                // LD A, n / LD HL, n : n is already there
+                if ( known_same_value(known[reg].value, op2) ) {
+                    optim(buf[0], RULE "[known](LD r, n)->()", NULL);
+                    ++_environment->removedAssemblyLines;
+                    return;
+                }
+                known_forget(reg);
+                strcpy(known[reg].value, op2);
+            } else {
+                known_forget(reg);
+            }
+        } else if ( known_indirect(op1, symbol) && known_is_trackable(symbol) ) {
+            // LD (x), r : now r is also a copy of x
+            known_forget_memory(symbol);
+            int source = known_register(op2);
+            if ( source != KNOWN_NONE && ( known_same(op2, "A") || known_same(op2, "HL") || known_same(op2, "DE") || known_same(op2, "BC") ) ) {
+                strcpy(known[source].memory, symbol);
+            }
+        } else {
+            known_write(op1);
+        }
+        return;
+    }
+
+    /* instructions that do not change any tracked register */
+    if ( known_same(mnemonic, "CP") || known_same(mnemonic, "BIT") || known_same(mnemonic, "PUSH") ||
+         known_same(mnemonic, "NOP") || known_same(mnemonic, "DI") || known_same(mnemonic, "EI") ||
+         known_same(mnemonic, "SCF") || known_same(mnemonic, "CCF") || known_same(mnemonic, "OUT") ) {
+        return;
+    }
+
+    /* OR A / AND A only set the flags */
+    if ( ( known_same(mnemonic, "OR") || known_same(mnemonic, "AND") ) && known_same(op1, "A") && !op2[0] ) {
+        return;
+    }
+
+    /* conditional jumps and returns: the fall-through keeps everything */
+    if ( ( known_same(mnemonic, "JP") || known_same(mnemonic, "JR") ) && op2[0] && known_is_condition(op1) ) {
+        return;
+    }
+    if ( known_same(mnemonic, "RET") && op1[0] ) {
+        return;
+    }
+
+    if ( known_same(mnemonic, "DJNZ") ) {
+        known_forget(KNOWN_BC);
+        return;
+    }
+
+    if ( known_same(mnemonic, "EX") && 
+         ( ( known_same(op1, "DE") && known_same(op2, "HL") ) || ( known_same(op1, "HL") && known_same(op2, "DE") ) ) ) {
+        char tmp[KNOWN_MAX_TOKEN];
+        strcpy(tmp, known[KNOWN_HL].value); strcpy(known[KNOWN_HL].value, known[KNOWN_DE].value); strcpy(known[KNOWN_DE].value, tmp);
+        strcpy(tmp, known[KNOWN_HL].memory); strcpy(known[KNOWN_HL].memory, known[KNOWN_DE].memory); strcpy(known[KNOWN_DE].memory, tmp);
+        return;
+    }
+
+    /* XOR A / SUB A : A = 0 */
+    if ( ( known_same(mnemonic, "XOR") || known_same(mnemonic, "SUB") ) && known_same(op1, "A") && !op2[0] ) {
+        known_forget(KNOWN_A);
+        strcpy(known[KNOWN_A].value, "0");
+        return;
+    }
+
+    /* arithmetic and logic on the accumulator (or on HL) */
+    if ( known_same(mnemonic, "ADD") || known_same(mnemonic, "ADC") || known_same(mnemonic, "SUB") ||
+         known_same(mnemonic, "SBC") || known_same(mnemonic, "AND") || known_same(mnemonic, "OR") ||
+         known_same(mnemonic, "XOR") ) {
+        if ( op2[0] ) {
+            known_forget(known_register(op1));
+        } else {
+            known_forget(KNOWN_A);
+        }
+        return;
+    }
+
+    if ( known_same(mnemonic, "CPL") || known_same(mnemonic, "NEG") || known_same(mnemonic, "DAA") ||
+         known_same(mnemonic, "RLA") || known_same(mnemonic, "RRA") || known_same(mnemonic, "RLCA") ||
+         known_same(mnemonic, "RRCA") ) {
+        known_forget(KNOWN_A);
+        return;
+    }
+
+    /* single operand read-modify-write (the last operand is the target) */
+    if ( known_same(mnemonic, "INC") || known_same(mnemonic, "DEC") || known_same(mnemonic, "RL") ||
+         known_same(mnemonic, "RR") || known_same(mnemonic, "RLC") || known_same(mnemonic, "RRC") ||
+         known_same(mnemonic, "SLA") || known_same(mnemonic, "SRA") || known_same(mnemonic, "SRL") ||
+         known_same(mnemonic, "SLL") || known_same(mnemonic, "SET") ||
+         known_same(mnemonic, "RES") ) {
+        known_write(op2[0] ? op2 : op1);
+        return;
+    }
+
+    if ( known_same(mnemonic, "POP") ) {
+        known_forget(known_same(op1, "AF") ? KNOWN_A : known_register(op1));
+        return;
+    }
+
+    if ( known_same(mnemonic, "IN") && op2[0] ) {
+        known_forget(known_register(op1));
+        return;
+    }
+
+    /* anything else (calls, jumps, block instructions, directives...) */
+    known_forget_all();
+}
+
 /* perform basic peephole optimization with a length-4 look-ahead */
 static void basic_peephole(POBuffer buf[LOOK_AHEAD], int zA, int zB) {
     /* allows presumably safe operations */
@@ -243,12 +573,15 @@ static void basic_peephole(POBuffer buf[LOOK_AHEAD], int zA, int zB) {
     // ;try this
     // ld (hl),$42
     // ; -> save 1 byte and 4 T-states
-	// if( po_buf_match( buf[0], " LD A, $*", v1) && 
-    //     po_buf_match( buf[1], " LD (HL), A")
-    //     ) {
-	// 	optim( buf[0], RULE "(LD A, x; LD (HL), A)->(LD (HL), x)", "\tLD HL, $%s", v1->str );
-	// 	optim( buf[1], NULL, NULL );
-    // }
+    // ;(only if A is reloaded right after)
+	if( po_buf_match( buf[0], " LD A, $*", v1) && 
+        po_buf_match( buf[1], " LD (HL), A") &&
+        po_buf_match( buf[2], " LD A, *", v2) &&
+        strchr( v2->str, 'A' ) == NULL && strchr( v2->str, 'a' ) == NULL
+        ) {
+		optim( buf[0], RULE "(LD A, x; LD (HL), A)->(LD (HL), x)", "\tLD (HL), $%s", v1->str );
+		optim( buf[1], NULL, NULL );
+    }
 
     // ;Instead of
     //     ld A, (var)
@@ -278,25 +611,31 @@ static void basic_peephole(POBuffer buf[LOOK_AHEAD], int zA, int zB) {
     // ldi
     // inc bc
     // ; -> save 1 byte and 4 T-states
-	// if( po_buf_match( buf[0], " LD A, (HL)") && 
-    //     po_buf_match( buf[1], " LD (DE), A" ) &&
-    //     po_buf_match( buf[2], " INC HL" ) &&
-    //     po_buf_match( buf[3], " INC DE" )
-    //     ) {
-	// 	optim( buf[0], RULE "(LD A, (HL); LD (DE), A; INC HL; INC DE)->(LDI; INC BC)", "\tLDI" );
-	// 	optim( buf[1], NULL, "\tINC BC" );
-	// 	optim( buf[2], NULL, NULL );
-	// 	optim( buf[3], NULL, NULL );
-    // }
+    // ;(only if A is reloaded right after: LDI does not load it)
+	if( po_buf_match( buf[0], " LD A, (HL)") && 
+        po_buf_match( buf[1], " LD (DE), A" ) &&
+        po_buf_match( buf[2], " INC HL" ) &&
+        po_buf_match( buf[3], " INC DE" ) &&
+        po_buf_match( buf[4], " LD A, *", v1 ) &&
+        strchr( v1->str, 'A' ) == NULL && strchr( v1->str, 'a' ) == NULL
+        ) {
+		optim( buf[0], RULE "(LD A, (HL); LD (DE), A; INC HL; INC DE)->(LDI; INC BC)", "\tLDI" );
+		optim( buf[1], NULL, "\tINC BC" );
+		optim( buf[2], NULL, NULL );
+		optim( buf[3], NULL, NULL );
+    }
 
     // ;Instead of:
     //  cp 0
     // ;Use
     //  or a
     // ; -> save 1 byte and 3 T-states
-	// if( po_buf_match( buf[0], " CP 0") ) {
-	// 	optim( buf[0], RULE "(CP 0)->(OR A)", "\tOR A" );
-    // }
+    // ;(only if followed by a jump on Z/NZ/C/NC: P/V and N are different)
+	if( po_buf_match( buf[0], " CP *", v1 ) && _isZero( v1 ) &&
+        ( po_buf_match( buf[1], " JP *, *", v2, v3 ) || po_buf_match( buf[1], " JR *, *", v2, v3 ) ) &&
+        ( known_same( v2->str, "Z" ) || known_same( v2->str, "NZ" ) || known_same( v2->str, "C" ) || known_same( v2->str, "NC" ) ) ) {
+		optim( buf[0], RULE "(CP 0)->(OR A)", "\tOR A" );
+    }
 
     //   xor %11111111
     // ; >
@@ -664,6 +1003,7 @@ static int optim_pass( Environment * _environment, POBuffer buf[LOOK_AHEAD], Pee
         
         case PEEPHOLE:
         ++peephole_pass;
+        known_forget_all();
         // vars_clear();
         break;
     }
@@ -721,6 +1061,7 @@ static int optim_pass( Environment * _environment, POBuffer buf[LOOK_AHEAD], Pee
         switch(kind) {
             case PEEPHOLE:
             basic_peephole(buf, zA, zB);
+            optim_known(_environment, buf);
             
             /* only look fo variable when no peephole has been performed */
             if(change == 0) vars_scan(buf);
@@ -818,6 +1159,8 @@ void target_finalize( Environment * _environment ) {
 
         adiline0( "A:0" );
 
+        hotspot_begin( _environment );
+
         fileAsm = fopen( _environment->asmFileName, "rb" );
         if(fileAsm == NULL) {
             perror(_environment->asmFileName);
@@ -849,6 +1192,8 @@ void target_finalize( Environment * _environment ) {
                 continue;
             }
 
+            hotspot_instruction( _environment, _environment->currentSourceLineAnalyzed, bufferAsm->str, leftPadding == 0 );
+
             *bufferListing->str = 0;
             int pos = ftell( fileListing );
             po_buf_trim( bufferAsm );
@@ -886,6 +1231,8 @@ void target_finalize( Environment * _environment ) {
                 _environment->bytesProduced );
         }
 
+        hotspot_end( _environment );
+
         (void)fclose(fileListing);
         (void)fclose(fileAsm);
 
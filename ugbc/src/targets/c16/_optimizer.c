@@ -2013,6 +2013,7 @@ static void optim_remove_comments( Environment * _environment ) {
 
 /* main entry-point for this service */
 void target_peephole_optimizer( Environment * _environment ) {
+    optim_timer_context_6502( _environment );
     optim_remove_unused_temporary( _environment );
     //_environment->peepholeOptimizationLimit = 0;
     if ( _environment->peepholeOptimizationLimit > 0 ) {
@@ -2066,6 +2067,8 @@ void target_finalize( Environment * _environment ) {
 
         adiline0( "A:0" );
 
+        hotspot_begin( _environment );
+
         fileAsm = fopen( _environment->asmFileName, "rb" );
         if(fileAsm == NULL) {
             perror(_environment->asmFileName);
@@ -2100,6 +2103,8 @@ void target_finalize( Environment * _environment ) {
                 continue;
             }
 
+            hotspot_instruction( _environment, _environment->currentSourceLineAnalyzed, bufferAsm->str, leftPadding == 0 );
+
             *bufferListing->str = 0;
             pos = ftell( fileListing );
             posUpdated = 0;
@@ -2186,6 +2191,8 @@ void target_finalize( Environment * _environment ) {
             adiline1( "AF:0:%d", _environment->bytesProduced );
         }
 
+        hotspot_end( _environment );
+
         (void)fclose(fileListing);
         (void)fclose(fileAsm);
 
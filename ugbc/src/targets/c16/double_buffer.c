@@ -46,7 +46,24 @@
  */
 /* <usermanual>
 @keyword DOUBLE BUFFER
+
+@target c16
 </usermanual> */
 void double_buffer( Environment * _environment, int _enabled ) {
 
+    deploy( vbl, src_hw_ted_vbl_asm );
+    deploy( doubleBuffer, src_hw_ted_double_buffer_asm );
+
+    if ( _environment->doubleBufferEnabled != _enabled ) {
+
+        _environment->doubleBufferEnabled = _enabled;
+
+        if ( _enabled ) {
+            outline0("JSR DOUBLEBUFFERINIT");
+        } else {
+            outline0("JSR DOUBLEBUFFERCLEANUP");
+        }
+
+    };
+
 }
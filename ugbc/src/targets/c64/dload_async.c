@@ -0,0 +1,133 @@
+/*****************************************************************************
+ * ugBASIC - an isomorphic BASIC language compiler for retrocomputers        *
+ *****************************************************************************
+ * Copyright 2021-2025 Marco Spedaletti (asimov@mclink.it)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *----------------------------------------------------------------------------
+ * Concesso in licenza secondo i termini della Licenza Apache, versione 2.0
+ * (la "Licenza"); è proibito usare questo file se non in conformità alla
+ * Licenza. Una copia della Licenza è disponibile all'indirizzo:
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Se non richiesto dalla legislazione vigente o concordato per iscritto,
+ * il software distribuito nei termini della Licenza è distribuito
+ * "COSÌ COM'È", SENZA GARANZIE O CONDIZIONI DI ALCUN TIPO, esplicite o
+ * implicite. Consultare la Licenza per il testo specifico che regola le
+ * autorizzazioni e le limitazioni previste dalla medesima.
+ ****************************************************************************/
+
+/****************************************************************************
+ * INCLUDE SECTION 
+ ****************************************************************************/
+
+#include "../../ugbc.h"
+
+/****************************************************************************
+ * CODE SECTION 
+ ****************************************************************************/
+
+/**
+ * @brief Emit code for <strong>DLOAD ASYNC ...</strong>
+ * 
+ * Start loading a file in background: the file is received by the
+ * built-in fast loader, a few bytes at a time, during the timer
+ * interrupt. If the fast loader is not available (i.e. the drive
+ * is not a 1541 or compatible), the file is loaded at once.
+ * 
+ * @param _environment Current calling environment
+ * @param _filename Filename to read
+ * @param _address Address where to load the file (NULL = the one on file)
+ */
+/* <usermanual>
+@keyword DLOAD ASYNC
+
+@english
+Start loading a file from disk in background, using the built-in
+fast loader. The program continues to run while the file is being
+transferred, so it is possible to prefetch the next level while
+playing the current one. Use ''DLOAD READY'' to know when the file
+has been completely loaded, and ''DLOAD ERROR'' to check if it has
+been found. Another ''DLOAD'' or ''DSAVE'' waits for the end of the
+pending transfer. Only one device must be connected to the serial
+bus, and if the drive is not compatible the file is loaded at once.
+
+@italian
+Avvia il caricamento di un file da disco in background, usando il
+fast loader integrato. Il programma continua ad essere eseguito
+mentre il file viene trasferito, e quindi è possibile precaricare
+il livello successivo mentre si gioca quello corrente. Usare
+''DLOAD READY'' per sapere quando il file è stato caricato, e
+''DLOAD ERROR'' per controllare se è stato trovato. Un altro ''DLOAD''
+o ''DSAVE'' attende la fine del trasferimento in corso. Sul bus 
+seriale deve essere collegato un solo dispositivo, e se il drive non
+è compatibile il file viene caricato immediatamente.
+
+@syntax DLOAD ASYNC filename [TO address]
+
+@example DLOAD ASYNC "LEVEL2" TO $8000
+@example WHILE NOT DLOAD READY: ... : WEND
+
+@target c64
+</usermanual> */
+void dload_async( Environment * _environment, char * _filename, char * _address ) {
+
+    if ( _environment->emptyProcedure ) {
+        return;
+    }
+    
+    if ( _environment->tenLinerRulesEnforced ) {
+        CRITICAL_10_LINE_RULES_ENFORCED( "DLOAD");
+    }
+
+    if ( _environment->sandbox ) {
+        CRITICAL_SANDBOX_ENFORCED( "DLOAD");
+    }
+
+    c64_dload_async( _environment, _filename, _address );
+
+}
+
+/**
+ * @brief Emit code for <strong>DLOAD READY</strong>
+ * 
+ * @param _environment Current calling environment
+ * @return TRUE if there is no pending DLOAD ASYNC
+ */
+/* <usermanual>
+@keyword DLOAD READY
+
+@english
+Returns ''TRUE'' if there is no file being loaded in background
+(see ''DLOAD ASYNC''), ''FALSE'' otherwise.
+
+@italian
+Restituisce ''TRUE'' se non ci sono file in caricamento in background
+(vedi ''DLOAD ASYNC''), ''FALSE'' altrimenti.
+
+@syntax = DLOAD READY
+
+@example IF DLOAD READY THEN: GOSUB nextLevel: ENDIF
+
+@target c64
+</usermanual> */
+Variable * dload_ready( Environment * _environment ) {
+
+    Variable * result = variable_temporary( _environment, VT_SBYTE, "(dload ready)" );
+
+    c64_dload_ready( _environment, result->realName );
+
+    return result;
+
+}
@@ -123,6 +123,9 @@ void generate_d64( Environment * _environment ) {
         char * storageFileName = generate_storage_filename( _environment, exeFileName, "d64", diskNumber );
 
         handle = d64_create( CBMDOS );
+        if ( _environment->diskInterleave ) {
+            d64_set_interleave( handle, _environment->diskInterleave );
+        }
         d64_write_file( handle, "MAIN", FT_PRG, prgContent, prgSize );
         Bank * bank = _environment->expansionBanks;
         while( bank ) {
@@ -143,6 +146,9 @@ void generate_d64( Environment * _environment ) {
                     ++diskNumber;
                     storageFileName = generate_storage_filename( _environment, exeFileName, "d64", diskNumber );
                     handle = d64_create( CBMDOS );
+                    if ( _environment->diskInterleave ) {
+                        d64_set_interleave( handle, _environment->diskInterleave );
+                    }
                 } else {
                     bank = bank->next;
                 }
@@ -183,6 +189,9 @@ void generate_d64( Environment * _environment ) {
         int i=0;
         while( storage ) {
             handle = d64_create( CBMDOS );
+            if ( _environment->diskInterleave ) {
+                d64_set_interleave( handle, _environment->diskInterleave );
+            }
             if ( i == 0 ) {
                 d64_write_file( handle, "MAIN", FT_PRG, prgContent, prgSize );
             }
@@ -246,6 +255,9 @@ void generate_d64( Environment * _environment ) {
         Bank * bank = _environment->expansionBanks;
         if ( bank && ! handle ) {
             handle = d64_create( CBMDOS );
+            if ( _environment->diskInterleave ) {
+                d64_set_interleave( handle, _environment->diskInterleave );
+            }
         }
         while( bank ) {
             int bankSize = bank->space - bank->remains;
@@ -258,6 +270,9 @@ void generate_d64( Environment * _environment ) {
                 ++diskNumber;
                 storageFileName = generate_storage_filename( _environment, filemask, "d64", diskNumber );
                 handle = d64_create( CBMDOS );
+                if ( _environment->diskInterleave ) {
+                    d64_set_interleave( handle, _environment->diskInterleave );
+                }
             }
             if ( bank->remains < bank->space ) {
                 char bankFileName[MAX_TEMPORARY_STORAGE];
@@ -307,6 +322,9 @@ void generate_reu( Environment * _environment ) {
         }
         fseek( reuHandle, 0, SEEK_SET );
         handle = d64_create( CBMDOS );
+        if ( _environment->diskInterleave ) {
+            d64_set_interleave( handle, _environment->diskInterleave );
+        }
         d64_write_file( handle, "MAIN", FT_PRG, prgContent, prgSize );
         Bank * bank = _environment->expansionBanks;
         while( bank ) {
@@ -352,6 +370,9 @@ void generate_reu( Environment * _environment ) {
         int i=0;
         while( storage ) {
             handle = d64_create( CBMDOS );
+            if ( _environment->diskInterleave ) {
+                d64_set_interleave( handle, _environment->diskInterleave );
+            }
             if ( i == 0 ) {
                 d64_write_file( handle, "MAIN", FT_PRG, prgContent, prgSize );
             }
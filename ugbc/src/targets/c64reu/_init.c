@@ -153,6 +153,7 @@ void target_initialization( Environment * _environment ) {
     setup_text_variables( _environment );
 
     deploy_preferred( startup, src_hw_c64reu_startup_asm);
+    deploy_preferred( reu, src_hw_c64reu_reu_asm);
     cpu_call( _environment, "C64REUSTARTUP" );
 
     vic2_initialization( _environment );
@@ -160,6 +160,15 @@ static void variable_cleanup_entry( Environment * _environment, Variable * _firs
                         outhead1("%s: .res 16,0", variable->realName);
                     }
                     break;
+                case VT_BCD4:
+                case VT_BCD6:
+                case VT_BCD8:
+                    if ( variable->memoryArea ) {
+                        // outhead2("%s = $%4.4x", variable->realName, variable->absoluteAddress);
+                    } else {
+                        outhead2("%s: .res %d,0", variable->realName, VT_BCD_BYTES( variable->type ) );
+                    }
+                    break;
                 case VT_VECTOR2:
                     if ( variable->memoryArea ) {
                         // outhead2("%s = $%4.4x", variable->realName, variable->absoluteAddress);
@@ -402,6 +411,12 @@ static void variable_cleanup_memory_mapped( Environment * _environment, Variable
             outhead1("%s:", _variable->realName );
             outline0(" .res 16, 0" );
             break;
+        case VT_BCD4:
+        case VT_BCD6:
+        case VT_BCD8:
+            outhead1("%s:", _variable->realName );
+            outline1(" .res %d, 0", VT_BCD_BYTES( _variable->type ) );
+            break;
         case VT_VECTOR2:
             outhead1("%s:", _variable->realName );
             outline0(" .res 4, 0" );
@@ -837,6 +852,7 @@ void variable_cleanup( Environment * _environment ) {
     }
     deploy_inplace_preferred( vars, src_hw_c64reu_vars_asm);
     deploy_inplace_preferred( startup, src_hw_c64reu_startup_asm);
+    deploy_inplace_preferred( reu, src_hw_c64reu_reu_asm);
     deploy_inplace_preferred( vic2vars, src_hw_vic2_vars_asm );
     deploy_inplace_preferred( vic2startup, src_hw_vic2_startup_asm);
     deploy_inplace_preferred( vScrollTextDown, src_hw_vic2_vscroll_text_down_asm )
@@ -56,6 +56,11 @@
 
 void sound( Environment * _environment, int _freq, int _delay, int _channels ) {
 
+    if ( _delay && _environment->audioConfig.async ) {
+        sid_queue_sound( _environment, _channels, _freq, _delay / 20, _environment->audioConfig.priority + 1, IMF_INSTRUMENT_REED_ORGAN );
+        return;
+    }
+
     sid_start( _environment, _channels );
     sid_set_program( _environment, _channels, IMF_INSTRUMENT_REED_ORGAN );
     sid_set_frequency( _environment, _channels, _freq );
@@ -80,6 +85,19 @@ void sound( Environment * _environment, int _freq, int _delay, int _channels ) {
 void sound_vars( Environment * _environment, char * _freq, char * _delay, char * _channels ) {
 
     Variable * freq = variable_retrieve_or_define( _environment, _freq, VT_WORD, 440 );
+
+    if ( _delay && _environment->audioConfig.async ) {
+        Variable * delay = variable_retrieve_or_define( _environment, _delay, VT_WORD, 0 );
+        Variable * durationInTicks = variable_cast( _environment, variable_div_const( _environment, delay->name, 20, NULL )->name, VT_WORD );
+        if ( _channels ) {
+            Variable * channels = variable_retrieve_or_define( _environment, _channels, VT_WORD, 0x07 );
+            sid_queue_sound_vars( _environment, channels->realName, freq->realName, durationInTicks->realName, _environment->audioConfig.priority + 1, IMF_INSTRUMENT_REED_ORGAN );
+        } else {
+            sid_queue_sound_vars( _environment, NULL, freq->realName, durationInTicks->realName, _environment->audioConfig.priority + 1, IMF_INSTRUMENT_REED_ORGAN );
+        }
+        return;
+    }
+
     if ( _channels ) {
         Variable * channels = variable_retrieve_or_define( _environment, _channels, VT_WORD, 0x07 );
         sid_start_var( _environment, channels->realName );
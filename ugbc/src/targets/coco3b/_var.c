@@ -260,6 +260,15 @@ static void variable_cleanup_entry_byte( Environment * _environment, Variable *
                         outhead1("%s rzb 16", variable->realName);
                     }   
                     break;
+                case VT_BCD4:
+                case VT_BCD6:
+                case VT_BCD8:
+                    if ( variable->memoryArea ) {
+                        outhead2("%s equ $%4.4x", variable->realName, variable->absoluteAddress);
+                    } else {
+                        outhead2("%s rzb %d", variable->realName, VT_BCD_BYTES( variable->type ) );
+                    }   
+                    break;
                 case VT_VECTOR2:
                     if ( variable->memoryArea ) {
                         outhead2("%s equ $%4.4x", variable->realName, variable->absoluteAddress);
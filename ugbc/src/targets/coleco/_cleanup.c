@@ -40,6 +40,17 @@
 
 void target_prepare_finalization( Environment * _environment ) {
 
+    if ( _environment->screenCache ) {
+        variable_import( _environment, "VDPSHADOW", VT_BUFFER, 768 );
+        variable_global( _environment, "VDPSHADOW" );
+        variable_import( _environment, "VDPSHADOWDIRTY", VT_BUFFER, 48 );
+        variable_global( _environment, "VDPSHADOWDIRTY" );
+        variable_import( _environment, "VDPSHADOWVALID", VT_BYTE, 0 );
+        variable_global( _environment, "VDPSHADOWVALID" );
+        variable_import( _environment, "VDPSHADOWPENDING", VT_BYTE, 0 );
+        variable_global( _environment, "VDPSHADOWPENDING" );
+    }
+
     if ( _environment->deployed.timer ) {
         variable_import( _environment, "TIMERRUNNING", VT_BYTE, 0 );
         variable_global( _environment, "TIMERRUNNING" );
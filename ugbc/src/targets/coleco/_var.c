@@ -89,6 +89,17 @@ static void variable_cleanup_entry( Environment * _environment, Variable * _firs
                         outhead0("section code_user");
                     }
                     break;
+                case VT_BCD4:
+                case VT_BCD6:
+                case VT_BCD8:
+                    if ( variable->memoryArea ) {
+                        outline2("%s: EQU $%4.4x", variable->realName, variable->absoluteAddress);
+                    } else {
+                        outhead0("section data_user");
+                        outline2("%s: defs %d", variable->realName, VT_BCD_BYTES( variable->type ) );
+                        outhead0("section code_user");
+                    }
+                    break;
                 case VT_VECTOR2:
                     if ( variable->memoryArea ) {
                         outline2("%s: EQU $%4.4x", variable->realName, variable->absoluteAddress);
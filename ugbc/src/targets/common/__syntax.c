@@ -4438,6 +4438,34 @@ degli angoli nelle funzioni trigonometriche, impostandola a radianti
 
 </usermanual> */
 
+/* <usermanual>
+@keyword BINARY RADIAN
+
+@english
+
+This command allows you to select the angle mode with 
+trigonometric functions, setting it to binary radians: a full turn
+is made by 256 steps, so an angle is a byte (0...255). In this mode
+''SIN'' and ''COS'' are read from a table, and they return an 
+integer with the value multiplied by 256. This is much faster than
+using floating point numbers.
+
+@italian
+
+Questo comando permette di selezionare la modalità 
+degli angoli nelle funzioni trigonometriche, impostandola a radianti
+binari: un giro completo è fatto da 256 passi, quindi un angolo è un
+byte (0...255). In questa modalità ''SIN'' e ''COS'' sono letti da
+una tabella, e restituiscono un intero con il valore moltiplicato
+per 256. Questo è molto più veloce che usare numeri in virgola mobile.
+
+@syntax BINARY RADIAN
+
+@example BINARY RADIAN
+@example x = ( COS(a) * 10 ) / 256
+
+</usermanual> */
+
 /* <usermanual>
 @keyword DELETE (constant)
 
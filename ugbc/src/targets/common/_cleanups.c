@@ -33,6 +33,7 @@
  ****************************************************************************/
 
 #include "../../ugbc.h"
+#include <ctype.h>
 
 /****************************************************************************
  * CODE SECTION 
@@ -55,6 +56,97 @@ void gameloop_cleanup( Environment * _environment ) {
     
 }
 
+/**
+ * @brief Emit the runtime library
+ * 
+ * This function emits, once and after the program, all the runtime modules
+ * that have been deployed during the compilation. On the targets that use
+ * a linker configuration (ca65/ld65: c64, c64reu, c128, plus4, c16, vic20,
+ * atari and atarixl), they are placed into a separate LIB segment.
+ * 
+ * The other targets have no linker configuration where a separate section
+ * could be placed, so the library simply follows the program:
+ * 
+ *  - 6809 targets (coco, coco3, dragon, mo5, to8, pc128op): asm6809
+ *    assembles a single absolute image, starting from the ORG, without
+ *    any link step;
+ *  - Z80 and SM83 targets (msx1, zx, cpc, coleco, sg1000, sc3000, vg5000,
+ *    vz200, c128z, gb): z88dk-z80asm lays the sections out one after the
+ *    other, from a fixed origin, and msx1, coleco, sg1000, sc3000 and gb
+ *    glue exactly the code_user and data_user binaries; a new section
+ *    could only follow the program, and it would be dropped by the latter;
+ *  - pc1403: as61860 assembles into a single absolute area;
+ *  - pccga: nasm writes a flat binary, where the only section is the
+ *    program itself.
+ * 
+ * @param _environment Current calling environment
+ */
+void library_cleanup( Environment * _environment ) {
+
+    // the runtime does not belong to any source line
+    outline0("; L:0");
+
+    if ( _environment->libraryOutput ) {
+#if defined(__c64__) || defined(__c64reu__) || defined(__c128__) || defined(__plus4__) || defined(__c16__) || \
+    defined(__vic20__) || defined(__atari__) || defined(__atarixl__)
+        outhead0(".segment \"LIB\"");
+#endif
+        buffered_library_output( _environment );
+#if defined(__c64__) || defined(__c64reu__) || defined(__c128__) || defined(__plus4__) || defined(__c16__) || \
+    defined(__vic20__) || defined(__atari__) || defined(__atarixl__)
+        outhead0(".segment \"CODE\"");
+#endif
+    } else {
+        buffered_library_output( _environment );
+    }
+
+}
+
+/**
+ * @brief Emit the procedures expanded inline that are still referenced
+ * 
+ * The out-of-line copy of a procedure expanded inline is emitted only if
+ * something still refers to it (a call that has not been expanded, SPAWN, 
+ * EVERY ... CALL, and so on). Since an emitted copy can refer to other
+ * procedures, the search is repeated until nothing else is emitted.
+ * 
+ * @param _environment Current calling environment
+ */
+void procedure_cleanup( Environment * _environment ) {
+
+    int emitted;
+
+    do {
+        emitted = 0;
+        Procedure * procedure = _environment->procedures;
+        while( procedure ) {
+            if ( procedure->outOfLine ) {
+                int length = strlen( procedure->realName );
+                int referenced = 0;
+                for( int level=0; level<=_environment->currentBufferOutput && !referenced; ++level ) {
+                    char * output = _environment->bufferOutput[level];
+                    int size = _environment->bufferOutputSize[level];
+                    for( int i=0; i+length<=size && !referenced; ++i ) {
+                        if ( output[i] == procedure->realName[0] && !memcmp( output + i, procedure->realName, length ) &&
+                             ( i == 0 || !( isalnum( (unsigned char)output[i-1] ) || output[i-1] == '_' ) ) &&
+                             ( i+length == size || !( isalnum( (unsigned char)output[i+length] ) || output[i+length] == '_' ) ) ) {
+                            referenced = 1;
+                        }
+                    }
+                }
+                if ( referenced ) {
+                    buffered_fputs( _environment, procedure->outOfLine, _environment->asmFile );
+                    free( procedure->outOfLine );
+                    procedure->outOfLine = NULL;
+                    emitted = 1;
+                }
+            }
+            procedure = procedure->next;
+        }
+    } while( emitted );
+
+}
+
 void end_compilation( Environment * _environment ) {
 
     gameloop_cleanup( _environment );
@@ -124,8 +216,12 @@ void end_compilation( Environment * _environment ) {
         }
     }
     
+    procedure_cleanup( _environment );
+
     finalize_text_variables( _environment );
 
+    library_cleanup( _environment );
+
     int j=0;
     for( j=0; j<MAX_TEMPORARY_STORAGE; ++j ) {
         if ( _environment->deferredEmbedded[j] ) {
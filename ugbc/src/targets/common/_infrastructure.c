@@ -102,7 +102,10 @@ char DATATYPE_AS_STRING[][16] = {
     "PATH",
     "VECTOR",
     "TYPE",
-    "NUMBER"
+    "NUMBER",
+    "BCD4",
+    "BCD6",
+    "BCD8"
 };
 
 char OUTPUT_FILE_TYPE_AS_STRING[][16] = {
@@ -338,6 +341,8 @@ static int calculate_cast_type_best_fit( Environment * _environment, int _type1,
         return VT_FLOAT;
     } else if ( _type1 == VT_NUMBER || _type2 == VT_NUMBER ) {
         return VT_NUMBER;
+    } else if ( VT_BCD( _type1 ) || VT_BCD( _type2 ) ) {
+        return ( VT_BCD_BYTES( _type1 ) > VT_BCD_BYTES( _type2 ) ) ? _type1 : _type2;
     } else {
         if ( VT_SIGNED( _type1 ) != VT_SIGNED( _type2 ) ) {
             int bits1 = VT_BITWIDTH( _type1 ) + VT_SIGNED( _type1 );
@@ -1045,6 +1050,8 @@ Variable * variable_retrieve_or_define( Environment * _environment, char * _name
  * @param _environment Current calling environment
  */
 void variable_reset( Environment * _environment ) {
+    variable_array_walk_sync( _environment );
+    value_record_reset( _environment );
     if ( _environment->procedureName ) {
         variable_reset_pool( _environment, _environment->tempVariables[_environment->currentProcedure] );
     } else {
@@ -1119,6 +1126,53 @@ Variable * variable_array_type( Environment * _environment, char *_name, Variabl
     
 }
 
+/**
+ * @brief Describe the offset of an element in a multidimensional array
+ *
+ * The offset of an element is worth to be reused only if it needs a
+ * multiplication, that is if an index other than the first one is not 
+ * a constant.
+ *
+ * @param _environment Current calling environment
+ * @param _array Array
+ * @param _signature Description of the offset (at least MAX_TEMPORARY_STORAGE bytes)
+ * @return int 1 if the offset can be reused, 0 otherwise
+ */
+static int calculate_offset_in_array_signature( Environment * _environment, Variable * _array, char * _signature ) {
+
+    int indexes = _environment->arrayIndexes[_environment->arrayNestedIndex];
+
+    if ( indexes < 2 ) {
+        return 0;
+    }
+
+    int multiplied = 0;
+    int i;
+    char index[MAX_TEMPORARY_STORAGE];
+
+    sprintf( _signature, "%s[", _array->realName );
+    for( i=0; i<indexes; ++i ) {
+        if ( _environment->arrayIndexesEach[_environment->arrayNestedIndex][i] == NULL ) {
+            sprintf( index, "#%d", _environment->arrayIndexesDirectEach[_environment->arrayNestedIndex][i] );
+        } else {
+            if ( ! value_record_signature( _environment, variable_retrieve( _environment, _environment->arrayIndexesEach[_environment->arrayNestedIndex][i] ), index ) ) {
+                return 0;
+            }
+            if ( i ) {
+                multiplied = 1;
+            }
+        }
+        if ( ( strlen( _signature ) + strlen( index ) + 2 ) >= MAX_TEMPORARY_STORAGE ) {
+            return 0;
+        }
+        strcat( _signature, index );
+        strcat( _signature, i < ( indexes - 1 ) ? "," : "]" );
+    }
+
+    return multiplied;
+
+}
+
 // @bit2: ok
 static Variable * calculate_offset_in_array( Environment * _environment, char * _array ) {
 
@@ -1128,8 +1182,33 @@ static Variable * calculate_offset_in_array( Environment * _environment, char *
         CRITICAL_ARRAY_SIZE_MISMATCH( _array, array->arrayDimensions, _environment->arrayIndexes[_environment->arrayNestedIndex] );
     }
 
+    // If the statement has already calculated the same offset, take a copy 
+    // of it: the code of the indexes can be removed, if it is the last one.
+
+    char signature[MAX_TEMPORARY_STORAGE];
+    int reusable = calculate_offset_in_array_signature( _environment, array, signature );
+
+    if ( reusable ) {
+        Variable * product = NULL;
+        Variable * calculated = value_record_find( _environment, signature, &product );
+        if ( calculated ) {
+            int i;
+            for( i=_environment->arrayIndexes[_environment->arrayNestedIndex]-1; i>=0; --i ) {
+                if ( _environment->arrayIndexesEach[_environment->arrayNestedIndex][i] ) {
+                    if ( ! value_record_drop( _environment, variable_retrieve( _environment, _environment->arrayIndexesEach[_environment->arrayNestedIndex][i] ) ) ) {
+                        break;
+                    }
+                }
+            }
+            Variable * offset = variable_temporary( _environment, VT_WORD, "(offset in array)");
+            cpu_math_add_16bit( _environment, calculated->realName, product->realName, offset->realName );
+            return offset;
+        }
+    }
+
     Variable * base = variable_temporary( _environment, VT_WORD, "(base in array)");
     Variable * offset = variable_temporary( _environment, VT_WORD, "(offset in array)");
+    Variable * product = NULL;
 
     variable_store( _environment, offset->name, 0 );
 
@@ -1169,7 +1248,14 @@ static Variable * calculate_offset_in_array( Environment * _environment, char *
                 if(baseValue!=1) {
                     variable_store( _environment, base->name, baseValue );
                     Variable * additionalOffset = variable_mul( _environment, index->name, base->name );
-                    variable_add_inplace_vars( _environment, offset->name, additionalOffset->name );
+                    if ( reusable ) {
+                        if ( product ) {
+                            variable_add_inplace_vars( _environment, offset->name, product->name );
+                        }
+                        product = variable_cast( _environment, additionalOffset->name, offset->type );
+                    } else {
+                        variable_add_inplace_vars( _environment, offset->name, additionalOffset->name );
+                    }
                 } else {
                     variable_add_inplace_vars( _environment, offset->name, index->name );
                 }
@@ -1177,6 +1263,16 @@ static Variable * calculate_offset_in_array( Environment * _environment, char *
         }
     }
 
+    // The callers change the offset in place: so the last product is added
+    // into another variable (the base, that is no longer needed), and the
+    // partial offset and the product are kept, to be added again on reuse.
+
+    if ( product ) {
+        cpu_math_add_16bit( _environment, offset->realName, product->realName, base->realName );
+        value_record_store( _environment, signature, offset, product );
+        return base;
+    }
+
     return offset;
 
 }
@@ -1372,6 +1468,8 @@ Variable * variable_temporary( Environment * _environment, VariableType _type, c
             sprintf(name, "Tflt%d", UNIQUE_ID);
         } else if ( _type == VT_NUMBER ) {
             sprintf(name, "Tnum%d", UNIQUE_ID);
+        } else if ( VT_BCD( _type ) ) {
+            sprintf(name, "Tbcd%d", UNIQUE_ID);
         } else if ( _type == VT_BIT ) {
             sprintf(name, "Tbit%d", UNIQUE_ID);
         } else {
@@ -1640,6 +1738,11 @@ Variable * variable_store( Environment * _environment, char * _destination, unsi
     
     Variable * destination = variable_retrieve( _environment, _destination );
 
+    if ( ! destination->temporary ) {
+        value_record_reset( _environment );
+        variable_array_walk_written( _environment, _destination );
+    }
+
     destination->value = _value;
 
     switch( VT_BITWIDTH( destination->type ) ) {
@@ -1716,6 +1819,13 @@ Variable * variable_store( Environment * _environment, char * _destination, unsi
                 // value[6] = (unsigned char)((_value>>48) & 0xff );
                 // value[7] = (unsigned char)((_value>>56) & 0xff );
                 cpu_store_nbit( _environment, destination->realName, _environment->numberConfig.maxBytes << 3, value );
+            } else if ( VT_BCD( destination->type ) ) {
+                unsigned int value = _value;
+                for( int i=VT_BCD_BYTES( destination->type )-1; i>=0; --i ) {
+                    char offsetAsString[MAX_TEMPORARY_STORAGE]; sprintf( offsetAsString, "%d", i );
+                    cpu_store_8bit( _environment, address_displacement( _environment, destination->realName, offsetAsString ), ( value % 10 ) | ( ( ( value / 10 ) % 10 ) << 4 ) );
+                    value /= 100;
+                }
             } else {
                 CRITICAL_STORE_UNSUPPORTED(DATATYPE_AS_STRING[destination->type]);
             }
@@ -1771,6 +1881,46 @@ Variable * variable_by_constant( Environment * _environment, VariableType _type,
     return result;
 }
 
+/* value of a constant as it is held by a variable of type _type */
+static int variable_constant_normalize( VariableType _type, int _value ) {
+    switch( VT_BITWIDTH( _type ) ) {
+        case 8:
+            return VT_UNSIGN_8BIT( _type, ( _value & 0xff ) );
+        case 16:
+            return VT_UNSIGN_16BIT( _type, ( _value & 0xffff ) );
+        default:
+            return _value;
+    }
+}
+
+/* both operands are integer constants, so the operation can be folded */
+static int variable_constant_operands( Variable * _source, Variable * _target ) {
+    return _source->initializedByConstant && _target->initializedByConstant &&
+        VT_BITWIDTH( _source->type ) >= 8 && VT_BITWIDTH( _target->type ) >= 8;
+}
+
+/* integer type of the given width and sign */
+static VariableType variable_constant_type( VariableType _type, int _signed ) {
+    switch( VT_BITWIDTH( _type ) ) {
+        case 32:
+            return _signed ? VT_SDWORD : VT_DWORD;
+        case 16:
+            return _signed ? VT_SWORD : VT_WORD;
+        default:
+            return _signed ? VT_SBYTE : VT_BYTE;
+    }
+}
+
+/* temporary holding the result of a folded operation */
+static Variable * variable_constant_result( Environment * _environment, VariableType _type, int _value, char * _meaning ) {
+    Variable * result = variable_temporary( _environment, _type, _meaning );
+    int value = variable_constant_normalize( _type, _value );
+    variable_store( _environment, result->name, value );
+    result->value = value;
+    result->initializedByConstant = 1;
+    return result;
+}
+
 #define UNESCAPE_COLOR( c, d ) \
             else if ( strcmp_nocase( word, c ) == 0 ) { \
                             int c2 = COLOR_##d;\
@@ -2989,6 +3139,180 @@ static void variable_move_number_1bit( Environment * _environment, Variable * _s
 
 }
 
+/**
+ * @brief (internal) routine to move a packed BCD into another packed BCD
+ * 
+ * Values are aligned to the least significant digits: the missing ones
+ * are filled with zeros, the exceeding ones are dropped.
+ * 
+ * @param _environment Environment for execution
+ * @param _source Variable with source of data (BCD)
+ * @param _target Variable with target of data (BCD)
+ */
+static void variable_move_bcd_bcd( Environment * _environment, Variable * _source, Variable * _target ) {
+
+    int sourceBytes = VT_BCD_BYTES( _source->type );
+    int targetBytes = VT_BCD_BYTES( _target->type );
+
+    if ( sourceBytes == targetBytes ) {
+        cpu_mem_move_direct_size( _environment, _source->realName, _target->realName, targetBytes );
+    } else if ( sourceBytes < targetBytes ) {
+        char offsetAsString[MAX_TEMPORARY_STORAGE]; sprintf( offsetAsString, "%d", targetBytes - sourceBytes );
+        cpu_fill_direct_size_value( _environment, _target->realName, targetBytes - sourceBytes, 0 );
+        cpu_mem_move_direct_size( _environment, _source->realName, address_displacement( _environment, _target->realName, offsetAsString ), sourceBytes );
+    } else {
+        char offsetAsString[MAX_TEMPORARY_STORAGE]; sprintf( offsetAsString, "%d", sourceBytes - targetBytes );
+        cpu_mem_move_direct_size( _environment, address_displacement( _environment, _source->realName, offsetAsString ), _target->realName, targetBytes );
+    }
+
+}
+
+/**
+ * @brief (internal) routine to move a packed BCD into an integer
+ * 
+ * The value is rebuilt digit by digit, from the most significant one, 
+ * as value = value * 10 + digit. 
+ * 
+ * @param _environment Environment for execution
+ * @param _source Variable with source of data (BCD)
+ * @param _target Variable with target of data (8, 16 or 32 bit)
+ */
+static void variable_move_bcd_integer( Environment * _environment, Variable * _source, Variable * _target ) {
+
+    Variable * value = variable_temporary( _environment, VT_DWORD, "(value of BCD)" );
+    Variable * times = variable_temporary( _environment, VT_DWORD, "(value of BCD)" );
+    Variable * digit = variable_temporary( _environment, VT_BYTE, "(digit of BCD)" );
+    Variable * digitValue = variable_temporary( _environment, VT_DWORD, "(digit of BCD)" );
+
+    for( int i=0; i<VT_BCD_BYTES( _source->type ); ++i ) {
+        char offsetAsString[MAX_TEMPORARY_STORAGE]; sprintf( offsetAsString, "%d", i );
+        for( int high=1; high>=0; --high ) {
+            cpu_move_8bit( _environment, address_displacement( _environment, _source->realName, offsetAsString ), digit->realName );
+            if ( high ) {
+                cpu_math_div2_const_8bit( _environment, digit->realName, 4, 0, NULL );
+            } else {
+                cpu_math_and_const_8bit( _environment, digit->realName, 0x0f );
+            }
+            if ( i == 0 && high ) {
+                variable_move( _environment, digit->name, value->name );
+            } else {
+                // value * 10 = value * 2 + value * 8
+                cpu_math_mul2_const_32bit( _environment, value->realName, 1, 0 );
+                cpu_move_32bit( _environment, value->realName, times->realName );
+                cpu_math_mul2_const_32bit( _environment, times->realName, 2, 0 );
+                cpu_math_add_32bit( _environment, value->realName, times->realName, value->realName );
+                variable_move( _environment, digit->name, digitValue->name );
+                cpu_math_add_32bit( _environment, value->realName, digitValue->realName, value->realName );
+            }
+        }
+    }
+
+    variable_move( _environment, value->name, _target->name );
+
+}
+
+/**
+ * @brief (internal) routine to move an integer into a packed BCD
+ * 
+ * Bits are shifted in from the most significant one, doubling the BCD
+ * value each time with a decimal addition ("double dabble").
+ * 
+ * @param _environment Environment for execution
+ * @param _source Variable with source of data (8, 16 or 32 bit)
+ * @param _target Variable with target of data (BCD)
+ */
+static void variable_move_integer_bcd( Environment * _environment, Variable * _source, Variable * _target ) {
+
+    MAKE_LABEL
+
+    int bits = VT_BITWIDTH( _source->type );
+    int bytes = VT_BCD_BYTES( _target->type );
+
+    Variable * value = variable_temporary( _environment, VT_UNSIGN( _source->type ), "(value for BCD)" );
+    Variable * counter = variable_temporary( _environment, VT_BYTE, "(counter for BCD)" );
+    Variable * bit = variable_temporary( _environment, VT_BYTE, "(bit for BCD)" );
+    Variable * one = variable_temporary( _environment, _target->type, "(one in BCD)" );
+
+    char skipLabel[MAX_TEMPORARY_STORAGE]; sprintf( skipLabel, "%sskip", label );
+
+    cpu_mem_move_direct_size( _environment, _source->realName, value->realName, bits >> 3 );
+    cpu_store_8bit( _environment, counter->realName, bits );
+    cpu_fill_direct_size_value( _environment, _target->realName, bytes, 0 );
+    variable_store( _environment, one->name, 1 );
+
+    cpu_label( _environment, label );
+    cpu_bcd_add( _environment, _target->realName, _target->realName, _target->realName, bytes );
+    cpu_bit_check( _environment, value->realName, bits - 1, bit->realName, bits );
+    cpu_compare_and_branch_8bit_const( _environment, bit->realName, 0, skipLabel, 1 );
+    cpu_bcd_add( _environment, _target->realName, one->realName, _target->realName, bytes );
+    cpu_label( _environment, skipLabel );
+    switch( bits ) {
+        case 32:
+            cpu_math_mul2_const_32bit( _environment, value->realName, 1, 0 );
+            break;
+        case 16:
+            cpu_math_mul2_const_16bit( _environment, value->realName, 1, 0 );
+            break;
+        case 8:
+            cpu_math_mul2_const_8bit( _environment, value->realName, 1, 0 );
+            break;
+    }
+    cpu_dec( _environment, counter->realName );
+    cpu_compare_and_branch_8bit_const( _environment, counter->realName, 0, label, 0 );
+
+}
+
+/**
+ * @brief (internal) routine to move from or to a packed BCD
+ * 
+ * @param _environment Environment for execution
+ * @param _source Variable with source of data
+ * @param _target Variable with target of data
+ */
+static void variable_move_bcd( Environment * _environment, Variable * _source, Variable * _target ) {
+
+    if ( VT_BCD( _source->type ) && VT_BCD( _target->type ) ) {
+        variable_move_bcd_bcd( _environment, _source, _target );
+    } else if ( VT_BCD( _target->type ) ) {
+        if ( _source->initializedByConstant ) {
+            variable_store( _environment, _target->name, _source->value );
+        } else {
+            switch( VT_BITWIDTH( _source->type ) ) {
+                case 32:
+                case 16:
+                case 8:
+                    variable_move_integer_bcd( _environment, _source, _target );
+                    break;
+                case 0:
+                    if ( _source->type == VT_FLOAT || _source->type == VT_NUMBER ) {
+                        Variable * value = variable_temporary( _environment, VT_DWORD, "(value for BCD)" );
+                        variable_move( _environment, _source->name, value->name );
+                        variable_move_integer_bcd( _environment, value, _target );
+                        break;
+                    }
+                default:
+                    CRITICAL_CANNOT_CAST( DATATYPE_AS_STRING[_source->type], DATATYPE_AS_STRING[_target->type]);
+            }
+        }
+    } else {
+        switch( VT_BITWIDTH( _target->type ) ) {
+            case 32:
+            case 16:
+            case 8:
+                variable_move_bcd_integer( _environment, _source, _target );
+                break;
+            case 0:
+                if ( _target->type == VT_FLOAT || _target->type == VT_NUMBER ) {
+                    variable_move_bcd_integer( _environment, _source, _target );
+                    break;
+                }
+            default:
+                CRITICAL_CANNOT_CAST( DATATYPE_AS_STRING[_source->type], DATATYPE_AS_STRING[_target->type]);
+        }
+    }
+
+}
+
 /**
  * @brief Store the value of a variable inside another variable by converting it
  * 
@@ -3016,6 +3340,16 @@ Variable * variable_move( Environment * _environment, char * _source, char * _de
         CRITICAL_CANNOT_COPY_TO_BANKED(_destination);
     }
 
+    if ( ! target->temporary ) {
+        value_record_reset( _environment );
+        variable_array_walk_written( _environment, _destination );
+    }
+
+    if ( VT_BCD( source->type ) || VT_BCD( target->type ) ) {
+        variable_move_bcd( _environment, source, target );
+        return target;
+    }
+
     switch( VT_BITWIDTH( source->type ) ) {
 
         //////////////////////////////////////////////////////////////////////////////
@@ -3817,6 +4151,11 @@ Variable * variable_move_naked( Environment * _environment, char * _source, char
     Variable * source = variable_retrieve( _environment, _source );
     Variable * target = variable_retrieve( _environment, _destination );
 
+    if ( ! target->temporary ) {
+        value_record_reset( _environment );
+        variable_array_walk_written( _environment, _destination );
+    }
+
     if ( source->type != target->type ) {
         CRITICAL_DATATYPE_MISMATCH( DATATYPE_AS_STRING[source->type], DATATYPE_AS_STRING[target->type] );
     }
@@ -4060,6 +4399,12 @@ Variable * variable_add( Environment * _environment, char * _source, char * _des
         source = variable_cast( _environment, source->name, best );
         target = variable_cast( _environment, target->name, best );
 
+        if ( variable_constant_operands( source, target ) ) {
+            return variable_constant_result( _environment, 
+                variable_constant_type( source->type, VT_SIGNED( source->type ) || VT_SIGNED( target->type ) ), 
+                source->value + target->value, "(result of sum)" );
+        }
+
     }
 
     Variable * result;
@@ -4169,6 +4514,12 @@ Variable * variable_add( Environment * _environment, char * _source, char * _des
                     result = variable_temporary( _environment, VT_NUMBER, "(result of sum)" );
                     cpu_math_add_nbit( _environment, source->realName, target->realName, result->realName, _environment->numberConfig.maxBytes << 3 );
                     break;                            
+                case VT_BCD4:
+                case VT_BCD6:
+                case VT_BCD8:
+                    result = variable_temporary( _environment, source->type, "(result of sum)" );
+                    cpu_bcd_add( _environment, source->realName, target->realName, result->realName, VT_BCD_BYTES( source->type ) );
+                    break;
                 default: {
                     CRITICAL_ADD_UNSUPPORTED( _source, DATATYPE_AS_STRING[source->type]);
                 }
@@ -4180,6 +4531,8 @@ Variable * variable_add( Environment * _environment, char * _source, char * _des
 
 void variable_add_inplace( Environment * _environment, char * _source, int _destination ) {
 
+    variable_array_walk_written( _environment, _source );
+
     if ( _destination ) {
 
         Variable * source = variable_retrieve( _environment, _source );
@@ -4269,6 +4622,8 @@ void variable_add_inplace_type( Environment * _environment, char * _source, char
  */
 void variable_add_inplace_vars( Environment * _environment, char * _source, char * _destination ) {
 
+    variable_array_walk_written( _environment, _source );
+
     Variable * source = variable_retrieve( _environment, _source );
     if ( source->type == VT_STRING ) {
         source = variable_cast( _environment, _source, VT_DSTRING );
@@ -4429,6 +4784,8 @@ void variable_add_inplace_mt( Environment * _environment, char * _source, char *
 
 void variable_xor_inplace( Environment * _environment, char * _source, int _destination ) {
 
+    variable_array_walk_written( _environment, _source );
+
     if ( _destination ) {
 
         Variable * source = variable_retrieve( _environment, _source );
@@ -4468,6 +4825,8 @@ void variable_xor_inplace( Environment * _environment, char * _source, int _dest
  */
 void variable_xor_inplace_vars( Environment * _environment, char * _source, char * _destination ) {
 
+    variable_array_walk_written( _environment, _source );
+
     Variable * source = variable_retrieve( _environment, _source );
     Variable * target = variable_retrieve( _environment, _destination );
 
@@ -4584,6 +4943,11 @@ Variable * variable_sub( Environment * _environment, char * _source, char * _des
             int best = calculate_cast_type_best_fit( _environment, source->type, target->type );
             source = variable_cast( _environment, source->name, best );
             target = variable_cast( _environment, target->name, best );
+
+            if ( variable_constant_operands( source, target ) ) {
+                return variable_constant_result( _environment, VT_SIGN( best ), source->value - target->value, "(result of subtracting)" );
+            }
+
             result = variable_temporary( _environment, VT_SIGN( best ), "(result of subtracting)" );
         
         }
@@ -4621,6 +4985,11 @@ Variable * variable_sub( Environment * _environment, char * _source, char * _des
                     case VT_NUMBER:
                         cpu_math_sub_nbit( _environment, source->realName, target->realName, result->realName, _environment->numberConfig.maxBytes << 3 );
                         break;                            
+                    case VT_BCD4:
+                    case VT_BCD6:
+                    case VT_BCD8:
+                        cpu_bcd_sub( _environment, source->realName, target->realName, result->realName, VT_BCD_BYTES( source->type ) );
+                        break;
                     case VT_VECTOR2: {
                         switch( VT_BITWIDTH( target->type ) ) {
                             case 32:
@@ -4724,6 +5093,7 @@ Variable * variable_sub_const( Environment * _environment, char * _source, int _
  * @throw EXIT_FAILURE "Source variable does not exist"
  */
 void variable_sub_inplace( Environment * _environment, char * _source, char * _dest ) {
+    variable_array_walk_written( _environment, _source );
     Variable * source = variable_retrieve( _environment, _source );
     Variable * target;
     if ( source->type == VT_VECTOR2 ) {
@@ -4875,6 +5245,9 @@ larghezza di bit (in caso di tipo numerico) o dello stesso tipo (in caso di stri
 </usermanual> */
 void variable_swap( Environment * _environment, char * _source, char * _dest ) {
     
+    variable_array_walk_written( _environment, _source );
+    variable_array_walk_written( _environment, _dest );
+
     Variable * source = variable_retrieve( _environment, _source );
     Variable * target = variable_retrieve( _environment, _dest );
 
@@ -5391,6 +5764,8 @@ void variable_increment( Environment * _environment, char * _source ) {
         return;
     }
 
+    variable_array_walk_written( _environment, _source );
+
     Variable * source = variable_retrieve( _environment, _source );
 
     switch( VT_BITWIDTH( source->type ) ) {
@@ -5713,6 +6088,8 @@ void variable_decrement( Environment * _environment, char * _source ) {
         return;
     }
 
+    variable_array_walk_written( _environment, _source );
+
     Variable * source = variable_retrieve( _environment, _source );
 
     switch( VT_BITWIDTH( source->type ) ) {
@@ -5884,6 +6261,12 @@ Variable * variable_compare( Environment * _environment, char * _source, char *
         target = variable_cast( _environment, _destination, VT_SIGN( target->type ) );
     }
 
+    if ( variable_constant_operands( source, target ) && VT_BITWIDTH( source->type ) == VT_BITWIDTH( target->type ) ) {
+        return variable_constant_result( _environment, VT_SBYTE, 
+            ( variable_constant_normalize( source->type, source->value ) == variable_constant_normalize( target->type, target->value ) ) ? 0xff : 0x00, 
+            "(result of compare)" );
+    }
+
     MAKE_LABEL
 
     Variable * result = variable_temporary( _environment, VT_SBYTE, "(result of compare)" );
@@ -6724,6 +7107,10 @@ Variable * variable_and( Environment * _environment, char * _left, char * _right
         CRITICAL_VARIABLE(_right);
     }
 
+    if ( variable_constant_operands( source, target ) ) {
+        return variable_constant_result( _environment, source->type, source->value & target->value, "(result of AND)" );
+    }
+
     Variable * result = variable_temporary( _environment, source->type, "(result of OR)" );
 
     switch( VT_BITWIDTH( source->type ) ) {
@@ -6978,6 +7365,10 @@ Variable * variable_or( Environment * _environment, char * _left, char * _right
         CRITICAL_VARIABLE(_right);
     }
 
+    if ( variable_constant_operands( source, target ) ) {
+        return variable_constant_result( _environment, source->type, source->value | target->value, "(result of OR)" );
+    }
+
     Variable * result = variable_temporary( _environment, source->type, "(result of OR)" );
 
     switch( VT_BITWIDTH( source->type ) ) {
@@ -7087,6 +7478,10 @@ Variable * variable_not( Environment * _environment, char * _value ) {
 
     Variable * source = variable_retrieve( _environment, _value );
 
+    if ( source->initializedByConstant && VT_BITWIDTH( source->type ) >= 8 ) {
+        return variable_constant_result( _environment, source->type, ~source->value, "(result of NOT)" );
+    }
+
     Variable * result = variable_temporary( _environment, source->type, "(result of OR)" );
 
     switch( VT_BITWIDTH( source->type ) ) {
@@ -9027,6 +9422,16 @@ Variable * variable_string_str( Environment * _environment, char * _value ) {
                         value = NULL;
                     }
                     break;
+                case VT_BCD4:
+                case VT_BCD6:
+                case VT_BCD8:
+                    variable_store_string( _environment, result->name, "        " );
+                    cpu_dswrite( _environment, result->realName );
+                    cpu_dsdescriptor( _environment, result->realName, address->realName, size->realName );
+                    cpu_bcd_to_string( _environment, value->realName, address->realName, size->realName, VT_BCD_BYTES( value->type ) );
+                    cpu_dsresize( _environment, result->realName, size->realName );
+                    value = NULL;
+                    break;
                 default:
                     CRITICAL_STR_UNSUPPORTED( _value, DATATYPE_AS_STRING[value->type]);
                     break;
@@ -10096,6 +10501,18 @@ void variable_move_array_byte( Environment * _environment, Variable * _array, Va
 
     }
 
+    ArrayWalk * walk = variable_array_walk_find( _environment, _array );
+    if ( walk ) {
+        // The address of the element is kept by the FOR loop.
+        Variable * address = walk->pointer;
+        if ( VT_BITWIDTH( _array->arrayType ) == 32 ) {
+            cpu_move_32bit_indirect( _environment, _value->realName, address->realName );
+        } else {
+            cpu_move_16bit_indirect( _environment, _value->realName, address->realName );
+        }
+        return;
+    }
+
     outline0("; variable_move_array_byte(2)");
 
     // @bit2: ok
@@ -10385,6 +10802,8 @@ Variable * variable_move_from_array_bit( Environment * _environment, Variable *
 
 void variable_move_from_array_byte_inplace( Environment * _environment, Variable * _array, Variable * _result ) {
 
+    ArrayWalk * walk = NULL;
+
     _result->typeType = _array->typeType;
     if ( _array->typeType ) {
         _result->size = _array->typeType->size;
@@ -10457,6 +10876,14 @@ void variable_move_from_array_byte_inplace( Environment * _environment, Variable
         } else if ( _array->size < 256 && VT_BITWIDTH( _array->arrayType ) == 16 ) {
             Variable * offset = calculate_offset_in_array_byte( _environment, _array->name );
             cpu_move_16bit_indirect2_8bit( _environment, _array->realName, offset->realName, _result->realName );
+        } else if ( ( walk = variable_array_walk_find( _environment, _array ) ) ) {
+            // The address of the element is kept by the FOR loop.
+            Variable * address = walk->pointer;
+            if ( VT_BITWIDTH( _array->arrayType ) == 32 ) {
+                cpu_move_32bit_indirect2( _environment, address->realName, _result->realName );
+            } else {
+                cpu_move_16bit_indirect2( _environment, address->realName, _result->realName );
+            }
         } else {
 
             // @bit2: ok
@@ -11440,6 +11867,14 @@ int label_exists_named( Environment * _environment, char * _label ) {
 
 void label_define_numeric( Environment * _environment, int _label ) {
     
+    if ( _environment->procedureName ) {
+        _environment->procedureInlineBlocked = 1;
+    }
+
+    if_then_dead_keep( _environment );
+    value_record_reset( _environment );
+    variable_array_walk_invalidate( _environment );
+
     if (label_exists_numeric( _environment, _label )) {
         CRITICAL_LINE_NUMBER_ALREADY_DEFINED( _label );
     }
@@ -11461,6 +11896,14 @@ void label_define_numeric( Environment * _environment, int _label ) {
 
 void label_define_named( Environment * _environment, char * _label ) {
     
+    if ( _environment->procedureName ) {
+        _environment->procedureInlineBlocked = 1;
+    }
+
+    if_then_dead_keep( _environment );
+    value_record_reset( _environment );
+    variable_array_walk_invalidate( _environment );
+
     if (label_exists_named( _environment, _label )) {
         CRITICAL_LABEL_ALREADY_DEFINED( _label );
     }
@@ -12693,57 +13136,45 @@ void variable_temporary_remove( Environment * _environment, char * _name ) {
 
 }
 
-int calculate_white_area( TileData * _tileData ) {
-    int i=0, j=0;
-    int actual = 0;
-    for(i=0;i<8;++i) {
-        for(j=0;j<8;++j) {
-            if ( _tileData->data[j] & ( 1 << i ) ) {
-                ++actual;
-            }
-        }
-    }
-    return actual;
+// 64 bit population count: it maps on a single instruction where
+// the host CPU supports it.
+static int tile_popcount( unsigned long long _value ) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll( _value );
+#else
+    _value = _value - ( ( _value >> 1 ) & 0x5555555555555555ULL );
+    _value = ( _value & 0x3333333333333333ULL ) + ( ( _value >> 2 ) & 0x3333333333333333ULL );
+    _value = ( _value + ( _value >> 4 ) ) & 0x0f0f0f0f0f0f0f0fULL;
+    return (int)( ( _value * 0x0101010101010101ULL ) >> 56 );
+#endif
 }
 
-int calculate_horizontal_edges( TileData * _tileData, int _position ) {
-    int edges = 0;
+static unsigned long long tile_bitboard( TileData * _tileData ) {
+    unsigned long long bitboard = 0;
     int i=0;
-    int actual = 0;
     for(i=0;i<8;++i) {
-        if ( _tileData->data[_position] & ( 1 << i ) ) {
-            if ( !actual ) {
-                ++edges;
-                actual = 1;
-            }
-        } else {
-            if ( actual ) {
-                ++edges;
-                actual = 0;
-            }
-        }
+        bitboard |= ( (unsigned long long) (unsigned char) _tileData->data[i] ) << ( i * 8 );
     }
-    return edges;
+    return bitboard;
+}
+
+// A bit is set for every pixel that differs from the one on its left
+// (horizontal) or above it (vertical), starting from an empty border.
+#define TILE_HORIZONTAL_CHANGES( b )    ( (b) ^ ( ( (b) << 1 ) & 0xfefefefefefefefeULL ) )
+#define TILE_VERTICAL_CHANGES( b )      ( (b) ^ ( (b) << 8 ) )
+
+int calculate_white_area( TileData * _tileData ) {
+    return tile_popcount( tile_bitboard( _tileData ) );
+}
+
+int calculate_horizontal_edges( TileData * _tileData, int _position ) {
+    unsigned long long changes = TILE_HORIZONTAL_CHANGES( tile_bitboard( _tileData ) );
+    return tile_popcount( changes & ( 0xffULL << ( _position * 8 ) ) );
 }
 
 int calculate_vertical_edges( TileData * _tileData, int _position ) {
-    int edges = 0;
-    int i=0;
-    int actual = 0;
-    for(i=0;i<8;++i) {
-        if ( _tileData->data[i] & ( 1 << _position ) ) {
-            if ( !actual ) {
-                ++edges;
-                actual = 1;
-            }
-        } else {
-            if ( actual ) {
-                ++edges;
-                actual = 0;
-            }
-        }
-    }
-    return edges;
+    unsigned long long changes = TILE_VERTICAL_CHANGES( tile_bitboard( _tileData ) );
+    return tile_popcount( changes & ( 0x0101010101010101ULL << _position ) );
 }
 
 TileDescriptor * calculate_tile_descriptor( TileData * _tileData ) {
@@ -12752,26 +13183,18 @@ TileDescriptor * calculate_tile_descriptor( TileData * _tileData ) {
 
     int i=0;
 
-    // printf( "+--------+\n" );
-    // for( i=0; i<8; ++i ) {
-    //     printf( "|" );
-    //     int j;
-    //     for( j=0; j<8; ++j ) {
-    //         if (  _tileData->data[i] & ( 1 << j ) ) {
-    //             printf( "*" );
-    //         } else {
-    //             printf( " " );
-    //         }
-    //     }
-    //     printf( "|\n" );
-    // }
-    // printf( "+--------+\n" );
-    // printf( "\n\n" );
+    unsigned long long bitboard = tile_bitboard( _tileData );
+    unsigned long long horizontalChanges = TILE_HORIZONTAL_CHANGES( bitboard );
+    unsigned long long verticalChanges = TILE_VERTICAL_CHANGES( bitboard );
 
-    tileDescriptor->whiteArea = calculate_white_area( _tileData );
+    tileDescriptor->bitboard = bitboard;
+    tileDescriptor->whiteArea = tile_popcount( bitboard );
+    tileDescriptor->edges = 0;
     for(i=0;i<8;++i) {
-        tileDescriptor->horizontalEdges[i] = calculate_horizontal_edges( _tileData, i );
-        tileDescriptor->verticalEdges[i] = calculate_vertical_edges( _tileData, i );
+        tileDescriptor->horizontalEdges[i] = tile_popcount( horizontalChanges & ( 0xffULL << ( i * 8 ) ) );
+        tileDescriptor->verticalEdges[i] = tile_popcount( verticalChanges & ( 0x0101010101010101ULL << i ) );
+        tileDescriptor->edges |= ( (unsigned long long) tileDescriptor->horizontalEdges[i] ) << ( i * 4 );
+        tileDescriptor->edges |= ( (unsigned long long) tileDescriptor->verticalEdges[i] ) << ( 32 + i * 4 );
     }
 
     return tileDescriptor;
@@ -12803,6 +13226,10 @@ int calculate_tile_affinity( TileDescriptor * _first, TileDescriptor * _second )
     int affinity = 0;
     int i=0;
 
+    if ( _first->bitboard == _second->bitboard ) {
+        return 0;
+    }
+
     affinity += abs( _first->whiteArea - _second->whiteArea );
     for(i=0;i<8;++i) {
         affinity += abs( _first->horizontalEdges[i] - _second->horizontalEdges[i] );
@@ -12813,18 +13240,89 @@ int calculate_tile_affinity( TileDescriptor * _first, TileDescriptor * _second )
 
 }
 
+static int tile_descriptor_hash( TileDescriptor * _tile ) {
+    unsigned long long hash = _tile->edges ^ ( (unsigned long long) _tile->whiteArea * 0x9e3779b97f4a7c15ULL );
+    hash ^= hash >> 31;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 29;
+    return (int)( hash & ( TILE_DESCRIPTORS_HASH_SIZE - 1 ) );
+}
+
+// The index is rebuilt only when a descriptor has been added or replaced
+// since the last lookup (descriptors are never updated in place).
+static void tile_descriptors_index( TileDescriptors * _tiles ) {
+
+    int i=0, count[65];
+
+    if ( _tiles->indexValid && ! memcmp( _tiles->indexed, _tiles->descriptor, sizeof( _tiles->descriptor ) ) ) {
+        return;
+    }
+
+    memcpy( _tiles->indexed, _tiles->descriptor, sizeof( _tiles->descriptor ) );
+    memset( count, 0, sizeof( count ) );
+    for(i=0;i<TILE_DESCRIPTORS_HASH_SIZE;++i) {
+        _tiles->hash[i] = -1;
+    }
+
+    for(i=0;i<256;++i) {
+        TileDescriptor * tile = _tiles->descriptor[i];
+        if ( tile ) {
+            // Only the first tile with a given signature is kept, so
+            // that the lowest index wins as with a linear scan.
+            int slot = tile_descriptor_hash( tile );
+            while( _tiles->hash[slot] != -1 ) {
+                TileDescriptor * other = _tiles->descriptor[_tiles->hash[slot]];
+                if ( other->whiteArea == tile->whiteArea && other->edges == tile->edges ) {
+                    break;
+                }
+                slot = ( slot + 1 ) & ( TILE_DESCRIPTORS_HASH_SIZE - 1 );
+            }
+            if ( _tiles->hash[slot] == -1 ) {
+                _tiles->hash[slot] = i;
+            }
+            ++count[tile->whiteArea];
+        }
+    }
+
+    _tiles->whiteAreaFirst[0] = 0;
+    for(i=0;i<65;++i) {
+        _tiles->whiteAreaFirst[i+1] = _tiles->whiteAreaFirst[i] + count[i];
+        count[i] = _tiles->whiteAreaFirst[i];
+    }
+    for(i=0;i<256;++i) {
+        if ( _tiles->descriptor[i] ) {
+            _tiles->byWhiteArea[count[_tiles->descriptor[i]->whiteArea]++] = i;
+        }
+    }
+
+    _tiles->indexValid = 1;
+
+}
+
 int calculate_nearest_tile( TileDescriptor * _tile, TileDescriptors * _tiles ) {
 
     int minAffinity = 0xffffff;
     int nearestTileIndex = -1;
-    int i;
+    int distance, side, i;
 
-    for(i=0;i<256;++i) {
-        if ( _tiles->descriptor[i] ) {
-            int affinity = calculate_tile_affinity( _tile, _tiles->descriptor[i] );
-            if ( minAffinity > affinity ) {
-                minAffinity = affinity;
-                nearestTileIndex = i;
+    tile_descriptors_index( _tiles );
+
+    // The difference of white areas is a lower bound of the affinity: tiles
+    // are visited by increasing white area distance, and the scan stops as
+    // soon as no further tile can beat the best one.
+    for(distance=0;distance<=64 && distance<=minAffinity;++distance) {
+        for(side=0;side<2;++side) {
+            int whiteArea = side ? _tile->whiteArea + distance : _tile->whiteArea - distance;
+            if ( ( side && !distance ) || whiteArea < 0 || whiteArea > 64 ) {
+                continue;
+            }
+            for(i=_tiles->whiteAreaFirst[whiteArea];i<_tiles->whiteAreaFirst[whiteArea+1];++i) {
+                int index = _tiles->byWhiteArea[i];
+                int affinity = calculate_tile_affinity( _tile, _tiles->descriptor[index] );
+                if ( minAffinity > affinity || ( minAffinity == affinity && nearestTileIndex > index ) ) {
+                    minAffinity = affinity;
+                    nearestTileIndex = index;
+                }
             }
         }
     }
@@ -12835,22 +13333,19 @@ int calculate_nearest_tile( TileDescriptor * _tile, TileDescriptors * _tiles ) {
 
 int calculate_exact_tile( TileDescriptor * _tile, TileDescriptors * _tiles ) {
 
-    int i=0;
-
     if ( ! _tiles ) {
         return -1;
     }
 
-    if ( ! _tiles->descriptor ) {
-        return -1;
-    }
+    tile_descriptors_index( _tiles );
 
-    for(i=0;i<256;++i) {
-        if ( _tiles->descriptor[i] ) {
-            if ( calculate_tile_affinity( _tile, _tiles->descriptor[i] ) == 0 ) {
-                return i;
-            };
+    int slot = tile_descriptor_hash( _tile );
+    while( _tiles->hash[slot] != -1 ) {
+        TileDescriptor * other = _tiles->descriptor[_tiles->hash[slot]];
+        if ( other->whiteArea == _tile->whiteArea && other->edges == _tile->edges ) {
+            return _tiles->hash[slot];
         }
+        slot = ( slot + 1 ) & ( TILE_DESCRIPTORS_HASH_SIZE - 1 );
     }
 
     return -1;
@@ -14738,6 +15233,196 @@ void buffered_pop_output( Environment * _environment ) {
     --_environment->currentBufferOutput;
 }
 
+/* <usermanual>
+@keyword OPTIMIZE
+
+@english
+The ''OPTIMIZE'' command selects how the compiler chooses, for each use of
+a primitive that has both forms, between expanding its code inline and
+calling a shared routine. ''OPTIMIZE SPEED'' always expands the code inline,
+''OPTIMIZE SIZE'' calls the routine whenever the call is smaller than the
+expansion, and ''OPTIMIZE BALANCED'' expands the code inside loops and calls 
+the routine elsewhere. If used inside a ''PROCEDURE'', the mode is valid up 
+to the ''END PROC'' and it does not change the mode of the rest of the
+program: a procedure with ''OPTIMIZE SPEED'' is considered "hot" and it is
+always expanded inline. The primitives selected with the ''-e'' option are 
+always called. The ''-E'' option prints how many uses have been inlined or 
+called, and the estimated cost.
+
+@italian
+Il comando ''OPTIMIZE'' seleziona come il compilatore sceglie, per ogni uso
+di una primitiva che le preveda entrambe, tra l'espansione del codice in linea
+e la chiamata ad una routine condivisa. ''OPTIMIZE SPEED'' espande sempre il 
+codice in linea, ''OPTIMIZE SIZE'' chiama la routine quando la chiamata è
+più piccola dell'espansione, e ''OPTIMIZE BALANCED'' espande il codice 
+all'interno dei cicli e chiama la routine altrove. Se usato all'interno di
+una ''PROCEDURE'', la modalità vale fino a ''END PROC'' e non cambia quella
+del resto del programma: una procedura con ''OPTIMIZE SPEED'' è considerata
+"calda" ed è sempre espansa in linea. Le primitive selezionate con l'opzione 
+''-e'' sono sempre chiamate. L'opzione ''-E'' stampa quanti usi sono stati 
+espansi o chiamati, e il costo stimato.
+
+@syntax OPTIMIZE SPEED
+@syntax OPTIMIZE SIZE
+@syntax OPTIMIZE BALANCED
+
+@example OPTIMIZE SIZE
+@example PROCEDURE inner
+@example    OPTIMIZE SPEED
+@example    x = a * b
+@example END PROC
+
+@target all
+</usermanual> */
+/**
+ * @brief Set the optimization mode (OPTIMIZE SPEED|SIZE|BALANCED)
+ * 
+ * Inside a procedure the mode is valid up to the END PROC, outside of it
+ * the mode is valid for the rest of the program.
+ * 
+ * @param _environment Current calling environment
+ * @param _mode Optimization mode
+ */
+void optimize_mode( Environment * _environment, OptimizeMode _mode ) {
+
+    if ( _environment->procedureName ) {
+        _environment->procedureOptimizeMode = _mode;
+    } else {
+        _environment->optimizeMode = _mode;
+    }
+
+}
+
+/**
+ * @brief Decide if a call site must call the embedded version of a primitive
+ * 
+ * The primitives selected with the -e option are always called. Otherwise,
+ * the decision is taken on the cost model given by the CPU, following the
+ * current optimization mode: with SPEED (or by default) primitives are 
+ * inlined, with SIZE they are called whenever the call site is smaller than
+ * the inline expansion, with BALANCED they are inlined inside loops (and in
+ * procedures optimized for SPEED) and called elsewhere.
+ * 
+ * @param _environment Current calling environment
+ * @param _name Name of the primitive
+ * @param _forced If the primitive has been selected with the -e option
+ * @return 1 if the embedded version must be called, 0 to inline
+ */
+int embedded_call( Environment * _environment, char * _name, int _forced ) {
+
+    if ( _forced ) {
+        return 1;
+    }
+
+    OptimizeMode mode = _environment->optimizeMode;
+    if ( _environment->procedureName && _environment->procedureOptimizeMode ) {
+        mode = _environment->procedureOptimizeMode;
+    }
+
+    if ( mode == OPTIMIZE_MODE_DEFAULT || mode == OPTIMIZE_MODE_SPEED ) {
+        return 0;
+    }
+
+    EmbeddedCost * cost = cpu_embedded_cost( _environment, _name );
+
+    if ( ! cost ) {
+        return 0;
+    }
+
+    if ( mode == OPTIMIZE_MODE_BALANCED && _environment->loops ) {
+        return 0;
+    }
+
+    return cost->callBytes < cost->inlineBytes;
+
+}
+
+/**
+ * @brief Print the estimated cost of a primitive, for the -E option
+ * 
+ * @param _environment Current calling environment
+ * @param _name Name of the primitive
+ * @param _sites Number of call sites
+ * @param _calls Number of call sites that called the embedded version
+ */
+void embedded_cost_report( Environment * _environment, char * _name, int _sites, int _calls ) {
+
+    EmbeddedCost * cost = cpu_embedded_cost( _environment, _name );
+
+    if ( ! cost || ! _sites ) {
+        return;
+    }
+
+    int inlined = _sites - _calls;
+
+    printf("\t%d inline, %d called: %d bytes (%d if inlined), +%d cycles per call\n", 
+        inlined, _calls, 
+        inlined * cost->inlineBytes + _calls * cost->callBytes, 
+        _sites * cost->inlineBytes,
+        cost->callCycles );
+
+}
+
+/**
+ * @brief Redirect the output to the library buffer
+ * 
+ * The runtime modules are not emitted at the point of first use anymore
+ * (with a jump over them), but they are collected into a separate buffer,
+ * that will be emitted once, after the program. Nested deployments are
+ * written into the same buffer.
+ * 
+ * @param _environment Current calling environment
+ * @return 1 if the output has been redirected, 0 if the library has already
+ *         been emitted, and the caller must deploy the module inline
+ */
+int buffered_push_library( Environment * _environment ) {
+    if ( _environment->libraryOutputClosed ) {
+        return 0;
+    }
+    if ( _environment->libraryOutputDepth++ ) {
+        return 1;
+    }
+    _environment->libraryOutputSaved = _environment->bufferOutput[_environment->currentBufferOutput];
+    _environment->libraryOutputSavedSize = _environment->bufferOutputSize[_environment->currentBufferOutput];
+    _environment->bufferOutput[_environment->currentBufferOutput] = _environment->libraryOutput;
+    _environment->bufferOutputSize[_environment->currentBufferOutput] = _environment->libraryOutputSize;
+    return 1;
+}
+
+/**
+ * @brief Restore the output redirected by buffered_push_library()
+ * 
+ * @param _environment Current calling environment
+ */
+void buffered_pop_library( Environment * _environment ) {
+    if ( --_environment->libraryOutputDepth ) {
+        return;
+    }
+    _environment->libraryOutput = _environment->bufferOutput[_environment->currentBufferOutput];
+    _environment->libraryOutputSize = _environment->bufferOutputSize[_environment->currentBufferOutput];
+    _environment->bufferOutput[_environment->currentBufferOutput] = _environment->libraryOutputSaved;
+    _environment->bufferOutputSize[_environment->currentBufferOutput] = _environment->libraryOutputSavedSize;
+    _environment->libraryOutputSaved = NULL;
+    _environment->libraryOutputSavedSize = 0;
+}
+
+/**
+ * @brief Emit the library buffer into the current output
+ * 
+ * After this call, any further deployment will be emitted inline.
+ * 
+ * @param _environment Current calling environment
+ */
+void buffered_library_output( Environment * _environment ) {
+    _environment->libraryOutputClosed = 1;
+    if ( _environment->libraryOutput ) {
+        buffered_realloc( _environment, _environment->libraryOutput, _environment->libraryOutputSize );
+        free( _environment->libraryOutput );
+        _environment->libraryOutput = NULL;
+        _environment->libraryOutputSize = 0;
+    }
+}
+
 void buffered_prepend_output( Environment * _environment ) {
     char * p = malloc( _environment->bufferOutputSize[_environment->currentBufferOutput-1] + _environment->bufferOutputSize[_environment->currentBufferOutput] );
     memset( p, 0, _environment->bufferOutputSize[_environment->currentBufferOutput-1] + _environment->bufferOutputSize[_environment->currentBufferOutput] );
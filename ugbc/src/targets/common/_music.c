@@ -69,6 +69,46 @@
 // DELAY, 1 byte, FORMAT: 0dddddddd -> dddddddd is the delay (in jiffies)
 #define IMF_DELAY( jiffies ) ( ( jiffies ) & 0x7f )
 
+// The version 2 of the IMF format adds some instructions (1111xxxx) 
+// to represent long delays and to reuse repeated sequences of 
+// instructions ("patterns"). It is generated only for those targets 
+// whose player is able to decode it.
+#if defined(__c64__) || defined(__c64reu__) || defined(__c128__) || defined(__atari__) || defined(__atarixl__) || defined(__msx1__) || defined(__cpc__) || defined(__gb__)
+    #define IMF_VERSION 2
+#else
+    #define IMF_VERSION 1
+#endif
+
+// LONG WAIT, 3 bytes,
+//          FORMAT:
+//              11110000
+//              llllllll -> low byte of the delay (in jiffies)
+//              hhhhhhhh -> high byte of the delay (in jiffies)
+#define IMF_LONG_WAIT 0xf0
+
+// CALL, 4 bytes,
+//          FORMAT:
+//              11111100
+//              nnnnnnnn -> number of times the pattern will be played (1...255)
+//              llllllll -> low byte of the offset of the pattern
+//              hhhhhhhh -> high byte of the offset of the pattern
+#define IMF_CALL 0xfc
+
+// RETURN, 1 byte, FORMAT: 11111101 -> end of the pattern
+#define IMF_RETURN 0xfd
+
+// END, 1 byte, FORMAT: 11111110 -> end of the stream
+#define IMF_END 0xfe
+
+// Maximum length of a pattern (in instructions).
+#define IMF_PATTERN_MAX_LENGTH 128
+
+// Maximum number of patterns extracted from a stream.
+#define IMF_PATTERN_MAX_COUNT 64
+
+// Maximum number of repetitions for a single CALL.
+#define IMF_PATTERN_MAX_REPEAT 255
+
 // Maximum size of an IMF stream.
 #define IMF_MAX_STREAM_SIZE ( 16 * MAX_TEMPORARY_STORAGE );
 
@@ -439,6 +479,307 @@ static int decode_midi_payload( MidiMessagePayload * _payload, int _control_only
 
 }
 
+#if IMF_VERSION >= 2
+
+// A single instruction of the IMF stream, as seen by the pattern
+// search. The "id" is the content of the instruction (up to 3 bytes),
+// so two instructions are equal if their ids are equal. A CALL to a 
+// pattern is represented by an id equal to -1, and it will never
+// be part of another pattern (patterns cannot be nested).
+typedef struct _ImfToken {
+
+    int offset;
+    int size;
+    int id;
+    int pattern;
+    int count;
+
+} ImfToken;
+
+// A repeated sequence of instructions, found by the pattern search.
+typedef struct _ImfPattern {
+
+    ImfToken * tokens;
+    int length;
+    int offset;
+
+} ImfPattern;
+
+// An entry of the hash table used to count the occurrences of each
+// sequence of instructions of a given length.
+typedef struct _ImfPatternCandidate {
+
+    int stamp;
+    unsigned long long hash;
+    int lastEnd;
+    int count;
+    int runs;
+    int runLength;
+
+} ImfPatternCandidate;
+
+// Size (in bytes) of the instruction that starts with the given opcode.
+static int imf_instruction_size( unsigned char _opcode ) {
+
+    if ( _opcode < 0x80 ) {
+        return 1;
+    } else if ( _opcode < 0xc0 ) {
+        return 2;
+    } else if ( _opcode < 0xe0 ) {
+        return 3;
+    } else if ( _opcode == IMF_LONG_WAIT ) {
+        return 3;
+    } else {
+        return 1;
+    }
+
+}
+
+// This routine searches the stream for the sequence of instructions 
+// that, if moved into a pattern, would save the greatest number of bytes. 
+// Occurrences are counted without overlapping, from left to right, and 
+// adjacent occurrences are considered as a single CALL with a repeat count.
+// It returns the gain in bytes (0 if there is nothing to gain).
+static int imf_pattern_best( ImfToken * _tokens, int _count, ImfPatternCandidate * _table, int _table_size, int * _stamp, int * _first, int * _length ) {
+
+    int bestGain = 0;
+
+    unsigned long long * prefixHash = malloc( ( _count + 1 ) * sizeof( unsigned long long ) );
+    unsigned long long * power = malloc( ( IMF_PATTERN_MAX_LENGTH + 1 ) * sizeof( unsigned long long ) );
+    int * prefixSize = malloc( ( _count + 1 ) * sizeof( int ) );
+    int * prefixCalls = malloc( ( _count + 1 ) * sizeof( int ) );
+
+    prefixHash[0] = 0;
+    prefixSize[0] = 0;
+    prefixCalls[0] = 0;
+    for( int i=0; i<_count; ++i ) {
+        prefixHash[i+1] = prefixHash[i] * 1000003ULL + (unsigned long long)( _tokens[i].id + 2 );
+        prefixSize[i+1] = prefixSize[i] + _tokens[i].size;
+        prefixCalls[i+1] = prefixCalls[i] + ( _tokens[i].id < 0 ? 1 : 0 );
+    }
+    power[0] = 1;
+    for( int i=1; i<=IMF_PATTERN_MAX_LENGTH; ++i ) {
+        power[i] = power[i-1] * 1000003ULL;
+    }
+
+    for( int length=1; length<=IMF_PATTERN_MAX_LENGTH && ( length * 2 ) <= _count; ++length ) {
+
+        ++(*_stamp);
+
+        for( int i=0; i<=(_count-length); ++i ) {
+
+            if ( prefixCalls[i+length] != prefixCalls[i] ) {
+                continue;
+            }
+
+            unsigned long long hash = prefixHash[i+length] - prefixHash[i] * power[length];
+            int slot = (int)( ( hash ^ ( hash >> 29 ) ) & ( _table_size - 1 ) );
+            while( _table[slot].stamp == *_stamp && _table[slot].hash != hash ) {
+                slot = ( slot + 1 ) & ( _table_size - 1 );
+            }
+
+            ImfPatternCandidate * candidate = &_table[slot];
+
+            if ( candidate->stamp != *_stamp ) {
+                candidate->stamp = *_stamp;
+                candidate->hash = hash;
+                candidate->lastEnd = i + length;
+                candidate->count = 1;
+                candidate->runs = 1;
+                candidate->runLength = 1;
+                continue;
+            }
+
+            if ( i < candidate->lastEnd ) {
+                continue;
+            }
+
+            if ( i == candidate->lastEnd && candidate->runLength < IMF_PATTERN_MAX_REPEAT ) {
+                ++candidate->runLength;
+            } else {
+                ++candidate->runs;
+                candidate->runLength = 1;
+            }
+            ++candidate->count;
+            candidate->lastEnd = i + length;
+
+            // Each occurrence saves the body of the pattern, while each
+            // run of adjacent occurrences costs a CALL (4 bytes). The pattern
+            // itself is stored once, followed by a RETURN.
+            int size = prefixSize[i+length] - prefixSize[i];
+            int gain = candidate->count * size - candidate->runs * 4 - size - 1;
+            if ( gain > bestGain ) {
+                bestGain = gain;
+                *_first = i;
+                *_length = length;
+            }
+
+        }
+
+    }
+
+    free( prefixCalls );
+    free( prefixSize );
+    free( power );
+    free( prefixHash );
+
+    return bestGain;
+
+}
+
+// This routine replaces every occurrence of the sequence of instructions
+// starting at _first, and long _length, with a CALL to a new pattern. 
+// It returns the new number of instructions of the stream.
+static int imf_pattern_apply( ImfToken * _tokens, int _count, int _first, int _length, ImfPattern * _pattern, int _pattern_index ) {
+
+    _pattern->tokens = malloc( _length * sizeof( ImfToken ) );
+    memcpy( _pattern->tokens, &_tokens[_first], _length * sizeof( ImfToken ) );
+    _pattern->length = _length;
+    _pattern->offset = 0;
+
+    int i = 0, j = 0;
+    ImfToken * lastCall = NULL;
+    int lastEnd = -1;
+
+    while( i < _count ) {
+        int match = ( i + _length ) <= _count;
+        for( int k=0; match && k<_length; ++k ) {
+            if ( _tokens[i+k].id < 0 || _tokens[i+k].id != _pattern->tokens[k].id ) {
+                match = 0;
+            }
+        }
+        if ( match ) {
+            if ( lastCall && lastEnd == i && lastCall->count < IMF_PATTERN_MAX_REPEAT ) {
+                ++lastCall->count;
+            } else {
+                _tokens[j].offset = 0;
+                _tokens[j].size = 4;
+                _tokens[j].id = -1;
+                _tokens[j].pattern = _pattern_index;
+                _tokens[j].count = 1;
+                lastCall = &_tokens[j];
+                ++j;
+            }
+            i += _length;
+            lastEnd = i;
+        } else {
+            _tokens[j++] = _tokens[i++];
+            lastCall = NULL;
+        }
+    }
+
+    return j;
+
+}
+
+// This routine converts a (flat) IMF stream into the version 2 of the
+// IMF format, by moving repeated sequences of instructions into patterns.
+// The main stream is followed by an END instruction, then by all the
+// patterns, each one ended by a RETURN instruction. It returns NULL if
+// the conversion does not make the stream smaller.
+static char * imf_patterns_compress( char * _buffer, int * _size ) {
+
+    ImfToken * tokens = malloc( ( *_size + 1 ) * sizeof( ImfToken ) );
+    int count = 0;
+
+    for( int i=0; i<*_size; ) {
+        unsigned char * instruction = (unsigned char *) &_buffer[i];
+        int size = imf_instruction_size( instruction[0] );
+        if ( ( i + size ) > *_size ) {
+            free( tokens );
+            return NULL;
+        }
+        tokens[count].offset = i;
+        tokens[count].size = size;
+        tokens[count].id = ( instruction[0] << 16 ) | ( ( size > 1 ? instruction[1] : 0 ) << 8 ) | ( size > 2 ? instruction[2] : 0 );
+        tokens[count].pattern = 0;
+        tokens[count].count = 0;
+        ++count;
+        i += size;
+    }
+
+    int tableSize = 1;
+    while( tableSize < ( 2 * count ) ) {
+        tableSize <<= 1;
+    }
+    ImfPatternCandidate * table = malloc( tableSize * sizeof( ImfPatternCandidate ) );
+    memset( table, 0, tableSize * sizeof( ImfPatternCandidate ) );
+    int stamp = 0;
+
+    ImfPattern patterns[IMF_PATTERN_MAX_COUNT];
+    int patternCount = 0;
+
+    while( patternCount < IMF_PATTERN_MAX_COUNT ) {
+        int first = 0, length = 0;
+        if ( imf_pattern_best( tokens, count, table, tableSize, &stamp, &first, &length ) <= 0 ) {
+            break;
+        }
+        count = imf_pattern_apply( tokens, count, first, length, &patterns[patternCount], patternCount );
+        ++patternCount;
+    }
+
+    free( table );
+
+    char * result = NULL;
+
+    if ( patternCount ) {
+
+        int size = 1;
+        for( int i=0; i<count; ++i ) {
+            size += tokens[i].size;
+        }
+        for( int p=0; p<patternCount; ++p ) {
+            patterns[p].offset = size;
+            for( int i=0; i<patterns[p].length; ++i ) {
+                size += patterns[p].tokens[i].size;
+            }
+            ++size;
+        }
+
+        if ( size < *_size && size <= 0xffff ) {
+
+            result = malloc( size );
+            int pos = 0;
+
+            for( int i=0; i<count; ++i ) {
+                if ( tokens[i].id < 0 ) {
+                    result[pos++] = IMF_CALL;
+                    result[pos++] = tokens[i].count;
+                    result[pos++] = patterns[tokens[i].pattern].offset & 0xff;
+                    result[pos++] = ( patterns[tokens[i].pattern].offset >> 8 ) & 0xff;
+                } else {
+                    memcpy( &result[pos], &_buffer[tokens[i].offset], tokens[i].size );
+                    pos += tokens[i].size;
+                }
+            }
+            result[pos++] = IMF_END;
+
+            for( int p=0; p<patternCount; ++p ) {
+                for( int i=0; i<patterns[p].length; ++i ) {
+                    memcpy( &result[pos], &_buffer[patterns[p].tokens[i].offset], patterns[p].tokens[i].size );
+                    pos += patterns[p].tokens[i].size;
+                }
+                result[pos++] = IMF_RETURN;
+            }
+
+            *_size = size;
+
+        }
+
+        for( int p=0; p<patternCount; ++p ) {
+            free( patterns[p].tokens );
+        }
+
+    }
+
+    free( tokens );
+
+    return result;
+
+}
+
+#endif
+
 static Variable * midi_load_to_variable( Environment * _environment, char * _filename, char * _alias, int _bank_expansion ) {
 
     // Reinitialize all parameters for MIDI>IMF decoding.
@@ -654,6 +995,26 @@ static Variable * midi_load_to_variable( Environment * _environment, char * _fil
 
                     // printf(" DELAY: %d jiffies\n", jiffies );
 
+#if IMF_VERSION >= 2
+                    // A delay that needs more than two DELAY instructions
+                    // is better represented by a single LONG WAIT. Since 
+                    // the player spends one more jiffy to read each DELAY, 
+                    // we add them in order to keep the same timing.
+                    if ( jiffies > 254 ) {
+                        jiffies += ( ( jiffies + 126 ) / 127 ) - 1;
+                        if ( jiffies > 0xffff ) {
+                            jiffies = 0xffff;
+                        }
+                        imfBuffer[imfStreamPos++] = IMF_LONG_WAIT;
+                        imfBuffer[imfStreamPos++] = jiffies & 0xff;
+                        imfBuffer[imfStreamPos++] = ( jiffies >> 8 ) & 0xff;
+                        jiffies = 0;
+                        if ( !decode_midi_inside_memory_limits( ) ) {
+                            CRITICAL_MIDI_OUT_OF_MEMORY( _filename )
+                        }
+                    }
+#endif
+
                     // Since the IMF format can represent a pause of
                     // maximum 127 jiffies for each byte produced,
                     // we must split a larger delay. The former
@@ -699,6 +1060,15 @@ static Variable * midi_load_to_variable( Environment * _environment, char * _fil
 
         size = imfStreamPos;
 
+#if IMF_VERSION >= 2
+        // Repeated bars and choruses are moved into patterns.
+        char * imfPatternBuffer = imf_patterns_compress( imfBuffer, &size );
+        if ( imfPatternBuffer ) {
+            free( imfBuffer );
+            imfBuffer = imfPatternBuffer;
+        }
+#endif
+
         result = variable_temporary( _environment, VT_MUSIC, "(buffer)" );
 
         variable_store_buffer( _environment, result->name, imfBuffer, size, 0 );
@@ -330,3 +330,818 @@ int po_buf_is_hex(POBuffer _s) {
     }
     return 1;
 }
+
+/****************************************************************************
+ * TIMER CONTEXT
+ ****************************************************************************/
+
+/* Every TIMERMANAGER saves a fixed set of items around each call to a timer
+   handler: the pointers on the 6502, and the registers that the manager
+   still needs after the call on the other CPUs. Each save / restore group
+   is marked in the source with "; TIMERSAVE <item>" ... "; TIMERSAVEEND",
+   so this pass can walk the code reachable from the handlers (given to
+   TIMERSETADDRESS) and drop the groups of the items that none of them can
+   write. Since the manager is shared by all timers, the kept set is the
+   union over all the handlers. Anything we cannot follow (indirect jumps,
+   unknown targets) keeps all. The syntax of each CPU is described by a
+   TimerContextCpu. */
+
+#define TIMER_CONTEXT_ITEMS     4
+
+typedef struct _TimerContextCpu {
+
+    /* the call that sets a handler, and the instruction that loads
+       the address of the handler (a few lines before the call) */
+    char * setAddress;
+    char * handler;
+
+    /* the items saved around the call to the handler */
+    char * items[TIMER_CONTEXT_ITEMS];
+
+    /* labels are written as "NAME:" (otherwise, as "NAME") */
+    int colon;
+
+    /* the items are registers, so any call to a fixed address
+       (i.e. into the ROM) can write them */
+    int registers;
+
+    /* the operands are memory references between these characters */
+    char memory;
+    char memoryEnd;
+
+    /* symbols that can be found in a jump and that are not targets */
+    char ** keywords;
+
+    /* 1 if the instruction is a jump or a call, 2 if it is indirect */
+    int (*flow)( char * _mnemonic, char * _operands );
+
+    /* 1 if the instruction can take the address of a label */
+    int (*takes)( char * _mnemonic, char * _operands );
+
+    /* 1 if the flow never continues with the next line */
+    int (*ends)( char * _mnemonic, char * _operands );
+
+    /* 1 if the instruction can write the given item */
+    int (*writes)( char * _mnemonic, char * _operands, char * _item );
+
+} TimerContextCpu;
+
+typedef struct _TimerContextLabel {
+    char * name;
+    int line;
+} TimerContextLabel;
+
+static int timer_context_is_ident( char _c ) {
+    return ( _c >= 'A' && _c <= 'Z' ) || ( _c >= 'a' && _c <= 'z' ) || ( _c >= '0' && _c <= '9' ) || _c == '_';
+}
+
+static int timer_context_label_cmp( const void * _a, const void * _b ) {
+    return strcmp( ((TimerContextLabel *)_a)->name, ((TimerContextLabel *)_b)->name );
+}
+
+static int timer_context_label_find( TimerContextLabel * _labels, int _count, char * _name ) {
+    TimerContextLabel key;
+    key.name = _name;
+    TimerContextLabel * found = bsearch( &key, _labels, _count, sizeof( TimerContextLabel ), timer_context_label_cmp );
+    return found ? found->line : -1;
+}
+
+/* skip blanks, and return NULL on empty lines and comments */
+static char * timer_context_code( char * _line ) {
+    while( *_line == ' ' || *_line == '\t' ) ++_line;
+    if ( *_line == '\0' || *_line == ';' || *_line == '\r' || *_line == '\n' ) {
+        return NULL;
+    }
+    return _line;
+}
+
+/* 1 if one of the (comma separated) names is a symbol of the operands */
+static int timer_context_mentions( char * _operands, char * _names ) {
+    char * p = _operands;
+    while( *p && *p != ';' && *p != '\r' && *p != '\n' ) {
+        if ( !timer_context_is_ident( *p ) ) {
+            ++p;
+            continue;
+        }
+        char * start = p;
+        while( timer_context_is_ident( *p ) ) ++p;
+        char * name = _names;
+        while( *name ) {
+            int l = 0;
+            while( name[l] && name[l] != ',' ) ++l;
+            if ( l == ( p - start ) && !strncasecmp( start, name, l ) ) {
+                return 1;
+            }
+            name += l;
+            if ( *name == ',' ) ++name;
+        }
+    }
+    return 0;
+}
+
+/* copy the first operand, and return 1 if there are more than one */
+static int timer_context_destination( char * _operands, char * _destination ) {
+    int k = 0;
+    while( _operands[k] && _operands[k] != ',' && _operands[k] != ';' && k < MAX_TEMPORARY_STORAGE - 1 ) {
+        _destination[k] = _operands[k];
+        ++k;
+    }
+    _destination[k] = 0;
+    return _operands[k] == ',';
+}
+
+/* 1 if the mnemonic is one of the (comma separated) names */
+static int timer_context_is( char * _mnemonic, char * _names ) {
+    char * name = _names;
+    int l = strlen( _mnemonic );
+    while( *name ) {
+        int k = 0;
+        while( name[k] && name[k] != ',' ) ++k;
+        if ( k == l && !strncasecmp( _mnemonic, name, l ) ) {
+            return 1;
+        }
+        name += k;
+        if ( *name == ',' ) ++name;
+    }
+    return 0;
+}
+
+/* 6502: the items are the pointers in zero page. */
+
+static int timer_context_flow_6502( char * _mnemonic, char * _operands ) {
+    if ( timer_context_is( _mnemonic, "JMP" ) && *_operands == '(' ) {
+        return 2;
+    }
+    if ( ( _mnemonic[0] == 'B' || _mnemonic[0] == 'b' ) && !timer_context_is( _mnemonic, "BIT,BRK" ) ) {
+        return 1;
+    }
+    return timer_context_is( _mnemonic, "JMP,JSR" );
+}
+
+static int timer_context_takes_6502( char * _mnemonic, char * _operands ) {
+    return *_operands == '#';
+}
+
+static int timer_context_ends_6502( char * _mnemonic, char * _operands ) {
+    return timer_context_is( _mnemonic, "RTS,RTI,JMP" );
+}
+
+static int timer_context_writes_6502( char * _mnemonic, char * _operands, char * _item ) {
+    int l = strlen( _item );
+    return timer_context_is( _mnemonic, "STA,STX,STY,INC,DEC,ASL,LSR,ROL,ROR" ) &&
+        !strncmp( _operands, _item, l ) && !timer_context_is_ident( _operands[l] );
+}
+
+/* 6809 / 6309: the items are the X index and the direct page. */
+
+static int timer_context_flow_6809( char * _mnemonic, char * _operands ) {
+    int flow = timer_context_is( _mnemonic, "JMP,JSR" ) ||
+        ( ( _mnemonic[0] == 'B' || _mnemonic[0] == 'b' ) && strncasecmp( _mnemonic, "BIT", 3 ) ) ||
+        !strncasecmp( _mnemonic, "LB", 2 );
+    if ( flow && ( strchr( _operands, ',' ) || *_operands == '[' ) ) {
+        return 2;
+    }
+    // software interrupts are calls into the ROM
+    return flow || !strncasecmp( _mnemonic, "SWI", 3 );
+}
+
+static int timer_context_takes_6809( char * _mnemonic, char * _operands ) {
+    return *_operands == '#' || !strncasecmp( _mnemonic, "LEA", 3 );
+}
+
+static int timer_context_ends_6809( char * _mnemonic, char * _operands ) {
+    return timer_context_is( _mnemonic, "RTS,RTI,JMP,BRA,LBRA" ) ||
+        ( timer_context_is( _mnemonic, "PULS,PULU" ) && timer_context_mentions( _operands, "PC" ) );
+}
+
+static int timer_context_writes_6809( char * _mnemonic, char * _operands, char * _item ) {
+    if ( timer_context_is( _mnemonic, "RTI" ) ) {
+        return 1;
+    }
+    if ( timer_context_is( _mnemonic, "TFR,EXG,PULS,PULU,ADDR,ADCR,SUBR,SBCR,ANDR,ORR,EORR" ) ) {
+        return timer_context_mentions( _operands, _item );
+    }
+    if ( strcasecmp( _item, "X" ) ) {
+        return 0;
+    }
+    if ( timer_context_is( _mnemonic, "LDX,LEAX,ABX" ) ) {
+        return 1;
+    }
+    // auto increment and decrement (",X+", ",--X", TFM "X+")
+    for( char * p = _operands; *p && *p != ';'; ++p ) {
+        if ( ( *p == 'X' || *p == 'x' ) && ( p[1] == '+' || ( p > _operands && p[-1] == '-' ) ) ) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Z80 / SM83: the item is the DE pair. */
+
+static char * timerContextKeywordsZ80[] = { "NZ", "Z", "NC", "C", "PO", "PE", "P", "M", NULL };
+
+static int timer_context_flow_z80( char * _mnemonic, char * _operands ) {
+    if ( timer_context_is( _mnemonic, "JP" ) && *_operands == '(' ) {
+        return 2;
+    }
+    return timer_context_is( _mnemonic, "JP,JR,CALL,DJNZ,RST" );
+}
+
+static int timer_context_takes_any( char * _mnemonic, char * _operands ) {
+    return 1;
+}
+
+static int timer_context_ends_z80( char * _mnemonic, char * _operands ) {
+    char * p = timer_context_code( _operands );
+    return ( timer_context_is( _mnemonic, "RET,RETI,RETN" ) && !p ) ||
+        ( timer_context_is( _mnemonic, "JP,JR" ) && p && !strchr( p, ',' ) );
+}
+
+static int timer_context_writes_z80( char * _mnemonic, char * _operands, char * _item ) {
+    char destination[MAX_TEMPORARY_STORAGE];
+    if ( timer_context_is( _mnemonic, "LDI,LDIR,LDD,LDDR,EXX" ) ) {
+        return 1;
+    }
+    if ( timer_context_is( _mnemonic, "PUSH,CP,OUT,BIT" ) ) {
+        return 0;
+    }
+    // these write just the first operand (or A, if there is only one)
+    if ( timer_context_is( _mnemonic, "LD,LDH,ADD,ADC,SBC,SUB,AND,OR,XOR" ) ) {
+        return timer_context_destination( _operands, destination ) && timer_context_mentions( destination, "DE,D,E" );
+    }
+    return timer_context_mentions( _operands, "DE,D,E" );
+}
+
+/* 8086: the item is the AX register. */
+
+static char * timerContextKeywords8086[] = { "SHORT", "NEAR", "FAR", "WORD", "PTR", NULL };
+
+static int timer_context_flow_8086( char * _mnemonic, char * _operands ) {
+    int flow = _mnemonic[0] == 'J' || _mnemonic[0] == 'j' || !strncasecmp( _mnemonic, "LOOP", 4 ) ||
+        timer_context_is( _mnemonic, "CALL,INT,INTO" );
+    if ( flow && strchr( _operands, '[' ) ) {
+        return 2;
+    }
+    return flow;
+}
+
+static int timer_context_ends_8086( char * _mnemonic, char * _operands ) {
+    return timer_context_is( _mnemonic, "RET,RETF,IRET,JMP" );
+}
+
+static int timer_context_writes_8086( char * _mnemonic, char * _operands, char * _item ) {
+    if ( timer_context_is( _mnemonic, "MUL,IMUL,DIV,IDIV,CBW,CWD,LODSB,LODSW,LODS,IN,XLAT,XLATB,LAHF,AAA,AAS,AAM,AAD,DAA,DAS,POPA" ) ||
+         !strncasecmp( _mnemonic, "REP", 3 ) ) {
+        return 1;
+    }
+    if ( timer_context_is( _mnemonic, "PUSH,CMP,TEST,OUT" ) ) {
+        return 0;
+    }
+    if ( timer_context_is( _mnemonic, "XCHG,XADD,CMPXCHG" ) ) {
+        return timer_context_mentions( _operands, "AX,AL,AH,EAX" );
+    }
+    // the destination is the first operand
+    char destination[MAX_TEMPORARY_STORAGE];
+    timer_context_destination( _operands, destination );
+    return timer_context_mentions( destination, "AX,AL,AH,EAX" );
+}
+
+static TimerContextCpu timerContext6502 = {
+    "JSR TIMERSETADDRESS", "LDA #<",
+    { "TMPPTR", "TMPPTR2", "PLOTDEST", "PLOTCDEST" },
+    1, 0, 0, 0, NULL,
+    timer_context_flow_6502, timer_context_takes_6502, timer_context_ends_6502, timer_context_writes_6502
+};
+
+static TimerContextCpu timerContext6809 = {
+    "JSR TIMERSETADDRESS", "LDD #",
+    { "X", "DP" },
+    0, 1, 0, 0, NULL,
+    timer_context_flow_6809, timer_context_takes_6809, timer_context_ends_6809, timer_context_writes_6809
+};
+
+static TimerContextCpu timerContextZ80 = {
+    "CALL TIMERSETADDRESS", "LD HL, ",
+    { "DE" },
+    1, 1, '(', ')', timerContextKeywordsZ80,
+    timer_context_flow_z80, timer_context_takes_any, timer_context_ends_z80, timer_context_writes_z80
+};
+
+static TimerContextCpu timerContext8086 = {
+    "CALL TIMERSETADDRESS", "MOV DX, ",
+    { "AX" },
+    1, 1, '[', ']', timerContextKeywords8086,
+    timer_context_flow_8086, timer_context_takes_any, timer_context_ends_8086, timer_context_writes_8086
+};
+
+static void optim_timer_context( Environment * _environment, TimerContextCpu * _cpu ) {
+
+    FILE * fileAsm = fopen( _environment->asmFileName, "rt" );
+    if(fileAsm == NULL) {
+        perror(_environment->asmFileName);
+        exit(-1);
+    }
+
+    POBuffer bufLine = TMP_BUF;
+
+    char ** lines = NULL;
+    int linesCount = 0;
+    int linesSize = 0;
+    int hasTimerManager = 0;
+
+    while( !feof(fileAsm) ) {
+        po_buf_fgets( bufLine, fileAsm );
+        if ( !bufLine->len && feof(fileAsm) ) {
+            break;
+        }
+        if ( linesCount == linesSize ) {
+            linesSize = linesSize ? linesSize * 2 : 4096;
+            lines = realloc( lines, linesSize * sizeof( char * ) );
+        }
+        if ( strstr( bufLine->str, "; TIMERSAVE " ) ) {
+            hasTimerManager = 1;
+        }
+        lines[linesCount++] = strdup( bufLine->str );
+    }
+
+    fclose( fileAsm );
+
+    if ( !hasTimerManager ) {
+        for( int i=0; i<linesCount; ++i ) {
+            free( lines[i] );
+        }
+        free( lines );
+        return;
+    }
+
+    // Collect the labels, as "NAME:" (or "NAME") starting at the first column.
+
+    TimerContextLabel * labels = malloc( ( linesCount + 1 ) * sizeof( TimerContextLabel ) );
+    int labelsCount = 0;
+
+    for( int i=0; i<linesCount; ++i ) {
+        char * p = lines[i];
+        if ( !timer_context_is_ident( *p ) ) {
+            continue;
+        }
+        while( timer_context_is_ident( *p ) ) ++p;
+        if ( _cpu->colon && *p != ':' ) {
+            continue;
+        }
+        labels[labelsCount].name = malloc( p - lines[i] + 1 );
+        memcpy( labels[labelsCount].name, lines[i], p - lines[i] );
+        labels[labelsCount].name[p - lines[i]] = 0;
+        labels[labelsCount].line = i;
+        ++labelsCount;
+    }
+
+    qsort( labels, labelsCount, sizeof( TimerContextLabel ), timer_context_label_cmp );
+
+    // The handlers are the addresses loaded just before a call
+    // to TIMERSETADDRESS (see the *_timer_set_address functions).
+
+    int * worklist = malloc( ( linesCount + 1 ) * sizeof( int ) );
+    int worklistCount = 0;
+    char * visited = calloc( linesCount + 1, 1 );
+    int written[TIMER_CONTEXT_ITEMS];
+    int everything = 0;
+    int setAddressLength = strlen( _cpu->setAddress );
+    int handlerLength = strlen( _cpu->handler );
+
+    memset( written, 0, sizeof( written ) );
+
+    for( int i=0; i<linesCount && !everything; ++i ) {
+        char * p = timer_context_code( lines[i] );
+        if ( !p || strncasecmp( p, _cpu->setAddress, setAddressLength ) ) {
+            continue;
+        }
+        int j, handler = -1;
+        for( j=i-1; j>=0 && j>=i-10 && !timer_context_is_ident( *lines[j] ); --j ) {
+            char * q = timer_context_code( lines[j] );
+            if ( q && !strncasecmp( q, _cpu->handler, handlerLength ) ) {
+                char name[MAX_TEMPORARY_STORAGE];
+                int k = 0;
+                q += handlerLength;
+                while( timer_context_is_ident( *q ) && k < MAX_TEMPORARY_STORAGE - 1 ) name[k++] = *q++;
+                name[k] = 0;
+                handler = timer_context_label_find( labels, labelsCount, name );
+                break;
+            }
+        }
+        if ( handler < 0 ) {
+            everything = 1;
+        } else if ( !visited[handler] ) {
+            visited[handler] = 1;
+            worklist[worklistCount++] = handler;
+        }
+    }
+
+    // Walk the code reachable from the handlers, following the jumps and
+    // the addresses taken as immediates, until the flow leaves the routine.
+
+    while( worklistCount && !everything ) {
+
+        int i = worklist[--worklistCount];
+
+        for( ; i<linesCount && !everything; ++i ) {
+
+            // skip the label, if any, and look at the code on the same line
+            char * p = lines[i];
+            if ( timer_context_is_ident( *p ) ) {
+                while( timer_context_is_ident( *p ) ) ++p;
+                if ( *p == ':' ) ++p;
+            }
+            p = timer_context_code( p );
+            if ( !p || *p == '.' || *p == '@' ) {
+                continue;
+            }
+
+            char mnemonic[8];
+            int k = 0;
+            while( timer_context_is_ident( *p ) && k < 7 ) mnemonic[k++] = *p++;
+            mnemonic[k] = 0;
+            if ( !k || timer_context_is_ident( *p ) ) {
+                continue;
+            }
+            while( *p == ' ' || *p == '\t' ) ++p;
+
+            char * operands = p;
+            int flow = _cpu->flow( mnemonic, operands );
+
+            if ( flow > 1 ) {
+                everything = 1;
+                break;
+            }
+
+            for( k=0; k<TIMER_CONTEXT_ITEMS && _cpu->items[k]; ++k ) {
+                if ( _cpu->writes( mnemonic, operands, _cpu->items[k] ) ) {
+                    written[k] = 1;
+                }
+            }
+
+            if ( !flow && !_cpu->takes( mnemonic, operands ) ) {
+                p = "";
+            }
+
+            int targets = 0;
+            int memory = 0;
+
+            while( *p && *p != ';' ) {
+                if ( _cpu->memory && *p == _cpu->memory ) {
+                    ++memory;
+                }
+                if ( _cpu->memoryEnd && *p == _cpu->memoryEnd && memory ) {
+                    --memory;
+                }
+                if ( *p == '\'' || *p == '"' ) {
+                    char quote = *p++;
+                    while( *p && *p != quote ) ++p;
+                    if ( *p ) ++p;
+                    continue;
+                }
+                if ( !timer_context_is_ident( *p ) || ( *p >= '0' && *p <= '9' ) ) {
+                    if ( *p == '$' || *p == '%' || ( *p >= '0' && *p <= '9' ) ) {
+                        ++p;
+                        while( timer_context_is_ident( *p ) ) ++p;
+                    } else {
+                        ++p;
+                    }
+                    continue;
+                }
+                char * start = p;
+                while( timer_context_is_ident( *p ) ) ++p;
+                if ( memory && !flow ) {
+                    continue;
+                }
+                char name[MAX_TEMPORARY_STORAGE];
+                int l = ( p - start ) < MAX_TEMPORARY_STORAGE - 1 ? ( p - start ) : MAX_TEMPORARY_STORAGE - 1;
+                memcpy( name, start, l );
+                name[l] = 0;
+                if ( flow && _cpu->keywords ) {
+                    int m;
+                    for( m=0; _cpu->keywords[m] && strcasecmp( _cpu->keywords[m], name ); ++m ) ;
+                    if ( _cpu->keywords[m] ) {
+                        continue;
+                    }
+                }
+                int target = timer_context_label_find( labels, labelsCount, name );
+                if ( target >= 0 ) {
+                    ++targets;
+                    if ( !visited[target] ) {
+                        visited[target] = 1;
+                        worklist[worklistCount++] = target;
+                    }
+                } else if ( flow ) {
+                    everything = 1;
+                    break;
+                }
+            }
+
+            // a call to a fixed address (ROM) can write any register
+            if ( flow && !targets && _cpu->registers ) {
+                everything = 1;
+            }
+
+            if ( _cpu->ends( mnemonic, operands ) ) {
+                break;
+            }
+
+        }
+
+    }
+
+    // Rewrite the file, dropping the groups that are not needed.
+
+    char fileNameOptimized[MAX_TEMPORARY_STORAGE];
+    FILE * fileOptimized;
+
+    sprintf( fileNameOptimized, "%s.asm", get_temporary_filename( _environment ) );
+
+    fileOptimized = fopen( fileNameOptimized, "wt" );
+    if(fileOptimized == NULL) {
+        perror(fileNameOptimized);
+        exit(-1);
+    }
+
+    int skipping = 0;
+
+    for( int i=0; i<linesCount; ++i ) {
+        char * p = timer_context_code( lines[i] );
+        if ( !p ) {
+            p = lines[i];
+            while( *p == ' ' || *p == '\t' ) ++p;
+        }
+        if ( !strncmp( p, "; TIMERSAVEEND", 14 ) ) {
+            skipping = 0;
+        } else if ( !strncmp( p, "; TIMERSAVE ", 12 ) ) {
+            for( int k=0; k<TIMER_CONTEXT_ITEMS && _cpu->items[k] && !everything; ++k ) {
+                int l = strlen( _cpu->items[k] );
+                if ( !strncmp( p + 12, _cpu->items[k], l ) && !timer_context_is_ident( p[12+l] ) ) {
+                    skipping = !written[k];
+                }
+            }
+        } else if ( !skipping ) {
+            fputs( lines[i], fileOptimized );
+        }
+        free( lines[i] );
+    }
+
+    fclose( fileOptimized );
+
+    for( int i=0; i<labelsCount; ++i ) {
+        free( labels[i].name );
+    }
+    free( labels );
+    free( worklist );
+    free( visited );
+    free( lines );
+
+    /* makes our generated file the new asm file */
+    remove(_environment->asmFileName);
+    BUILD_SAFE_MOVE( _environment, fileNameOptimized, _environment->asmFileName );
+
+}
+
+void optim_timer_context_6502( Environment * _environment ) {
+    optim_timer_context( _environment, &timerContext6502 );
+}
+
+void optim_timer_context_6809( Environment * _environment ) {
+    optim_timer_context( _environment, &timerContext6809 );
+}
+
+void optim_timer_context_z80( Environment * _environment ) {
+    optim_timer_context( _environment, &timerContextZ80 );
+}
+
+void optim_timer_context_8086( Environment * _environment ) {
+    optim_timer_context( _environment, &timerContext8086 );
+}
+
+/****************************************************************************
+ * CYCLES AND HOT SPOTS
+ ****************************************************************************/
+
+/* While target_finalize() walks the final assembly, each instruction is
+   costed with the static cycle table of the CPU (cpu_instruction_cycles) and
+   the cost is charged to the BASIC line that produced it. A branch back to
+   a label already seen closes a loop: the cycles between the label and the
+   branch are the cost of one iteration, charged to the line that holds the
+   label (the FOR, DO, WHILE...). At the end, one "AC" record is written for
+   each line, followed by the hot spots ("AH"), sorted by weight. Timings
+   are static: branches are counted as not taken, and calls do not include
+   the called routine. */
+
+#define HOTSPOT_LABELS_HASH         1024
+#define HOTSPOT_LOOP_WEIGHT         16
+#define HOTSPOT_REPORT_COUNT        20
+
+typedef struct _HotSpotLabel {
+    char * name;
+    int line;
+    int cycles;
+    struct _HotSpotLabel * next;
+} HotSpotLabel;
+
+typedef struct _HotSpotLine {
+    int line;
+    int cycles;
+    int loopCycles;
+} HotSpotLine;
+
+static HotSpotLabel * hotSpotLabels[HOTSPOT_LABELS_HASH];
+static HotSpotLine * hotSpotLines = NULL;
+static int hotSpotLinesCount = 0;
+static int hotSpotLinesSize = 0;
+static int hotSpotCycles = 0;
+
+static unsigned int hotspot_hash( char * _name ) {
+    unsigned int hash = 5381;
+    while( *_name ) {
+        hash = ( ( hash << 5 ) + hash ) + (unsigned char)*_name++;
+    }
+    return hash % HOTSPOT_LABELS_HASH;
+}
+
+static HotSpotLabel * hotspot_label_find( char * _name ) {
+    HotSpotLabel * label = hotSpotLabels[hotspot_hash( _name )];
+    while( label ) {
+        if ( !strcmp( label->name, _name ) ) {
+            return label;
+        }
+        label = label->next;
+    }
+    return NULL;
+}
+
+static HotSpotLine * hotspot_line( int _line ) {
+    for( int i=hotSpotLinesCount-1; i>=0; --i ) {
+        if ( hotSpotLines[i].line == _line ) {
+            return &hotSpotLines[i];
+        }
+    }
+    if ( hotSpotLinesCount == hotSpotLinesSize ) {
+        hotSpotLinesSize = hotSpotLinesSize ? hotSpotLinesSize * 2 : 256;
+        hotSpotLines = realloc( hotSpotLines, hotSpotLinesSize * sizeof( HotSpotLine ) );
+    }
+    HotSpotLine * line = &hotSpotLines[hotSpotLinesCount++];
+    memset( line, 0, sizeof( HotSpotLine ) );
+    line->line = _line;
+    return line;
+}
+
+static int hotspot_weight( HotSpotLine * _line ) {
+    return _line->cycles + HOTSPOT_LOOP_WEIGHT * _line->loopCycles;
+}
+
+static int hotspot_compare( const void * _a, const void * _b ) {
+    int a = hotspot_weight( (HotSpotLine *)_a );
+    int b = hotspot_weight( (HotSpotLine *)_b );
+    if ( a != b ) {
+        return b - a;
+    }
+    return ((HotSpotLine *)_a)->line - ((HotSpotLine *)_b)->line;
+}
+
+/* look up a cycle table (see cpu_instruction_cycles): if the instruction
+   does not have the given addressing mode, the first one available is used */
+int instruction_cycles( InstructionCycles * _table, char * _mnemonic, int _mode, int * _branch ) {
+
+    for( int i=0; _table[i].mnemonic; ++i ) {
+        if ( !strcasecmp( _table[i].mnemonic, _mnemonic ) ) {
+            *_branch = _table[i].branch;
+            if ( _mode >= 0 && _mode < INSTRUCTION_CYCLES_MODES && _table[i].cycles[_mode] >= 0 ) {
+                return _table[i].cycles[_mode];
+            }
+            for( int j=0; j<INSTRUCTION_CYCLES_MODES; ++j ) {
+                if ( _table[i].cycles[j] > 0 ) {
+                    return _table[i].cycles[j];
+                }
+            }
+            return 0;
+        }
+    }
+
+    return 0;
+
+}
+
+void hotspot_begin( Environment * _environment ) {
+
+    memset( hotSpotLabels, 0, sizeof( hotSpotLabels ) );
+    hotSpotLinesCount = 0;
+    hotSpotCycles = 0;
+
+}
+
+/* _line is the trimmed assembly line, _label is true if it started at column 0 */
+void hotspot_instruction( Environment * _environment, int _sourceLine, char * _line, int _label ) {
+
+    char mnemonic[MAX_TEMPORARY_STORAGE];
+    char * operands = _line;
+    int i = 0;
+
+    if ( !*_line || *_line == ';' ) {
+        return;
+    }
+
+    while( *operands && *operands != ' ' && *operands != '\t' && i < MAX_TEMPORARY_STORAGE - 1 ) {
+        mnemonic[i++] = *operands++;
+    }
+    mnemonic[i] = 0;
+
+    if ( _label || mnemonic[i-1] == ':' ) {
+        if ( mnemonic[i-1] == ':' ) {
+            mnemonic[i-1] = 0;
+        }
+        if ( mnemonic[0] && mnemonic[0] != '.' ) {
+            // local labels can be redefined: a branch refers to the last one
+            HotSpotLabel * label = hotspot_label_find( mnemonic );
+            if ( ! label ) {
+                label = malloc( sizeof( HotSpotLabel ) );
+                label->name = strdup( mnemonic );
+                unsigned int hash = hotspot_hash( mnemonic );
+                label->next = hotSpotLabels[hash];
+                hotSpotLabels[hash] = label;
+            }
+            label->line = _sourceLine;
+            label->cycles = hotSpotCycles;
+        }
+        return;
+    }
+
+    while( *operands == ' ' || *operands == '\t' ) {
+        ++operands;
+    }
+
+    int branch = 0;
+    int cycles = cpu_instruction_cycles( _environment, mnemonic, operands, &branch );
+
+    hotSpotCycles += cycles;
+    hotspot_line( _sourceLine )->cycles += cycles;
+
+    if ( branch ) {
+        // the target is the last operand (JP NZ, label / BNE label / DJNZ label)
+        char * target = strrchr( operands, ',' );
+        target = target ? target + 1 : operands;
+        while( *target == ' ' ) {
+            ++target;
+        }
+        char name[MAX_TEMPORARY_STORAGE];
+        for( i=0; target[i] && target[i] != ' ' && target[i] != '\t' && target[i] != ';' && i < MAX_TEMPORARY_STORAGE - 1; ++i ) {
+            name[i] = target[i];
+        }
+        name[i] = 0;
+        HotSpotLabel * label = hotspot_label_find( name );
+        if ( label && label->line ) {
+            HotSpotLine * line = hotspot_line( label->line );
+            int loopCycles = hotSpotCycles - label->cycles;
+            if ( loopCycles > line->loopCycles ) {
+                line->loopCycles = loopCycles;
+            }
+        }
+    }
+
+}
+
+void hotspot_end( Environment * _environment ) {
+
+    for( int i=0; i<hotSpotLinesCount; ++i ) {
+        adiline3( "AC:0:%d:%d:%d", hotSpotLines[i].line, hotSpotLines[i].cycles, hotSpotLines[i].loopCycles );
+    }
+
+    qsort( hotSpotLines, hotSpotLinesCount, sizeof( HotSpotLine ), hotspot_compare );
+
+    if ( _environment->embeddedStatsEnabled ) {
+        printf( "Hot spots (static cycles, loop body cycles):\n");
+    }
+
+    for( int i=0, rank=0; i<hotSpotLinesCount && rank<HOTSPOT_REPORT_COUNT; ++i ) {
+        // line 0 is the runtime (startup and library)
+        if ( !hotSpotLines[i].line ) {
+            continue;
+        }
+        ++rank;
+        adiline4( "AH:0:%d:%d:%d:%d", rank, hotSpotLines[i].line, hotSpotLines[i].cycles, hotSpotLines[i].loopCycles );
+        if ( _environment->embeddedStatsEnabled ) {
+            printf( "%d. line %d:\t%d\t%d\n", rank, hotSpotLines[i].line, hotSpotLines[i].cycles, hotSpotLines[i].loopCycles );
+        }
+    }
+
+    for( int i=0; i<HOTSPOT_LABELS_HASH; ++i ) {
+        HotSpotLabel * label = hotSpotLabels[i];
+        while( label ) {
+            HotSpotLabel * next = label->next;
+            free( label->name );
+            free( label );
+            label = next;
+        }
+        hotSpotLabels[i] = NULL;
+    }
+
+    free( hotSpotLines );
+    hotSpotLines = NULL;
+    hotSpotLinesCount = 0;
+    hotSpotLinesSize = 0;
+
+}
@@ -55,6 +55,9 @@ void variable_on_memory_init( Environment * _environment, int _imported_too ) {
                 case VT_DSTRING:
                 case VT_MSPRITE:
                 case VT_SPRITE:
+                case VT_BCD4:
+                case VT_BCD6:
+                case VT_BCD8:
                 case VT_DOJOKA:
                 case VT_TILESET:
                 case VT_TILES:
@@ -91,6 +94,9 @@ void variable_on_memory_init( Environment * _environment, int _imported_too ) {
                 case VT_STRING:
                 case VT_DSTRING:
                 case VT_MSPRITE:
+                case VT_BCD4:
+                case VT_BCD6:
+                case VT_BCD8:
                 case VT_DOJOKA:
                 case VT_TILESET:
                 case VT_TILES:
@@ -0,0 +1,342 @@
+/*****************************************************************************
+ * ugBASIC - an isomorphic BASIC language compiler for retrocomputers        *
+ *****************************************************************************
+ * Copyright 2021-2025 Marco Spedaletti (asimov@mclink.it)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *----------------------------------------------------------------------------
+ * Concesso in licenza secondo i termini della Licenza Apache, versione 2.0
+ * (la "Licenza"); è proibito usare questo file se non in conformità alla
+ * Licenza. Una copia della Licenza è disponibile all'indirizzo:
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Se non richiesto dalla legislazione vigente o concordato per iscritto,
+ * il software distribuito nei termini della Licenza è distribuito
+ * "COSÌ COM'È", SENZA GARANZIE O CONDIZIONI DI ALCUN TIPO, esplicite o
+ * implicite. Consultare la Licenza per il testo specifico che regola le
+ * autorizzazioni e le limitazioni previste dalla medesima.
+ ****************************************************************************/
+
+/****************************************************************************
+ * INCLUDE SECTION
+ ****************************************************************************/
+
+#include "../../ugbc.h"
+
+/****************************************************************************
+ * CODE SECTION
+ ****************************************************************************/
+
+/*
+ * Inside a FOR loop, each access to an array indexed by the loop index
+ * (like "a(i)") calculates the address of the element from the beginning:
+ * index, multiplied by the size of the element, plus the address of the
+ * array. Since the index only changes by the (constant) step, the address
+ * can be kept on a resident variable and moved forward by step * size at
+ * each NEXT.
+ *
+ * The walks follow the loops opened by FOR and closed by NEXT: the first
+ * access to an array indexed by the index of an open loop adds the array
+ * to the walks of that loop. The addresses are calculated by a subroutine
+ * ("...walk"), that is called by FOR just after the index has been set,
+ * and emitted by NEXT when all the walks are known. The same subroutine
+ * is called again whenever the index could have been changed by something
+ * else than NEXT:
+ *
+ *  - a statement writes the index (see variable_array_walk_written());
+ *  - a label is defined, some code is called (GOSUB, procedures, SYS...)
+ *    or the memory is written (POKE, ASM) (see
+ *    variable_array_walk_invalidate()).
+ *
+ * The call is emitted before the next access to a walked array, or at
+ * the end of the statement (see variable_array_walk_sync()). If the index
+ * could have been changed before the first access, the loop does not
+ * walk any array.
+ *
+ * Only FOR loops are walked, since DO...LOOP, REPEAT...UNTIL and
+ * WHILE...WEND have no index to follow, and only arrays with a single
+ * dimension of 16 or 32 bit elements. Expressions that do not change
+ * inside the loop are not moved outside it. Handlers called by the
+ * interrupts (EVERY, ...) must not write the index of a walking loop.
+ */
+
+static int array_walk_step_value( Loop * _loop, int * _step ) {
+
+    if ( _loop->statical || ! _loop->step ) {
+        *_step = 1;
+        return 1;
+    }
+
+    if ( _loop->step->initializedByConstant ) {
+        *_step = _loop->step->value;
+        return 1;
+    }
+
+    return 0;
+
+}
+
+/**
+ * @brief Call the calculation of the arrays walked by the current FOR loop
+ *
+ * This function must be called just after the index has been set to
+ * its starting value, before the beginning of the loop. If the loop
+ * can walk arrays, the subroutine that calculates their addresses
+ * is called (see variable_array_walk_end()).
+ *
+ * @param _environment Current calling environment
+ */
+void variable_array_walk_begin( Environment * _environment ) {
+
+    Loop * loop = _environment->loops;
+
+    int step;
+
+    loop->walkSync = 0;
+
+    if ( _environment->checkBoundary || loop->type != LT_FOR ) {
+        return;
+    }
+
+    if ( _environment->procedureName && _environment->protothread ) {
+        return;
+    }
+
+    if ( ! array_walk_step_value( loop, &step ) ) {
+        return;
+    }
+
+    if ( VT_BITWIDTH( loop->index->type ) != 8 && VT_BITWIDTH( loop->index->type ) != 16 ) {
+        return;
+    }
+
+    char walkLabel[MAX_TEMPORARY_STORAGE]; sprintf( walkLabel, "%swalk", loop->label );
+
+    loop->walkable = 1;
+    loop->walkBuffer = _environment->currentBufferOutput;
+
+    cpu_call( _environment, walkLabel );
+
+}
+
+/**
+ * @brief Emit the calculation of the arrays walked by the current FOR loop
+ *
+ * This function must be called on NEXT, where the code cannot be reached
+ * without a jump: it emits the subroutine that calculates the address
+ * of each walked array from the current value of the index.
+ *
+ * @param _environment Current calling environment
+ */
+void variable_array_walk_end( Environment * _environment ) {
+
+    Loop * loop = _environment->loops;
+
+    if ( ! loop->walkable ) {
+        return;
+    }
+
+    char walkLabel[MAX_TEMPORARY_STORAGE]; sprintf( walkLabel, "%swalk", loop->label );
+
+    cpu_label( _environment, walkLabel );
+
+    // The subroutine is called from other statements, so it cannot
+    // use temporary variables.
+    ArrayWalk * walk = loop->walks;
+    while( walk ) {
+        Variable * array = variable_retrieve( _environment, walk->name );
+        if ( VT_BITWIDTH( loop->index->type ) == 16 ) {
+            cpu_move_16bit( _environment, loop->index->realName, walk->pointer->realName );
+        } else if ( VT_SIGNED( loop->index->type ) ) {
+            cpu_move_8bit_signed_16bit_unsigned( _environment, loop->index->realName, walk->pointer->realName );
+        } else {
+            cpu_move_8bit_unsigned_16bit_unsigned( _environment, loop->index->realName, walk->pointer->realName );
+        }
+        cpu_math_mul2_const_16bit( _environment, walk->pointer->realName, walk->size == 2 ? 1 : 2, 0 );
+        cpu_math_add_16bit_with_16bit( _environment, walk->pointer->realName, array->realName, walk->pointer->realName );
+        walk = walk->next;
+    }
+
+    cpu_return( _environment );
+
+}
+
+/**
+ * @brief Move the address of the arrays walked by the current FOR loop
+ *
+ * This function must be called just after the step has been added to
+ * the index, on NEXT.
+ *
+ * @param _environment Current calling environment
+ */
+void variable_array_walk_step( Environment * _environment ) {
+
+    Loop * loop = _environment->loops;
+
+    int step;
+
+    if ( ! loop->walks || ! array_walk_step_value( loop, &step ) ) {
+        return;
+    }
+
+    ArrayWalk * walk = loop->walks;
+    while( walk ) {
+        variable_add_inplace( _environment, walk->pointer->name, step * walk->size );
+        walk = walk->next;
+    }
+
+}
+
+static void array_walk_sync( Environment * _environment, Loop * _loop ) {
+
+    char walkLabel[MAX_TEMPORARY_STORAGE]; sprintf( walkLabel, "%swalk", _loop->label );
+
+    cpu_call( _environment, walkLabel );
+
+    _loop->walkSync = 0;
+
+}
+
+/**
+ * @brief Find the address of the element of an array, if walked by a loop
+ *
+ * The address can be used in place of the usual calculation only if the
+ * (only) index of the array is the index of an open FOR loop. The first
+ * access adds the array to the walks of the loop, if the index has not
+ * been changed since the FOR.
+ *
+ * @param _environment Current calling environment
+ * @param _array Array to access
+ * @return ArrayWalk* The walk with the address of the element, or NULL
+ */
+ArrayWalk * variable_array_walk_find( Environment * _environment, Variable * _array ) {
+
+    if ( _environment->checkBoundary || _environment->arrayIndexes[_environment->arrayNestedIndex] != 1 ) {
+        return NULL;
+    }
+
+    char * index = _environment->arrayIndexesEach[_environment->arrayNestedIndex][0];
+
+    if ( ! index ) {
+        return NULL;
+    }
+
+    Loop * loop = _environment->loops;
+    while( loop ) {
+        if ( loop->index && !strcmp( loop->index->name, index ) ) {
+            break;
+        }
+        loop = loop->next;
+    }
+
+    if ( ! loop || ! loop->walkable || loop->walkBuffer != _environment->currentBufferOutput ) {
+        return NULL;
+    }
+
+    ArrayWalk * walk = loop->walks;
+    while( walk ) {
+        if ( !strcmp( walk->name, _array->name ) ) {
+            break;
+        }
+        walk = walk->next;
+    }
+
+    if ( ! walk ) {
+
+        if ( loop->walkSync ) {
+            return NULL;
+        }
+
+        if ( _array->type != VT_TARRAY || _array->arrayDimensions != 1 || _array->bankAssigned != -1 ||
+            ( VT_BITWIDTH( _array->arrayType ) != 16 && VT_BITWIDTH( _array->arrayType ) != 32 ) ) {
+            return NULL;
+        }
+
+        walk = malloc( sizeof( ArrayWalk ) );
+        memset( walk, 0, sizeof( ArrayWalk ) );
+        walk->name = strdup( _array->name );
+        walk->size = VT_BITWIDTH( _array->arrayType ) >> 3;
+        walk->pointer = variable_resident( _environment, VT_WORD, "(array walk)" );
+        walk->pointer->locked = 1;
+
+        walk->next = loop->walks;
+        loop->walks = walk;
+
+    }
+
+    if ( loop->walkSync ) {
+        array_walk_sync( _environment, loop );
+    }
+
+    return walk;
+
+}
+
+/**
+ * @brief Take note that a variable has been written
+ *
+ * If the variable is the index of an open FOR loop, the addresses of
+ * the walked arrays must be calculated again.
+ *
+ * @param _environment Current calling environment
+ * @param _name Name of the variable written
+ */
+void variable_array_walk_written( Environment * _environment, char * _name ) {
+
+    Loop * loop = _environment->loops;
+    while( loop ) {
+        if ( loop->index && !strcmp( loop->index->name, _name ) ) {
+            loop->walkSync = 1;
+        }
+        loop = loop->next;
+    }
+
+}
+
+/**
+ * @brief Take note that any variable could have been written
+ *
+ * The addresses of the arrays walked by all the open FOR loops must be
+ * calculated again.
+ *
+ * @param _environment Current calling environment
+ */
+void variable_array_walk_invalidate( Environment * _environment ) {
+
+    Loop * loop = _environment->loops;
+    while( loop ) {
+        loop->walkSync = 1;
+        loop = loop->next;
+    }
+
+}
+
+/**
+ * @brief Calculate again the walked arrays, if needed
+ *
+ * This function must be called at the end of each statement.
+ *
+ * @param _environment Current calling environment
+ */
+void variable_array_walk_sync( Environment * _environment ) {
+
+    Loop * loop = _environment->loops;
+    while( loop ) {
+        if ( loop->walks && loop->walkSync ) {
+            array_walk_sync( _environment, loop );
+        }
+        loop = loop->next;
+    }
+
+}
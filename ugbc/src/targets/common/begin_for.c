@@ -325,6 +325,8 @@ void begin_for_identifier( Environment * _environment, char * _index ) {
 
     variable_move( _environment, loop->fromResident->name, index->name );
 
+    variable_array_walk_begin( _environment );
+
     cpu_label( _environment, beginFor );
 
     if ( !loop->step || loop->step->initializedByConstant ) {
@@ -489,6 +491,8 @@ void begin_for( Environment * _environment, char * _index, char * _from, char *
 
     variable_move( _environment, from->name, index->name );
 
+    variable_array_walk_begin( _environment );
+
     unsigned char beginFor[MAX_TEMPORARY_STORAGE]; sprintf(beginFor, "%sbf", loop->label );
     unsigned char endFor[MAX_TEMPORARY_STORAGE]; sprintf(endFor, "%sbis", loop->label );
 
@@ -112,6 +112,9 @@ un parametro, i parametri devono essere separate da virgole.
 </usermanual> */
 void begin_procedure( Environment * _environment, char * _name ) {
 
+    int inlineRequested = _environment->inlineProcedure;
+    _environment->inlineProcedure = 0;
+
     if ( _environment->emptyProcedure ) {
         return;
     }
@@ -140,6 +143,7 @@ void begin_procedure( Environment * _environment, char * _name ) {
 
     procedure->parameters = _environment->parameters;
     procedure->protothread = _environment->protothread;
+    procedure->inlineRequested = inlineRequested;
     _environment->protothreadStep = 0;
 
     memcpy( &procedure->parametersEach, &_environment->parametersEach, sizeof( char * ) * _environment->parameters );
@@ -151,14 +155,26 @@ void begin_procedure( Environment * _environment, char * _name ) {
 
     _environment->procedureName = strdup( _name );
     _environment->procedureVariables = NULL;
+    _environment->procedureOptimizeMode = OPTIMIZE_MODE_DEFAULT;
     ++_environment->currentProcedure;
 
     char procedureAfterLabel[MAX_TEMPORARY_STORAGE]; sprintf(procedureAfterLabel, "%safter", _environment->procedureName );
 
+    // remember where the procedure starts, to expand it inline (if possible)
+    _environment->procedureInlineBlocked = 0;
+    _environment->procedureCalls = 0;
+    _environment->procedureBufferLevel = _environment->currentBufferOutput;
+    _environment->procedureStart = _environment->bufferOutputSize[_environment->currentBufferOutput];
+
+    // the procedure can be called from everywhere
+    if_then_dead_keep( _environment );
+
     cpu_jump( _environment, procedureAfterLabel  );
 
     cpu_label( _environment, procedure->realName );
 
+    _environment->procedureBodyStart = _environment->bufferOutputSize[_environment->currentBufferOutput];
+
     if ( procedure->protothread ) {
         _environment->anyProtothread = 1;
         char procedureParallelDispatch[MAX_TEMPORARY_STORAGE]; sprintf(procedureParallelDispatch, "%sdispatch", _environment->procedureName );
@@ -142,6 +142,10 @@ void call_procedure( Environment * _environment, char * _name ) {
         return;
     }
 
+    // The procedure can change any (global) variable.
+    value_record_reset( _environment );
+    variable_array_walk_invalidate( _environment );
+
     Procedure * procedure = _environment->procedures;
 
     while( procedure ) {
@@ -209,6 +213,11 @@ void call_procedure( Environment * _environment, char * _name ) {
             CRITICAL_PROCEDURE_PARAMETERS_MISMATCH(_name, procedure->parameters, _environment->parameters );
         }
 
+        if ( procedure->inlineBody && !_environment->optionCallAsGoto ) {
+            procedure_inline( _environment, procedure );
+            return;
+        }
+
         int i=0;
         for( i=0; i<procedure->parameters; ++i ) {
             if ( _environment->parametersEach[i] ) {
@@ -222,6 +231,11 @@ void call_procedure( Environment * _environment, char * _name ) {
                 variable_store( _environment, parameter->name, _environment->parametersValueEach[i] );
             }
         }
+
+        if ( _environment->procedureName ) {
+            _environment->procedureCalls = 1;
+        }
+
         _environment->parameters = 0;
 
         if ( _environment->optionCallAsGoto ) {
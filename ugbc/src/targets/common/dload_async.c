@@ -0,0 +1,75 @@
+/*****************************************************************************
+ * ugBASIC - an isomorphic BASIC language compiler for retrocomputers        *
+ *****************************************************************************
+ * Copyright 2021-2025 Marco Spedaletti (asimov@mclink.it)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *----------------------------------------------------------------------------
+ * Concesso in licenza secondo i termini della Licenza Apache, versione 2.0
+ * (la "Licenza"); è proibito usare questo file se non in conformità alla
+ * Licenza. Una copia della Licenza è disponibile all'indirizzo:
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Se non richiesto dalla legislazione vigente o concordato per iscritto,
+ * il software distribuito nei termini della Licenza è distribuito
+ * "COSÌ COM'È", SENZA GARANZIE O CONDIZIONI DI ALCUN TIPO, esplicite o
+ * implicite. Consultare la Licenza per il testo specifico che regola le
+ * autorizzazioni e le limitazioni previste dalla medesima.
+ ****************************************************************************/
+
+/****************************************************************************
+ * INCLUDE SECTION 
+ ****************************************************************************/
+
+#include "../../ugbc.h"
+
+/****************************************************************************
+ * CODE SECTION 
+ ****************************************************************************/
+
+#if !defined(__c64__)
+
+/**
+ * @brief Emit code for <strong>DLOAD ASYNC ...</strong>
+ * 
+ * On this target there is no way to load in background,
+ * so the file is loaded at once.
+ * 
+ * @param _environment Current calling environment
+ * @param _filename Filename to read
+ * @param _address Address where to load the file (NULL = default)
+ */
+void dload_async( Environment * _environment, char * _filename, char * _address ) {
+
+    dload( _environment, _filename, NULL, _address, NULL, NULL );
+
+}
+
+/**
+ * @brief Emit code for <strong>DLOAD READY</strong>
+ * 
+ * @param _environment Current calling environment
+ * @return TRUE, since DLOAD ASYNC always completes immediately
+ */
+Variable * dload_ready( Environment * _environment ) {
+
+    Variable * result = variable_temporary( _environment, VT_SBYTE, "(dload ready)" );
+
+    variable_store( _environment, result->name, 0xff );
+
+    return result;
+
+}
+
+#endif
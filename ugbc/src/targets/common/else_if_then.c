@@ -62,6 +62,21 @@ void else_if_then_label( Environment * _environment ) {
     char endifLabel[MAX_TEMPORARY_STORAGE]; sprintf(endifLabel, "%sf", conditional->label );
     char elseLabel[MAX_TEMPORARY_STORAGE]; sprintf(elseLabel, "%se%d", conditional->label, conditional->index );
 
+    // The branch just ended had a false condition: if it has been 
+    // removed, the next one follows directly.
+    if ( conditional->dead && ! conditional->taken ) {
+        if ( if_then_dead_end( _environment, conditional ) ) {
+            cpu_label( _environment, elseLabel );
+            return;
+        }
+    }
+
+    // The branch just ended is executed for sure: all the next 
+    // ones are dead, up to the ENDIF.
+    if ( conditional->taken && ! conditional->dead ) {
+        if_then_dead_begin( _environment, conditional );
+    }
+
     cpu_jump( _environment, endifLabel );
 
     cpu_label( _environment, elseLabel );
@@ -109,7 +124,18 @@ void else_if_then( Environment * _environment, char * _expression ) {
         conditional->expression = variable_cast( _environment, expression->name, expression->type );
         conditional->expression->locked = 1;
 
-        cpu_bveq( _environment, expression->realName, elseLabel );
+        if ( conditional->dead ) {
+            // a previous branch is executed for sure: nothing to test
+        } else if ( expression->initializedByConstant && VT_BITWIDTH( expression->type ) >= 8 ) {
+            if ( expression->value ) {
+                conditional->taken = 1;
+            } else {
+                if_then_dead_begin( _environment, conditional );
+                cpu_jump( _environment, elseLabel );
+            }
+        } else {
+            cpu_bveq( _environment, expression->realName, elseLabel );
+        }
 
     }
     
@@ -106,6 +106,8 @@ void end_for( Environment * _environment ) {
             variable_add_inplace_vars( _environment, loop->index->name, step->name );
         }
 
+        variable_array_walk_step( _environment );
+
         if ( !VT_SIGNED( loop->index->type ) ) {
             variable_compare_and_branch_const( _environment, loop->index->name, 0, endFor, 1 );
         }
@@ -164,6 +166,8 @@ void end_for( Environment * _environment ) {
     
     cpu_jump( _environment, beginFor );
 
+    variable_array_walk_end( _environment );
+
     cpu_label( _environment, endFor );
 
     if ( loop->to ) {
@@ -187,6 +191,11 @@ void end_for( Environment * _environment ) {
     if ( loop->stepResident ) {
         loop->stepResident->locked = 0;
     }
+    ArrayWalk * walk = loop->walks;
+    while( walk ) {
+        walk->pointer->locked = 0;
+        walk = walk->next;
+    }
 
     _environment->loops = _environment->loops->next;
 
@@ -62,6 +62,10 @@ void end_if_then( Environment * _environment ) {
     char elseLabel[MAX_TEMPORARY_STORAGE]; sprintf(elseLabel, "%se%d", conditional->label, conditional->index );
     char endifLabel[MAX_TEMPORARY_STORAGE]; sprintf(endifLabel, "%sf", conditional->label );
 
+    if ( conditional->dead ) {
+        if_then_dead_end( _environment, conditional );
+    }
+
     cpu_label( _environment, endifLabel );
     cpu_label( _environment, elseLabel );
 
@@ -91,6 +91,8 @@ void end_procedure( Environment * _environment, char * _value ) {
         variable_move( _environment, value->name, param->name );
     }
 
+    int bodyEnd = _environment->bufferOutputSize[_environment->currentBufferOutput];
+
     char procedureAfterLabel[MAX_TEMPORARY_STORAGE]; sprintf(procedureAfterLabel, "%safter", _environment->procedureName );
 
     if ( _environment->protothread ) {
@@ -146,6 +148,8 @@ void end_procedure( Environment * _environment, char * _value ) {
 
     cpu_label( _environment, procedureAfterLabel );
 
+    procedure_inline_end( _environment, _environment->procedures, bodyEnd );
+
     Variable * current = _environment->procedureVariables;
 
     if ( current ) {
@@ -170,6 +174,8 @@ void end_procedure( Environment * _environment, char * _value ) {
 
     _environment->procedureName = NULL;
 
+    _environment->procedureOptimizeMode = OPTIMIZE_MODE_DEFAULT;
+
     _environment->procedureVariables = NULL;
 
 };
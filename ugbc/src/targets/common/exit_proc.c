@@ -123,6 +123,10 @@ codice più difficile da leggere e gestire.
 
 void exit_procedure( Environment * _environment ) {
 
+    if ( _environment->procedureName ) {
+        _environment->procedureInlineBlocked = 1;
+    }
+
     cpu_return( _environment );
     
 }
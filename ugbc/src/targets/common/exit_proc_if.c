@@ -169,6 +169,10 @@ codice più difficile da leggere e gestire.
 
 void exit_proc_if( Environment * _environment, char * _expression, char * _value ) {
 
+    if ( _environment->procedureName ) {
+        _environment->procedureInlineBlocked = 1;
+    }
+
     MAKE_LABEL
 
     Variable * expression = variable_retrieve( _environment, _expression );
@@ -0,0 +1,230 @@
+/*****************************************************************************
+ * ugBASIC - an isomorphic BASIC language compiler for retrocomputers        *
+ *****************************************************************************
+ * Copyright 2021-2025 Marco Spedaletti (asimov@mclink.it)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *----------------------------------------------------------------------------
+ * Concesso in licenza secondo i termini della Licenza Apache, versione 2.0
+ * (la "Licenza"); è proibito usare questo file se non in conformità alla
+ * Licenza. Una copia della Licenza è disponibile all'indirizzo:
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Se non richiesto dalla legislazione vigente o concordato per iscritto,
+ * il software distribuito nei termini della Licenza è distribuito
+ * "COSÌ COM'È", SENZA GARANZIE O CONDIZIONI DI ALCUN TIPO, esplicite o
+ * implicite. Consultare la Licenza per il testo specifico che regola le
+ * autorizzazioni e le limitazioni previste dalla medesima.
+ ****************************************************************************/
+
+/****************************************************************************
+ * INCLUDE SECTION 
+ ****************************************************************************/
+
+#include "../../ugbc.h"
+#include <math.h>
+
+/****************************************************************************
+ * CODE SECTION 
+ ****************************************************************************/
+
+/**
+ * @brief Define the table with the arctangent of the first octant
+ *
+ * The entry i is the angle (in binary radians, 0...32) whose tangent
+ * is i / 64. The table is defined only once.
+ *
+ * @param _environment Current calling environment
+ * @return Variable* The table
+ */
+static Variable * fp_atan2_table( Environment * _environment ) {
+
+    if ( variable_exists( _environment, "ATAN2BYTE" ) ) {
+        return variable_retrieve( _environment, "ATAN2BYTE" );
+    }
+
+    Variable * table = variable_define_no_init( _environment, "ATAN2BYTE", VT_BUFFER );
+    table->valueBuffer = malloc( 65 );
+    for( int i=0; i<65; ++i ) {
+        table->valueBuffer[i] = (unsigned char) lround( atan( i / 64.0 ) * 128.0 / M_PI );
+    }
+    table->size = 65;
+
+    return table;
+
+}
+
+/* <usermanual>
+@keyword ATAN2
+
+@english
+This function calculates the angle of the direction given by a
+horizontal (''dx'') and a vertical (''dy'') distance, as the angle
+with the horizontal axis. It is useful to aim at a target: the angle
+can be used with ''SIN'' and ''COS'' to move toward it.
+
+The angle is calculated without floating point numbers, by reducing
+the direction to the first octant and reading the angle from a table.
+So it has a precision of 1/256 of a full turn. With ''BINARY RADIAN'' 
+the result is a byte (0...255), otherwise it is converted to a 
+floating point number (in radians or degrees), from 0 to a full turn.
+
+@italian
+Questa funzione calcola l'angolo della direzione data da una distanza
+orizzontale (''dx'') e da una verticale (''dy''), come angolo rispetto
+all'asse orizzontale. È utile per mirare a un bersaglio: l'angolo può
+essere usato con ''SIN'' e ''COS'' per muoversi verso di esso.
+
+L'angolo viene calcolato senza numeri in virgola mobile, riducendo la
+direzione al primo ottante e leggendo l'angolo da una tabella. Quindi
+ha una precisione di 1/256 di giro. Con ''BINARY RADIAN'' il risultato
+è un byte (0...255), altrimenti è convertito in un numero in virgola
+mobile (in radianti o gradi), da 0 a un giro completo.
+
+@syntax = ATAN2(dx, dy)
+
+@example BINARY RADIAN
+@example a = ATAN2( xTarget - x, yTarget - y )
+
+@target all
+</usermanual> */
+Variable * fp_atan2( Environment * _environment, char * _dx, char * _dy ) {
+
+    MAKE_LABEL
+
+    deploy_begin( fp_atan2 );
+
+        Variable * dx = variable_define( _environment, "atan2__dx", VT_SWORD, 0 );
+        Variable * dy = variable_define( _environment, "atan2__dy", VT_SWORD, 0 );
+        Variable * angle = variable_define( _environment, "atan2__angle", VT_BYTE, 0 );
+
+        Variable * table = fp_atan2_table( _environment );
+
+        Variable * ax = variable_temporary( _environment, VT_WORD, "(abs dx)" );
+        Variable * ay = variable_temporary( _environment, VT_WORD, "(abs dy)" );
+        Variable * numerator = variable_temporary( _environment, VT_WORD, "(numerator)" );
+        Variable * denominator = variable_temporary( _environment, VT_WORD, "(denominator)" );
+        Variable * quotient = variable_temporary( _environment, VT_WORD, "(quotient)" );
+        Variable * remainder = variable_temporary( _environment, VT_WORD, "(remainder)" );
+        Variable * steep = variable_temporary( _environment, VT_SBYTE, "(steep)" );
+        Variable * flag = variable_temporary( _environment, VT_SBYTE, "(flag)" );
+
+        char positiveXLabel[MAX_TEMPORARY_STORAGE]; sprintf( positiveXLabel, "%spx", label );
+        char positiveYLabel[MAX_TEMPORARY_STORAGE]; sprintf( positiveYLabel, "%spy", label );
+        char reduceLabel[MAX_TEMPORARY_STORAGE]; sprintf( reduceLabel, "%srd", label );
+        char shiftLabel[MAX_TEMPORARY_STORAGE]; sprintf( shiftLabel, "%ssh", label );
+        char reducedLabel[MAX_TEMPORARY_STORAGE]; sprintf( reducedLabel, "%srdd", label );
+        char steepLabel[MAX_TEMPORARY_STORAGE]; sprintf( steepLabel, "%sst", label );
+        char divideLabel[MAX_TEMPORARY_STORAGE]; sprintf( divideLabel, "%sdv", label );
+        char shallowLabel[MAX_TEMPORARY_STORAGE]; sprintf( shallowLabel, "%ssw", label );
+        char rightLabel[MAX_TEMPORARY_STORAGE]; sprintf( rightLabel, "%srg", label );
+        char upperLabel[MAX_TEMPORARY_STORAGE]; sprintf( upperLabel, "%sup", label );
+
+        // Work on the absolute values: the signs will select the octant.
+
+        cpu_move_16bit( _environment, dx->realName, ax->realName );
+        cpu_less_than_16bit_const( _environment, ax->realName, 0, flag->realName, 0, 1 );
+        cpu_bveq( _environment, flag->realName, positiveXLabel );
+        cpu_complement2_16bit( _environment, ax->realName, ax->realName );
+        cpu_label( _environment, positiveXLabel );
+
+        cpu_move_16bit( _environment, dy->realName, ay->realName );
+        cpu_less_than_16bit_const( _environment, ay->realName, 0, flag->realName, 0, 1 );
+        cpu_bveq( _environment, flag->realName, positiveYLabel );
+        cpu_complement2_16bit( _environment, ay->realName, ay->realName );
+        cpu_label( _environment, positiveYLabel );
+
+        // Scale down both distances, so that the smaller one
+        // multiplied by 64 fits into 16 bits.
+
+        cpu_label( _environment, reduceLabel );
+        cpu_greater_than_16bit_const( _environment, ax->realName, 1023, flag->realName, 0, 0 );
+        cpu_bvneq( _environment, flag->realName, shiftLabel );
+        cpu_greater_than_16bit_const( _environment, ay->realName, 1023, flag->realName, 0, 0 );
+        cpu_bveq( _environment, flag->realName, reducedLabel );
+        cpu_label( _environment, shiftLabel );
+        cpu_math_div2_const_16bit( _environment, ax->realName, 1, 0, NULL );
+        cpu_math_div2_const_16bit( _environment, ay->realName, 1, 0, NULL );
+        cpu_jump( _environment, reduceLabel );
+        cpu_label( _environment, reducedLabel );
+
+        // Reduce to the first octant: min(ax,ay) / max(ax,ay) is
+        // always between 0 and 1.
+
+        cpu_greater_than_16bit( _environment, ay->realName, ax->realName, steep->realName, 0, 0 );
+        cpu_bvneq( _environment, steep->realName, steepLabel );
+        cpu_move_16bit( _environment, ay->realName, numerator->realName );
+        cpu_move_16bit( _environment, ax->realName, denominator->realName );
+        cpu_jump( _environment, divideLabel );
+        cpu_label( _environment, steepLabel );
+        cpu_move_16bit( _environment, ax->realName, numerator->realName );
+        cpu_move_16bit( _environment, ay->realName, denominator->realName );
+        cpu_label( _environment, divideLabel );
+
+        cpu_store_8bit( _environment, angle->realName, 0 );
+        cpu_compare_and_branch_16bit_const( _environment, denominator->realName, 0, upperLabel, 1 );
+
+        cpu_math_mul2_const_16bit( _environment, numerator->realName, 6, 0 );
+        cpu_math_div_16bit_to_16bit( _environment, numerator->realName, denominator->realName, quotient->realName, remainder->realName, 0 );
+#ifdef CPU_BIG_ENDIAN
+        cpu_move_8bit_indirect2_8bit( _environment, table->realName, address_displacement( _environment, quotient->realName, "1" ), angle->realName );
+#else
+        cpu_move_8bit_indirect2_8bit( _environment, table->realName, quotient->realName, angle->realName );
+#endif
+
+        // Move the angle back from the first octant.
+
+        cpu_bveq( _environment, steep->realName, shallowLabel );
+        cpu_math_complement_const_8bit( _environment, angle->realName, 64 );
+        cpu_label( _environment, shallowLabel );
+
+        cpu_less_than_16bit_const( _environment, dx->realName, 0, flag->realName, 0, 1 );
+        cpu_bveq( _environment, flag->realName, rightLabel );
+        cpu_math_complement_const_8bit( _environment, angle->realName, 128 );
+        cpu_label( _environment, rightLabel );
+
+        cpu_less_than_16bit_const( _environment, dy->realName, 0, flag->realName, 0, 1 );
+        cpu_bveq( _environment, flag->realName, upperLabel );
+        cpu_math_complement_const_8bit( _environment, angle->realName, 0 );
+        cpu_label( _environment, upperLabel );
+
+        cpu_return( _environment );
+
+    deploy_end( fp_atan2 );
+
+    Variable * dx = variable_retrieve( _environment, "atan2__dx" );
+    Variable * dy = variable_retrieve( _environment, "atan2__dy" );
+    Variable * angle = variable_retrieve( _environment, "atan2__angle" );
+
+    variable_move( _environment, variable_retrieve_or_define( _environment, _dx, VT_SWORD, 0 )->name, dx->name );
+    variable_move( _environment, variable_retrieve_or_define( _environment, _dy, VT_SWORD, 0 )->name, dy->name );
+
+    cpu_call( _environment, "lib_fp_atan2" );
+
+    if ( _environment->floatType.angle == FT_BYTE ) {
+        Variable * result = variable_temporary( _environment, VT_BYTE, "(atan2)" );
+        variable_move( _environment, angle->name, result->name );
+        return result;
+    }
+
+    Variable * scale = variable_temporary( _environment, VT_FLOAT, "(scale)" );
+    if ( _environment->floatType.angle == FT_DEGREE ) {
+        variable_store_float( _environment, scale->name, 360.0 / 256.0 );
+    } else {
+        variable_store_float( _environment, scale->name, M_PI / 128.0 );
+    }
+
+    return variable_mul( _environment, variable_cast( _environment, angle->name, VT_FLOAT )->name, scale->name );
+
+}
@@ -57,6 +57,11 @@ as sound and light waves, the position and velocity of harmonic oscillators,
 sunlight intensity and day length, and average temperature variations throughout 
 the year.
 
+With ''BINARY RADIAN'' the angle is a byte (256 steps for a full turn)
+and the cosine is read from a table, without any floating point
+calculation: the result is an integer, with the value multiplied
+by 256 (so it goes from -256 to 256).
+
 @italian
 
 Questa funzione calcolerà il valore del coseno di un angolo. Il coseno di un angolo 
@@ -71,6 +76,11 @@ Le funzioni sinusoidali sono comunemente utilizzate per modellare fenomeni perio
 onde sonore e luminose, la posizione e la velocità degli oscillatori armonici, l'intensità 
 della luce solare e la durata del giorno e le variazioni di temperatura media durante tutto l'anno.
 
+Con ''BINARY RADIAN'' l'angolo è un byte (256 passi per un giro completo)
+e il coseno viene letto da una tabella, senza alcun calcolo in virgola
+mobile: il risultato è un intero, con il valore moltiplicato per 256
+(quindi va da -256 a 256).
+
 @syntax = COS(angle)
 
 @example x = COS(PI/2)
@@ -81,6 +91,10 @@ della luce solare e la durata del giorno e le variazioni di temperatura media du
 </usermanual> */
 Variable * fp_cos( Environment * _environment, char * _angle ) {
 
+    if ( _environment->floatType.angle == FT_BYTE ) {
+        return cos_byte( _environment, _angle );
+    }
+
     Variable * angle = variable_retrieve_or_define( _environment, _angle, VT_FLOAT, 0 );
     Variable * result = variable_temporary( _environment, VT_FLOAT, "(cos)");
 
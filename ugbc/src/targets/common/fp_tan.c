@@ -61,7 +61,17 @@ rettangolo.
 </usermanual> */
 Variable * fp_tan( Environment * _environment, char * _angle ) {
 
-    Variable * angle = variable_retrieve_or_define( _environment, _angle, VT_FLOAT, 0 );
+    Variable * angle = NULL;
+
+    // There is no table for the tangent: a binary angle is 
+    // converted into radians.
+    if ( _environment->floatType.angle == FT_BYTE ) {
+        Variable * scale = variable_temporary( _environment, VT_FLOAT, "(scale)" );
+        variable_store_float( _environment, scale->name, M_PI / 128.0 );
+        angle = variable_mul( _environment, variable_cast( _environment, variable_retrieve_or_define( _environment, _angle, VT_BYTE, 0 )->name, VT_FLOAT )->name, scale->name );
+    } else {
+        angle = variable_retrieve_or_define( _environment, _angle, VT_FLOAT, 0 );
+    }
     Variable * result = variable_temporary( _environment, VT_FLOAT, "(tan)");
 
     switch( result->precision ) {
@@ -125,6 +125,8 @@ void gosub_label( Environment * _environment, char * _label ) {
 
     cpu_call( _environment, realLabel );
 
+    variable_array_walk_invalidate( _environment );
+
 }
 
 /**
@@ -145,4 +147,6 @@ void gosub_number( Environment * _environment, int _number ) {
 
     cpu_call( _environment, label );
 
+    variable_array_walk_invalidate( _environment );
+
 }
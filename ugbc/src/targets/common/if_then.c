@@ -139,8 +139,91 @@ void if_then( Environment * _environment, char * _expression ) {
     char thenLabel[MAX_TEMPORARY_STORAGE]; sprintf(thenLabel, "%st", label );
     char elseLabel[MAX_TEMPORARY_STORAGE]; sprintf(elseLabel, "%se%d", conditional->label, conditional->index );
 
-    cpu_bveq( _environment, expression->realName, elseLabel );
+    // If the condition is known at compile time, there is nothing
+    // to test: a true condition is simply executed, while a false
+    // one starts a dead branch, that will be dropped at the next 
+    // ELSE / ENDIF.
+    if ( expression->initializedByConstant && VT_BITWIDTH( expression->type ) >= 8 ) {
+        if ( expression->value ) {
+            conditional->taken = 1;
+        } else {
+            if_then_dead_begin( _environment, conditional );
+            cpu_jump( _environment, elseLabel );
+        }
+    } else {
+        cpu_bveq( _environment, expression->realName, elseLabel );
+    }
 
     cpu_label( _environment, thenLabel );
 
 }
+
+/**
+ * @brief Start a branch of <b>IF ... THEN ...</b> that will never be executed
+ * 
+ * The code emitted from here up to the end of the branch (next 
+ * <b>ELSE</b> or <b>ENDIF</b>) will be removed from the output, 
+ * unless it defines a label that could be reached from elsewhere.
+ * 
+ * @param _environment Current calling environment
+ * @param _conditional Conditional with the dead branch
+ */
+void if_then_dead_begin( Environment * _environment, Conditional * _conditional ) {
+
+    _conditional->dead = 1;
+    _conditional->deadKept = 0;
+    _conditional->deadLevel = _environment->currentBufferOutput;
+    _conditional->deadStart = _environment->bufferOutputSize[_environment->currentBufferOutput];
+
+    // The saved context of a parallel procedure refers to labels 
+    // that could be inside the branch.
+    if ( _environment->protothread ) {
+        _conditional->deadKept = 1;
+    }
+
+}
+
+/**
+ * @brief End a branch of <b>IF ... THEN ...</b> that will never be executed
+ * 
+ * @param _environment Current calling environment
+ * @param _conditional Conditional with the dead branch
+ * @return int 1 if the code of the branch has been removed, 0 if it has been kept
+ */
+int if_then_dead_end( Environment * _environment, Conditional * _conditional ) {
+
+    _conditional->dead = 0;
+
+    if ( _conditional->deadKept || _conditional->deadLevel != _environment->currentBufferOutput ) {
+        return 0;
+    }
+
+    if ( _conditional->deadStart > _environment->bufferOutputSize[_environment->currentBufferOutput] ) {
+        return 0;
+    }
+
+    _environment->bufferOutputSize[_environment->currentBufferOutput] = _conditional->deadStart;
+
+    return 1;
+
+}
+
+/**
+ * @brief Keep the code of any dead branch currently opened
+ * 
+ * This function must be called when a label is defined, since it could 
+ * be the target of a jump from outside the branch.
+ * 
+ * @param _environment Current calling environment
+ */
+void if_then_dead_keep( Environment * _environment ) {
+
+    Conditional * conditional = _environment->conditionals;
+    while( conditional ) {
+        if ( conditional->dead ) {
+            conditional->deadKept = 1;
+        }
+        conditional = conditional->next;
+    }
+
+}
@@ -0,0 +1,337 @@
+/*****************************************************************************
+ * ugBASIC - an isomorphic BASIC language compiler for retrocomputers        *
+ *****************************************************************************
+ * Copyright 2021-2025 Marco Spedaletti (asimov@mclink.it)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *----------------------------------------------------------------------------
+ * Concesso in licenza secondo i termini della Licenza Apache, versione 2.0
+ * (la "Licenza"); è proibito usare questo file se non in conformità alla
+ * Licenza. Una copia della Licenza è disponibile all'indirizzo:
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Se non richiesto dalla legislazione vigente o concordato per iscritto,
+ * il software distribuito nei termini della Licenza è distribuito
+ * "COSÌ COM'È", SENZA GARANZIE O CONDIZIONI DI ALCUN TIPO, esplicite o
+ * implicite. Consultare la Licenza per il testo specifico che regola le
+ * autorizzazioni e le limitazioni previste dalla medesima.
+ ****************************************************************************/
+/****************************************************************************
+ * INCLUDE SECTION 
+ ****************************************************************************/
+
+#include "../../ugbc.h"
+#include <ctype.h>
+
+/****************************************************************************
+ * CODE SECTION 
+ ****************************************************************************/
+
+/* characters that can be part of a symbol in the assembly source */
+static int inline_symbol_char( char _c ) {
+    return isalnum( (unsigned char)_c ) || _c == '_' || _c == '@';
+}
+
+/* next occurrence of _name in _text, as a whole symbol (NULL if none) */
+static char * inline_find( char * _text, char * _name ) {
+    int length = strlen( _name );
+    char * p = _text;
+    while( ( p = strstr( p, _name ) ) ) {
+        if ( ( p == _text || !inline_symbol_char( p[-1] ) ) && !inline_symbol_char( p[length] ) ) {
+            return p;
+        }
+        p += length;
+    }
+    return NULL;
+}
+
+static void inline_append( char ** _text, int * _size, char * _string, int _length ) {
+    *_text = realloc( *_text, *_size + _length + 1 );
+    memcpy( *_text + *_size, _string, _length );
+    *_size += _length;
+    (*_text)[*_size] = 0;
+}
+
+/* replace each occurrence of _name (as a whole symbol) with _with: _text is freed */
+static char * inline_replace( char * _text, char * _name, char * _with ) {
+    char * result = NULL;
+    int size = 0;
+    char * in = _text;
+    char * p;
+    while( ( p = inline_find( in, _name ) ) ) {
+        inline_append( &result, &size, in, p - in );
+        inline_append( &result, &size, _with, strlen( _with ) );
+        in = p + strlen( _name );
+    }
+    if ( !result ) {
+        return _text;
+    }
+    inline_append( &result, &size, in, strlen( in ) );
+    free( _text );
+    return result;
+}
+
+static int inline_comment( char * _line ) {
+    while( *_line == ' ' || *_line == '\t' ) {
+        ++_line;
+    }
+    return *_line == ';';
+}
+
+/* copy the next line of _text into _line, and return the start of the following one */
+static char * inline_line( char * _text, char * _line ) {
+    char * end = strchr( _text, '\n' );
+    int length = end ? end - _text : strlen( _text );
+    if ( length > MAX_TEMPORARY_STORAGE - 1 ) {
+        length = MAX_TEMPORARY_STORAGE - 1;
+    }
+    memcpy( _line, _text, length );
+    _line[length] = 0;
+    return end ? end + 1 : _text + strlen( _text );
+}
+
+/* all the instructions of _body that use _name only read it */
+static int inline_only_reads( Environment * _environment, char * _body, char * _name ) {
+    char line[MAX_TEMPORARY_STORAGE];
+    char * p = _body;
+    while( *p ) {
+        p = inline_line( p, line );
+        if ( inline_find( line, _name ) && !inline_comment( line ) && cpu_inline_read( _environment, line, _name ) < 0 ) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* rewrite each read of _name in _body as an immediate value: NULL if not possible */
+static char * inline_constant( Environment * _environment, char * _body, char * _name, int _size, int _value ) {
+    char line[MAX_TEMPORARY_STORAGE];
+    char rewritten[MAX_TEMPORARY_STORAGE];
+    char * result = NULL;
+    int size = 0;
+    char * p = _body;
+    while( *p ) {
+        char * next = inline_line( p, line );
+        if ( inline_find( line, _name ) && !inline_comment( line ) ) {
+            if ( !cpu_inline_constant( _environment, line, _name, _size, _value, rewritten ) ) {
+                free( result );
+                return NULL;
+            }
+            strcat( rewritten, "\n" );
+            inline_append( &result, &size, rewritten, strlen( rewritten ) );
+        } else {
+            inline_append( &result, &size, p, next - p );
+        }
+        p = next;
+    }
+    return result ? result : strdup( "" );
+}
+
+/**
+ * @brief Decide if the procedure just ended can be expanded inline
+ * 
+ * The body of the procedure is the assembly produced between the label of
+ * the procedure and the final return. If the procedure can be expanded
+ * inline (it is not parallel, it does not define labels, it does not
+ * return before END PROC and it is small enough, or it has been defined
+ * with INLINE PROCEDURE), the body is kept aside and the whole procedure
+ * is removed from the output: the out-of-line copy will be emitted at 
+ * the end of the program, only if something still refers to it.
+ * 
+ * @param _environment Current calling environment
+ * @param _procedure Procedure just ended
+ * @param _bodyEnd Offset of the end of the body in the output
+ */
+void procedure_inline_end( Environment * _environment, Procedure * _procedure, int _bodyEnd ) {
+
+    if ( _procedure->protothread || _environment->optionCallAsGoto || _environment->procedureInlineBlocked ) {
+        return;
+    }
+
+    if ( _environment->procedureBufferLevel != _environment->currentBufferOutput ) {
+        return;
+    }
+
+    char * output = _environment->bufferOutput[_environment->currentBufferOutput];
+    int size = _environment->bufferOutputSize[_environment->currentBufferOutput];
+
+    if ( _environment->procedureBodyStart > _bodyEnd || _bodyEnd > size ) {
+        return;
+    }
+
+    // the markers of the source lines are not copied: the expansion
+    // belongs to the line of the call
+    char * body = strdup( "" );
+    int bodySize = 0;
+    int instructions = 0;
+    char * p = output + _environment->procedureBodyStart;
+    char * end = output + _bodyEnd;
+    while( p < end ) {
+        char * eol = memchr( p, '\n', end - p );
+        char * next = eol ? eol + 1 : end;
+        char * q = p;
+        while( q < next && ( *q == ' ' || *q == '\t' ) ) {
+            ++q;
+        }
+        if ( next - q >= 4 && !strncmp( q, "; L:", 4 ) ) {
+            p = next;
+            continue;
+        }
+        if ( q != p && q < next && *q != ';' && *q != '\n' && *q != '\r' ) {
+            ++instructions;
+        }
+        inline_append( &body, &bodySize, p, next - p );
+        p = next;
+    }
+
+    OptimizeMode mode = _environment->procedureOptimizeMode ? _environment->procedureOptimizeMode : _environment->optimizeMode;
+
+    int threshold = PROCEDURE_INLINE_THRESHOLD;
+    if ( mode == OPTIMIZE_MODE_SPEED ) {
+        threshold = PROCEDURE_INLINE_THRESHOLD_SPEED;
+    } else if ( mode == OPTIMIZE_MODE_SIZE ) {
+        threshold = PROCEDURE_INLINE_THRESHOLD_SIZE;
+    }
+
+    if ( !_procedure->inlineRequested && instructions > threshold ) {
+        free( body );
+        return;
+    }
+
+    _procedure->inlineBody = body;
+    _procedure->inlineCalls = _environment->procedureCalls;
+
+    _procedure->outOfLine = malloc( size - _environment->procedureStart + 1 );
+    memcpy( _procedure->outOfLine, output + _environment->procedureStart, size - _environment->procedureStart );
+    _procedure->outOfLine[size - _environment->procedureStart] = 0;
+
+    _environment->bufferOutputSize[_environment->currentBufferOutput] = _environment->procedureStart;
+
+}
+
+/* <usermanual>
+@keyword INLINE PROCEDURE
+
+@english
+The ''INLINE PROCEDURE'' command defines a procedure, like ''PROCEDURE'', whose 
+body is always expanded at the place of each call, instead of being called.
+Small procedures are expanded in this way even without ''INLINE'': by default,
+the ones with up to 16 instructions (48 with ''OPTIMIZE SPEED'', 4 with 
+''OPTIMIZE SIZE''). The procedures that define labels, that return before 
+''END PROC'' or that are ''PARALLEL'' are never expanded. When a procedure is 
+expanded, each parameter that the body only reads is replaced by the argument 
+(a variable of the same type, or a constant), so the copy of the argument is 
+not needed anymore. The called version of the procedure is kept only if it is
+still used in other ways (for example, by ''SPAWN'' or ''EVERY ... CALL'').
+
+@italian
+Il comando ''INLINE PROCEDURE'' definisce una procedura, come ''PROCEDURE'', il
+cui corpo viene sempre espanso nel punto di ogni chiamata, invece di essere
+chiamato. Le procedure piccole sono espanse in questo modo anche senza ''INLINE'':
+per impostazione predefinita, quelle fino a 16 istruzioni (48 con ''OPTIMIZE SPEED'', 
+4 con ''OPTIMIZE SIZE''). Le procedure che definiscono etichette, che ritornano
+prima di ''END PROC'' o che sono ''PARALLEL'' non sono mai espanse. Quando una 
+procedura viene espansa, ogni parametro che il corpo legge soltanto è sostituito
+dall'argomento (una variabile dello stesso tipo, o una costante), per cui la 
+copia dell'argomento non è più necessaria. La versione chiamata della procedura
+viene mantenuta solo se è ancora usata in altri modi (ad esempio, da ''SPAWN'' 
+o ''EVERY ... CALL'').
+
+@syntax INLINE PROCEDURE name[ par1[, par2[, ... ]]] ]
+@syntax  ...
+@syntax END PROC[ expression ]
+
+@example INLINE PROCEDURE plot[ x, y ]
+@example    PLOT x, y
+@example END PROC
+
+@target all
+</usermanual> */
+/**
+ * @brief Expand a procedure inline, at the place of a call
+ * 
+ * The arguments are taken from the environment, as for call_procedure().
+ * A parameter is replaced by the argument if the argument is a variable of 
+ * the same type and both are only read by the body (and the body does not
+ * call other procedures, that could change them), or if the argument is a 
+ * constant and each read can be rewritten as an immediate value. Otherwise,
+ * the argument is copied into the parameter, as usual. The labels of the 
+ * body are renamed, so that the body can be expanded more than once.
+ * 
+ * @param _environment Current calling environment
+ * @param _procedure Procedure to expand
+ */
+void procedure_inline( Environment * _environment, Procedure * _procedure ) {
+
+    char * body = strdup( _procedure->inlineBody );
+
+    for( int i=0; i<_procedure->parameters; ++i ) {
+        char parameterName[MAX_TEMPORARY_STORAGE]; sprintf( parameterName, "%s__%s", _procedure->name, _procedure->parametersEach[i] );
+        Variable * parameter = variable_retrieve_or_define( _environment, parameterName, _procedure->parametersTypeEach[i], 0 );
+        if ( _environment->parametersEach[i] ) {
+            Variable * value = variable_retrieve( _environment, _environment->parametersEach[i] );
+            if ( value->type == parameter->type && !_procedure->inlineCalls &&
+                 inline_only_reads( _environment, body, parameter->realName ) && 
+                 inline_only_reads( _environment, body, value->realName ) ) {
+                body = inline_replace( body, parameter->realName, value->realName );
+                continue;
+            }
+            variable_move( _environment, value->name, parameter->name );
+        } else {
+            int size = VT_BITWIDTH( parameter->type ) >> 3;
+            if ( size ) {
+                char * rewritten = inline_constant( _environment, body, parameter->realName, size, _environment->parametersValueEach[i] );
+                if ( rewritten ) {
+                    free( body );
+                    body = rewritten;
+                    continue;
+                }
+            }
+            variable_store( _environment, parameter->name, _environment->parametersValueEach[i] );
+        }
+    }
+    _environment->parameters = 0;
+
+    // labels are at the first column
+    char line[MAX_TEMPORARY_STORAGE];
+    char label[MAX_TEMPORARY_STORAGE];
+    char renamed[MAX_TEMPORARY_STORAGE+16];
+    int expansion = UNIQUE_ID;
+    char * labels = strdup( _procedure->inlineBody );
+    char * p = labels;
+    while( *p ) {
+        p = inline_line( p, line );
+        int i = 0;
+        while( inline_symbol_char( line[i] ) ) {
+            label[i] = line[i];
+            ++i;
+        }
+        label[i] = 0;
+        if ( i && ( !line[i] || line[i] == ':' || line[i] == ' ' || line[i] == '\t' || line[i] == '\r' ) ) {
+            snprintf( renamed, sizeof( renamed ), "%si%d", label, expansion );
+            body = inline_replace( body, label, renamed );
+        }
+    }
+    free( labels );
+
+    buffered_fputs( _environment, body, _environment->asmFile );
+    free( body );
+
+    ++_procedure->inlineExpansions;
+
+    if ( _environment->procedureName && _procedure->inlineCalls ) {
+        _environment->procedureCalls = 1;
+    }
+
+}
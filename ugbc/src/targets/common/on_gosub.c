@@ -80,6 +80,8 @@ void on_gosub( Environment * _environment, char * _expression ) {
 
     MAKE_LABEL
 
+    variable_array_walk_invalidate( _environment );
+
     Variable * expression = variable_retrieve( _environment, _expression );
 
     char newLabel[MAX_TEMPORARY_STORAGE]; sprintf(newLabel, "gosub%d", UNIQUE_ID );
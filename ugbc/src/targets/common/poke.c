@@ -105,6 +105,8 @@ Esiste anche una versione di questo comando che funziona all'interno di una copp
 
 void poke_var( Environment * _environment, char * _address, char * _value ) {
 
+    variable_array_walk_invalidate( _environment );
+
     Variable * address = variable_retrieve_or_define( _environment, _address, VT_ADDRESS, 0 );
 
     if ( variable_exists( _environment, _value ) ) {
@@ -186,6 +188,8 @@ Esiste anche una versione di questo comando che funziona all'interno di una copp
 
 void pokew_var( Environment * _environment, char * _address, char * _value ) {
 
+    variable_array_walk_invalidate( _environment );
+
     Variable * address = variable_retrieve_or_define( _environment, _address, VT_ADDRESS, 0 );
 
     if ( variable_exists( _environment, _value ) ) {
@@ -261,6 +265,8 @@ Esiste anche una versione di questo comando che funziona all'interno di una copp
 
 void poked_var( Environment * _environment, char * _address, char * _value ) {
 
+    variable_array_walk_invalidate( _environment );
+
     Variable * address = variable_retrieve_or_define( _environment, _address, VT_ADDRESS, 0 );
 
     if ( variable_exists( _environment, _value ) ) {
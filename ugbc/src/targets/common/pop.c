@@ -65,6 +65,10 @@ possibile usare un ''GOTO'' invece di un ''RETURN''.
 </usermanual> */
 void pop( Environment * _environment ) {
 
+    if ( _environment->procedureName ) {
+        _environment->procedureInlineBlocked = 1;
+    }
+
     cpu_pop( _environment );
 
 }
\ No newline at end of file
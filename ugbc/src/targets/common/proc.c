@@ -85,6 +85,8 @@ comando chiamerà la procedura, come l'istruzione ''CALL''.
 </usermanual> */
 void proc( Environment * _environment, char * _label ) {
 
+    variable_array_walk_invalidate( _environment );
+
     Procedure * procedure = _environment->procedures;
     while ( procedure ) {
         if ( strcmp( procedure->name, _label ) == 0 ) {
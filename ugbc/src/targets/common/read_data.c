@@ -349,6 +349,8 @@ void read_data( Environment * _environment, char * _variable, int _safe ) {
 
     _environment->readDataUsed = 1;
 
+    variable_array_walk_written( _environment, _variable );
+
     if ( _safe ) {
         read_data_safe( _environment, _variable );
     } else {
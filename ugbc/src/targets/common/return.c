@@ -70,6 +70,10 @@ a quella chaimante.
 </usermanual> */
 void return_label( Environment * _environment ) {
 
+    if ( _environment->procedureName ) {
+        _environment->procedureInlineBlocked = 1;
+    }
+
     cpu_return( _environment );
 
 }
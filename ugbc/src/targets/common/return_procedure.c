@@ -86,6 +86,10 @@ void return_procedure( Environment * _environment, char * _value ) {
         return;
     }
 
+    if ( _environment->procedureName ) {
+        _environment->procedureInlineBlocked = 1;
+    }
+
     char paramName[MAX_TEMPORARY_STORAGE]; sprintf(paramName,"%s__PARAM", _environment->procedureName );
     Variable * value;
     if ( variable_exists( _environment, _value ) ) {
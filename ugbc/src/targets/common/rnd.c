@@ -40,6 +40,67 @@
 
 extern char DATATYPE_AS_STRING[][16];
 
+/* upper part of random * _max, that is a random number between 0 and _max - 1:
+   _bits is the width of both the random number and _max (8 or 16) */
+static Variable * rnd_scale( Environment * _environment, int _bits, char * _max ) {
+
+    Variable * random;
+    Variable * product;
+    Variable * result;
+
+    if ( _bits == 8 ) {
+        random = random_value( _environment, VT_BYTE );
+        product = variable_temporary( _environment, VT_WORD, "(product for RND)" );
+        result = variable_temporary( _environment, VT_BYTE, "(result of RND)" );
+        cpu_math_mul_8bit_to_16bit( _environment, random->realName, _max, product->realName, 0 );
+        #ifdef CPU_BIG_ENDIAN
+            cpu_move_8bit( _environment, product->realName, result->realName );
+        #else
+            cpu_move_8bit( _environment, address_displacement( _environment, product->realName, "1" ), result->realName );
+        #endif
+    } else {
+        random = random_value( _environment, VT_WORD );
+        product = variable_temporary( _environment, VT_DWORD, "(product for RND)" );
+        result = variable_temporary( _environment, VT_WORD, "(result of RND)" );
+        cpu_math_mul_16bit_to_32bit( _environment, random->realName, _max, product->realName, 0 );
+        #ifdef CPU_BIG_ENDIAN
+            cpu_move_16bit( _environment, product->realName, result->realName );
+        #else
+            cpu_move_16bit( _environment, address_displacement( _environment, product->realName, "2" ), result->realName );
+        #endif
+    }
+
+    return result;
+
+}
+
+/* random number between 0 and _max - 1, with _max known at compile time */
+static Variable * rnd_const( Environment * _environment, unsigned int _max ) {
+
+    Variable * result;
+
+    if ( ( _max & ( _max - 1 ) ) == 0 ) {
+        if ( _max <= 0x100 ) {
+            result = random_value( _environment, VT_BYTE );
+            if ( _max < 0x100 ) {
+                cpu_math_and_const_8bit( _environment, result->realName, _max - 1 );
+            }
+        } else {
+            result = random_value( _environment, VT_WORD );
+            if ( _max < 0x10000 ) {
+                cpu_math_and_const_16bit( _environment, result->realName, _max - 1 );
+            }
+        }
+    } else if ( _max < 0x100 ) {
+        result = rnd_scale( _environment, 8, variable_by_constant( _environment, VT_BYTE, _max )->realName );
+    } else {
+        result = rnd_scale( _environment, 16, variable_by_constant( _environment, VT_WORD, _max )->realName );
+    }
+
+    return result;
+
+}
+
 /**
  * @brief Return a random value 
  * 
@@ -78,56 +139,70 @@ genera un numero intero casuale tra ''0'' e ''max-1''.
 </usermanual> */
 Variable * rnd( Environment * _environment, char * _value ) {
 
-    Variable * last_random = variable_temporary( _environment, VT_DWORD, "(last temporary for RND)");
-    last_random->locked = 1;
-
     Variable * value = variable_retrieve( _environment, _value );
 
-    Variable * result;
+    if ( VT_BITWIDTH( value->type ) < 8 ) {
+        CRITICAL_RANDOM_UNSUPPORTED( _value, DATATYPE_AS_STRING[value->type] );
+    }
 
-    Variable * bresult = variable_temporary( _environment, VT_BYTE, "(temporary for RND)");
+    // A maximum known at compile time needs neither the test for zero nor
+    // a division: a power of two is just a mask, any other value scales
+    // a random number of the same width with a multiplication.
+    if ( value->initializedByConstant ) {
+        unsigned int max = value->value;
+        if ( VT_BITWIDTH( value->type ) == 8 ) {
+            max &= 0xff;
+        } else if ( VT_BITWIDTH( value->type ) == 16 ) {
+            max &= 0xffff;
+        }
+        if ( max > 0 && max <= 0x10000 && !( VT_SIGNED( value->type ) && value->value < 0 ) ) {
+            Variable * result = rnd_const( _environment, max );
+            if ( result->type != value->type ) {
+                result = variable_cast( _environment, result->name, value->type );
+            }
+            return result;
+        }
+    }
 
-    Variable * ignored = variable_temporary( _environment, value->type, "(ignored)");
-    Variable * remainder = variable_temporary( _environment, value->type, "(remainder)");
+    Variable * last_random = variable_temporary( _environment, value->type, "(last temporary for RND)");
+    last_random->locked = 1;
 
-    Variable * zero = variable_temporary( _environment, value->type, "(0)" );
-    variable_store( _environment, zero->name, 0 );
+    Variable * result = variable_temporary( _environment, value->type, "(result of RND)" );
 
     MAKE_LABEL
 
     char endLabel[MAX_TEMPORARY_STORAGE]; sprintf(endLabel, "%send", label );
     char lastRandomLabel[MAX_TEMPORARY_STORAGE]; sprintf(lastRandomLabel, "%slr", label );
 
-    if_then( _environment, variable_compare( _environment, value->name, zero->name )->name );
-        cpu_jump( _environment, lastRandomLabel );
-    end_if_then( _environment );
-
-    result = random_value( _environment, value->type );
-
     switch( VT_BITWIDTH( value->type ) ) {
-        case 32:
-            cpu_math_div_32bit_to_16bit( _environment, result->realName, value->realName, ignored->realName, remainder->realName, 0 );
-            cpu_move_16bit( _environment, remainder->realName, result->realName );
-            cpu_move_16bit( _environment, remainder->realName, last_random->realName );
-            cpu_jump( _environment, endLabel );
-            break;
-        case 16:
-            cpu_math_div_16bit_to_16bit( _environment, result->realName, value->realName, ignored->realName, remainder->realName, 0 );
-            cpu_move_16bit( _environment, remainder->realName, result->realName );
-            cpu_move_16bit( _environment, remainder->realName, last_random->realName );
-            cpu_jump( _environment, endLabel );
+        case 32: {
+            cpu_compare_and_branch_32bit_const( _environment, value->realName, 0, lastRandomLabel, 1 );
+            Variable * random = random_value( _environment, value->type );
+            Variable * ignored = variable_temporary( _environment, VT_WORD, "(ignored)");
+            Variable * remainder = variable_temporary( _environment, VT_WORD, "(remainder)");
+            cpu_math_div_32bit_to_16bit( _environment, random->realName, value->realName, ignored->realName, remainder->realName, 0 );
+            variable_move( _environment, remainder->name, result->name );
+            variable_move( _environment, remainder->name, last_random->name );
             break;
-        case 8:
-            cpu_math_div_8bit_to_8bit( _environment, result->realName, value->realName, ignored->realName, remainder->realName, 0 );
-            cpu_move_8bit( _environment, remainder->realName, result->realName );
-            cpu_move_8bit( _environment, remainder->realName, last_random->realName );
-            cpu_jump( _environment, endLabel );
+        }
+        case 16: {
+            cpu_compare_and_branch_16bit_const( _environment, value->realName, 0, lastRandomLabel, 1 );
+            Variable * scaled = rnd_scale( _environment, 16, value->realName );
+            cpu_move_16bit( _environment, scaled->realName, result->realName );
+            cpu_move_16bit( _environment, scaled->realName, last_random->realName );
             break;
-        case 0:
-            CRITICAL_RANDOM_UNSUPPORTED( _value, DATATYPE_AS_STRING[value->type] );
+        }
+        case 8: {
+            cpu_compare_and_branch_8bit_const( _environment, value->realName, 0, lastRandomLabel, 1 );
+            Variable * scaled = rnd_scale( _environment, 8, value->realName );
+            cpu_move_8bit( _environment, scaled->realName, result->realName );
+            cpu_move_8bit( _environment, scaled->realName, last_random->realName );
             break;
+        }
     }
 
+    cpu_jump( _environment, endLabel );
+
     cpu_label( _environment, lastRandomLabel );
 
     variable_move( _environment, last_random->name, result->name );
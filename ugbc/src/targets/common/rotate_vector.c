@@ -38,6 +38,50 @@
  * CODE SECTION 
  ****************************************************************************/
 
+static Variable * rotate_vector_byte( Environment * _environment, char * _v, char * _a ) {
+
+    deploy_begin( rotate_vector_byte );
+
+        Variable * vector = variable_define( _environment, "rotatevectorbyte__vector", VT_VECTOR2, 0 );
+        Variable * angle = variable_define( _environment, "rotatevectorbyte__angle", VT_BYTE, 0 );
+
+        Variable * x = vector_get_x( _environment, vector->name );
+        Variable * y = vector_get_y( _environment, vector->name );
+
+        Variable * ca = cos_byte( _environment, angle->name );
+        Variable * sa = sin_byte( _environment, angle->name );
+
+        Variable * xpca = variable_mul( _environment, x->name, ca->name );
+        Variable * ypsa = variable_mul( _environment, y->name, sa->name );
+        Variable * xpsa = variable_mul( _environment, x->name, sa->name );
+        Variable * ypca = variable_mul( _environment, y->name, ca->name );
+
+        // Sine and cosine are multiplied by 256.
+        Variable * rx = variable_div2_const( _environment, variable_sub( _environment, xpca->name, ypsa->name )->name, 256, NULL );
+        Variable * ry = variable_div2_const( _environment, variable_add( _environment, xpsa->name, ypca->name )->name, 256, NULL );
+
+        cpu_move_16bit( _environment, variable_cast( _environment, rx->name, VT_POSITION )->realName, vector->realName );
+        cpu_move_16bit( _environment, variable_cast( _environment, ry->name, VT_POSITION )->realName, address_displacement( _environment, vector->realName, "2" ) );
+
+        cpu_return( _environment );
+
+    deploy_end( rotate_vector_byte )
+
+    Variable * vp = variable_retrieve( _environment, "rotatevectorbyte__vector" );
+    Variable * ap = variable_retrieve( _environment, "rotatevectorbyte__angle" );
+
+    Variable * v = variable_retrieve( _environment, _v );
+    Variable * a = variable_retrieve_or_define( _environment, _a, VT_BYTE, 0 );
+
+    variable_move( _environment, v->name, vp->name );
+    variable_move( _environment, a->name, ap->name );
+
+    cpu_call( _environment, "lib_rotate_vector_byte" );
+
+    return vp;
+
+}
+
 /**
  * @brief Emit ASM code to implement <strong>CREATE PATH</strong> command
  * 
@@ -61,11 +105,17 @@ Questo comando consente di ruotare un vettore bidimensionale (''VECTOR'') di un
 @example DIM p AS VECTOR
 @example    v = CREATE VECTOR( 10, 10 )
 @example    v = ROTATE VECTOR( v, 1.57 )
+@example BINARY RADIAN
+@example    v = ROTATE VECTOR( v, 64 )
 
 </usermanual> */
  
 Variable * rotate_vector( Environment * _environment, char * _v, char * _a ) {
 
+    if ( _environment->floatType.angle == FT_BYTE ) {
+        return rotate_vector_byte( _environment, _v, _a );
+    }
+
     deploy_begin( rotate_vector );
 
         Variable * vector = variable_define( _environment, "rotatevector__vector", VT_VECTOR2, 0 );
@@ -0,0 +1,292 @@
+/*****************************************************************************
+ * ugBASIC - an isomorphic BASIC language compiler for retrocomputers        *
+ *****************************************************************************
+ * Copyright 2021-2025 Marco Spedaletti (asimov@mclink.it)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *----------------------------------------------------------------------------
+ * Concesso in licenza secondo i termini della Licenza Apache, versione 2.0
+ * (la "Licenza"); è proibito usare questo file se non in conformità alla
+ * Licenza. Una copia della Licenza è disponibile all'indirizzo:
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Se non richiesto dalla legislazione vigente o concordato per iscritto,
+ * il software distribuito nei termini della Licenza è distribuito
+ * "COSÌ COM'È", SENZA GARANZIE O CONDIZIONI DI ALCUN TIPO, esplicite o
+ * implicite. Consultare la Licenza per il testo specifico che regola le
+ * autorizzazioni e le limitazioni previste dalla medesima.
+ ****************************************************************************/
+
+/****************************************************************************
+ * INCLUDE SECTION 
+ ****************************************************************************/
+
+#include "../../ugbc.h"
+
+/****************************************************************************
+ * CODE SECTION 
+ ****************************************************************************/
+
+/**
+ * @brief Emit ASM code for <b>SCROLL TILEMAP [tilemap] [direction]</b>
+ * 
+ * This function outputs a code that scrolls the screen by using the
+ * hardware (or the coarse scroll, where not available) and then draws
+ * only the column or row of tiles that entered the screen. The
+ * viewport starts from the position given to the last
+ * <b>PUT TILEMAP ... FROM</b>.
+ * 
+ * @param _environment Current calling environment
+ * @param _tilemap Tilemap to scroll
+ * @param _dx Horizontal direction (-1 = left, 0 = none, 1 = right)
+ * @param _dy Vertical direction (-1 = up, 0 = none, 1 = down)
+ */
+/* <usermanual>
+@keyword SCROLL TILEMAP
+
+@english
+
+The command ''SCROLL TILEMAP'' scrolls the screen exactly as ''SCROLL'' does, 
+but it keeps track of the position of the screen on the map. Every time the 
+screen is moved by an entire row or column, only the new column (or row) of 
+tiles is drawn, taking them from the map. The scrolling starts from the position
+given with the last ''PUT TILEMAP ... FROM'' command, and it stops at the 
+borders of the map. This command takes the place of any ''ON SCROLL'' 
+handler, and it needs tiles as big as a character cell.
+
+@italian
+
+Il comando ''SCROLL TILEMAP'' fa scorrere lo schermo esattamente come ''SCROLL'',
+ma tiene traccia della posizione dello schermo sulla mappa. Ogni volta che lo 
+schermo si sposta di una intera riga o colonna, viene disegnata solo la nuova 
+colonna (o riga) di tessere, prendendole dalla mappa. Lo scorrimento parte dalla 
+posizione data con l'ultimo comando ''PUT TILEMAP ... FROM'', e si ferma ai bordi
+della mappa. Questo comando prende il posto di qualsiasi gestore ''ON SCROLL'', 
+e richiede tessere grandi quanto un carattere.
+
+@syntax SCROLL TILEMAP resource [LEFT|RIGHT] [UP|DOWN]
+
+@example PUT TILEMAP level FROM 0, 0
+@example SCROLL TILEMAP level LEFT
+
+@target all
+</usermanual> */
+void scroll_tilemap( Environment * _environment, char * _tilemap, int _dx, int _dy ) {
+
+    if ( _environment->emptyProcedure ) {
+        return;
+    }
+
+    Variable * ptilemap = variable_retrieve( _environment, _tilemap );
+    if ( ptilemap->type != VT_TILEMAP ) {
+        CRITICAL_CANNOT_SCROLL_TILEMAP_FOR_NON_TILEMAP( _tilemap );
+    }
+    if ( ptilemap->onStorage || ! ptilemap->tileset ) {
+        CRITICAL_CANNOT_SCROLL_TILEMAP_FOR_TILEMAP_ON_STORAGE( _tilemap );
+    }
+    if ( ( ptilemap->tileset->frameWidth != _environment->fontWidth ) || ( ptilemap->tileset->frameHeight != _environment->fontHeight ) ) {
+        CRITICAL_CANNOT_SCROLL_TILEMAP_WITH_TILES_NOT_CELLS( _tilemap );
+    }
+
+    // The viewport is shared with PUT TILEMAP ... FROM.
+    Variable * dx = variable_retrieve_or_define( _environment, "puttilemap__dx", VT_BYTE, 0 );
+    Variable * dy = variable_retrieve_or_define( _environment, "puttilemap__dy", VT_BYTE, 0 );
+
+    deploy_begin( scroll_tilemap );
+
+        MAKE_LABEL
+
+        char labelLoop[MAX_TEMPORARY_STORAGE]; sprintf( labelLoop, "%sl", label );
+        char labelSkip[MAX_TEMPORARY_STORAGE]; sprintf( labelSkip, "%ss", label );
+        char labelStrip[MAX_TEMPORARY_STORAGE]; sprintf( labelStrip, "%sstrip", label );
+
+        // Parameters
+        Variable * tilemapAddress = variable_define( _environment, "scrolltilemap__tilemap", VT_ADDRESS, 0 );
+        Variable * tileset = variable_define( _environment, "scrolltilemap__tileset", VT_IMAGEREF, 0 );
+        Variable * mapWidth = variable_define( _environment, "scrolltilemap__mapWidth", VT_BYTE, 0 );
+        Variable * width = variable_define( _environment, "scrolltilemap__width", VT_BYTE, 0 );
+        Variable * height = variable_define( _environment, "scrolltilemap__height", VT_BYTE, 0 );
+        Variable * lastColumn = variable_define( _environment, "scrolltilemap__lastColumn", VT_BYTE, 0 );
+        Variable * lastRow = variable_define( _environment, "scrolltilemap__lastRow", VT_BYTE, 0 );
+        Variable * lastX = variable_define( _environment, "scrolltilemap__lastX", VT_POSITION, 0 );
+        Variable * lastY = variable_define( _environment, "scrolltilemap__lastY", VT_POSITION, 0 );
+        Variable * frameWidth = variable_define( _environment, "scrolltilemap__frameWidth", VT_BYTE, 0 );
+        Variable * frameHeight = variable_define( _environment, "scrolltilemap__frameHeight", VT_BYTE, 0 );
+        Variable * flags = variable_define( _environment, "scrolltilemap__flags", VT_WORD, 0 );
+
+        // Local variables
+        Variable * address = variable_define( _environment, "scrolltilemap__address", VT_ADDRESS, 0 );
+        Variable * column = variable_define( _environment, "scrolltilemap__column", VT_BYTE, 0 );
+        Variable * row = variable_define( _environment, "scrolltilemap__row", VT_BYTE, 0 );
+        Variable * x = variable_define( _environment, "scrolltilemap__x", VT_POSITION, 0 );
+        Variable * y = variable_define( _environment, "scrolltilemap__y", VT_POSITION, 0 );
+        Variable * stepX = variable_define( _environment, "scrolltilemap__stepX", VT_BYTE, 0 );
+        Variable * stepY = variable_define( _environment, "scrolltilemap__stepY", VT_BYTE, 0 );
+        Variable * step = variable_define( _environment, "scrolltilemap__step", VT_WORD, 0 );
+        Variable * count = variable_define( _environment, "scrolltilemap__count", VT_BYTE, 0 );
+        Variable * frame = variable_define( _environment, "scrolltilemap__frame", VT_BYTE, 0 );
+
+        // --------------------------------------------------------------------------
+        // Screen moved to the left: the viewport moves right, and the last
+        // column has to be drawn.
+        // --------------------------------------------------------------------------
+
+        cpu_label( _environment, "lib_scroll_tilemap_left" );
+        cpu_inc( _environment, dx->realName );
+        variable_move( _environment, variable_add( _environment, dx->name, lastColumn->name )->name, column->name );
+        variable_move( _environment, dy->name, row->name );
+        variable_move( _environment, lastX->name, x->name );
+        variable_store( _environment, y->name, 0 );
+        cpu_jump( _environment, labelStrip );
+
+        // --------------------------------------------------------------------------
+        // Screen moved to the right: the viewport moves left, and the first
+        // column has to be drawn.
+        // --------------------------------------------------------------------------
+
+        cpu_label( _environment, "lib_scroll_tilemap_right" );
+        cpu_dec( _environment, dx->realName );
+        variable_move( _environment, dx->name, column->name );
+        variable_move( _environment, dy->name, row->name );
+        variable_store( _environment, x->name, 0 );
+        variable_store( _environment, y->name, 0 );
+
+        // A column is made of "height" tiles, one map row apart.
+
+        cpu_label( _environment, labelStrip );
+        variable_store( _environment, stepX->name, 0 );
+        variable_move( _environment, frameHeight->name, stepY->name );
+        variable_move( _environment, mapWidth->name, step->name );
+        variable_move( _environment, height->name, count->name );
+        cpu_jump( _environment, "lib_scroll_tilemap_draw" );
+
+        // --------------------------------------------------------------------------
+        // Screen moved up: the viewport moves down, and the last row has 
+        // to be drawn.
+        // --------------------------------------------------------------------------
+
+        cpu_label( _environment, "lib_scroll_tilemap_up" );
+        cpu_inc( _environment, dy->realName );
+        variable_move( _environment, dx->name, column->name );
+        variable_move( _environment, variable_add( _environment, dy->name, lastRow->name )->name, row->name );
+        variable_store( _environment, x->name, 0 );
+        variable_move( _environment, lastY->name, y->name );
+        cpu_jump( _environment, "lib_scroll_tilemap_row" );
+
+        // --------------------------------------------------------------------------
+        // Screen moved down: the viewport moves up, and the first row has 
+        // to be drawn.
+        // --------------------------------------------------------------------------
+
+        cpu_label( _environment, "lib_scroll_tilemap_down" );
+        cpu_dec( _environment, dy->realName );
+        variable_move( _environment, dx->name, column->name );
+        variable_move( _environment, dy->name, row->name );
+        variable_store( _environment, x->name, 0 );
+        variable_store( _environment, y->name, 0 );
+
+        // A row is made of "width" consecutive tiles.
+
+        cpu_label( _environment, "lib_scroll_tilemap_row" );
+        variable_move( _environment, frameWidth->name, stepX->name );
+        variable_store( _environment, stepY->name, 0 );
+        variable_store( _environment, step->name, 1 );
+        variable_move( _environment, width->name, count->name );
+
+        // --------------------------------------------------------------------------
+        // Draw "count" tiles, starting from (column, row) of the map.
+        // --------------------------------------------------------------------------
+
+        cpu_label( _environment, "lib_scroll_tilemap_draw" );
+
+        variable_move( _environment, tilemapAddress->name, address->name );
+        variable_add_inplace_vars( _environment, address->name, variable_mul( _environment, row->name, mapWidth->name )->name );
+        variable_add_inplace_vars( _environment, address->name, column->name );
+
+        cpu_label( _environment, labelLoop );
+
+        cpu_peek( _environment, address->realName, frame->realName );
+        cpu_compare_and_branch_8bit_const( _environment, frame->realName, 0xff, labelSkip, 1 );
+        put_image_vars( _environment, tileset->name, x->name, y->name, NULL, NULL, frame->name, NULL, flags->realName );
+        cpu_label( _environment, labelSkip );
+
+        variable_add_inplace_vars( _environment, address->name, step->name );
+        variable_add_inplace_vars( _environment, x->name, stepX->name );
+        variable_add_inplace_vars( _environment, y->name, stepY->name );
+
+        cpu_dec( _environment, count->realName );
+        cpu_compare_and_branch_8bit_const( _environment, count->realName, 0, labelLoop, 0 );
+
+        cpu_return( _environment );
+
+    deploy_end( scroll_tilemap );
+
+    MAKE_LABEL
+
+    // The viewport cannot be larger than the map.
+
+    int widthConst = _environment->screenTilesWidth < ptilemap->mapWidth ? _environment->screenTilesWidth : ptilemap->mapWidth;
+    int heightConst = _environment->screenTilesHeight < ptilemap->mapHeight ? _environment->screenTilesHeight : ptilemap->mapHeight;
+
+    // If the viewport already touches the border of the map in the given
+    // direction, nothing has to be scrolled.
+
+    if ( _dx < 0 ) {
+        Variable * check = variable_less_than_const( _environment, dx->name, ptilemap->mapWidth - widthConst, 0 );
+        cpu_compare_and_branch_8bit_const( _environment, check->realName, 0x00, label, 1 );
+    } else if ( _dx > 0 ) {
+        cpu_compare_and_branch_8bit_const( _environment, dx->realName, 0x00, label, 1 );
+    }
+
+    if ( _dy < 0 ) {
+        Variable * check = variable_less_than_const( _environment, dy->name, ptilemap->mapHeight - heightConst, 0 );
+        cpu_compare_and_branch_8bit_const( _environment, check->realName, 0x00, label, 1 );
+    } else if ( _dy > 0 ) {
+        cpu_compare_and_branch_8bit_const( _environment, dy->realName, 0x00, label, 1 );
+    }
+
+    Variable * vtilemap = variable_retrieve( _environment, "scrolltilemap__tilemap" );
+    cpu_addressof_16bit( _environment, ptilemap->realName, vtilemap->realName );
+    variable_move( _environment, image_ref( _environment, ptilemap->tileset->name )->name, "scrolltilemap__tileset" );
+    variable_store( _environment, "scrolltilemap__mapWidth", ptilemap->mapWidth );
+    variable_store( _environment, "scrolltilemap__width", widthConst );
+    variable_store( _environment, "scrolltilemap__height", heightConst );
+    variable_store( _environment, "scrolltilemap__lastColumn", widthConst - 1 );
+    variable_store( _environment, "scrolltilemap__lastRow", heightConst - 1 );
+    variable_store( _environment, "scrolltilemap__lastX", ( widthConst - 1 ) * ptilemap->tileset->frameWidth );
+    variable_store( _environment, "scrolltilemap__lastY", ( heightConst - 1 ) * ptilemap->tileset->frameHeight );
+    variable_store( _environment, "scrolltilemap__frameWidth", ptilemap->tileset->frameWidth );
+    variable_store( _environment, "scrolltilemap__frameHeight", ptilemap->tileset->frameHeight );
+    variable_store( _environment, "scrolltilemap__flags", 0 );
+
+    // The drawing of the new column (or row) is hooked to the callbacks
+    // called by the hardware scroll when a whole cell has been scrolled.
+
+    if ( _dx < 0 ) {
+        cpu_set_callback( _environment, "ONSCROLLLEFT", "lib_scroll_tilemap_left" );
+    } else if ( _dx > 0 ) {
+        cpu_set_callback( _environment, "ONSCROLLRIGHT", "lib_scroll_tilemap_right" );
+    }
+
+    if ( _dy < 0 ) {
+        cpu_set_callback( _environment, "ONSCROLLUP", "lib_scroll_tilemap_up" );
+    } else if ( _dy > 0 ) {
+        cpu_set_callback( _environment, "ONSCROLLDOWN", "lib_scroll_tilemap_down" );
+    }
+
+    scroll( _environment, _dx, _dy );
+
+    cpu_label( _environment, label );
+
+}
@@ -0,0 +1,143 @@
+/*****************************************************************************
+ * ugBASIC - an isomorphic BASIC language compiler for retrocomputers        *
+ *****************************************************************************
+ * Copyright 2021-2025 Marco Spedaletti (asimov@mclink.it)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *----------------------------------------------------------------------------
+ * Concesso in licenza secondo i termini della Licenza Apache, versione 2.0
+ * (la "Licenza"); è proibito usare questo file se non in conformità alla
+ * Licenza. Una copia della Licenza è disponibile all'indirizzo:
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Se non richiesto dalla legislazione vigente o concordato per iscritto,
+ * il software distribuito nei termini della Licenza è distribuito
+ * "COSÌ COM'È", SENZA GARANZIE O CONDIZIONI DI ALCUN TIPO, esplicite o
+ * implicite. Consultare la Licenza per il testo specifico che regola le
+ * autorizzazioni e le limitazioni previste dalla medesima.
+ ****************************************************************************/
+
+/****************************************************************************
+ * INCLUDE SECTION 
+ ****************************************************************************/
+
+#include "../../ugbc.h"
+#include <math.h>
+
+/****************************************************************************
+ * CODE SECTION 
+ ****************************************************************************/
+
+static void sin_byte_table( Environment * _environment, char * _name, unsigned char * _values ) {
+
+    Variable * table = variable_define_no_init( _environment, _name, VT_BUFFER );
+    table->valueBuffer = malloc( 256 );
+    memcpy( table->valueBuffer, _values, 256 );
+    table->size = 256;
+
+}
+
+/**
+ * @brief Define the tables with the sine of the 256 binary angles
+ *
+ * The sine is stored as a 8.8 fixed point value (so 1.0 is 256), 
+ * splitted into a table for the low bytes and one for the high bytes:
+ * this way, the angle can be used as an 8 bit index on every CPU. 
+ * The tables are defined only once, the first time they are needed.
+ *
+ * @param _environment Current calling environment
+ */
+static void sin_byte_tables( Environment * _environment ) {
+
+    if ( variable_exists( _environment, "SINBYTEL" ) ) {
+        return;
+    }
+
+    unsigned char low[256];
+    unsigned char high[256];
+
+    for( int i=0; i<256; ++i ) {
+        int value = (int) lround( sin( ( 2.0 * M_PI * i ) / 256.0 ) * 256.0 );
+        low[i] = value & 0xff;
+        high[i] = ( value >> 8 ) & 0xff;
+    }
+
+    sin_byte_table( _environment, "SINBYTEL", low );
+    sin_byte_table( _environment, "SINBYTEH", high );
+
+}
+
+static void sin_byte_lookup( Environment * _environment, char * _angle, char * _result ) {
+
+    sin_byte_tables( _environment );
+
+    Variable * low = variable_retrieve( _environment, "SINBYTEL" );
+    Variable * high = variable_retrieve( _environment, "SINBYTEH" );
+
+#ifdef CPU_BIG_ENDIAN
+    cpu_move_8bit_indirect2_8bit( _environment, high->realName, _angle, _result );
+    cpu_move_8bit_indirect2_8bit( _environment, low->realName, _angle, address_displacement( _environment, _result, "1" ) );
+#else
+    cpu_move_8bit_indirect2_8bit( _environment, low->realName, _angle, _result );
+    cpu_move_8bit_indirect2_8bit( _environment, high->realName, _angle, address_displacement( _environment, _result, "1" ) );
+#endif
+
+}
+
+/**
+ * @brief Emit code for <strong>SIN(...)</strong> with binary angles
+ *
+ * With ''BINARY RADIAN'' a full turn is made by 256 steps, so the angle
+ * is a byte and the sine can be read from a table instead of being 
+ * calculated with floating point numbers. The result is a signed word
+ * with the sine in 8.8 fixed point (from -256 to 256).
+ *
+ * @param _environment Current calling environment
+ * @param _angle Angle (0...255)
+ * @return Variable* The sine of the angle
+ */
+Variable * sin_byte( Environment * _environment, char * _angle ) {
+
+    Variable * angle = variable_cast( _environment, variable_retrieve_or_define( _environment, _angle, VT_BYTE, 0 )->name, VT_BYTE );
+    Variable * result = variable_temporary( _environment, VT_SWORD, "(sin)");
+
+    sin_byte_lookup( _environment, angle->realName, result->realName );
+
+    return result;
+
+}
+
+/**
+ * @brief Emit code for <strong>COS(...)</strong> with binary angles
+ *
+ * The cosine is read from the same table of the sine, since 
+ * cos(a) = sin(a + 64) on a circle of 256 steps.
+ *
+ * @param _environment Current calling environment
+ * @param _angle Angle (0...255)
+ * @return Variable* The cosine of the angle
+ */
+Variable * cos_byte( Environment * _environment, char * _angle ) {
+
+    Variable * angle = variable_cast( _environment, variable_retrieve_or_define( _environment, _angle, VT_BYTE, 0 )->name, VT_BYTE );
+    Variable * shifted = variable_temporary( _environment, VT_BYTE, "(angle)");
+    Variable * result = variable_temporary( _environment, VT_SWORD, "(cos)");
+
+    cpu_math_add_8bit_const( _environment, angle->realName, 64, shifted->realName );
+
+    sin_byte_lookup( _environment, shifted->realName, result->realName );
+
+    return result;
+
+}
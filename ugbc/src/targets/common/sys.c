@@ -149,6 +149,8 @@ può essere utile aggiungere la specifica del target ''ON''.
 </usermanual> */
 void sys( Environment * _environment, int _address ) {
 
+    variable_array_walk_invalidate( _environment );
+
     if ( _environment->parameters ) {
         for( int i=0; i<_environment->parameters; ++i ) {
             if ( _environment->parametersEach[i] ) {
@@ -175,6 +177,8 @@ void sys( Environment * _environment, int _address ) {
 
 void sys_var( Environment * _environment, char * _address ) {
 
+    variable_array_walk_invalidate( _environment );
+
     Variable  * address = variable_retrieve_or_define( _environment, _address, VT_ADDRESS, 0 );
 
     if ( _environment->parameters ) {
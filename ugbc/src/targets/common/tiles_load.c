@@ -234,6 +234,7 @@ Variable * tiles_load( Environment * _environment, char * _filename, int _flags,
         if ( ! _environment->descriptors ) {
             // printf("On demand allocating...\n");
             _environment->descriptors = malloc( sizeof( TileDescriptors ) );
+            memset( _environment->descriptors, 0, sizeof( TileDescriptors ) );
             _environment->descriptors->count = 0;
             _environment->descriptors->first = 128;
             _environment->descriptors->firstFree = _environment->descriptors->first;
@@ -0,0 +1,292 @@
+/*****************************************************************************
+ * ugBASIC - an isomorphic BASIC language compiler for retrocomputers        *
+ *****************************************************************************
+ * Copyright 2021-2025 Marco Spedaletti (asimov@mclink.it)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *----------------------------------------------------------------------------
+ * Concesso in licenza secondo i termini della Licenza Apache, versione 2.0
+ * (la "Licenza"); è proibito usare questo file se non in conformità alla
+ * Licenza. Una copia della Licenza è disponibile all'indirizzo:
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Se non richiesto dalla legislazione vigente o concordato per iscritto,
+ * il software distribuito nei termini della Licenza è distribuito
+ * "COSÌ COM'È", SENZA GARANZIE O CONDIZIONI DI ALCUN TIPO, esplicite o
+ * implicite. Consultare la Licenza per il testo specifico che regola le
+ * autorizzazioni e le limitazioni previste dalla medesima.
+ ****************************************************************************/
+
+/****************************************************************************
+ * INCLUDE SECTION
+ ****************************************************************************/
+
+#include "../../ugbc.h"
+
+/****************************************************************************
+ * CODE SECTION
+ ****************************************************************************/
+
+/*
+ * The compiler emits the code of each operation as soon as it is parsed,
+ * so there is no intermediate representation to optimize. However, for
+ * each statement, the values calculated by simple operations are recorded
+ * with their operands (in three address form, like "+(_x,#1)") and with
+ * the range of code that calculates them. This way, a value that has
+ * already been calculated by the statement can be found again, and the
+ * code (and the temporary variable) of a value that is no longer needed
+ * can be removed, as long as it is the last code emitted.
+ *
+ * The records are valid only until a variable is written, a procedure is
+ * called or a label is defined, and in any case until the end of the
+ * statement.
+ */
+
+/**
+ * @brief Start recording the code that calculates a value
+ *
+ * @param _environment Current calling environment
+ * @param _buffer Output buffer (level) of the code
+ * @return int Position of the code, or -1 if it cannot be recorded
+ */
+int value_record_begin( Environment * _environment, int * _buffer ) {
+
+    *_buffer = _environment->currentBufferOutput;
+
+    if ( _environment->libraryOutputDepth ) {
+        return -1;
+    }
+
+    return _environment->bufferOutputSize[_environment->currentBufferOutput];
+
+}
+
+/**
+ * @brief Describe the value held by a variable
+ *
+ * A variable of the program is described by its name, a constant by its
+ * value and a temporary variable by the operation that calculated it, if
+ * it has been recorded.
+ *
+ * @param _environment Current calling environment
+ * @param _variable Variable to describe
+ * @param _signature Description of the value (at least MAX_TEMPORARY_STORAGE bytes)
+ * @return int 1 if the value can be described, 0 otherwise
+ */
+int value_record_signature( Environment * _environment, Variable * _variable, char * _signature ) {
+
+    if ( VT_BITWIDTH( _variable->type ) < 8 ) {
+        return 0;
+    }
+
+    if ( ! _variable->temporary ) {
+        return snprintf( _signature, MAX_TEMPORARY_STORAGE, "%s", _variable->realName ) < MAX_TEMPORARY_STORAGE;
+    }
+
+    if ( _variable->initializedByConstant ) {
+        sprintf( _signature, "#%d:%d", _variable->value, _variable->type );
+        return 1;
+    }
+
+    ValueRecord * record = _environment->valueRecords;
+    while( record ) {
+        if ( record->result == _variable ) {
+            strcpy( _signature, record->signature );
+            return 1;
+        }
+        record = record->next;
+    }
+
+    return 0;
+
+}
+
+static void value_record_add( Environment * _environment, char * _signature, Variable * _result, int _start ) {
+
+    ValueRecord * record = malloc( sizeof( ValueRecord ) );
+    memset( record, 0, sizeof( ValueRecord ) );
+    record->signature = strdup( _signature );
+    record->result = _result;
+    record->buffer = _environment->currentBufferOutput;
+    record->start = _start;
+    record->end = _environment->bufferOutputSize[_environment->currentBufferOutput];
+    record->next = _environment->valueRecords;
+    _environment->valueRecords = record;
+
+}
+
+/**
+ * @brief Record the value calculated by an operation
+ *
+ * @param _environment Current calling environment
+ * @param _operation Operation (like "+")
+ * @param _left First operand
+ * @param _right Second operand
+ * @param _result Temporary variable with the result
+ * @param _buffer Output buffer (level) of the code (see value_record_begin())
+ * @param _start Position of the code (see value_record_begin())
+ */
+void value_record( Environment * _environment, char * _operation, Variable * _left, Variable * _right, Variable * _result, int _buffer, int _start ) {
+
+    if ( _start < 0 || _environment->libraryOutputDepth ) {
+        return;
+    }
+
+    // The code must have been emitted into a single output buffer,
+    // otherwise its range is meaningless.
+    if ( _buffer != _environment->currentBufferOutput ) {
+        return;
+    }
+
+    if ( ! _result->temporary || _result->initializedByConstant || _result == _left || _result == _right ) {
+        return;
+    }
+
+    if ( VT_BITWIDTH( _result->type ) < 8 ) {
+        return;
+    }
+
+    char left[MAX_TEMPORARY_STORAGE];
+    char right[MAX_TEMPORARY_STORAGE];
+
+    if ( ! value_record_signature( _environment, _left, left ) || ! value_record_signature( _environment, _right, right ) ) {
+        return;
+    }
+
+    char signature[MAX_TEMPORARY_STORAGE];
+    if ( snprintf( signature, MAX_TEMPORARY_STORAGE, "%s(%s,%s):%d", _operation, left, right, _result->type ) >= MAX_TEMPORARY_STORAGE ) {
+        return;
+    }
+
+    value_record_add( _environment, signature, _result, _start );
+
+}
+
+/**
+ * @brief Record a value whose code must not be removed
+ *
+ * The value can be kept as the sum of two variables, if the one that
+ * held it has been changed in place: this way, no copy is needed.
+ *
+ * @param _environment Current calling environment
+ * @param _signature Description of the value
+ * @param _result Temporary variable with the value
+ * @param _addend Temporary variable to add to _result (or NULL)
+ */
+void value_record_store( Environment * _environment, char * _signature, Variable * _result, Variable * _addend ) {
+
+    if ( _environment->libraryOutputDepth ) {
+        return;
+    }
+
+    value_record_add( _environment, _signature, _result, -1 );
+    _environment->valueRecords->addend = _addend;
+
+}
+
+/**
+ * @brief Find a value already calculated by the current statement
+ *
+ * @param _environment Current calling environment
+ * @param _signature Description of the value
+ * @param _addend Variable to add to the result, if any (can be NULL)
+ * @return Variable* The variable with the value, or NULL
+ */
+Variable * value_record_find( Environment * _environment, char * _signature, Variable ** _addend ) {
+
+    if ( _environment->libraryOutputDepth ) {
+        return NULL;
+    }
+
+    ValueRecord * record = _environment->valueRecords;
+    while( record ) {
+        if ( !strcmp( record->signature, _signature ) ) {
+            if ( _addend ) {
+                *_addend = record->addend;
+            }
+            return record->result;
+        }
+        record = record->next;
+    }
+
+    return NULL;
+
+}
+
+/**
+ * @brief Remove the code of a value that is no longer needed
+ *
+ * The code can be removed only if it is the last one emitted into the
+ * same output buffer where it has been recorded. The
+ * temporary variable is released, and it can be used again by the
+ * same statement.
+ *
+ * @param _environment Current calling environment
+ * @param _variable Variable with the value
+ * @return int 1 if the code has been removed, 0 otherwise
+ */
+int value_record_drop( Environment * _environment, Variable * _variable ) {
+
+    if ( _environment->libraryOutputDepth ) {
+        return 0;
+    }
+
+    ValueRecord * previous = NULL;
+    ValueRecord * record = _environment->valueRecords;
+    while( record ) {
+        if ( record->result == _variable ) {
+            break;
+        }
+        previous = record;
+        record = record->next;
+    }
+
+    if ( ! record || record->start < 0 || record->start > record->end ||
+        record->buffer != _environment->currentBufferOutput ||
+        record->end != _environment->bufferOutputSize[_environment->currentBufferOutput] ) {
+        return 0;
+    }
+
+    _environment->bufferOutputSize[_environment->currentBufferOutput] = record->start;
+    _variable->used = 0;
+
+    if ( previous ) {
+        previous->next = record->next;
+    } else {
+        _environment->valueRecords = record->next;
+    }
+    free( record->signature );
+    free( record );
+
+    return 1;
+
+}
+
+/**
+ * @brief Forget all the values recorded
+ *
+ * @param _environment Current calling environment
+ */
+void value_record_reset( Environment * _environment ) {
+
+    ValueRecord * record = _environment->valueRecords;
+    while( record ) {
+        ValueRecord * next = record->next;
+        free( record->signature );
+        free( record );
+        record = next;
+    }
+    _environment->valueRecords = NULL;
+
+}
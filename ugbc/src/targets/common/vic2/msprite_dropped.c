@@ -0,0 +1,84 @@
+/*****************************************************************************
+ * ugBASIC - an isomorphic BASIC language compiler for retrocomputers        *
+ *****************************************************************************
+ * Copyright 2021-2025 Marco Spedaletti (asimov@mclink.it)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *----------------------------------------------------------------------------
+ * Concesso in licenza secondo i termini della Licenza Apache, versione 2.0
+ * (la "Licenza"); è proibito usare questo file se non in conformità alla
+ * Licenza. Una copia della Licenza è disponibile all'indirizzo:
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Se non richiesto dalla legislazione vigente o concordato per iscritto,
+ * il software distribuito nei termini della Licenza è distribuito
+ * "COSÌ COM'È", SENZA GARANZIE O CONDIZIONI DI ALCUN TIPO, esplicite o
+ * implicite. Consultare la Licenza per il testo specifico che regola le
+ * autorizzazioni e le limitazioni previste dalla medesima.
+ ****************************************************************************/
+
+/****************************************************************************
+ * INCLUDE SECTION 
+ ****************************************************************************/
+
+#include "../../../ugbc.h"
+
+/****************************************************************************
+ * CODE SECTION 
+ ****************************************************************************/
+
+#if defined(__c64__) || defined(__c64reu__) || defined(__c128__)
+
+/**
+ * @brief Emit code for <strong>MSPRITE DROPPED</strong>
+ * 
+ * @param _environment Current calling environment
+ * @return the number of multiplexed sprites dropped on the last frame
+ */
+/* <usermanual>
+@keyword MSPRITE DROPPED
+
+@english
+
+This function returns the number of multiplexed sprites that were not 
+drawn during the last update, since too many of them were on the same 
+raster lines. It is useful to tune the number and the position of the 
+sprites on the screen.
+
+@italian 
+
+Questa funzione restituisce il numero di sprite multiplexed che non 
+sono stati disegnati durante l'ultimo aggiornamento, in quanto troppi 
+di essi si trovavano sulle stesse linee di raster. E' utile per 
+regolare il numero e la posizione degli sprite sullo schermo.
+
+@syntax = MSPRITE DROPPED
+
+@example PRINT MSPRITE DROPPED
+
+@target c64
+@target c128
+@target c64reu
+</usermanual> */
+Variable * msprite_dropped( Environment * _environment ) {
+
+    Variable * result = variable_temporary( _environment, VT_BYTE, "(msprite dropped)" );
+
+    cpu_move_8bit( _environment, "MSPRITESDROPPED", result->realName );
+
+    return result;
+
+}
+
+#endif
@@ -80,6 +80,15 @@ static void variable_cleanup_entry( Environment * _environment, Variable * _firs
                         outline1("%s: defs 16", variable->realName);
                     }
                     break;
+                case VT_BCD4:
+                case VT_BCD6:
+                case VT_BCD8:
+                    if ( variable->memoryArea ) {
+                        outline2("%s: EQU $%4.4x", variable->realName, variable->absoluteAddress);
+                    } else {
+                        outline2("%s: defs %d", variable->realName, VT_BCD_BYTES( variable->type ) );
+                    }
+                    break;
                 case VT_VECTOR2:
                     if ( variable->memoryArea ) {
                         outline2("%s: EQU $%4.4x", variable->realName, variable->absoluteAddress);
@@ -49,4 +49,11 @@
 </usermanual> */
 void double_buffer( Environment * _environment, int _enabled ) {
 
+    // A second screen needs another 16 KB bank ($4000-$7FFF), where the
+    // program is loaded, and the drawing routines use fixed row tables
+    // based on $C000.
+    if ( _enabled ) {
+        WARNING_DOUBLE_BUFFER_UNSUPPORTED( );
+    }
+
 }
@@ -67,6 +67,11 @@ void sound( Environment * _environment, int _freq, int _delay, int _channels ) {
 
     int chipsetFrequency = ( 4000000 / _freq ) / 16;
 
+    if ( _delay && _environment->audioConfig.async ) {
+        ay8910_queue_sound( _environment, _channels, chipsetFrequency, _delay / 20, _environment->audioConfig.priority + 1 );
+        return;
+    }
+
     ay8910_start( _environment, ( _channels & 0x07 ) );
     ay8910_set_frequency( _environment, _channels, chipsetFrequency );
     if ( _delay ) {
@@ -106,6 +111,18 @@ void sound_vars( Environment * _environment, char * _freq, char * _delay, char *
                             NULL
                             );
 
+    if ( _delay && _environment->audioConfig.async ) {
+        Variable * delay = variable_retrieve_or_define( _environment, _delay, VT_WORD, 0 );
+        Variable * durationInTicks = variable_cast( _environment, variable_div_const( _environment, delay->name, 20, NULL )->name, VT_WORD );
+        if ( _channels ) {
+            Variable * channels = variable_retrieve_or_define( _environment, _channels, VT_WORD, 0x07 );
+            ay8910_queue_sound_vars( _environment, channels->realName, chipsetFrequency->realName, durationInTicks->realName, _environment->audioConfig.priority + 1 );
+        } else {
+            ay8910_queue_sound_vars( _environment, NULL, chipsetFrequency->realName, durationInTicks->realName, _environment->audioConfig.priority + 1 );
+        }
+        return;
+    }
+
     if ( _channels ) {
         Variable * channels = variable_retrieve_or_define( _environment, _channels, VT_WORD, 0x07 );
         ay8910_start_var( _environment, channels->realName );
@@ -2668,6 +2668,7 @@ void target_peephole_optimizer( Environment * _environment ) {
 
     // optim_used_temporary( _environment );
 
+    optim_timer_context_6809( _environment );
     // printf("FIRST 1)\n");
     optim_remove_unused_temporary( _environment );
 
@@ -2723,6 +2724,8 @@ void target_finalize( Environment * _environment ) {
 
         adiline0( "A:0" );
 
+        hotspot_begin( _environment );
+
         fileAsm = fopen( _environment->asmFileName, "rb" );
         if(fileAsm == NULL) {
             perror(_environment->asmFileName);
@@ -2754,6 +2757,8 @@ void target_finalize( Environment * _environment ) {
                 continue;
             }
 
+            hotspot_instruction( _environment, _environment->currentSourceLineAnalyzed, bufferAsm->str, leftPadding == 0 );
+
             *bufferListing->str = 0;
             int pos = ftell( fileListing );
             while( !feof(fileListing) && (strstr( bufferListing->str, bufferAsm->str ) == NULL) ) {
@@ -2799,6 +2804,8 @@ void target_finalize( Environment * _environment ) {
                 _environment->bytesProduced );
         }
 
+        hotspot_end( _environment );
+
         (void)fclose(fileListing);
         (void)fclose(fileAsm);
 
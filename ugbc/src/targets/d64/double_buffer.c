@@ -49,4 +49,8 @@
 </usermanual> */
 void double_buffer( Environment * _environment, int _enabled ) {
 
+    if ( _enabled ) {
+        WARNING_DOUBLE_BUFFER_UNSUPPORTED( );
+    }
+
 }
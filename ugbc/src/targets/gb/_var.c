@@ -88,6 +88,17 @@ static void variable_cleanup_entry( Environment * _environment, Variable * _firs
                         outhead0("section code");
                     }
                     break;
+                case VT_BCD4:
+                case VT_BCD6:
+                case VT_BCD8:
+                    if ( variable->memoryArea ) {
+                        outline2("%s: EQU $%4.4x", variable->realName, variable->absoluteAddress);
+                    } else {
+                        outhead0("section data");
+                        outline2("%s: defs %d", variable->realName, VT_BCD_BYTES( variable->type ) );
+                        outhead0("section code");
+                    }
+                    break;
                 case VT_VECTOR2:
                     if ( variable->memoryArea ) {
                         outline2("%s: EQU $%4.4x", variable->realName, variable->absoluteAddress);
@@ -606,6 +617,8 @@ void variable_cleanup( Environment * _environment ) {
 
     outhead0("SECTION data");
     outhead0("ORG $c000");
+    // The shadow OAM must be aligned to 256 bytes, for the OAM DMA.
+    outhead0("SHADOWOAM: DEFS 160");
     outhead0("SECTION code");
 
     deploy_inplace_preferred( startup, src_hw_gb_startup_asm);
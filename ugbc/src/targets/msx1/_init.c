@@ -109,7 +109,7 @@ void target_initialization( Environment * _environment ) {
     variable_import( _environment, "JOYSTICK1", VT_BYTE, 0 );
     variable_global( _environment, "JOYSTICK1" );   
 
-    variable_import( _environment, "AY8910TIMER", VT_BUFFER, 6 );
+    variable_import( _environment, "AY8910TIMER", VT_BUFFER, 8 );
     variable_global( _environment, "AY8910TIMER" );    
 
     variable_import( _environment, "KBDCHAR", VT_BYTE, 0 );
@@ -1293,6 +1293,7 @@ static void optim_remove_comments( Environment * _environment ) {
 /* main entry-point for this service */
 void target_peephole_optimizer( Environment * _environment ) {
 
+    optim_timer_context_8086( _environment );
     optim_remove_unused_temporary( _environment );
 
     if ( _environment->peepholeOptimizationLimit > 0 ) {
@@ -1340,6 +1341,8 @@ void target_finalize( Environment * _environment ) {
 
         adiline0( "A:0" );
 
+        hotspot_begin( _environment );
+
         fileAsm = fopen( _environment->asmFileName, "rb" );
         if(fileAsm == NULL) {
             perror(_environment->asmFileName);
@@ -1371,6 +1374,8 @@ void target_finalize( Environment * _environment ) {
                 continue;
             }
 
+            hotspot_instruction( _environment, _environment->currentSourceLineAnalyzed, bufferAsm->str, leftPadding == 0 );
+
             *bufferListing->str = 0;
             int pos = ftell( fileListing );
             po_buf_trim( bufferAsm );
@@ -1408,6 +1413,8 @@ void target_finalize( Environment * _environment ) {
                 _environment->bytesProduced );
         }
 
+        hotspot_end( _environment );
+
         (void)fclose(fileListing);
         (void)fclose(fileAsm);
 
@@ -70,6 +70,7 @@ void linker_setup( Environment * _environment ) {
     cfgline0("LOADADDR: load = LOADADDR, type = ro;");
     cfgline0("EXEHDR:   load = MAIN,     type = ro,  optional = yes;");
     cfgline0("CODE:     load = MAIN,     type = rw;");
+    cfgline0("LIB:      load = MAIN,     type = rw,  optional = yes;");
     cfgline0("RODATA:   load = MAIN,     type = ro,  optional = yes;");
     cfgline0("DATA:     load = MAIN,     type = rw,  optional = yes;");
     cfgline0("BSS:      load = MAIN,     type = bss, optional = yes, define = yes;");
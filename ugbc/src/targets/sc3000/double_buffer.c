@@ -46,7 +46,23 @@
  */
 /* <usermanual>
 @keyword DOUBLE BUFFER
+
+@target sc3000
 </usermanual> */
 void double_buffer( Environment * _environment, int _enabled ) {
 
+    deploy( doubleBuffer, src_hw_tms9918_double_buffer_asm );
+
+    if ( _environment->doubleBufferEnabled != _enabled ) {
+
+        _environment->doubleBufferEnabled = _enabled;
+
+        if ( _enabled ) {
+            outline0("CALL DOUBLEBUFFERINIT");
+        } else {
+            outline0("CALL DOUBLEBUFFERCLEANUP");
+        }
+
+    };
+
 }
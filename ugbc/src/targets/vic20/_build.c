@@ -107,6 +107,9 @@ void generate_d64( Environment * _environment ) {
 
     if ( !storage ) {
         D64Handle * handle = d64_create( CBMDOS );
+        if ( _environment->diskInterleave ) {
+            d64_set_interleave( handle, _environment->diskInterleave );
+        }
         d64_write_file( handle, "MAIN", FT_PRG, prgContent, prgSize );
         d64_output( handle, d64FileName );
         if ( _environment->outputGeneratedFiles ) {
@@ -117,6 +120,9 @@ void generate_d64( Environment * _environment ) {
         int i=0;
         while( storage ) {
             D64Handle * handle = d64_create( CBMDOS );
+            if ( _environment->diskInterleave ) {
+                d64_set_interleave( handle, _environment->diskInterleave );
+            }
             if ( i == 0 ) {
                 d64_write_file( handle, "MAIN", FT_PRG, prgContent, prgSize );
             }
@@ -64,6 +64,7 @@ void linker_setup( Environment * _environment ) {
     cfgline0("BSS:      load = MAIN,  type = bss, optional = yes;");
     cfgline0("UDCCHAR:  load = MAIN, type = overwrite,  optional = yes, start = $1800;");
     cfgline1("CODE:     load = MAIN,  type = overwrite,  optional = yes, start = $%4.4x;", _environment->program.startingAddress);
+    cfgline0("LIB:      load = MAIN,  type = rw,  optional = yes;");
 
 }
 
@@ -59,6 +59,15 @@ static void variable_cleanup_entry( Environment * _environment, Variable * _firs
                         vars_emit_byte( _environment, variable->realName, variable->initialValue );
                     }
                     break;
+                case VT_BCD4:
+                case VT_BCD6:
+                case VT_BCD8:
+                    if ( variable->memoryArea ) {
+                        outline2("%s: EQU $%4.4x", variable->realName, variable->absoluteAddress);
+                    } else {
+                        outline2("%s: defs %d", variable->realName, VT_BCD_BYTES( variable->type ) );
+                    }
+                    break;
                 case VT_DOJOKA:
                     if ( variable->memoryArea ) {
                         outline2("%s: EQU $%4.4x", variable->realName, variable->absoluteAddress);
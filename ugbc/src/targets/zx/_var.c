@@ -65,6 +65,11 @@ static void variable_cleanup_entry( Environment * _environment, Variable * _firs
                 case VT_PATH:
                     outline1("%s: defs 16", variable->realName);
                     break;
+                case VT_BCD4:
+                case VT_BCD6:
+                case VT_BCD8:
+                    outline2("%s: defs %d", variable->realName, VT_BCD_BYTES( variable->type ) );
+                    break;
                 case VT_VECTOR2:
                     outline1("%s: defs 4", variable->realName);
                     break;
@@ -49,4 +49,11 @@
 </usermanual> */
 void double_buffer( Environment * _environment, int _enabled ) {
 
+    // The shadow screen needs the 128K paging ($7FFD), that is not
+    // supported, and the drawing routines use the fixed row table at
+    // $4000 (ROWSADDRESS).
+    if ( _enabled ) {
+        WARNING_DOUBLE_BUFFER_UNSUPPORTED( );
+    }
+
 }
@@ -523,6 +523,10 @@ const_factor:
                 $$ = ((struct _Environment *)_environment)->deployed.dsave;
             } else if ( strcmp( $3, "dcommon" ) == 0 ) {
                 $$ = ((struct _Environment *)_environment)->deployed.dcommon;
+            } else if ( strcmp( $3, "fastload" ) == 0 ) {
+                $$ = ((struct _Environment *)_environment)->deployed.fastload;
+            } else if ( strcmp( $3, "dloadasync" ) == 0 ) {
+                $$ = ((struct _Environment *)_environment)->deployed.dloadasync;
             } else if ( strcmp( $3, "msprites" ) == 0 ) {
                 $$ = ((struct _Environment *)_environment)->deployed.msprite;
             } else if ( strcmp( $3, "flash" ) == 0 ) {
@@ -557,6 +561,8 @@ const_factor:
                 $$ = ((struct _Environment *)_environment)->deployed.joystick;
             } else if ( strcmp( $3, "fp" ) == 0 ) {
                 $$ = ((struct _Environment *)_environment)->deployed.fp_vars;
+            } else if ( strcmp( $3, "textAtGraphic" ) == 0 ) {
+                $$ = ((struct _Environment *)_environment)->deployed.textEncodedAtGraphic;
             } else {
                 $$ = 0;
             }
@@ -586,6 +592,10 @@ const_factor:
             $$ = ((struct _Environment *)_environment)->transparencyCoarse;
         } else if ( strcmp( $1, "printSafe" ) == 0 ) {
             $$ = ((struct _Environment *)_environment)->printSafe;
+        } else if ( strcmp( $1, "printCache" ) == 0 ) {
+            $$ = ((struct _Environment *)_environment)->printCache;
+        } else if ( strcmp( $1, "screenCache" ) == 0 ) {
+            $$ = ((struct _Environment *)_environment)->screenCache;
         } else if ( strcmp( $1, "putImageSafe" ) == 0 ) {
             $$ = ((struct _Environment *)_environment)->putImageSafe;
         } else if ( strcmp( $1, "getImageSafe" ) == 0 ) {
@@ -540,7 +540,16 @@ typedef enum _VariableType {
     VT_TYPE = 34,
 
     /** NUMBER */
-    VT_NUMBER = 35
+    VT_NUMBER = 35,
+
+    /** BCD (packed decimal, 4 digits) */
+    VT_BCD4 = 36,
+
+    /** BCD (packed decimal, 6 digits) */
+    VT_BCD6 = 37,
+
+    /** BCD (packed decimal, 8 digits) */
+    VT_BCD8 = 38
 
 } VariableType;
 
@@ -561,6 +570,7 @@ typedef struct _Resource {
 #define MAX_PARAMETERS                  256
 #define MAX_PALETTE                     256
 #define MAX_TILESETS                    256
+#define TILE_DESCRIPTORS_HASH_SIZE      512
 #define MAX_NESTED_ARRAYS               16
 #define MAX_PROCEDURES                  4096
 #define MAX_RESIDENT_SHAREDS            128
@@ -635,10 +645,21 @@ typedef struct _Resource {
                     ( ( (t) == (VT_FLOAT) ) ? VT_FLOAT : 0 ) + \
                     ( ( (t) == (VT_POSITION) ) ? VT_POSITION : 0 ) + \
                     ( ( (t) == (VT_ADDRESS) ) ? VT_ADDRESS : 0 ) + \
-                    ( ( (t) == (VT_COLOR) ) ? VT_COLOR : 0 ) \
+                    ( ( (t) == (VT_COLOR) ) ? VT_COLOR : 0 ) + \
+                    ( ( (t) == (VT_BCD4) ) ? VT_BCD4 : 0 ) + \
+                    ( ( (t) == (VT_BCD6) ) ? VT_BCD6 : 0 ) + \
+                    ( ( (t) == (VT_BCD8) ) ? VT_BCD8 : 0 ) \
                 ) \
             : t )
 
+// Packed BCD values are stored with the most significant pair of digits
+// first, whatever the endianness of the CPU.
+#define VT_BCD( t ) \
+        ( ( (t) == VT_BCD4 ) || ( (t) == VT_BCD6 ) || ( (t) == VT_BCD8 ) )
+
+#define VT_BCD_BYTES( t ) \
+        ( VT_VALUE( t, VT_BCD4, 2 ) + VT_VALUE( t, VT_BCD6, 3 ) + VT_VALUE( t, VT_BCD8, 4 ) )
+
 #define VT_SIGN_8BIT( v ) ( v < 0 ? ( ((~(unsigned char)(abs(v)))+1 ) ) : (v) )
 #define VT_SIGN_16BIT( v ) ( v < 0 ? ( ((~(unsigned short)(abs(v)))+1 ) ) : (v) )
 #define VT_SIGN_32BIT( v ) ( v < 0 ? ( (~((unsigned int) (abs(v)))+1 ) ) : (v) )
@@ -854,7 +875,8 @@ typedef enum _FloatTypePrecision {
 typedef enum _FloatTypeAngle {
 
     FT_RADIAN = 0,        // radiants
-    FT_DEGREE = 1          // degrees
+    FT_DEGREE = 1,         // degrees
+    FT_BYTE = 2            // binary radians (256 steps per turn)
 
 } FloatTypeAngle;
 
@@ -1306,11 +1328,44 @@ typedef struct _Procedure {
      */
     VariableType returnsTypeEach[MAX_PARAMETERS];
 
+    /**
+     * Has been defined with INLINE PROCEDURE?
+     */
+    int inlineRequested;
+
+    /**
+     * Assembly of the body, if the procedure can be expanded inline
+     */
+    char * inlineBody;
+
+    /**
+     * Does the body call other procedures?
+     */
+    int inlineCalls;
+
+    /**
+     * Number of call sites expanded inline
+     */
+    int inlineExpansions;
+
+    /**
+     * Assembly of the out-of-line copy, emitted only if it is referenced
+     */
+    char * outOfLine;
+
     /** Link to the next procedure (NULL if this is the last one) */
     struct _Procedure * next;
 
 } Procedure;
 
+/**
+ * @brief Maximum number of instructions of a procedure expanded inline
+ * (without INLINE PROCEDURE), by optimization mode
+ */
+#define PROCEDURE_INLINE_THRESHOLD          16
+#define PROCEDURE_INLINE_THRESHOLD_SPEED    48
+#define PROCEDURE_INLINE_THRESHOLD_SIZE     4
+
 /**
  * @brief Types of conditional jumps supported.
  */
@@ -1357,11 +1412,69 @@ typedef struct _Conditional {
     /** In case of CT_SELECT_CASE, case else has been emitted?. */
     int caseElse;
 
+    /** The branch being compiled will never be executed (its condition is a constant). */
+    int dead;
+
+    /** A previous branch is executed for sure: the next ones are dead. */
+    int taken;
+
+    /** Level and offset of the output where the dead branch starts. */
+    int deadLevel;
+    int deadStart;
+
+    /** The dead branch defines a label, so it must be kept. */
+    int deadKept;
+
     /** Next conditional */
     struct _Conditional * next;
 
 } Conditional;
 
+/**
+ * @brief Structure of an array walked by a FOR loop.
+ */
+typedef struct _ArrayWalk {
+
+    /** Name of the array. */
+    char * name;
+
+    /** Address of the element indexed by the loop (resident). */
+    Variable * pointer;
+
+    /** Size of each element (in bytes). */
+    int size;
+
+    /** Next array */
+    struct _ArrayWalk * next;
+
+} ArrayWalk;
+
+/**
+ * @brief Structure of a value calculated by the current statement.
+ */
+typedef struct _ValueRecord {
+
+    /** Operation and operands, like "+(_x,#1)". */
+    char * signature;
+
+    /** Variable that holds the value. */
+    struct _Variable * result;
+
+    /** Variable to add to result to obtain the value (if any). */
+    struct _Variable * addend;
+
+    /** Output buffer (level) that holds the code. */
+    int buffer;
+
+    /** Code that calculates the value (if -1, it cannot be removed). */
+    int start;
+    int end;
+
+    /** Next value */
+    struct _ValueRecord * next;
+
+} ValueRecord;
+
 /**
  * @brief Types of loops supported.
  */
@@ -1430,6 +1543,18 @@ typedef struct _Loop {
     Variable *zero;
 
     int statical;
+
+    /** Arrays walked by the index (see variable_array_walk_begin()). */
+    ArrayWalk * walks;
+
+    /** The walks are calculated by a subroutine, called on FOR. */
+    int walkable;
+
+    /** Level of the output buffer where the loop has been opened. */
+    int walkBuffer;
+
+    /** The index could have been written: walks must be recalculated. */
+    int walkSync;
     
     /** Next conditional */
     struct _Loop * next;
@@ -1701,6 +1826,71 @@ typedef struct _Embedded {
 
 } Embedded;
 
+/**
+ * @brief Optimization mode (OPTIMIZE SPEED|SIZE|BALANCED)
+ * 
+ * It drives the choice, for each call site, between the inline expansion
+ * of a primitive and the call to its embedded module.
+ */
+typedef enum _OptimizeMode {
+
+    /** Default: only the modules selected with -e are called */
+    OPTIMIZE_MODE_DEFAULT = 0,
+
+    /** Always inline */
+    OPTIMIZE_MODE_SPEED = 1,
+
+    /** Call whenever the call site is smaller than the inline expansion */
+    OPTIMIZE_MODE_SIZE = 2,
+
+    /** Inline inside loops and hot procedures, call elsewhere */
+    OPTIMIZE_MODE_BALANCED = 3
+
+} OptimizeMode;
+
+/**
+ * @brief Cost of a primitive that has both an inline and an embedded version
+ */
+typedef struct _EmbeddedCost {
+
+    /** Name of the primitive */
+    char * name;
+
+    /** Bytes of an inline expansion */
+    int inlineBytes;
+
+    /** Cycles of an inline expansion (straight line) */
+    int inlineCycles;
+
+    /** Bytes of a call site (parameters passing and call) */
+    int callBytes;
+
+    /** Extra cycles paid by a call (parameters passing, call and return) */
+    int callCycles;
+
+} EmbeddedCost;
+
+#define INSTRUCTION_CYCLES_MODES        8
+
+/**
+ * @brief Static cycles of an instruction, for each addressing mode
+ * 
+ * The meaning of each addressing mode depends on the CPU; -1 means that
+ * the instruction does not have that mode.
+ */
+typedef struct _InstructionCycles {
+
+    /** Mnemonic */
+    char * mnemonic;
+
+    /** Cycles, for each addressing mode */
+    int cycles[INSTRUCTION_CYCLES_MODES];
+
+    /** True if it is a jump or a branch */
+    int branch;
+
+} InstructionCycles;
+
 typedef struct _Deployed {
 
     int vbl;
@@ -1796,6 +1986,7 @@ typedef struct _Deployed {
     int raster;
     int putimage;
     int putimagereu;
+    int reu;
     int putimageram;
     int putimageramrle;
     int getimage;
@@ -1829,6 +2020,8 @@ typedef struct _Deployed {
     int create_path;
     int create_vector;
     int rotate_vector;
+    int rotate_vector_byte;
+    int fp_atan2;
     int travel_path;
     int fade;
 
@@ -1910,12 +2103,15 @@ typedef struct _Deployed {
     int paint;
     int play_string;
     int put_tilemap;
+    int scroll_tilemap;
 
     int timer;
 
     int dcommon;
     int dload;
     int dsave;
+    int fastload;
+    int dloadasync;
     int bank;
     int msc1;
     int flipimagex;
@@ -2052,6 +2248,7 @@ typedef struct _AudioConfig {
 
     int                 async;
     AudioDeviceName     target;
+    int                 priority;
 
 } AudioConfig;
 
@@ -2097,6 +2294,13 @@ typedef struct _TileDescriptor {
     int horizontalEdges[8];
     int verticalEdges[8];
 
+    // The 8x8 tile as a single 64 bit word (row 0 in the lower byte).
+    unsigned long long bitboard;
+
+    // All the edge counts packed as 4 bit nibbles: two descriptors with
+    // the same white area and the same edges have an affinity of zero.
+    unsigned long long edges;
+
 } TileDescriptor;
 
 typedef struct _TileData {
@@ -2115,6 +2319,14 @@ typedef struct _TileDescriptors {
     TileDescriptor *    descriptor[256];
     TileData            data[256];
 
+    // Lookup index, rebuilt whenever the descriptors change: the exact
+    // match hash table and the tiles sorted by white area.
+    int                 indexValid;
+    TileDescriptor *    indexed[256];
+    short               hash[TILE_DESCRIPTORS_HASH_SIZE];
+    unsigned char       byWhiteArea[256];
+    short               whiteAreaFirst[66];
+
 } TileDescriptors;
 
 typedef int (*RgbConverterFunction)(int, int, int);
@@ -2360,6 +2572,21 @@ typedef struct _Environment {
      */
     Embedded embeddedStats;
 
+    /**
+     * Stats about call sites that called the embedded method
+     */
+    Embedded embeddedCalls;
+
+    /**
+     * Optimization mode for the whole program
+     */
+    OptimizeMode optimizeMode;
+
+    /**
+     * Optimization mode for the current procedure (if not default)
+     */
+    OptimizeMode procedureOptimizeMode;
+
     /**
      * 
      */
@@ -2634,6 +2861,12 @@ typedef struct _Environment {
      */
     Loop * loops;
 
+    /**
+     * Values calculated by the current statement, that can be
+     * reused (see value_record()).
+     */
+    ValueRecord * valueRecords;
+
     // /**
     //  * "Every" status
     //  */
@@ -2795,6 +3028,30 @@ typedef struct _Environment {
      */
     int protothread;
 
+    /**
+     * Temporary storage for INLINE PROCEDURE definition
+     */
+    int inlineProcedure;
+
+    /**
+     * The current procedure cannot be expanded inline (it has labels
+     * or it returns before the END PROC)
+     */
+    int procedureInlineBlocked;
+
+    /**
+     * The current procedure calls other procedures
+     */
+    int procedureCalls;
+
+    /**
+     * Level and offsets of the output of the current procedure: start 
+     * of the procedure and start of the body
+     */
+    int procedureBufferLevel;
+    int procedureStart;
+    int procedureBodyStart;
+
     /**
      * Has at least one parallel procedure?
      */
@@ -2920,6 +3177,16 @@ typedef struct _Environment {
     int debugImageLoad;
     
     int bankedLoadDefault;
+
+    /**
+     * Use the built-in fast loader for DLOAD (if available).
+     */
+    int dloadFast;
+
+    /**
+     * Sector interleave for the disk images (0 = default).
+     */
+    int diskInterleave;
     
     /**
      * Default type for variables.
@@ -3086,6 +3353,11 @@ typedef struct _Environment {
      */
     int frameBufferStart2;
 
+    /*
+     * Starting address of the pair of double buffered screens
+     */
+    int doubleBufferStart;
+
     int lineInput;
 
     int keyPressDutyCycle;
@@ -3239,6 +3511,8 @@ typedef struct _Environment {
 
     int printSafe;
     int printRaw;
+    int printCache;
+    int screenCache;
     int putImageSafe;
     int getImageSafe;
 
@@ -3298,6 +3572,34 @@ typedef struct _Environment {
      */
     int bufferOutputSize[MAX_BUFFERED_OUTPUT];
 
+    /**
+     * Library output content: the runtime modules deployed during the
+     * compilation are collected here, and emitted once after the program.
+     */
+    char * libraryOutput;
+
+    /**
+     * Library output size
+     */
+    int libraryOutputSize;
+
+    /**
+     * Nesting level of deployments (only the outermost switches output)
+     */
+    int libraryOutputDepth;
+
+    /**
+     * Set when the library output has been emitted: any later deployment
+     * goes inline (with a jump over it), as before.
+     */
+    int libraryOutputClosed;
+
+    /**
+     * Buffered output content and size saved while writing the library
+     */
+    char * libraryOutputSaved;
+    int libraryOutputSavedSize;
+
 } Environment;
 
 #define UNIQUE_ID            ((struct _Environment *)_environment)->uniqueId++
@@ -3792,6 +4094,11 @@ int yyerror ( Environment * _ignored, const char * _message );
 #define CRITICAL_INVALID_NUMBER_DIGITS( n ) CRITICAL2i("E399 - invalid number of digits for NUMBER representation", n );
 #define CRITICAL_INVALID_FRAME_WIDTH( s ) CRITICAL2("E400 - invalid frame width", s );
 #define CRITICAL_INVALID_FRAME_HEIGHT( s ) CRITICAL2("E401 - invalid frame height", s );
+#define CRITICAL_CANNOT_SCROLL_TILEMAP_FOR_NON_TILEMAP( v ) CRITICAL2("E402 - cannot SCROLL TILEMAP without a tile map", v );
+#define CRITICAL_CANNOT_SCROLL_TILEMAP_FOR_TILEMAP_ON_STORAGE( v ) CRITICAL2("E403 - cannot use (yet) SCROLL TILEMAP on tilemap on storage", v );
+#define CRITICAL_CANNOT_SCROLL_TILEMAP_WITH_TILES_NOT_CELLS( v ) CRITICAL2("E404 - SCROLL TILEMAP needs tiles as big as a character cell", v );
+#define CRITICAL_SOUND_PRIORITY_OUT_OF_RANGE( v ) CRITICAL2i("E405 - SOUND PRIORITY must be between 0 and 254", v );
+#define CRITICAL_DLOAD_INVALID_INTERLEAVE( v ) CRITICAL2i("E406 - DLOAD INTERLEAVE must be between 1 and 20", v );
 
 #define CRITICALB( s ) fprintf(stderr, "CRITICAL ERROR during building of %s:\n\t%s\n", ((struct _Environment *)_environment)->sourceFileName, s ); target_cleanup( ((struct _Environment *)_environment) ); exit( EXIT_FAILURE );
 #define CRITICALB2( s, v ) fprintf(stderr, "CRITICAL ERROR during building of %s:\n\t%s (%s)\n", ((struct _Environment *)_environment)->sourceFileName, s, v ); target_cleanup( ((struct _Environment *)_environment) ); exit( EXIT_FAILURE );
@@ -3818,6 +4125,7 @@ int yyerror ( Environment * _ignored, const char * _message );
 #define WARNING_DLOAD_IGNORED_OFFSET( f ) WARNING2("W008 - offset for DLOAD is ignored", f );
 #define WARNING_DEPRECATED( k ) WARNING2("W009 - keyword has been deprecated and has no effect", k );
 #define WARNING_DLOAD_IGNORED_FILENAME( f ) WARNING2("W010 - filename for DLOAD is ignored", f );
+#define WARNING_DOUBLE_BUFFER_UNSUPPORTED( ) WARNING("W011 - DOUBLE BUFFER is not supported on this target and has no effect" );
 
 int assemblyLineIsAComment( char * _buffer );
 const char* strstrcase( const char* _x, const char* _y );
@@ -3835,6 +4143,9 @@ void buffered_push_output( Environment * _environment );
 void buffered_output( Environment * _environment, FILE * _stream );
 void buffered_prepend_output( Environment * _environment );
 void buffered_pop_output( Environment * _environment );
+int buffered_push_library( Environment * _environment );
+void buffered_pop_library( Environment * _environment );
+void buffered_library_output( Environment * _environment );
 
 #define outline0n(n,s,r)     \
     { \
@@ -4209,13 +4520,26 @@ int embed_scan_string (const char *);
 #define cfg4(s,a,b,c,d)         cfgline4n(0, s, a, b, c, d, 0)
 #define cfg5(s,a,b,c,d,e)       cfgline5n(0, s, a, b, c, d, e, 0)
 
+#define deploy_library_begin(s)  \
+            int deployInLibrary = buffered_push_library( _environment ); \
+            if ( ! deployInLibrary ) { \
+                cpu_jump( _environment, #s "_after" ); \
+            }
+
+#define deploy_library_end(s)  \
+            if ( deployInLibrary ) { \
+                buffered_pop_library( _environment ); \
+            } else { \
+                cpu_label( _environment, #s "_after" ); \
+            }
+
 #define deploy(s,e)  \
         if ( ! _environment->deployed.s ) { \
             int ignoreEmptyProcedure = _environment->emptyProcedure; \
             _environment->emptyProcedure = 0; \
-            cpu_jump( _environment, #s "_after" ); \
+            deploy_library_begin(s); \
             outembedded0(e); \
-            cpu_label( _environment, #s "_after" ); \
+            deploy_library_end(s); \
             _environment->emptyProcedure = ignoreEmptyProcedure; \
             _environment->deployed.s = 1; \
         }
@@ -4245,10 +4569,10 @@ int embed_scan_string (const char *);
         if ( ! _environment->deployed.s ) { \
             int ignoreEmptyProcedure = _environment->emptyProcedure; \
             _environment->emptyProcedure = 0; \
-            cpu_jump( _environment, #s "_after" ); \
+            deploy_library_begin(s); \
             outembedded0(e); \
             v(_environment);\
-            cpu_label( _environment, #s "_after" ); \
+            deploy_library_end(s); \
             _environment->emptyProcedure = ignoreEmptyProcedure; \
             _environment->deployed.s = 1; \
         }
@@ -4264,9 +4588,9 @@ int embed_scan_string (const char *);
         if ( ! _environment->deployed.embedded.s ) { \
             int ignoreEmptyProcedure = _environment->emptyProcedure; \
             _environment->emptyProcedure = 0; \
-            cpu_jump( _environment, #s "_after" ); \
+            deploy_library_begin(s); \
             outembedded0(e); \
-            cpu_label( _environment, #s "_after" ); \
+            deploy_library_end(s); \
             _environment->emptyProcedure = ignoreEmptyProcedure; \
             _environment->deployed.embedded.s = 1; \
         }
@@ -4283,11 +4607,11 @@ int embed_scan_string (const char *);
             int ignoreEmptyProcedure = _environment->emptyProcedure; \
             _environment->protothread = 0; \
             _environment->emptyProcedure = 0; \
-            cpu_jump( _environment, #s "_after" ); \
+            deploy_library_begin(s); \
             cpu_label( _environment, "lib_" #s ); \
 
 #define deploy_end(s)  \
-            cpu_label( _environment, #s "_after" ); \
+            deploy_library_end(s); \
             _environment->protothread = ignoreProtothread; \
             _environment->emptyProcedure = ignoreEmptyProcedure; \
             _environment->deployed.s = 1; \
@@ -4295,7 +4619,7 @@ int embed_scan_string (const char *);
 
 #define inline(s) \
         _environment->embeddedStats.s++; \
-        if ( !_environment->embedded.s ) {
+        if ( !( embedded_call( _environment, #s, _environment->embedded.s ) && ++_environment->embeddedCalls.s ) ) {
 
 #define no_inline(s) \
         if ( !_environment->embedded.s ) { \
@@ -4319,7 +4643,8 @@ int embed_scan_string (const char *);
     }
 
 #define stats_embedded(s) \
-    printf("%s:\t%d\t%s\t\n", #s, _environment->embeddedStats.s, _environment->embedded.s ? "embedded" : "inline" );
+    printf("%s:\t%d\t%s\t\n", #s, _environment->embeddedStats.s, _environment->embedded.s ? "embedded" : "inline" ); \
+    embedded_cost_report( _environment, #s, _environment->embeddedStats.s, _environment->embeddedCalls.s );
 
 #define WW_PEN              1
 #define WW_PAPER            2
@@ -4884,6 +5209,11 @@ void target_cleanup( Environment *_environment );
 void end_build( Environment * _environment );
 void bank_cleanup( Environment * _environment );
 void gameloop_cleanup( Environment * _environment );
+void library_cleanup( Environment * _environment );
+void procedure_cleanup( Environment * _environment );
+int embedded_call( Environment * _environment, char * _name, int _forced );
+void embedded_cost_report( Environment * _environment, char * _name, int _sites, int _calls );
+void optimize_mode( Environment * _environment, OptimizeMode _mode );
 void linker_cleanup( Environment * _environment );
 void linker_setup( Environment * _environment );
 int pattern_match( char * _pattern, char * _value );
@@ -4942,6 +5272,14 @@ void tmp_buf_clr(void *key1);
 POBuffer po_buf_match(POBuffer _buf, const char *_pattern, ...);
 int po_buf_strcmp(POBuffer _s, POBuffer _t);
 int po_buf_is_hex(POBuffer _s);
+void optim_timer_context_6502( Environment * _environment );
+void optim_timer_context_6809( Environment * _environment );
+void optim_timer_context_z80( Environment * _environment );
+void optim_timer_context_8086( Environment * _environment );
+void hotspot_begin( Environment * _environment );
+void hotspot_instruction( Environment * _environment, int _sourceLine, char * _line, int _label );
+void hotspot_end( Environment * _environment );
+int instruction_cycles( InstructionCycles * _table, char * _mnemonic, int _mode, int * _branch );
 
 #define TMP_BUF         tmp_buf(__FILE__, __LINE__)
 #define TMP_BUF_CLR     tmp_buf_clr(__FILE__)
@@ -5170,6 +5508,7 @@ void                    copper_wait( Environment * _environment, int _line );
 void                    copper_move( Environment * _environment, int _address1, int _address2, VariableType _VariableType );
 void                    copper_store( Environment * _environment, int _address, int _value, VariableType _VariableType );
 void                    copper_use( Environment * _environment, char * _name );
+Variable *              cos_byte( Environment * _environment, char * _angle );
 Variable *              create_path( Environment * _environment, char * _x0, char * _y0, char * _x1, char * _y1 );
 Variable *              create_vector( Environment * _environment, char * _x, char * _y );
 Variable *              csprite_init( Environment * _environment, char * _image, char * _sprite, int _flags );
@@ -5193,6 +5532,8 @@ void                    declare_procedure( Environment * _environment, char * _n
 void                    defdgr_vars( Environment * _environment, char * _character, char * _b0, char * _b1, char * _b2, char * _b3, char * _b4, char * _b5, char * _b6, char * _b7 );
 Variable *              distance( Environment * _environment, char * _x1, char * _y1, char * _x2, char * _y2 );
 void                    dload( Environment * _environment, char * _filename, char * _offset, char * _address, char * _bank, char * _size );
+void                    dload_async( Environment * _environment, char * _filename, char * _address );
+Variable *              dload_ready( Environment * _environment );
 void                    double_buffer( Environment * _environment, int _enabled );
 void                    downw( Environment * _environment, char * _line, char * _column, char * _width, char * _height );
 void                    downb( Environment * _environment, char * _line, char * _column, char * _width, char * _height );
@@ -5322,6 +5663,7 @@ void                    flip_image_vars_direction( Environment * _environment, c
 void                    flip_image_vars_indirection( Environment * _environment, char * _image, char * _frame, char * _sequence, char * _direction );
 void                    font_descriptors_init( Environment * _environment, int _embedded_present );
 void                    forbid( Environment * _environment );
+Variable *              fp_atan2( Environment * _environment, char * _dx, char * _dy );
 Variable *              fp_cos( Environment * _environment, char * _angle );
 Variable *              fp_sin( Environment * _environment, char * _angle );
 Variable *              fp_tan( Environment * _environment, char * _angle );
@@ -5392,6 +5734,9 @@ void                    home( Environment * _environment );
 //----------------------------------------------------------------------------
 
 void                    if_then( Environment * _environment, char * _expression );
+void                    if_then_dead_begin( Environment * _environment, Conditional * _conditional );
+int                     if_then_dead_end( Environment * _environment, Conditional * _conditional );
+void                    if_then_dead_keep( Environment * _environment );
 char *                  image_cut( Environment * _environment, char * _source, int _x, int _y, int _width, int _height );
 char *                  image_flip_x( Environment * _environment, char * _source, int _width, int _height, int _depth );
 char *                  image_flip_y( Environment * _environment, char * _source, int _width, int _height, int _depth );
@@ -5513,6 +5858,7 @@ Variable *              moving( Environment * _environment, char * _prefix, char
 Variable *              msprite_init( Environment * _environment, char * _image, char * _sprite, int _flags );
 Variable *              msprite_duplicate( Environment * _environment, char * _original );
 void                    msprite_update( Environment * _environment );
+Variable *              msprite_dropped( Environment * _environment );
 Variable *              music_load( Environment * _environment, char * _filename, char * _alias, int _bank_expansion );
 Variable *              music_load_to_variable( Environment * _environment, char * _filename, char * _alias, int _bank_expansion );
 Variable *              music_storage( Environment * _environment, char * _filename, char * _alias, int _bank_expansion );
@@ -5605,6 +5951,8 @@ void                    print_question_mark( Environment * _environment );
 void                    print_tab( Environment * _environment, int _new_line );
 void                    proc( Environment * _environment, char * _label );
 int                     procedure_exists( Environment * _environment, char * _name );
+void                    procedure_inline( Environment * _environment, Procedure * _procedure );
+void                    procedure_inline_end( Environment * _environment, Procedure * _procedure, int _bodyEnd );
 void                    put_key( Environment * _environment, char * _string );
 void                    put_image( Environment * _environment, char * _image, char * _x1, char * _y1, char * _x2, char * _y2, char * _frame, char * _sequence, int _flags );
 void                    put_image_vars( Environment * _environment, char * _image, char * _x1, char * _y1, char * _x2, char * _y2, char * _frame, char * _sequence, char * _flags );
@@ -5687,6 +6035,7 @@ Variable *              screen_var( Environment * _environment, char * _x, char
 void                    screen_vertical_scroll( Environment * _environment, int _displacement );
 void                    screen_vertical_scroll_var( Environment * _environment, char * _displacement );
 void                    scroll( Environment * _environment, int _dx, int _dy );
+void                    scroll_tilemap( Environment * _environment, char * _tilemap, int _dx, int _dy );
 void                    select_case( Environment * _environment, char * _expression );
 Variable *              sequence_load( Environment * _environment, char * _filename, char * _alias, int _mode, int _frame_width, int _frame_height, int _flags, int _transparent_color, int _background_color, int _bank_expansion, int _origin_x, int _origin_y, int _offset_x, int _offset_y );
 Variable *              sequence_storage( Environment * _environment, char * _filename, char * _alias, int _mode, int _frame_width, int _frame_height, int _flags, int _transparent_color, int _background_color, int _bank_expansion, int _origin_x, int _origin_y, int _offset_x, int _offset_y );
@@ -5703,6 +6052,7 @@ void                    sound_vars( Environment * _environment, char * _freq, ch
 void                    sound_off( Environment * _environment, int _channels );
 void                    sound_off_var( Environment * _environment, char * _channels );
 Variable *              sign( Environment * _environment, char * _value );
+Variable *              sin_byte( Environment * _environment, char * _angle );
 Variable *              spawn_procedure( Environment * _environment, char * _name , int _halted );
 void                    spc( Environment * _environment, char * _spaces );
 Variable *              spen( Environment * _environment );
@@ -5804,6 +6154,13 @@ void                    upb( Environment * _environment, char * _line, char * _c
 // *V*
 //----------------------------------------------------------------------------
 
+int                     value_record_begin( Environment * _environment, int * _buffer );
+int                     value_record_drop( Environment * _environment, Variable * _variable );
+Variable *              value_record_find( Environment * _environment, char * _signature, Variable ** _addend );
+void                    value_record( Environment * _environment, char * _operation, Variable * _left, Variable * _right, Variable * _result, int _buffer, int _start );
+void                    value_record_reset( Environment * _environment );
+int                     value_record_signature( Environment * _environment, Variable * _variable, char * _signature );
+void                    value_record_store( Environment * _environment, char * _signature, Variable * _result, Variable * _addend );
 Variable *              variable_add( Environment * _environment, char * _source, char * _dest );
 Variable *              variable_add_const( Environment * _environment, char * _source, int _dest );
 void                    variable_add_inplace( Environment * _environment, char * _source, int _dest );
@@ -5823,6 +6180,13 @@ void                    variable_array_fill_random( Environment * _environment,
 void                    variable_array_fill_incremental( Environment * _environment, char * _name, int _min, int _count );
 void                    variable_array_shuffle( Environment * _environment, char * _name, int _rounds );
 Variable *              variable_array_type( Environment * _environment, char *_name, VariableType _type );
+void                    variable_array_walk_begin( Environment * _environment );
+void                    variable_array_walk_end( Environment * _environment );
+ArrayWalk *             variable_array_walk_find( Environment * _environment, Variable * _array );
+void                    variable_array_walk_invalidate( Environment * _environment );
+void                    variable_array_walk_step( Environment * _environment );
+void                    variable_array_walk_sync( Environment * _environment );
+void                    variable_array_walk_written( Environment * _environment, char * _name );
 Variable *              variable_bin( Environment * _environment, char * _value, char * _digits );
 Variable *              variable_bit( Environment * _environment, char * _value, char * _position );
 Variable *              variable_cast( Environment * _environment, char * _source, VariableType _type );
@@ -60,7 +60,8 @@ extern char OUTPUT_FILE_TYPE_AS_STRING[][16];
 %token POINT GOSUB RETURN POP OR ELSE NOT TRUE FALSE DO EXIT WEND UNTIL FOR STEP EVERY
 %token MID INSTR UPPER UCASE LOWER LCASE STR VAL STRING SPACE FLIP CHR ASC LEN MOD ADD MIN MAX SGN
 %token SIGNED ABS RND COLORS COLOURS INK TIMER POWERING DIM ADDRESS PROC PROCEDURE CALL OSP CSP
-%token SHARED MILLISECOND MILLISECONDS TICK TICKS GLOBAL PARAM PRINT DEFAULT USE
+%token SHARED MILLISECOND MILLISECONDS TICK TICKS GLOBAL PARAM PRINT DEFAULT USE PRIORITY INTERLEAVE
+%token OPTIMIZE BALANCED INLINE
 %token PAPER INVERSE REPLACE XOR IGNORE NORMAL WRITING ONLY LOCATE CLS HOME CMOVE
 %token CENTER CENTRE TAB SET CUP CDOWN CLEFT CRIGHT CLINE XCURS YCURS MEMORIZE REMEMBER
 %token HSCROLL VSCROLL TEXTADDRESS JOY BIN BIT COUNT JOYCOUNT FIRE JUP JDOWN JLEFT JRIGHT JFIRE
@@ -89,7 +90,7 @@ extern char OUTPUT_FILE_TYPE_AS_STRING[][16];
 %token XYLOPHONE KILL COMPRESSED STORAGE ENDSTORAGE FILEX DLOAD LET CPC INT INTEGER LONG OP_PERC OP_PERC2 OP_AMPERSAND OP_AT
 %token EMBEDDED RELEASE READONLY OPTION EXPLICIT ORIGIN RELATIVE DTILE DTILES OUT RESOLUTION
 %token COCO STANDARD SEMIGRAPHIC COMPLETE PRESERVE BLIT COPY THRESHOLD SOURCE DESTINATION VALUE
-%token LBOUND UBOUND BINARY C128Z FLOAT FAST SINGLE PRECISION DEGREE RADIAN PI SIN COS BITMAPS OPACITY
+%token LBOUND UBOUND BINARY C128Z FLOAT FAST SINGLE PRECISION DEGREE RADIAN PI SIN COS ATAN2 BITMAPS OPACITY
 %token ALL BUT VG5000 CLASS PROBABILITY LAYER SLICE INDEX SYS EXEC CPU6502 CPU6809 CPUZ80 ASM 
 %token STACK DECLARE SYSTEM KEYBOARD RATE DELAY NAMED ID RATIO BETA PER SECOND AUTO COCO1 COCO2 COCO3
 %token RESTORE SAFE PAGE PMODE PCLS PRESET PSET BF PAINT SPC UNSIGNED NARROW WIDE AFTER STRPTR ERROR
@@ -110,7 +111,7 @@ extern char OUTPUT_FILE_TYPE_AS_STRING[][16];
 %token REGISTER SUM VCENTER VHCENTER VCENTRE VHCENTRE BOTTOM JMOVE LBOTTOM RANGE FWIDTH FHEIGHT PLOTR INKB ADDC
 %token ENDPROC EXITIF VIRTUALIZED BY COARSE PRECISE VECTOR ROTATE SPEN CSV ENDTYPE ALPHA BITMAPADDRESS COPPER STORE ENDCOPPER
 %token VZ200 FCIRCLE FELLIPSE RECT TRIANGLE C16 PCCGA CPU8086 FLASH CHAIN NUMBER DIGITS RESET CPU6309 
-%token CPU6510 CPU7501 CPU8501 CPU8502 COMPILE
+%token CPU6510 CPU7501 CPU8501 CPU8502 COMPILE DROPPED CACHE BCD BCD4 BCD6 BCD8
 
 %token A B C D E F G H I J K L M N O P Q R S T U V X Y W Z
 %token F1 F2 F3 F4 F5 F6 F7 F8
@@ -1566,20 +1567,26 @@ expr_math2:
     | expr_math2 OP_PLUS term {
         Variable * v = variable_retrieve( _environment, $1 );
         Variable * expr = variable_retrieve( _environment, $3 );
+        int buffer;
+        int start = value_record_begin( _environment, &buffer );
         if ( expr->initializedByConstant && VT_BITWIDTH(v->type)>1 ) {
             $$ = variable_add_const( _environment, $1, expr->value )->name;
         } else {
             $$ = variable_add( _environment, $1, $3 )->name;
         }
+        value_record( _environment, "+", v, expr, variable_retrieve( _environment, $$ ), buffer, start );
     }
     | expr_math2 OP_MINUS term {
         Variable * v = variable_retrieve( _environment, $1 );
         Variable * expr = variable_retrieve( _environment, $3 );
+        int buffer;
+        int start = value_record_begin( _environment, &buffer );
         if ( expr->initializedByConstant && VT_BITWIDTH(v->type)>1 ) {
             $$ = variable_sub_const( _environment, $1, expr->value )->name;
         } else {
             $$ = variable_sub( _environment, $1, $3 )->name;
         }
+        value_record( _environment, "-", v, expr, variable_retrieve( _environment, $$ ), buffer, start );
     }
     ;
 
@@ -3146,6 +3153,9 @@ exponential_less:
     | TAN OP expr CP {
         $$ = fp_tan( _environment, $3 )->name;
       }
+    | ATAN2 OP expr OP_COMMA expr CP {
+        $$ = fp_atan2( _environment, $3, $5 )->name;
+      }
     | COMBINE NIBBLE OP expr OP_COMMA expr CP {
         $$ = combine_nibble_vars( _environment, $4, $6 )->name;
       }
@@ -3966,6 +3976,9 @@ exponential_less:
             variable_store( _environment, $$, 0 );
           }
     }
+    | DLOAD READY {
+        $$ = dload_ready( _environment )->name;
+    }
     | DLOAD ERROR {
         $$ = variable_temporary( _environment, VT_BYTE, "(DLOAD ERROR)" )->name;
         variable_move( _environment, "DLOADERROR", $$ );
@@ -4170,6 +4183,9 @@ exponential_less:
     | MSPRITE OP expr OP_COMMA expr sprite_flags CP {
         $$ = msprite_init( _environment, $3, $5, $6 )->name;
     }
+    | MSPRITE DROPPED {
+        $$ = msprite_dropped( _environment )->name;
+    }
     | PAGE Integer {
         if ( ( $2 != 0 ) && ( $2 != 1 ) ) {
             CRITICAL_PAGE01();
@@ -7184,6 +7200,18 @@ datatype :
     | NUMBER {
         $$ = VT_NUMBER;
     }
+    | BCD {
+        $$ = VT_BCD8;
+    }
+    | BCD4 {
+        $$ = VT_BCD4;
+    }
+    | BCD6 {
+        $$ = VT_BCD6;
+    }
+    | BCD8 {
+        $$ = VT_BCD8;
+    }
     | ADDRESS {
         $$ = VT_ADDRESS;
     }
@@ -8455,11 +8483,13 @@ sound_definition_argument :
     }
     | expr milliseconds_optional {
         ((struct _Environment *)_environment)->soundNote[((struct _Environment *)_environment)->lastSoundNoteDuration] = strdup( $1 );
+        ((struct _Environment *)_environment)->atLeastOneSoundNoteDurationSymbolic = 1;
         ++((struct _Environment *)_environment)->lastSoundNoteDuration;
     }
     | expr OP_COMMA expr milliseconds_optional {
         ((struct _Environment *)_environment)->soundNote[((struct _Environment *)_environment)->lastSoundNoteDuration] = strdup( $1 );
         ((struct _Environment *)_environment)->soundDuration[((struct _Environment *)_environment)->lastSoundNoteDuration] = strdup( $3 );
+        ((struct _Environment *)_environment)->atLeastOneSoundNoteDurationSymbolic = 1;
         ++((struct _Environment *)_environment)->lastSoundNoteDuration;
     };
 
@@ -8491,6 +8521,14 @@ sound_definition :
                 sound( _environment, ((struct _Environment *)_environment)->soundNoteValue[i], ((struct _Environment *)_environment)->soundDurationValue[i], $4 );
             }
         }
+        for( int i=0; i<((struct _Environment *)_environment)->lastSoundNoteDuration; ++i ) {
+            ((struct _Environment *)_environment)->soundNote[i] = NULL;
+            ((struct _Environment *)_environment)->soundNoteValue[i] = 0;
+            ((struct _Environment *)_environment)->soundDuration[i] = NULL;
+            ((struct _Environment *)_environment)->soundDurationValue[i] = 0;
+        }
+        ((struct _Environment *)_environment)->lastSoundNoteDuration = 0;
+        ((struct _Environment *)_environment)->atLeastOneSoundNoteDurationSymbolic = 0;
     }
     | sound_definition_arguments ON expr {
         for( int i=0; i<((struct _Environment *)_environment)->lastSoundNoteDuration; ++i ) {
@@ -8515,6 +8553,14 @@ sound_definition :
                 sound_vars( _environment, note->name, duration->name, $3 );
             }
         }
+        for( int i=0; i<((struct _Environment *)_environment)->lastSoundNoteDuration; ++i ) {
+            ((struct _Environment *)_environment)->soundNote[i] = NULL;
+            ((struct _Environment *)_environment)->soundNoteValue[i] = 0;
+            ((struct _Environment *)_environment)->soundDuration[i] = NULL;
+            ((struct _Environment *)_environment)->soundDurationValue[i] = 0;
+        }
+        ((struct _Environment *)_environment)->lastSoundNoteDuration = 0;
+        ((struct _Environment *)_environment)->atLeastOneSoundNoteDurationSymbolic = 0;
     }
     | sound_definition_arguments {
         for( int i=0; i<((struct _Environment *)_environment)->lastSoundNoteDuration; ++i ) {
@@ -8534,6 +8580,20 @@ sound_definition :
                 sound( _environment, ((struct _Environment *)_environment)->soundNoteValue[i], ((struct _Environment *)_environment)->soundDurationValue[i], 0xff );
             }
         }
+        for( int i=0; i<((struct _Environment *)_environment)->lastSoundNoteDuration; ++i ) {
+            ((struct _Environment *)_environment)->soundNote[i] = NULL;
+            ((struct _Environment *)_environment)->soundNoteValue[i] = 0;
+            ((struct _Environment *)_environment)->soundDuration[i] = NULL;
+            ((struct _Environment *)_environment)->soundDurationValue[i] = 0;
+        }
+        ((struct _Environment *)_environment)->lastSoundNoteDuration = 0;
+        ((struct _Environment *)_environment)->atLeastOneSoundNoteDurationSymbolic = 0;
+    }
+    | PRIORITY const_expr {
+        if ( $2 < 0 || $2 > 254 ) {
+            CRITICAL_SOUND_PRIORITY_OUT_OF_RANGE( $2 );
+        }
+        ((struct _Environment *)_environment)->audioConfig.priority = $2;
     }
     | OFF  {
         sound_off( _environment, 0xffff );
@@ -8864,6 +8924,7 @@ input_definition2 :
             vt = ((struct _Environment *)_environment)->defaultVariableType;
         }
         input( _environment, $1, vt );
+        variable_array_walk_written( _environment, $1 );
         print_newline( _environment );
       }
     | Identifier as_datatype_suffix_optional OP_SEMICOLON {
@@ -8872,6 +8933,7 @@ input_definition2 :
             vt = ((struct _Environment *)_environment)->defaultVariableType;
         }
         input( _environment, $1, vt );
+        variable_array_walk_written( _environment, $1 );
       }
     | Identifier as_datatype_suffix_optional {
         VariableType vt = $2;
@@ -8879,6 +8941,7 @@ input_definition2 :
             vt = ((struct _Environment *)_environment)->defaultVariableType;
         }
         input( _environment, $1, vt );
+        variable_array_walk_written( _environment, $1 );
       } OP_COMMA input_definition2
     ;
 
@@ -9015,6 +9078,7 @@ input_definition :
             print( _environment, qm->name, 0, ((struct _Environment *)_environment)->printRaw );
         }
         input( _environment, $3, vt );
+        variable_array_walk_written( _environment, $3 );
     }
     | String op_comma_or_semicolon Identifier as_datatype_suffix_optional OP_COMMA {
         VariableType vt = $4;
@@ -9030,6 +9094,7 @@ input_definition :
             print( _environment, qm->name, 0, ((struct _Environment *)_environment)->printRaw );
         }
         input( _environment, $3, vt );
+        variable_array_walk_written( _environment, $3 );
     }  input_definition2
     | input_definition2
     | RawString op_comma_or_semicolon Identifier as_datatype_suffix_optional {
@@ -9044,6 +9109,7 @@ input_definition :
             print( _environment, qm->name, 0, ((struct _Environment *)_environment)->printRaw );
         }
         input( _environment, $3, vt );
+        variable_array_walk_written( _environment, $3 );
         print_newline( _environment );
     }
     | RawString op_comma_or_semicolon Identifier as_datatype_suffix_optional OP_SEMICOLON {
@@ -9061,6 +9127,7 @@ input_definition :
             print( _environment, qm->name, 0, ((struct _Environment *)_environment)->printRaw );
         }
         input( _environment, $3, vt );
+        variable_array_walk_written( _environment, $3 );
     }
     | RawString op_comma_or_semicolon Identifier as_datatype_suffix_optional OP_COMMA {
         VariableType vt = $4;
@@ -9077,6 +9144,7 @@ input_definition :
             print( _environment, qm->name, 0, ((struct _Environment *)_environment)->printRaw );
         }
         input( _environment, $3, vt );
+        variable_array_walk_written( _environment, $3 );
     }  input_definition2
   ;
 
@@ -9212,6 +9280,9 @@ define_definition :
     | PRINT SAFE {
         ((struct _Environment *)_environment)->printSafe = 1;
     }
+    | PRINT CACHE {
+        ((struct _Environment *)_environment)->printCache = 1;
+    }
     | IMAGEREF FAST {
         ((struct _Environment *)_environment)->putImageRefUnsafe = 1;
     }
@@ -9338,6 +9409,18 @@ define_definition :
     | LOAD BANKED OFF {
         ((struct _Environment *)_environment)->bankedLoadDefault = 0;
     }
+    | DLOAD FAST {
+        ((struct _Environment *)_environment)->dloadFast = 1;
+    }
+    | DLOAD NORMAL {
+        ((struct _Environment *)_environment)->dloadFast = 0;
+    }
+    | DLOAD INTERLEAVE const_expr {
+        if ( $3 < 1 || $3 > 20 ) {
+            CRITICAL_DLOAD_INVALID_INTERLEAVE( $3 );
+        }
+        ((struct _Environment *)_environment)->diskInterleave = $3;
+    }
     | KEY PRESSED SYNC {
         ((Environment *)_environment)->keyPressDutyCycle = 1;
     }
@@ -9501,6 +9584,9 @@ define_definition :
     | SCREEN MODE UNIQUE ON {
         ((struct _Environment *)_environment)->vestigialConfig.screenModeUnique = 1;
     }    
+    | SCREEN CACHE {
+        ((struct _Environment *)_environment)->screenCache = 1;
+    }    
     | DOUBLE BUFFER ON {
         ((struct _Environment *)_environment)->vestigialConfig.doubleBufferSelected = 1;
         ((struct _Environment *)_environment)->vestigialConfig.doubleBuffer = 1;
@@ -10129,6 +10215,15 @@ scroll_definition :
     | scroll_definition_vdirection {
         scroll( _environment, 0, $1 );
     }
+    | TILEMAP Identifier scroll_definition_hdirection scroll_definition_vdirection {
+        scroll_tilemap( _environment, $2, $3, $4 );
+    }
+    | TILEMAP Identifier scroll_definition_hdirection {
+        scroll_tilemap( _environment, $2, $3, 0 );
+    }
+    | TILEMAP Identifier scroll_definition_vdirection {
+        scroll_tilemap( _environment, $2, 0, $3 );
+    }
     ;
 
 palette_definition:
@@ -10202,6 +10297,17 @@ option_read :
         $$ = 1;
     };
 
+optimize_definition :
+    SPEED {
+        optimize_mode( _environment, OPTIMIZE_MODE_SPEED );
+    }
+    | SIZE {
+        optimize_mode( _environment, OPTIMIZE_MODE_SIZE );
+    }
+    | BALANCED {
+        optimize_mode( _environment, OPTIMIZE_MODE_BALANCED );
+    };
+
 option_definitions :
     COMPILE on_targets {
         if ( ! $2 ) {
@@ -10586,6 +10692,9 @@ dload_size_size :
 dload_definition :
     expr dload_from_offset dload_to_address dload_to_bank dload_size_size {
         dload( _environment, $1, $2, $3, $4, $5 );
+    }
+    | ASYNC expr dload_to_address {
+        dload_async( _environment, $2, $3 );
     };
 
 chain_definition :
@@ -12692,6 +12801,21 @@ statement2nc:
       ((struct _Environment *)_environment)->emptyProcedure = !$8;
       begin_procedure( _environment, $3 );
   }
+  | INLINE PROCEDURE Identifier on_targets {
+      ((struct _Environment *)_environment)->parameters = 0;
+      ((struct _Environment *)_environment)->protothread = 0;
+      ((struct _Environment *)_environment)->emptyProcedure = !$4;
+      ((struct _Environment *)_environment)->inlineProcedure = 1;
+      begin_procedure( _environment, $3 );
+  }
+  | INLINE PROCEDURE Identifier {
+      ((struct _Environment *)_environment)->parameters = 0;
+      ((struct _Environment *)_environment)->protothread = 0;
+    } OSP parameters CSP on_targets {
+      ((struct _Environment *)_environment)->emptyProcedure = !$8;
+      ((struct _Environment *)_environment)->inlineProcedure = 1;
+      begin_procedure( _environment, $3 );
+  }
   | SHARED parameters_expr {
       shared( _environment );
   }
@@ -12755,6 +12879,7 @@ statement2nc:
     }
     if ( $1 && $3 ) {
         outline1("%s", $2 );
+        variable_array_walk_invalidate( _environment );
     }
 #if defined(__to8__)
     }
@@ -12879,6 +13004,9 @@ statement2nc:
   | RADIAN {
      ((struct _Environment *)_environment)->floatType.angle = FT_RADIAN;
   }
+  | BINARY RADIAN {
+     ((struct _Environment *)_environment)->floatType.angle = FT_BYTE;
+  }
   | BELL bell_definition
   | BOOM boom_definition
   | SHOOT shoot_definition
@@ -13109,6 +13237,7 @@ statement2nc:
   | DECLARE declare_definition
   | DEFINE define_definitions
   | OPTION option_definitions
+  | OPTIMIZE optimize_definition
   | CONFIGURE configure_definitions
   | ORIGIN origin_definitions
   | RESOLUTION resolution_definitions